@@ -0,0 +1,75 @@
+// Scaling of slice_mesh(), slice_mesh_ex() and slice_mesh_slabs() with the number of threads,
+// verifying that the results do not depend on the number of threads.
+// Usage: slice_mesh_bench [mesh.stl|mesh.obj] [layer_height]
+// Without a mesh, a sphere of about 5 million triangles is sliced.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <tbb/global_control.h>
+
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+#include "libslic3r/Model.hpp"
+
+#include "libnest2d/tools/benchmark.h"
+
+using namespace Slic3r;
+
+template<class Fn>
+static double measure(Fn &&fn, int repeats = 3)
+{
+    Benchmark b;
+    double    best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++ i) {
+        b.start();
+        fn();
+        b.stop();
+        best = std::min(best, b.getElapsedSec());
+    }
+    return best;
+}
+
+int main(const int argc, const char *argv[])
+{
+    indexed_triangle_set its;
+    if (argc > 1) {
+        Model model = Model::read_from_file(argv[1]);
+        its = model.mesh().its;
+    } else
+        // 4 * PI^2 / fa^2 triangles.
+        its = its_make_sphere(50., 0.0028);
+    const float layer_height = argc > 2 ? std::stof(argv[2]) : 0.08f;
+
+    const BoundingBoxf3 bbox = bounding_box(its);
+    std::vector<float> zs;
+    for (float z = float(bbox.min.z()) + 0.5f * layer_height; z < bbox.max.z(); z += layer_height)
+        zs.emplace_back(z);
+    std::cout << its.indices.size() << " triangles, " << zs.size() << " layers" << std::endl;
+
+    std::vector<Polygons>   reference;
+    std::vector<ExPolygons> reference_ex;
+    std::vector<Polygons>   reference_top, reference_bottom;
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "slice_mesh [s]" << std::setw(20) << "slice_mesh_ex [s]" << std::setw(23) << "slice_mesh_slabs [s]" << std::endl;
+    for (int threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+        tbb::global_control      control(tbb::global_control::max_allowed_parallelism, threads);
+        std::vector<Polygons>    slices;
+        std::vector<ExPolygons>  slices_ex;
+        std::vector<Polygons>    top, bottom;
+        double t_slice    = measure([&]() { slices = slice_mesh(its, zs, MeshSlicingParams{}); });
+        double t_slice_ex = measure([&]() { slices_ex = slice_mesh_ex(its, zs, MeshSlicingParamsEx{}); });
+        double t_slabs    = measure([&]() { slice_mesh_slabs(its, zs, Transform3d::Identity(), &top, &bottom, []{}); });
+        std::cout << std::setw(8) << threads << std::setw(16) << t_slice << std::setw(20) << t_slice_ex << std::setw(23) << t_slabs;
+        if (threads == 1) {
+            reference        = std::move(slices);
+            reference_ex     = std::move(slices_ex);
+            reference_top    = std::move(top);
+            reference_bottom = std::move(bottom);
+        } else if (slices != reference || slices_ex != reference_ex || top != reference_top || bottom != reference_bottom)
+            std::cout << "  results differ from the single threaded run!";
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -22,6 +22,9 @@
 #include <cstring>
 #include <iostream>
 #include <math.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 #if defined(__linux__) || defined(__LINUX__)
 #include <condition_variable>
@@ -34,6 +37,7 @@ using namespace nlohmann;
 #endif
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/nowide/args.hpp>
 #include <boost/nowide/cenv.hpp>
@@ -49,10 +53,12 @@ using namespace nlohmann;
 #include "libslic3r/Config.hpp"
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/GCode/PostProcessor.hpp"
+#include "libslic3r/GCode/SeamVisibilityCache.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/ModelArrange.hpp"
 #include "libslic3r/Platform.hpp"
 #include "libslic3r/Print.hpp"
+#include "libslic3r/PrintObjectStepCache.hpp"
 #include "libslic3r/SLAPrint.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/Format/AMF.hpp"
@@ -340,6 +346,14 @@ typedef struct _cli_callback_mgr {
             close(m_pipe_fd);
             m_pipe_fd = -1;
         }
+        // Allow the manager to be started again by the next job of a batch.
+        lck.lock();
+        m_started        = false;
+        m_exit           = false;
+        m_data_ready     = false;
+        m_progress       = 0;
+        m_total_progress = 0;
+        lck.unlock();
         BOOST_LOG_TRIVIAL(info) << "cli_callback_mgr_t::stop successfully.";
     }
 }cli_callback_mgr_t;
@@ -394,6 +408,77 @@ static PrinterTechnology get_printer_technology(const DynamicConfig &config)
     return(ret);}
 #endif
 
+// A plate applied to its Print by CLI::run(), to be processed and exported concurrently with the other plates.
+struct ParallelPlateJob
+{
+    int                                     index { 0 };
+    Print                                  *print { nullptr };
+    Slic3r::GUI::GCodeResult               *gcode_result { nullptr };
+    std::string                             outfile;
+    sliced_plate_info_t                     sliced_plate_info;
+    // Warnings reported by the status callback of the print, which may be called from multiple threads.
+    std::mutex                              warnings_mutex;
+    std::vector<PrintBase::SlicingStatus>   warnings;
+    // Times in seconds: Applying the plate, processing and exporting it, and the part of the latter not covered by the step cache.
+    long long                               prepare_time { 0 };
+    long long                               process_time { 0 };
+    long long                               time_using_cache { 0 };
+    std::string                             error;
+};
+
+// Process and export the jobs by max_concurrency threads. The parallel loops of the prints share the TBB worker pool,
+// thus the machine is not oversubscribed. A further plate is only started while the resident memory of the process
+// is below memory_limit (three quarters of the physical memory if zero), or if no other plate is being sliced.
+static void run_parallel_plate_jobs(std::vector<std::unique_ptr<ParallelPlateJob>> &jobs, size_t max_concurrency, size_t memory_limit)
+{
+    if (memory_limit == 0)
+        memory_limit = total_physical_memory() / 4 * 3;
+    max_concurrency = std::min(max_concurrency, jobs.size());
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": slicing %1% plates, up to %2% at the same time, memory limit %3%")
+        % jobs.size() % max_concurrency % format_memsize_MB(memory_limit);
+
+    std::atomic<size_t>     next_job { 0 };
+    std::mutex              mutex;
+    std::condition_variable condition;
+    size_t                  running = 0;
+    auto worker = [&]() {
+        CNumericLocalesSetter locales_setter;
+        for (size_t job_idx = next_job ++; job_idx < jobs.size(); job_idx = next_job ++) {
+            ParallelPlateJob &job = *jobs[job_idx];
+            {
+                std::unique_lock<std::mutex> lck(mutex);
+                // The memory is not released by the plates, thus poll it.
+                while (running > 0 && current_process_memory() >= memory_limit)
+                    condition.wait_for(lck, std::chrono::milliseconds(100));
+                ++ running;
+            }
+            BOOST_LOG_TRIVIAL(info) << "start Print::process for partplate " << job.index + 1 << log_memory_info();
+            long long start_time = (long long)Slic3r::Utils::get_current_time_utc();
+            try {
+                job.print->process(&job.time_using_cache);
+                long long export_start_time = (long long)Slic3r::Utils::get_current_time_utc();
+                job.outfile = job.print->export_gcode(job.outfile, job.gcode_result, nullptr);
+                job.time_using_cache += (long long)Slic3r::Utils::get_current_time_utc() - export_start_time;
+            } catch (const std::exception &ex) {
+                job.error = ex.what();
+            }
+            job.process_time = (long long)Slic3r::Utils::get_current_time_utc() - start_time;
+            BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%: processed and exported in %2% secs") % (job.index + 1) % job.process_time;
+            {
+                std::lock_guard<std::mutex> lck(mutex);
+                -- running;
+            }
+            condition.notify_all();
+        }
+    };
+    std::vector<boost::thread> threads;
+    for (size_t i = 1; i < max_concurrency; ++ i)
+        threads.emplace_back(create_thread(worker));
+    worker();
+    for (boost::thread &thread : threads)
+        thread.join();
+}
+
 void record_exit_reson(std::string outputdir, int code, int plate_id, std::string error_message, sliced_info_t& sliced_info, std::map<std::string, std::string> key_values = std::map<std::string, std::string>())
 {
 #if defined(__linux__) || defined(__LINUX__)
@@ -876,6 +961,138 @@ static int construct_assemble_list(std::vector<assemble_plate_info_t> &assemble_
     return ret;
 }
 
+// Settings files parsed by load_config_file(), reused by the following jobs of a batch, see CLI::run_batch().
+// Keyed by the path of the file, invalidated by its modification time and size.
+struct CachedConfigFile
+{
+    std::time_t                         last_write_time { 0 };
+    uintmax_t                           file_size { 0 };
+    DynamicPrintConfig                  config;
+    std::map<std::string, std::string>  key_values;
+    // Reported again for every job loading the file.
+    ConfigSubstitutions                 config_substitutions;
+};
+static std::map<std::string, CachedConfigFile>  g_config_file_cache;
+static std::mutex                               g_config_file_cache_mutex;
+
+static ConfigSubstitutions clone_config_substitutions(const ConfigSubstitutions &substitutions)
+{
+    ConfigSubstitutions out;
+    out.reserve(substitutions.size());
+    for (const ConfigSubstitution &substitution : substitutions)
+        out.push_back({ substitution.opt_def, substitution.old_value, ConfigOptionUniquePtr(substitution.new_value ? substitution.new_value->clone() : nullptr) });
+    return out;
+}
+
+static ConfigSubstitutions load_config_from_json_cached(const std::string &file, ForwardCompatibilitySubstitutionRule compatibility_rule, DynamicPrintConfig &config,
+    std::map<std::string, std::string> &key_values, std::string &reason)
+{
+    boost::system::error_code ec;
+    std::time_t last_write_time = boost::filesystem::last_write_time(file, ec);
+    uintmax_t   file_size       = ec ? 0 : boost::filesystem::file_size(file, ec);
+    if (! ec) {
+        std::lock_guard<std::mutex> lock(g_config_file_cache_mutex);
+        auto it = g_config_file_cache.find(file);
+        if (it != g_config_file_cache.end() && it->second.last_write_time == last_write_time && it->second.file_size == file_size) {
+            BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": reusing the already parsed setting file %1%") % file;
+            config.apply(it->second.config);
+            key_values = it->second.key_values;
+            return clone_config_substitutions(it->second.config_substitutions);
+        }
+    }
+    ConfigSubstitutions config_substitutions = config.load_from_json(file, compatibility_rule, key_values, reason);
+    if (! ec && reason.empty()) {
+        std::lock_guard<std::mutex> lock(g_config_file_cache_mutex);
+        g_config_file_cache[file] = { last_write_time, file_size, config, key_values, clone_config_substitutions(config_substitutions) };
+    }
+    return config_substitutions;
+}
+
+int CLI::run_batch(const std::string &jobs_file, char *program)
+{
+    boost::nowide::ifstream  file_stream;
+    std::istream            *in = &boost::nowide::cin;
+    if (jobs_file != "-") {
+        file_stream.open(jobs_file);
+        if (! file_stream.is_open()) {
+            boost::nowide::cerr << __FUNCTION__ << ": can not open the batch file " << jobs_file << std::endl;
+            return CLI_FILE_NOTFOUND;
+        }
+        in = &file_stream;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": start reading the jobs from %1%") % jobs_file;
+    size_t      job_id = 0, failed_jobs = 0;
+    std::string line;
+    while (std::getline(*in, line)) {
+        boost::algorithm::trim(line);
+        if (line.empty() || line.front() == '#')
+            continue;
+        ++ job_id;
+
+        json report;
+        report["job"] = job_id;
+        // The arguments of the job, argv[0] is the path of this program as for the first run.
+        std::vector<std::string> args;
+        try {
+            json job = json::parse(line);
+            if (! job.is_array())
+                throw Slic3r::InvalidArgument("a job shall be a JSON array of the command line arguments");
+            for (const json &arg : job)
+                args.emplace_back(arg.get<std::string>());
+        } catch (const std::exception &ex) {
+            report["return_code"]  = CLI_INVALID_PARAMS;
+            report["error_string"] = ex.what();
+            boost::nowide::cout << "batch_job_result: " << report.dump() << std::endl;
+            ++ failed_jobs;
+            continue;
+        }
+        std::string outputdir;
+        for (size_t i = 0; i < args.size(); ++ i) {
+            if ((args[i] == "--outputdir" || args[i] == "-outputdir") && i + 1 < args.size())
+                outputdir = args[i + 1];
+            else if (boost::algorithm::starts_with(args[i], "--outputdir="))
+                outputdir = args[i].substr(12);
+        }
+        std::vector<char*> argv;
+        argv.emplace_back(program);
+        for (std::string &arg : args)
+            argv.emplace_back(arg.data());
+        argv.emplace_back(nullptr);
+
+        g_slicing_warnings.clear();
+        // The sliced_info of the job, as saved by record_exit_reson(). Remove the one of a previous job sharing the output directory,
+        // so that it is not reported if this job fails before saving its own.
+        boost::filesystem::path result_file = boost::filesystem::path(outputdir.empty() ? "." : outputdir) / "result.json";
+        boost::system::error_code ec;
+        boost::filesystem::remove(result_file, ec);
+        long long start_time = (long long)Slic3r::Utils::get_current_time_utc();
+        int       ret        = CLI_SUCCESS;
+        try {
+            ret = CLI().run(int(args.size() + 1), argv.data());
+        } catch (const std::exception &ex) {
+            ret = CLI_SLICING_ERROR;
+            report["error_string"] = ex.what();
+        }
+        report["return_code"] = ret;
+        report["time"]        = (long long)Slic3r::Utils::get_current_time_utc() - start_time;
+        if (boost::filesystem::exists(result_file)) {
+            try {
+                boost::nowide::ifstream ifs(result_file.string());
+                report["result"] = json::parse(ifs);
+            } catch (const std::exception &ex) {
+                BOOST_LOG_TRIVIAL(warning) << __FUNCTION__ << boost::format(": failed to read %1%: %2%") % result_file.string() % ex.what();
+            }
+        }
+        if (ret != CLI_SUCCESS)
+            ++ failed_jobs;
+        boost::nowide::cout << "batch_job_result: " << report.dump() << std::endl;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": finished %1% jobs, %2% failed") % job_id % failed_jobs;
+    return failed_jobs == 0 ? CLI_SUCCESS : CLI_SLICING_ERROR;
+}
+
 int CLI::run(int argc, char **argv)
 {
     // Mark the main thread for the debugger and for runtime checks.
@@ -916,6 +1133,10 @@ int CLI::run(int argc, char **argv)
         return CLI_INVALID_PARAMS;
     }
     BOOST_LOG_TRIVIAL(info) << "finished setup params, argc="<< argc << std::endl;
+
+    if (const std::string &batch_jobs = m_config.opt_string("batch", true); ! batch_jobs.empty())
+        return this->run_batch(batch_jobs, argv[0]);
+
     std::string temp_path = wxFileName::GetTempDir().utf8_str().data();
     set_temporary_dir(temp_path);
 
@@ -1477,7 +1698,7 @@ int CLI::run(int argc, char **argv)
             std::map<std::string, std::string> key_values;
             std::string reason;
 
-            config_substitutions = config.load_from_json(file, config_substitution_rule, key_values, reason);
+            config_substitutions = load_config_from_json_cached(file, config_substitution_rule, config, key_values, reason);
             if (!reason.empty()) {
                 BOOST_LOG_TRIVIAL(error) <<__FUNCTION__<<  ":Can not load config from file "<<file<<"\n";
                 return CLI_CONFIG_FILE_ERROR;
@@ -4105,7 +4326,7 @@ int CLI::run(int argc, char **argv)
 
     // loop through action options
     bool export_to_3mf = false, load_slicedata = false, export_slicedata = false, export_slicedata_error = false;
-    bool no_check = false;
+    bool no_check = false, export_slicedata_binary = false;
     std::string export_3mf_file, load_slice_data_dir, export_slice_data_dir;
     std::vector<ThumbnailData*> calibration_thumbnails;
     int max_slicing_time_per_plate = 0, max_triangle_count_per_plate = 0;
@@ -4188,6 +4409,8 @@ int CLI::run(int argc, char **argv)
             export_3mf_file = m_config.opt_string(opt_key);
         }else if(opt_key=="no_check"){
             no_check = m_config.opt_bool(opt_key);
+        } else if (opt_key == "export_slicedata_binary") {
+            export_slicedata_binary = m_config.opt_bool(opt_key);
         //} else if (opt_key == "export_gcode" || opt_key == "export_sla" || opt_key == "slice") {
         } else if (opt_key == "normative_check") {
             //already processed before
@@ -4236,6 +4459,32 @@ int CLI::run(int argc, char **argv)
                 std::string outfile;
                 //Print       fff_print;
                 std::vector<size_t> plate_triangle_counts(partplate_list.get_plate_count(), 0);
+                std::shared_ptr<PrintObjectStepCache> step_cache;
+                if (std::string step_cache_dir = m_config.opt_string("step_cache_dir", true); !step_cache_dir.empty()) {
+                    BOOST_LOG_TRIVIAL(info) << "use step cache directory " << step_cache_dir;
+                    step_cache = std::make_shared<PrintObjectStepCache>(step_cache_dir);
+                    SeamVisibilityCache::set_directory((boost::filesystem::path(step_cache_dir) / "seam_visibility").string());
+                }
+                // Plates sliced concurrently by ParallelPlateJob workers, only when slicing all plates of a FFF project
+                // without reporting the progress of the individual plates over the pipe.
+                size_t parallel_plates = (size_t)std::max(1, m_config.option<ConfigOptionInt>("parallel_plates", true)->value);
+                if (parallel_plates > 1 && (plate_to_slice != 0 || partplate_list.get_plate_count() < 2 || printer_technology != ptFFF || load_slicedata)) {
+                    BOOST_LOG_TRIVIAL(info) << "parallel_plates ignored, plates will be sliced one by one.";
+                    parallel_plates = 1;
+                }
+#if defined(__linux__) || defined(__LINUX__)
+                if (parallel_plates > 1 && g_cli_callback_mgr.is_started()) {
+                    BOOST_LOG_TRIVIAL(info) << "parallel_plates ignored when reporting the progress to a pipe.";
+                    parallel_plates = 1;
+                }
+#endif
+                auto plate_gcode_path = [&outfile_dir](int index, Slic3r::GUI::PartPlate *part_plate) {
+                    if (outfile_dir.empty())
+                        return part_plate->get_tmp_gcode_path();
+                    std::string path = outfile_dir + "/plate_" + std::to_string(index + 1) + ".gcode";
+                    part_plate->set_tmp_gcode_path(path);
+                    return path;
+                };
 
                 while(!finished)
                 {
@@ -4245,6 +4494,7 @@ int CLI::run(int argc, char **argv)
 
                     Slic3r::GUI::GCodeResult *gcode_result = NULL;
                     int print_index;
+                    std::vector<std::unique_ptr<ParallelPlateJob>> parallel_jobs;
                     for (int index = 0; index < partplate_list.get_plate_count(); index ++)
                     {
                         if ((plate_to_slice != 0) && (plate_to_slice != (index + 1))) {
@@ -4263,6 +4513,7 @@ int CLI::run(int argc, char **argv)
                         part_plate->get_print(&print, &gcode_result, &print_index);
 
                         print_fff = dynamic_cast<Print *>(print);
+                        print_fff->set_step_cache(step_cache);
                         /*if (outfile_config.empty())
                         {
                             outfile = "plate_" + std::to_string(index + 1) + ".gcode";
@@ -4466,6 +4717,27 @@ int CLI::run(int argc, char **argv)
                                 const PrintConfig& print_config = print_fff->config();
                                 Model::setExtruderParams(m_print_config, filament_count);
                                 Model::setPrintSpeedTable(m_print_config, print_config);
+                                if (parallel_plates > 1) {
+                                    // Processed and exported by run_parallel_plate_jobs() once all the plates were applied.
+                                    auto job = std::make_unique<ParallelPlateJob>();
+                                    job->index             = index;
+                                    job->print             = print_fff;
+                                    job->gcode_result      = gcode_result;
+                                    job->outfile           = plate_gcode_path(index, part_plate);
+                                    job->sliced_plate_info = sliced_plate_info;
+                                    job->prepare_time      = (long long)Slic3r::Utils::get_current_time_utc() - start_time;
+                                    ParallelPlateJob *job_ptr = job.get();
+                                    print->set_status_callback([job_ptr](const PrintBase::SlicingStatus &slicing_status) {
+                                        if (slicing_status.warning_step != -1) {
+                                            std::lock_guard<std::mutex> lock(job_ptr->warnings_mutex);
+                                            job_ptr->warnings.push_back(slicing_status);
+                                        }
+                                        BOOST_LOG_TRIVIAL(debug) << "plate " << job_ptr->index + 1 << boost::format(": percent=%1%, warning_step=%2%, message=%3%")
+                                            % slicing_status.percent % slicing_status.warning_step % slicing_status.text;
+                                    });
+                                    parallel_jobs.emplace_back(std::move(job));
+                                    continue;
+                                }
                                 if (load_slicedata) {
                                     std::string plate_dir = load_slice_data_dir+"/"+std::to_string(index+1);
                                     int ret = print->load_cached_data(plate_dir);
@@ -4531,14 +4803,7 @@ int CLI::run(int argc, char **argv)
                                     sliced_plate_info.triangle_count = plate_triangle_counts[index];
 
                                     // The outfile is processed by a PlaceholderParser.
-                                    //outfile = part_plate->get_tmp_gcode_path();
-                                    if (outfile_dir.empty()) {
-                                        outfile = part_plate->get_tmp_gcode_path();
-                                    }
-                                    else {
-                                        outfile = outfile_dir + "/plate_" + std::to_string(index + 1) + ".gcode";
-                                        part_plate->set_tmp_gcode_path(outfile);
-                                    }
+                                    outfile = plate_gcode_path(index, part_plate);
                                     BOOST_LOG_TRIVIAL(info) << "process finished, will export gcode temporily to " << outfile << std::endl;
                                     temp_time = (long long)Slic3r::Utils::get_current_time_utc();
                                     outfile = print_fff->export_gcode(outfile, gcode_result, nullptr);
@@ -4575,7 +4840,7 @@ int CLI::run(int argc, char **argv)
                                     BOOST_LOG_TRIVIAL(info) << "plate "<< index+1<< ":will export Slicing data to " << export_slice_data_dir;
                                     std::string plate_dir = export_slice_data_dir+"/"+std::to_string(index+1);
                                     bool with_space = (get_logging_level() >= 4)?true:false;
-                                    int ret = print->export_cached_data(plate_dir, with_space);
+                                    int ret = print->export_cached_data(plate_dir, with_space, export_slicedata_binary);
                                     if (ret) {
                                         BOOST_LOG_TRIVIAL(error) << "plate "<< index+1<< ": export Slicing data error, ret=" << ret;
                                         export_slicedata_error = true;
@@ -4609,6 +4874,66 @@ int CLI::run(int argc, char **argv)
                             }
                         }
                     }
+                    if (! parallel_jobs.empty()) {
+                        run_parallel_plate_jobs(parallel_jobs, parallel_plates, (size_t)m_config.option<ConfigOptionInt>("parallel_plates_memory", true)->value * 1024 * 1024);
+                        // Report the results in the order of plates, stopping at the first failing plate as the sequential slicing does.
+                        for (std::unique_ptr<ParallelPlateJob> &job : parallel_jobs) {
+                            int                  index             = job->index;
+                            sliced_plate_info_t &sliced_plate_info = job->sliced_plate_info;
+                            if (! job->error.empty()) {
+                                BOOST_LOG_TRIVIAL(error) << "found slicing or export error for partplate "<<index+1 << std::endl;
+                                boost::nowide::cerr << job->error << std::endl;
+                                record_exit_reson(outfile_dir, CLI_SLICING_ERROR, index+1, cli_errors[CLI_SLICING_ERROR], sliced_info);
+                                flush_and_exit(CLI_SLICING_ERROR);
+                            }
+                            if (! job->print->get_conflict_string().empty()) {
+                                BOOST_LOG_TRIVIAL(error) << "plate "<< index+1<< ": found slicing result conflict!"<< std::endl;
+                                record_exit_reson(outfile_dir, CLI_GCODE_PATH_CONFLICTS, index+1, cli_errors[CLI_GCODE_PATH_CONFLICTS], sliced_info);
+                                flush_and_exit(CLI_GCODE_PATH_CONFLICTS);
+                            }
+                            for (const PrintBase::SlicingStatus &status : job->warnings) {
+                                if (status.message_type == PrintStateBase::SlicingDefaultNotification)
+                                    continue;
+                                sliced_plate_info.warning_message = status.text;
+                                BOOST_LOG_TRIVIAL(warning) << boost::format("plate %1%: found slicing warnings: %2%, no_check=%3%")%(index+1) %status.text %no_check;
+                                if (status.warning_level != PrintStateBase::WarningLevel::NON_CRITICAL && !no_check &&
+                                    (status.message_type == PrintStateBase::SlicingEmptyGcodeLayers || status.message_type == PrintStateBase::SlicingGcodeOverlap)) {
+                                    sliced_info.sliced_plates.push_back(sliced_plate_info);
+                                    record_exit_reson(outfile_dir, CLI_SLICING_ERROR, index+1, cli_errors[CLI_SLICING_ERROR], sliced_info);
+                                    flush_and_exit(CLI_SLICING_ERROR);
+                                }
+                            }
+                            sliced_plate_info.triangle_count = plate_triangle_counts[index];
+                            BOOST_LOG_TRIVIAL(info) << "Slicing result of plate " << index+1 << " exported to " << job->outfile << std::endl;
+                            partplate_list.get_plate(index)->update_slice_result_valid_state(true);
+                            if (export_slicedata) {
+                                BOOST_LOG_TRIVIAL(info) << "plate "<< index+1<< ":will export Slicing data to " << export_slice_data_dir;
+                                std::string plate_dir = export_slice_data_dir+"/"+std::to_string(index+1);
+                                bool with_space = (get_logging_level() >= 4)?true:false;
+                                int ret = job->print->export_cached_data(plate_dir, with_space, export_slicedata_binary);
+                                if (ret) {
+                                    BOOST_LOG_TRIVIAL(error) << "plate "<< index+1<< ": export Slicing data error, ret=" << ret;
+                                    export_slicedata_error = true;
+                                    if (fs::exists(plate_dir))
+                                        fs::remove_all(plate_dir);
+                                    record_exit_reson(outfile_dir, ret, index+1, cli_errors[ret], sliced_info);
+                                    flush_and_exit(ret);
+                                }
+                            }
+                            // The time spent on this plate only, excluding the time waiting for the other plates.
+                            long long time_cost = job->prepare_time + job->process_time;
+                            sliced_plate_info.sliced_time = time_cost;
+                            sliced_plate_info.sliced_time_with_cache = job->time_using_cache;
+                            if (max_slicing_time_per_plate != 0 && time_cost > max_slicing_time_per_plate) {
+                                sliced_plate_info.warning_message = (boost::format("plate %1%'s slice time %2% exceeds the limit %3%, return error.")%(index+1) %time_cost %max_slicing_time_per_plate).str();
+                                BOOST_LOG_TRIVIAL(error) << sliced_plate_info.warning_message;
+                                sliced_info.sliced_plates.push_back(sliced_plate_info);
+                                record_exit_reson(outfile_dir, CLI_SLICING_TIME_EXCEEDS_LIMIT, index+1, cli_errors[CLI_SLICING_TIME_EXCEEDS_LIMIT], sliced_info);
+                                flush_and_exit(CLI_SLICING_TIME_EXCEEDS_LIMIT);
+                            }
+                            sliced_info.sliced_plates.push_back(sliced_plate_info);
+                        }
+                    }
                     if (pre_check&& (partplate_list.get_plate_count() > 1))
                         pre_check = false;
                     else
@@ -5459,6 +5784,7 @@ bool CLI::export_project(Model *model, std::string& path, PlateDataPtrs &partpla
     store_params.id_bboxes = plate_bboxes;
     store_params.strategy = SaveStrategy::Silence|SaveStrategy::WithGcode|SaveStrategy::SplitModel|SaveStrategy::UseLoadedId|SaveStrategy::ShareMesh;
     store_params.export_plate_idx = plate_to_export;
+    store_params.compression_level = m_config.option<ConfigOptionInt>("compression_level", true)->value;
     if (minimum_save)
         store_params.strategy = store_params.strategy | SaveStrategy::SkipModel;
 
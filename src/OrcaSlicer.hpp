@@ -70,6 +70,9 @@ private:
 
     bool setup(int argc, char **argv);
 
+    /// Runs the jobs of the --batch mode, each one by a fresh CLI instance.
+    int run_batch(const std::string &jobs_file, char *program);
+
     /// Prints usage of the CLI.
     void print_help(bool include_print_options = false, PrinterTechnology printer_technology = ptAny) const;
 
@@ -26,6 +26,8 @@
 #include <math.h>
 
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <vector>
 
 #include <boost/predef/other/endian.h>
@@ -34,6 +36,11 @@
 #define BOOST_POOL_NO_MT
 #include <boost/pool/object_pool.hpp>
 
+#include <tbb/combinable.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include "stl.h"
 
 struct HashEdge {
@@ -43,6 +50,15 @@ struct HashEdge {
 	bool operator==(const HashEdge &rhs) const { return memcmp(key, rhs.key, sizeof(key)) == 0; }
 	bool operator!=(const HashEdge &rhs) const { return ! (*this == rhs); }
 	int  hash(int M) const { return ((key[0] / 11 + key[1] / 7 + key[2] / 3) ^ (key[3] / 11  + key[4] / 7 + key[5] / 3)) % M; }
+	// Well mixed hash of the whole key for sorting the edges, see match_edges_sorted().
+	uint64_t hash64() const {
+		uint64_t h = 0;
+		for (uint32_t k : key) {
+			h = (h ^ k) * 0x9E3779B97F4A7C15ull;
+			h ^= h >> 29;
+		}
+		return h;
+	}
 
 	// Index of a facet owning this edge.
 	int        facet_number;
@@ -53,11 +69,15 @@ struct HashEdge {
 
 	void load_exact(stl_file *stl, const stl_vertex *a, const stl_vertex *b)
 	{
-		{
-	    	stl_vertex diff = (*a - *b).cwiseAbs();
-	    	float max_diff = std::max(diff(0), std::max(diff(1), diff(2)));
-	    	stl->stats.shortest_edge = std::min(max_diff, stl->stats.shortest_edge);
-	  	}
+		stl->stats.shortest_edge = std::min(this->load_exact_key(a, b), stl->stats.shortest_edge);
+	}
+
+	// Same as load_exact() without updating the statistics, thus it may be called in parallel.
+	// Returns the length of the edge measured as the maximum difference of the vertex coordinates.
+	float load_exact_key(const stl_vertex *a, const stl_vertex *b)
+	{
+    	stl_vertex diff = (*a - *b).cwiseAbs();
+    	float max_diff = std::max(diff(0), std::max(diff(1), diff(2)));
 
 	  	// Ensure identical vertex ordering of equal edges.
 	  	// This method is numerically robust.
@@ -82,6 +102,7 @@ struct HashEdge {
 	      		p[0] = 0;
 	#endif /* BOOST_ENDIAN_LITTLE_BYTE */
 	  	}
+	  	return max_diff;
 	}
 
 	bool load_nearby(const stl_file *stl, const stl_vertex &a, const stl_vertex &b, float tolerance)
@@ -120,6 +141,198 @@ private:
 	}
 };
 
+// Connect edge_a with edge_b. Only touches the neighbor slots of the two edges, thus edge pairs may be connected in parallel.
+static void link_neighbors(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
+{
+	// Facet a's neighbor is facet b
+	stl->neighbors_start[edge_a.facet_number].neighbor[edge_a.which_edge % 3] = edge_b.facet_number;	/* sets the .neighbor part */
+	stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] = (edge_b.which_edge + 2) % 3; /* sets the .which_vertex_not part */
+
+	// Facet b's neighbor is facet a
+	stl->neighbors_start[edge_b.facet_number].neighbor[edge_b.which_edge % 3] = edge_a.facet_number;	/* sets the .neighbor part */
+	stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] = (edge_a.which_edge + 2) % 3; /* sets the .which_vertex_not part */
+
+	if ((edge_a.which_edge < 3 && edge_b.which_edge < 3) || (edge_a.which_edge > 2 && edge_b.which_edge > 2)) {
+		// These facets are oriented in opposite directions, their normals are probably messed up.
+		stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] += 3;
+		stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] += 3;
+	}
+}
+
+// Connect edge_a with edge_b, update edge connection statistics.
+static void record_neighbors(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
+{
+	link_neighbors(stl, edge_a, edge_b);
+
+	// Count successful connects:
+	// Total connects:
+	stl->stats.connected_edges += 2;
+	// Count individual connects:
+	switch (stl->neighbors_start[edge_a.facet_number].num_neighbors()) {
+	case 1:	++ stl->stats.connected_facets_1_edge; break;
+	case 2: ++ stl->stats.connected_facets_2_edge; break;
+	case 3: ++ stl->stats.connected_facets_3_edge; break;
+	default: assert(false);
+	}
+	switch (stl->neighbors_start[edge_b.facet_number].num_neighbors()) {
+	case 1:	++ stl->stats.connected_facets_1_edge; break;
+	case 2: ++ stl->stats.connected_facets_2_edge; break;
+	case 3: ++ stl->stats.connected_facets_3_edge; break;
+	default: assert(false);
+	}
+}
+
+static void match_neighbors_nearby(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
+{
+	record_neighbors(stl, edge_a, edge_b);
+
+	// Which vertices to change
+	int facet1 = -1;
+	int facet2 = -1;
+	int vertex1, vertex2;
+	stl_vertex new_vertex1, new_vertex2;
+	{
+		int v1a; // pair 1, facet a
+		int v1b; // pair 1, facet b
+		int v2a; // pair 2, facet a
+		int v2b; // pair 2, facet b
+		// Find first pair.
+		if (edge_a.which_edge < 3) {
+			v1a = edge_a.which_edge;
+			v2a = (edge_a.which_edge + 1) % 3;
+		} else {
+			v2a = edge_a.which_edge % 3;
+			v1a = (edge_a.which_edge + 1) % 3;
+		}
+		if (edge_b.which_edge < 3) {
+			v1b = edge_b.which_edge;
+			v2b = (edge_b.which_edge + 1) % 3;
+		} else {
+			v2b = edge_b.which_edge % 3;
+			v1b = (edge_b.which_edge + 1) % 3;
+		}
+
+		// Of the first pair, which vertex, if any, should be changed
+		if (stl->facet_start[edge_a.facet_number].vertex[v1a] != stl->facet_start[edge_b.facet_number].vertex[v1b]) {
+			// These facets are different.
+			if (   (stl->neighbors_start[edge_a.facet_number].neighbor[v1a] == -1)
+		        && (stl->neighbors_start[edge_a.facet_number].neighbor[(v1a + 2) % 3] == -1)) {
+		  		// This vertex has no neighbors.  This is a good one to change.
+		  		facet1 = edge_a.facet_number;
+		  		vertex1 = v1a;
+		  		new_vertex1 = stl->facet_start[edge_b.facet_number].vertex[v1b];
+			} else {
+			  	facet1 = edge_b.facet_number;
+		  		vertex1 = v1b;
+		  		new_vertex1 = stl->facet_start[edge_a.facet_number].vertex[v1a];
+			}
+		}
+
+		// Of the second pair, which vertex, if any, should be changed.
+		if (stl->facet_start[edge_a.facet_number].vertex[v2a] != stl->facet_start[edge_b.facet_number].vertex[v2b]) {
+			// These facets are different.
+			if (  (stl->neighbors_start[edge_a.facet_number].neighbor[v2a] == -1)
+		       && (stl->neighbors_start[edge_a.facet_number].neighbor[(v2a + 2) % 3] == -1)) {
+		  		// This vertex has no neighbors.  This is a good one to change.
+		  		facet2 = edge_a.facet_number;
+		  		vertex2 = v2a;
+		  		new_vertex2 = stl->facet_start[edge_b.facet_number].vertex[v2b];
+			} else {
+		  		facet2 = edge_b.facet_number;
+		  		vertex2 = v2b;
+		  		new_vertex2 = stl->facet_start[edge_a.facet_number].vertex[v2a];
+			}
+		}
+	}
+
+	auto change_vertices = [stl](int facet_num, int vnot, stl_vertex new_vertex)
+	{
+		int first_facet = facet_num;
+		bool direction = false;
+
+		for (;;) {
+			int pivot_vertex;
+			int next_edge;
+			if (vnot > 2) {
+				if (direction) {
+					pivot_vertex = (vnot + 1) % 3;
+					next_edge = vnot % 3;
+				}
+				else {
+					pivot_vertex = (vnot + 2) % 3;
+					next_edge = pivot_vertex;
+				}
+				direction = !direction;
+			}
+			else {
+				if (direction) {
+					pivot_vertex = (vnot + 2) % 3;
+					next_edge = pivot_vertex;
+				}
+				else {
+					pivot_vertex = (vnot + 1) % 3;
+					next_edge = vnot;
+				}
+			}
+#if 0
+			if (stl->facet_start[facet_num].vertex[pivot_vertex](0) == new_vertex(0) &&
+				stl->facet_start[facet_num].vertex[pivot_vertex](1) == new_vertex(1) &&
+				stl->facet_start[facet_num].vertex[pivot_vertex](2) == new_vertex(2))
+				printf("Changing vertex %f,%f,%f: Same !!!\r\n", new_vertex(0), new_vertex(1), new_vertex(2));
+			else {
+				if (stl->facet_start[facet_num].vertex[pivot_vertex](0) != new_vertex(0))
+					printf("Changing coordinate x, vertex %e (0x%08x) to %e(0x%08x)\r\n",
+						stl->facet_start[facet_num].vertex[pivot_vertex](0),
+						*reinterpret_cast<const int*>(&stl->facet_start[facet_num].vertex[pivot_vertex](0)),
+						new_vertex(0),
+						*reinterpret_cast<const int*>(&new_vertex(0)));
+				if (stl->facet_start[facet_num].vertex[pivot_vertex](1) != new_vertex(1))
+					printf("Changing coordinate x, vertex %e (0x%08x) to %e(0x%08x)\r\n",
+						stl->facet_start[facet_num].vertex[pivot_vertex](1),
+						*reinterpret_cast<const int*>(&stl->facet_start[facet_num].vertex[pivot_vertex](1)),
+						new_vertex(1),
+						*reinterpret_cast<const int*>(&new_vertex(1)));
+				if (stl->facet_start[facet_num].vertex[pivot_vertex](2) != new_vertex(2))
+					printf("Changing coordinate x, vertex %e (0x%08x) to %e(0x%08x)\r\n",
+						stl->facet_start[facet_num].vertex[pivot_vertex](2),
+						*reinterpret_cast<const int*>(&stl->facet_start[facet_num].vertex[pivot_vertex](2)),
+						new_vertex(2),
+						*reinterpret_cast<const int*>(&new_vertex(2)));
+			}
+#endif
+			stl->facet_start[facet_num].vertex[pivot_vertex] = new_vertex;
+			vnot = stl->neighbors_start[facet_num].which_vertex_not[next_edge];
+			facet_num = stl->neighbors_start[facet_num].neighbor[next_edge];
+			if (facet_num == -1)
+				break;
+
+			if (facet_num == first_facet) {
+				// back to the beginning
+				BOOST_LOG_TRIVIAL(info) << "Back to the first facet changing vertices: probably a mobius part. Try using a smaller tolerance or don't do a nearby check.";
+				return;
+			}
+		}
+	};
+
+	if (facet1 != -1) {
+		int vnot1 = (facet1 == edge_a.facet_number) ? 
+	  		(edge_a.which_edge + 2) % 3 :
+			(edge_b.which_edge + 2) % 3;
+		if (((vnot1 + 2) % 3) == vertex1)
+	  		vnot1 += 3;
+		change_vertices(facet1, vnot1, new_vertex1);
+	}
+	if (facet2 != -1) {
+		int vnot2 = (facet2 == edge_a.facet_number) ?
+	  		(edge_a.which_edge + 2) % 3 :
+			(edge_b.which_edge + 2) % 3;
+		if (((vnot2 + 2) % 3) == vertex2)
+	  		vnot2 += 3;
+		change_vertices(facet2, vnot2, new_vertex2);
+	}
+	stl->stats.edges_fixed += 2;
+}
+
 struct HashTableEdges {
 	HashTableEdges(size_t number_of_faces) {
 		this->M = (int)hash_size_from_nr_faces(number_of_faces);
@@ -239,192 +452,121 @@ private:
 	    return edge_a.facet_number != edge_b.facet_number && edge_a == edge_b;
 	}
 
-	// Connect edge_a with edge_b, update edge connection statistics.
-	static void record_neighbors(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
-	{
-		// Facet a's neighbor is facet b
-		stl->neighbors_start[edge_a.facet_number].neighbor[edge_a.which_edge % 3] = edge_b.facet_number;	/* sets the .neighbor part */
-		stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] = (edge_b.which_edge + 2) % 3; /* sets the .which_vertex_not part */
-
-		// Facet b's neighbor is facet a
-		stl->neighbors_start[edge_b.facet_number].neighbor[edge_b.which_edge % 3] = edge_a.facet_number;	/* sets the .neighbor part */
-		stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] = (edge_a.which_edge + 2) % 3; /* sets the .which_vertex_not part */
-
-		if ((edge_a.which_edge < 3 && edge_b.which_edge < 3) || (edge_a.which_edge > 2 && edge_b.which_edge > 2)) {
-			// These facets are oriented in opposite directions, their normals are probably messed up.
-			stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] += 3;
-			stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] += 3;
-		}
+};
 
-		// Count successful connects:
-		// Total connects:
-		stl->stats.connected_edges += 2;
-		// Count individual connects:
-		switch (stl->neighbors_start[edge_a.facet_number].num_neighbors()) {
-		case 1:	++ stl->stats.connected_facets_1_edge; break;
-		case 2: ++ stl->stats.connected_facets_2_edge; break;
-		case 3: ++ stl->stats.connected_facets_3_edge; break;
-		default: assert(false);
-		}
-		switch (stl->neighbors_start[edge_b.facet_number].num_neighbors()) {
-		case 1:	++ stl->stats.connected_facets_1_edge; break;
-		case 2: ++ stl->stats.connected_facets_2_edge; break;
-		case 3: ++ stl->stats.connected_facets_3_edge; break;
-		default: assert(false);
-		}
-	}
+// A pair of matching edges, edge_a inserted after edge_b. Only facet_number and which_edge of the edges are filled in.
+struct EdgeMatch {
+	HashEdge edge_a;
+	HashEdge edge_b;
+};
 
-	static void match_neighbors_nearby(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
-	{
-		record_neighbors(stl, edge_a, edge_b);
-
-		// Which vertices to change
-		int facet1 = -1;
-		int facet2 = -1;
-		int vertex1, vertex2;
-		stl_vertex new_vertex1, new_vertex2;
-		{
-			int v1a; // pair 1, facet a
-			int v1b; // pair 1, facet b
-			int v2a; // pair 2, facet a
-			int v2b; // pair 2, facet b
-			// Find first pair.
-			if (edge_a.which_edge < 3) {
-				v1a = edge_a.which_edge;
-				v2a = (edge_a.which_edge + 1) % 3;
-			} else {
-				v2a = edge_a.which_edge % 3;
-				v1a = (edge_a.which_edge + 1) % 3;
-			}
-			if (edge_b.which_edge < 3) {
-				v1b = edge_b.which_edge;
-				v2b = (edge_b.which_edge + 1) % 3;
-			} else {
-				v2b = edge_b.which_edge % 3;
-				v1b = (edge_b.which_edge + 1) % 3;
-			}
+struct EdgeRecord {
+	uint32_t hash;
+	// 3 * facet_number + which_edge % 3, thus the insertion order of HashTableEdges.
+	uint32_t edge_idx;
+};
 
-			// Of the first pair, which vertex, if any, should be changed
-			if (stl->facet_start[edge_a.facet_number].vertex[v1a] != stl->facet_start[edge_b.facet_number].vertex[v1b]) {
-				// These facets are different.
-				if (   (stl->neighbors_start[edge_a.facet_number].neighbor[v1a] == -1)
-			        && (stl->neighbors_start[edge_a.facet_number].neighbor[(v1a + 2) % 3] == -1)) {
-			  		// This vertex has no neighbors.  This is a good one to change.
-			  		facet1 = edge_a.facet_number;
-			  		vertex1 = v1a;
-			  		new_vertex1 = stl->facet_start[edge_b.facet_number].vertex[v1b];
-				} else {
-				  	facet1 = edge_b.facet_number;
-			  		vertex1 = v1b;
-			  		new_vertex1 = stl->facet_start[edge_a.facet_number].vertex[v1a];
-				}
+// Stable parallel LSD radix sort of the edge records by their hashes, 4 passes of 8 bits.
+static void radix_sort_edge_records(std::vector<EdgeRecord> &records)
+{
+	static constexpr const size_t num_buckets = 256;
+	const size_t num_blocks = std::max<size_t>(1, std::min<size_t>(records.size() / 65536, 4 * size_t(tbb::this_task_arena::max_concurrency())));
+	auto block_begin = [&records, num_blocks](size_t block_idx) { return records.size() * block_idx / num_blocks; };
+	std::vector<EdgeRecord> tmp(records.size());
+	// Per block offsets of the buckets into the output.
+	std::vector<std::array<size_t, num_buckets>> offsets(num_blocks);
+	for (int shift = 0; shift < 32; shift += 8) {
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&records, &offsets, &block_begin, shift](const tbb::blocked_range<size_t> &range) {
+			for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+				std::array<size_t, num_buckets> &counts = offsets[block_idx];
+				counts.fill(0);
+				for (size_t i = block_begin(block_idx); i < block_begin(block_idx + 1); ++ i)
+					++ counts[(records[i].hash >> shift) & 0x0ff];
 			}
-
-			// Of the second pair, which vertex, if any, should be changed.
-			if (stl->facet_start[edge_a.facet_number].vertex[v2a] != stl->facet_start[edge_b.facet_number].vertex[v2b]) {
-				// These facets are different.
-				if (  (stl->neighbors_start[edge_a.facet_number].neighbor[v2a] == -1)
-			       && (stl->neighbors_start[edge_a.facet_number].neighbor[(v2a + 2) % 3] == -1)) {
-			  		// This vertex has no neighbors.  This is a good one to change.
-			  		facet2 = edge_a.facet_number;
-			  		vertex2 = v2a;
-			  		new_vertex2 = stl->facet_start[edge_b.facet_number].vertex[v2b];
-				} else {
-			  		facet2 = edge_b.facet_number;
-			  		vertex2 = v2b;
-			  		new_vertex2 = stl->facet_start[edge_a.facet_number].vertex[v2a];
-				}
+		});
+		size_t offset = 0;
+		for (size_t bucket = 0; bucket < num_buckets; ++ bucket)
+			for (std::array<size_t, num_buckets> &counts : offsets) {
+				size_t cnt = counts[bucket];
+				counts[bucket] = offset;
+				offset += cnt;
 			}
-		}
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&records, &tmp, &offsets, &block_begin, shift](const tbb::blocked_range<size_t> &range) {
+			for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+				std::array<size_t, num_buckets> &block_offsets = offsets[block_idx];
+				for (size_t i = block_begin(block_idx); i < block_begin(block_idx + 1); ++ i)
+					tmp[block_offsets[(records[i].hash >> shift) & 0x0ff] ++] = records[i];
+			}
+		});
+		records.swap(tmp);
+	}
+}
 
-		auto change_vertices = [stl](int facet_num, int vnot, stl_vertex new_vertex)
-		{
-			int first_facet = facet_num;
-			bool direction = false;
+// Sort-merge alternative to HashTableEdges, which processes the edges in parallel.
+// load_edge(edge) fills in the key of an edge with facet_number and which_edge set, it returns false if the edge shall be skipped.
+// The edges are radix sorted by a 32bit hash of their keys, the runs of equal hashes are then resolved by comparing the full keys.
+// Edges with equal keys are paired in the order of insertion (facet by facet, edge by edge), exactly as HashTableEdges pairs them.
+// The matches are returned in an arbitrary order.
+template<typename LoadEdge>
+static std::vector<EdgeMatch> match_edges_sorted(uint32_t num_facets, LoadEdge load_edge)
+{
+	static constexpr const uint32_t invalid = std::numeric_limits<uint32_t>::max();
+	auto edge_from_idx = [](uint32_t edge_idx) {
+		HashEdge edge;
+		edge.facet_number = int(edge_idx / 3);
+		edge.which_edge   = int(edge_idx % 3);
+		return edge;
+	};
 
-			for (;;) {
-				int pivot_vertex;
-				int next_edge;
-				if (vnot > 2) {
-					if (direction) {
-						pivot_vertex = (vnot + 1) % 3;
-						next_edge = vnot % 3;
-					}
-					else {
-						pivot_vertex = (vnot + 2) % 3;
-						next_edge = pivot_vertex;
-					}
-					direction = !direction;
-				}
-				else {
-					if (direction) {
-						pivot_vertex = (vnot + 2) % 3;
-						next_edge = pivot_vertex;
-					}
-					else {
-						pivot_vertex = (vnot + 1) % 3;
-						next_edge = vnot;
-					}
-				}
-	#if 0
-				if (stl->facet_start[facet_num].vertex[pivot_vertex](0) == new_vertex(0) &&
-					stl->facet_start[facet_num].vertex[pivot_vertex](1) == new_vertex(1) &&
-					stl->facet_start[facet_num].vertex[pivot_vertex](2) == new_vertex(2))
-					printf("Changing vertex %f,%f,%f: Same !!!\r\n", new_vertex(0), new_vertex(1), new_vertex(2));
+	std::vector<EdgeRecord> records(size_t(num_facets) * 3);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, records.size()), [&records, &load_edge, &edge_from_idx](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i) {
+			HashEdge edge = edge_from_idx(uint32_t(i));
+			records[i] = load_edge(edge) ? EdgeRecord{ uint32_t(edge.hash64() >> 32), uint32_t(i) } : EdgeRecord{ 0, invalid };
+		}
+	});
+	records.erase(std::remove_if(records.begin(), records.end(), [](const EdgeRecord &r){ return r.edge_idx == invalid; }), records.end());
+	// The records are ordered by edge_idx, the stable sort keeps them ordered by edge_idx inside the runs of equal hashes.
+	radix_sort_edge_records(records);
+
+	tbb::enumerable_thread_specific<std::vector<EdgeMatch>> matches_per_thread;
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, records.size()), [&records, &load_edge, &edge_from_idx, &matches_per_thread](const tbb::blocked_range<size_t> &range) {
+		std::vector<EdgeMatch> &matches = matches_per_thread.local();
+		std::vector<HashEdge>   unmatched;
+		// Process the runs of equal hashes starting inside this range.
+		size_t begin = range.begin();
+		while (begin > 0 && begin < range.end() && records[begin].hash == records[begin - 1].hash)
+			++ begin;
+		for (size_t end = begin; begin < range.end(); begin = end) {
+			for (++ end; end < records.size() && records[end].hash == records[begin].hash; ++ end) ;
+			if (end - begin < 2)
+				continue;
+			unmatched.clear();
+			for (size_t i = begin; i < end; ++ i) {
+				HashEdge edge = edge_from_idx(records[i].edge_idx);
+				load_edge(edge);
+				auto it = std::find_if(unmatched.begin(), unmatched.end(), [&edge](const HashEdge &other) { return other.facet_number != edge.facet_number && other == edge; });
+				if (it == unmatched.end())
+					unmatched.emplace_back(edge);
 				else {
-					if (stl->facet_start[facet_num].vertex[pivot_vertex](0) != new_vertex(0))
-						printf("Changing coordinate x, vertex %e (0x%08x) to %e(0x%08x)\r\n",
-							stl->facet_start[facet_num].vertex[pivot_vertex](0),
-							*reinterpret_cast<const int*>(&stl->facet_start[facet_num].vertex[pivot_vertex](0)),
-							new_vertex(0),
-							*reinterpret_cast<const int*>(&new_vertex(0)));
-					if (stl->facet_start[facet_num].vertex[pivot_vertex](1) != new_vertex(1))
-						printf("Changing coordinate x, vertex %e (0x%08x) to %e(0x%08x)\r\n",
-							stl->facet_start[facet_num].vertex[pivot_vertex](1),
-							*reinterpret_cast<const int*>(&stl->facet_start[facet_num].vertex[pivot_vertex](1)),
-							new_vertex(1),
-							*reinterpret_cast<const int*>(&new_vertex(1)));
-					if (stl->facet_start[facet_num].vertex[pivot_vertex](2) != new_vertex(2))
-						printf("Changing coordinate x, vertex %e (0x%08x) to %e(0x%08x)\r\n",
-							stl->facet_start[facet_num].vertex[pivot_vertex](2),
-							*reinterpret_cast<const int*>(&stl->facet_start[facet_num].vertex[pivot_vertex](2)),
-							new_vertex(2),
-							*reinterpret_cast<const int*>(&new_vertex(2)));
-				}
-	#endif
-				stl->facet_start[facet_num].vertex[pivot_vertex] = new_vertex;
-				vnot = stl->neighbors_start[facet_num].which_vertex_not[next_edge];
-				facet_num = stl->neighbors_start[facet_num].neighbor[next_edge];
-				if (facet_num == -1)
-					break;
-
-				if (facet_num == first_facet) {
-					// back to the beginning
-					BOOST_LOG_TRIVIAL(info) << "Back to the first facet changing vertices: probably a mobius part. Try using a smaller tolerance or don't do a nearby check.";
-					return;
+					matches.push_back({ edge, *it });
+					unmatched.erase(it);
 				}
 			}
-		};
-
-		if (facet1 != -1) {
-			int vnot1 = (facet1 == edge_a.facet_number) ? 
-		  		(edge_a.which_edge + 2) % 3 :
-				(edge_b.which_edge + 2) % 3;
-			if (((vnot1 + 2) % 3) == vertex1)
-		  		vnot1 += 3;
-			change_vertices(facet1, vnot1, new_vertex1);
-		}
-		if (facet2 != -1) {
-			int vnot2 = (facet2 == edge_a.facet_number) ?
-		  		(edge_a.which_edge + 2) % 3 :
-				(edge_b.which_edge + 2) % 3;
-			if (((vnot2 + 2) % 3) == vertex2)
-		  		vnot2 += 3;
-			change_vertices(facet2, vnot2, new_vertex2);
 		}
-		stl->stats.edges_fixed += 2;
+	});
+
+	std::vector<EdgeMatch> out;
+	size_t num_matches = 0;
+	for (const std::vector<EdgeMatch> &matches : matches_per_thread)
+		num_matches += matches.size();
+	out.reserve(num_matches);
+	for (std::vector<EdgeMatch> &matches : matches_per_thread) {
+		out.insert(out.end(), matches.begin(), matches.end());
+		matches = {};
 	}
-};
+	return out;
+}
 
 // This function builds the neighbors list.  No modifications are made
 // to any of the facets.  The edges are said to match only if all six
@@ -454,22 +596,33 @@ void stl_check_facets_exact(stl_file *stl)
 		  	++ i;
   	}
 
-  	// Initialize hash table.
-  	HashTableEdges hash_table(stl->stats.number_of_facets);
 	for (auto &neighbor : stl->neighbors_start)
 		neighbor.reset();
 
   	// Connect neighbor edges.
-	for (uint32_t i = 0; i < stl->stats.number_of_facets; ++ i) {
-		const stl_facet &facet = stl->facet_start[i];
-		for (int j = 0; j < 3; ++ j) {
-			HashEdge edge;
-			edge.facet_number = i;
-			edge.which_edge = j;
-			edge.load_exact(stl, &facet.vertex[j], &facet.vertex[(j + 1) % 3]);
-			hash_table.insert_edge_exact(stl, edge);
+	tbb::combinable<float> shortest_edge([stl]() { return stl->stats.shortest_edge; });
+	std::vector<EdgeMatch> matches = match_edges_sorted(stl->stats.number_of_facets, [stl, &shortest_edge](HashEdge &edge) {
+		const stl_facet &facet = stl->facet_start[edge.facet_number];
+		float &shortest = shortest_edge.local();
+		shortest = std::min(shortest, edge.load_exact_key(&facet.vertex[edge.which_edge], &facet.vertex[(edge.which_edge + 1) % 3]));
+		return true;
+	});
+	// Each edge is matched at most once, thus the matches touch disjoint neighbor slots.
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, matches.size()), [stl, &matches](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i)
+			link_neighbors(stl, matches[i].edge_a, matches[i].edge_b);
+	});
+	stl->stats.shortest_edge = shortest_edge.combine([](float a, float b) { return std::min(a, b); });
+
+	// Statistics as if the neighbors were recorded one by one by record_neighbors().
+	stl->stats.connected_edges = 2 * int(matches.size());
+	for (const stl_neighbors &neighbors : stl->neighbors_start)
+		switch (neighbors.num_neighbors()) {
+		case 3: ++ stl->stats.connected_facets_3_edge; // fall through
+		case 2: ++ stl->stats.connected_facets_2_edge; // fall through
+		case 1: ++ stl->stats.connected_facets_1_edge; // fall through
+		default: break;
 		}
-	}
 
 #if 0
 	printf("Number of faces: %d, number of manifold edges: %d, number of connected edges: %d, number of unconnected edges: %d\r\n", 
@@ -488,21 +641,22 @@ void stl_check_facets_nearby(stl_file *stl, float tolerance)
     	// No need to check any further.  All facets are connected.
     	return;
 
-  	HashTableEdges hash_table(stl->stats.number_of_facets);
-  	for (uint32_t i = 0; i < stl->stats.number_of_facets; ++ i) {
-    	//FIXME is the copy necessary?
-    	stl_facet facet = stl->facet_start[i];
-    	for (int j = 0; j < 3; j++) {
-      		if (stl->neighbors_start[i].neighbor[j] == -1) {
-        		HashEdge edge;
-        		edge.facet_number = i;
-        		edge.which_edge = j;
-        		if (edge.load_nearby(stl, facet.vertex[j], facet.vertex[(j + 1) % 3], tolerance))
-          			// Only insert edges that have different keys.
-          			hash_table.insert_edge_nearby(stl, edge);
-      		}
-    	}
-  	}
+	// The keys of all the unconnected edges are calculated before any of the edges is fixed.
+	// match_neighbors_nearby() may move vertices of facets, which edges were not inserted yet, thus this may
+	// differ in rare cases from inserting the edges one by one into HashTableEdges.
+	std::vector<EdgeMatch> matches = match_edges_sorted(stl->stats.number_of_facets, [stl, tolerance](HashEdge &edge) {
+		const stl_facet &facet = stl->facet_start[edge.facet_number];
+		// Only insert edges that have different keys.
+		return stl->neighbors_start[edge.facet_number].neighbor[edge.which_edge] == -1 &&
+			edge.load_nearby(stl, facet.vertex[edge.which_edge], facet.vertex[(edge.which_edge + 1) % 3], tolerance);
+	});
+	// Fixing the edges modifies the facets around the fixed vertices, thus the matches are applied sequentially
+	// in the order in which HashTableEdges reports them, that is by the insertion order of edge_a.
+	std::sort(matches.begin(), matches.end(), [](const EdgeMatch &lhs, const EdgeMatch &rhs) {
+		return lhs.edge_a.facet_number < rhs.edge_a.facet_number || (lhs.edge_a.facet_number == rhs.edge_a.facet_number && lhs.edge_a.which_edge % 3 < rhs.edge_a.which_edge % 3);
+	});
+	for (const EdgeMatch &match : matches)
+		match_neighbors_nearby(stl, match.edge_a, match.edge_b);
 }
 
 void stl_remove_unconnected_facets(stl_file *stl)
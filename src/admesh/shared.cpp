@@ -23,108 +23,120 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <atomic>
 #include <vector>
 
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include "stl.h"
 
 #include "libslic3r/LocalesUtils.hpp"
 
-void stl_generate_shared_vertices(stl_file *stl, indexed_triangle_set &its)
+// Concurrent union-find of the facet corners (3 * facet_idx + vertex_idx). The root of a set is its lowest corner,
+// as the higher root is always linked below the lower root.
+class CornerSets
 {
-	// 3 indices to vertex per face
-	its.indices.assign(stl->stats.number_of_facets, stl_triangle_vertex_indices(-1, -1, -1));
-	// Shared vertices (3D coordinates)
-	its.vertices.clear();
-	its.vertices.reserve(stl->stats.number_of_facets / 2);
+public:
+	explicit CornerSets(size_t num_corners) : m_parent(num_corners) {
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, num_corners), [this](const tbb::blocked_range<size_t> &range) {
+			for (size_t i = range.begin(); i < range.end(); ++ i)
+				m_parent[i].store(uint32_t(i), std::memory_order_relaxed);
+		});
+	}
 
-	// A degenerate mesh may contain loops: Traversing a fan will end up in an endless loop
-	// while never reaching the starting face. To avoid these endless loops, traversed faces at each fan traversal
-	// are marked with a unique fan_traversal_stamp.
-	unsigned int			  fan_traversal_stamp = 0;
-	std::vector<unsigned int> fan_traversal_facet_visited(stl->stats.number_of_facets, 0);
+	uint32_t find(uint32_t i) {
+		for (;;) {
+			uint32_t parent = m_parent[i].load(std::memory_order_relaxed);
+			if (parent == i)
+				return i;
+			uint32_t grandparent = m_parent[parent].load(std::memory_order_relaxed);
+			// Path halving, losing the race with another thread only makes the path longer.
+			if (grandparent != parent)
+				m_parent[i].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+			i = grandparent;
+		}
+	}
 
-	for (uint32_t facet_idx = 0; facet_idx < stl->stats.number_of_facets; ++ facet_idx) {
-		for (int j = 0; j < 3; ++ j) {
-			if (its.indices[facet_idx][j] != -1)
-				// Shared vertex was already assigned.
-				continue;
-			// Create a new shared vertex.
-			its.vertices.emplace_back(stl->facet_start[facet_idx].vertex[j]);
-			// Traverse the fan around the j-th vertex of the i-th face, assign the newly created shared vertex index to all the neighboring triangles in the triangle fan.
-			int  facet_in_fan_idx 	= facet_idx;
-			bool edge_direction 	= false;
-			bool traversal_reversed = false;
-			int  vnot      			= (j + 2) % 3;
-			// Increase the 
-			++ fan_traversal_stamp;
-			for (;;) {
-				// Next edge on facet_in_fan_idx to be traversed. The edge is indexed by its starting vertex index.
-				int next_edge    = 0;
-				// Vertex index in facet_in_fan_idx, which is being pivoted around, and which is being assigned a new shared vertex.
-				int pivot_vertex = 0;
-				if (vnot > 2) {
-					// The edge of facet_in_fan_idx opposite to vnot is equally oriented, therefore
-					// the neighboring facet is flipped.
-			  		if (! edge_direction) {
-			    		pivot_vertex = (vnot + 2) % 3;
-			    		next_edge    = pivot_vertex;			    		
-			  		} else {
-			    		pivot_vertex = (vnot + 1) % 3;
-			    		next_edge    = vnot % 3;
-			  		}
-			  		edge_direction = ! edge_direction;
-				} else {
-					// The neighboring facet is correctly oriented.
-			  		if (! edge_direction) {
-			    		pivot_vertex = (vnot + 1) % 3;
-			    		next_edge    = vnot;
-			  		} else {
-			    		pivot_vertex = (vnot + 2) % 3;
-			    		next_edge    = pivot_vertex;
-			  		}
-				}
-				its.indices[facet_in_fan_idx][pivot_vertex] = its.vertices.size() - 1;
-				fan_traversal_facet_visited[facet_in_fan_idx] = fan_traversal_stamp;
+	void unite(uint32_t a, uint32_t b) {
+		for (;;) {
+			a = this->find(a);
+			b = this->find(b);
+			if (a == b)
+				return;
+			if (a < b)
+				std::swap(a, b);
+			// Link the higher root below the lower one, retry if the higher root was linked by another thread in the meantime.
+			uint32_t expected = a;
+			if (m_parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+				return;
+		}
+	}
 
-				// next_edge is an index of the starting vertex of the edge, not an index of the opposite vertex to the edge!
-				int next_facet = stl->neighbors_start[facet_in_fan_idx].neighbor[next_edge];
-				if (next_facet == -1) {
-					// No neighbor going in the current direction.
-					if (traversal_reversed) {
-						// Went to one limit, then turned back and reached the other limit. Quit the fan traversal.
-					    break;
-					} else {
-						// Reached the first limit. Now try to reverse and traverse up to the other limit.
-					    edge_direction        = true;
-					    vnot 	         	  = (j + 1) % 3;
-					    traversal_reversed    = true;
-				    	facet_in_fan_idx      = facet_idx;
-					}
-				} else if (next_facet == facet_idx) {
-					// Traversed a closed fan all around.
-//					assert(! traversal_reversed);
-					break;
-				} else if (next_facet >= (int)stl->stats.number_of_facets) {
-					// The mesh is not valid!
-					// assert(false);
-					break;
-				} else if (fan_traversal_facet_visited[next_facet] == fan_traversal_stamp) {
-					// Traversed a closed fan all around, but did not reach the starting face.
-					// This indicates an invalid geometry (non-manifold).
-					//assert(false);
-					break;
-				} else {
-					// Continue traversal.
-					// next_edge is an index of the starting vertex of the edge, not an index of the opposite vertex to the edge!
-					vnot = stl->neighbors_start[facet_in_fan_idx].which_vertex_not[next_edge];
-					facet_in_fan_idx = next_facet;
-				}
+private:
+	std::vector<std::atomic<uint32_t>> m_parent;
+};
+
+// A shared vertex is created for each set of facet corners connected over the neighbor edges, which for a manifold vertex
+// is the fan of facets around the vertex. The corners are grouped in parallel, the shared vertices are numbered by their
+// first corner, thus in the same order as by traversing the fans facet by facet.
+void stl_generate_shared_vertices(stl_file *stl, indexed_triangle_set &its)
+{
+	const uint32_t num_facets  = stl->stats.number_of_facets;
+	const size_t   num_corners = size_t(num_facets) * 3;
+	CornerSets     corners(num_corners);
+
+	tbb::parallel_for(tbb::blocked_range<uint32_t>(0, num_facets), [stl, num_facets, &corners](const tbb::blocked_range<uint32_t> &range) {
+		for (uint32_t facet_idx = range.begin(); facet_idx < range.end(); ++ facet_idx) {
+			const stl_neighbors &neighbors = stl->neighbors_start[facet_idx];
+			for (int edge = 0; edge < 3; ++ edge) {
+				int neighbor = neighbors.neighbor[edge];
+				if (neighbor < 0 || uint32_t(neighbor) >= num_facets || uint32_t(neighbor) == facet_idx)
+					continue;
+				// Edge "edge" starts at vertex "edge" and ends at vertex "edge + 1" of facet_idx.
+				// On the neighbor, the shared edge spans the vertices (vnot + 1) and (vnot + 2). If the neighbor is oriented
+				// equally (vnot > 2), the shared edge runs in the same direction, otherwise it runs in the opposite direction.
+				int      vnot     = neighbors.which_vertex_not[edge];
+				bool     flipped  = vnot > 2;
+				uint32_t start    = 3 * facet_idx + edge;
+				uint32_t end      = 3 * facet_idx + (edge + 1) % 3;
+				uint32_t nstart   = 3 * uint32_t(neighbor) + (vnot + 1) % 3;
+				uint32_t nend     = 3 * uint32_t(neighbor) + (vnot + 2) % 3;
+				corners.unite(start, flipped ? nstart : nend);
+				corners.unite(end,   flipped ? nend : nstart);
 			}
 		}
-	}
+	});
+
+	// Number the shared vertices by their first corners.
+	std::vector<uint32_t> corner_to_vertex(num_corners);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, num_corners), [&corners, &corner_to_vertex](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i)
+			corner_to_vertex[i] = corners.find(uint32_t(i));
+	});
+	std::vector<uint32_t> first_corners;
+	first_corners.reserve(num_facets / 2);
+	for (size_t i = 0; i < num_corners; ++ i)
+		if (corner_to_vertex[i] == i) {
+			corner_to_vertex[i] = uint32_t(first_corners.size());
+			first_corners.emplace_back(uint32_t(i));
+		} else
+			// The root is lower than i, thus it was already numbered.
+			corner_to_vertex[i] = corner_to_vertex[corner_to_vertex[i]];
+
+	its.vertices.assign(first_corners.size(), stl_vertex());
+	its.indices.assign(num_facets, stl_triangle_vertex_indices(-1, -1, -1));
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, first_corners.size()), [stl, &its, &first_corners](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i)
+			its.vertices[i] = stl->facet_start[first_corners[i] / 3].vertex[first_corners[i] % 3];
+	});
+	tbb::parallel_for(tbb::blocked_range<uint32_t>(0, num_facets), [&its, &corner_to_vertex](const tbb::blocked_range<uint32_t> &range) {
+		for (uint32_t facet_idx = range.begin(); facet_idx < range.end(); ++ facet_idx)
+			for (int j = 0; j < 3; ++ j)
+				its.indices[facet_idx][j] = int(corner_to_vertex[3 * size_t(facet_idx) + j]);
+	});
 }
 
 bool its_write_off(const indexed_triangle_set &its, const char *file)
@@ -43,7 +43,6 @@
 extern void stl_internal_reverse_quads(char *buf, size_t cnt);
 #endif /* BOOST_ENDIAN_BIG_BYTE */
 
-const int LOAD_STL_UNIT_NUM           = 5;
 static std::string model_id           = "";
 
 static FILE* stl_open_count_facets(stl_file *stl, const char *file) 
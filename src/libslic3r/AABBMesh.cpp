@@ -2,6 +2,7 @@
 #include <Execution/ExecutionTBB.hpp>
 
 #include <libslic3r/AABBTreeIndirect.hpp>
+#include <libslic3r/AABBTreeCache.hpp>
 #include <libslic3r/TriangleMesh.hpp>
 
 #include <numeric>
@@ -14,11 +15,12 @@ namespace Slic3r {
 
 class AABBMesh::AABBImpl {
 private:
-    AABBTreeIndirect::Tree3f m_tree;
+    // Shared by the copies of AABBMesh and possibly by AABBTreeCache.
+    AABBTreeCache::TreePtr   m_tree;
     double                   m_triangle_ray_epsilon;
 
 public:
-    void init(const indexed_triangle_set &its, bool calculate_epsilon)
+    void init(const indexed_triangle_set &its, bool calculate_epsilon, AABBTreeCache::TreePtr tree = {})
     {
         m_triangle_ray_epsilon = 0.000001;
         if (calculate_epsilon) {
@@ -27,8 +29,9 @@ public:
             if (l > 0)
                 m_triangle_ray_epsilon = 0.000001 * l * l;
         }
-        m_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(
-            its.vertices, its.indices);
+        m_tree = tree ? std::move(tree) :
+            std::make_shared<const AABBTreeIndirect::Tree3f>(
+                AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices));
     }
 
     void intersect_ray(const indexed_triangle_set &its,
@@ -37,7 +40,7 @@ public:
                        igl::Hit &                  hit)
     {
         AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices,
-                                                  m_tree, s, dir, hit, m_triangle_ray_epsilon);
+                                                  *m_tree, s, dir, hit, m_triangle_ray_epsilon);
     }
 
     void intersect_ray(const indexed_triangle_set &its,
@@ -46,7 +49,7 @@ public:
                        std::vector<igl::Hit> &     hits)
     {
         AABBTreeIndirect::intersect_ray_all_hits(its.vertices, its.indices,
-                                                 m_tree, s, dir, hits, m_triangle_ray_epsilon);
+                                                 *m_tree, s, dir, hits, m_triangle_ray_epsilon);
     }
 
     double squared_distance(const indexed_triangle_set & its,
@@ -58,7 +61,7 @@ public:
         Vec3d  closest_vec3d(closest);
         double dist =
             AABBTreeIndirect::squared_distance_to_indexed_triangle_set(
-                its.vertices, its.indices, m_tree, point, idx_unsigned,
+                its.vertices, its.indices, *m_tree, point, idx_unsigned,
                 closest_vec3d);
         i       = int(idx_unsigned);
         closest = closest_vec3d;
@@ -90,10 +93,21 @@ AABBMesh::AABBMesh(const TriangleMesh &mesh, bool calculate_epsilon)
     init(mesh, calculate_epsilon);
 }
 
+AABBMesh::AABBMesh(std::shared_ptr<const TriangleMesh> mesh, bool calculate_epsilon)
+    : m_tm(&mesh->its)
+    , m_mesh(mesh)
+    , m_aabb(new AABBImpl())
+    , m_vfidx{mesh->its}
+    , m_fnidx{its_face_neighbors(mesh->its)}
+{
+    m_aabb->init(*m_tm, calculate_epsilon, AABBTreeCache::get(m_mesh));
+}
+
 AABBMesh::~AABBMesh() {}
 
 AABBMesh::AABBMesh(const AABBMesh &other)
     : m_tm(other.m_tm)
+    , m_mesh(other.m_mesh)
     , m_aabb(new AABBImpl(*other.m_aabb))
     , m_vfidx{other.m_vfidx}
     , m_fnidx{other.m_fnidx}
@@ -102,6 +116,7 @@ AABBMesh::AABBMesh(const AABBMesh &other)
 AABBMesh &AABBMesh::operator=(const AABBMesh &other)
 {
     m_tm = other.m_tm;
+    m_mesh = other.m_mesh;
     m_aabb.reset(new AABBImpl(*other.m_aabb));
     m_vfidx = other.m_vfidx;
     m_fnidx = other.m_fnidx;
@@ -0,0 +1,81 @@
+#include "AABBTreeCache.hpp"
+
+#include <map>
+#include <mutex>
+
+#include "TriangleMesh.hpp"
+
+namespace Slic3r {
+namespace AABBTreeCache {
+
+namespace {
+
+using MeshKey = std::weak_ptr<const TriangleMesh>;
+
+struct Cache
+{
+    std::mutex mutex;
+    // Keyed by the control block of the mesh, which outlives the mesh as long as the weak pointer exists,
+    // thus a newly allocated mesh is never mistaken for a released one.
+    std::map<MeshKey, TreePtr, std::owner_less<MeshKey>> trees;
+
+    // Release trees of meshes, which are gone. Called with the mutex locked.
+    void purge()
+    {
+        for (auto it = trees.begin(); it != trees.end();)
+            it = it->first.expired() ? trees.erase(it) : std::next(it);
+    }
+
+    TreePtr find(const std::shared_ptr<const TriangleMesh> &mesh)
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        this->purge();
+        auto it = trees.find(mesh);
+        return it == trees.end() ? TreePtr() : it->second;
+    }
+
+    // The tree is built outside of the lock, thus two threads may build a tree over the same mesh.
+    // The first one inserted wins, so that all the consumers share the same tree.
+    TreePtr insert(const std::shared_ptr<const TriangleMesh> &mesh, TreePtr tree)
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        this->purge();
+        return trees.emplace(mesh, std::move(tree)).first->second;
+    }
+};
+
+Cache& cache()
+{
+    static Cache instance;
+    return instance;
+}
+
+} // namespace
+
+TreePtr get(const std::shared_ptr<const TriangleMesh> &mesh)
+{
+    assert(mesh);
+    if (TreePtr tree = cache().find(mesh); tree)
+        return tree;
+    return cache().insert(mesh, std::make_shared<const AABBTreeIndirect::Tree3f>(
+        AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(mesh->its.vertices, mesh->its.indices)));
+}
+
+size_t size()
+{
+    std::lock_guard<std::mutex> lk(cache().mutex);
+    size_t cnt = 0;
+    for (const auto &kv : cache().trees)
+        if (! kv.first.expired())
+            ++ cnt;
+    return cnt;
+}
+
+void clear()
+{
+    std::lock_guard<std::mutex> lk(cache().mutex);
+    cache().trees.clear();
+}
+
+} // namespace AABBTreeCache
+} // namespace Slic3r
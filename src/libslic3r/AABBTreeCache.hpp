@@ -0,0 +1,33 @@
+#ifndef slic3r_AABBTreeCache_hpp_
+#define slic3r_AABBTreeCache_hpp_
+
+#include <memory>
+
+#include "AABBTreeIndirect.hpp"
+
+namespace Slic3r {
+
+class TriangleMesh;
+
+// Process wide cache of AABB trees over triangle meshes, so that the raycasters (AABBMesh) of the same mesh
+// share a single tree instead of building their own.
+// A mesh held by std::shared_ptr<const TriangleMesh> is immutable (ModelVolume replaces the pointer
+// whenever its mesh changes, including the centering and scaling after its creation), thus the identity
+// of the shared pointer identifies the content of the mesh.
+// A cached tree is not kept alive by its mesh: it is released by the first lookup or insertion
+// after the mesh is destroyed, while the consumers holding the tree keep using it.
+namespace AABBTreeCache {
+
+using TreePtr = std::shared_ptr<const AABBTreeIndirect::Tree3f>;
+
+// Tree over the mesh, built when it is not cached yet.
+TreePtr get(const std::shared_ptr<const TriangleMesh> &mesh);
+
+// Number of cached trees of meshes, which are still alive.
+size_t size();
+void   clear();
+
+} // namespace AABBTreeCache
+} // namespace Slic3r
+
+#endif // slic3r_AABBTreeCache_hpp_
@@ -7,6 +7,7 @@
 #define slic3r_AABBTreeIndirect_hpp_
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <type_traits>
 #include <vector>
@@ -218,6 +219,123 @@ using Tree3f = Tree<3, float>;
 using Tree2d = Tree<2, double>;
 using Tree3d = Tree<3, double>;
 
+// Wide (Width-ary) AABB tree collapsed from the balanced binary Tree above for faster queries:
+// Bounding boxes of all children of a node are stored as a structure of arrays and tested against a ray
+// or a point together in a loop, which the compiler turns into SIMD instructions. Triangles referenced
+// by leaf children of a node are intersected by a ray together the same way.
+// The queries over a WideTree are overloads of the queries over a Tree giving the same results.
+template<int ANumDimensions, typename ACoordType, size_t AWidth = 4>
+class WideTree
+{
+public:
+    static constexpr int    NumDimensions = ANumDimensions;
+    static constexpr size_t Width         = AWidth;
+    using CoordType   = ACoordType;
+    using BinaryTree  = Tree<NumDimensions, CoordType>;
+    using BoundingBox = typename BinaryTree::BoundingBox;
+    static_assert(Width >= 2 && Width <= 8 * sizeof(unsigned), "Width does not fit the child masks");
+
+    enum : size_t {
+        // Child slot is not used.
+        npos = size_t(-1)
+    };
+
+    struct Node {
+        // Bounding boxes of the children, unused slots are empty (inverted) boxes.
+        std::array<std::array<CoordType, Width>, NumDimensions> min;
+        std::array<std::array<CoordType, Width>, NumDimensions> max;
+        // Index of a child node, or of the external source entity for a leaf child, npos for unused slot.
+        std::array<size_t, Width> child;
+        // Bit masks of used slots and of leaf children.
+        unsigned valid_mask = 0;
+        unsigned leaf_mask  = 0;
+
+        bool is_leaf(size_t i) const { return (this->leaf_mask >> i) & 1; }
+    };
+
+    WideTree() = default;
+    explicit WideTree(const BinaryTree &tree) { this->build(tree); }
+
+    void build(const BinaryTree &tree)
+    {
+        m_nodes.clear();
+        if (! tree.empty()) {
+            m_nodes.emplace_back();
+            build_recursive(tree, 0, 0);
+        }
+    }
+
+    void 						clear() { m_nodes.clear(); }
+    const std::vector<Node>& 	nodes() const { return m_nodes; }
+    const Node& 				node(size_t idx) const { return m_nodes[idx]; }
+    bool 						empty() const { return m_nodes.empty(); }
+
+private:
+    // Collapse the binary subtree starting at binary_idx into the wide node wide_idx: The children of the wide node
+    // are collected by replacing the inner binary node with the largest bounding box by its children.
+    void build_recursive(const BinaryTree &tree, size_t binary_idx, size_t wide_idx)
+    {
+        std::array<size_t, Width> slots;
+        size_t                    num_slots = 0;
+        if (tree.node(binary_idx).is_leaf())
+            slots[num_slots ++] = binary_idx;
+        else {
+            slots[num_slots ++] = BinaryTree::left_child_idx(binary_idx);
+            slots[num_slots ++] = BinaryTree::right_child_idx(binary_idx);
+            while (num_slots < Width) {
+                size_t     expand   = npos;
+                CoordType  max_size = CoordType(-1);
+                for (size_t i = 0; i < num_slots; ++ i)
+                    if (const auto &n = tree.node(slots[i]); n.is_inner()) {
+                        CoordType size = n.bbox.diagonal().squaredNorm();
+                        if (size > max_size) {
+                            max_size = size;
+                            expand   = i;
+                        }
+                    }
+                if (expand == npos)
+                    break;
+                size_t inner = slots[expand];
+                slots[expand]        = BinaryTree::left_child_idx(inner);
+                slots[num_slots ++]  = BinaryTree::right_child_idx(inner);
+            }
+        }
+
+        Node node;
+        for (int d = 0; d < NumDimensions; ++ d) {
+            node.min[d].fill(std::numeric_limits<CoordType>::max());
+            node.max[d].fill(std::numeric_limits<CoordType>::lowest());
+        }
+        node.child.fill(npos);
+        for (size_t i = 0; i < num_slots; ++ i) {
+            const auto &n = tree.node(slots[i]);
+            assert(n.is_valid());
+            for (int d = 0; d < NumDimensions; ++ d) {
+                node.min[d][i] = n.bbox.min()(d);
+                node.max[d][i] = n.bbox.max()(d);
+            }
+            node.valid_mask |= 1u << i;
+            if (n.is_leaf()) {
+                node.leaf_mask |= 1u << i;
+                node.child[i] = n.idx;
+            } else {
+                node.child[i] = m_nodes.size();
+                m_nodes.emplace_back();
+            }
+        }
+        m_nodes[wide_idx] = node;
+        for (size_t i = 0; i < num_slots; ++ i)
+            if (! node.is_leaf(i))
+                build_recursive(tree, slots[i], node.child[i]);
+    }
+
+    // Root is stored at index 0, children are stored after their parents.
+    std::vector<Node> m_nodes;
+};
+
+using WideTree3f = WideTree<3, float>;
+using WideTree3d = WideTree<3, double>;
+
 // Wrap a 2D Slic3r own BoundingBox to be passed to Tree::build() and similar
 // to build an AABBTree over coord_t 2D bounding boxes.
 class BoundingBoxWrapper {
@@ -848,6 +966,268 @@ inline bool is_any_triangle_in_radius(
     return hit_point.allFinite();
 }
 
+namespace detail {
+    // Slab test of a ray against all bounding boxes of the children of a WideTree node, see ray_box_intersect_invdir().
+    // Returns mask of the children hit in the <t0, t1> interval of the ray parameter, tnear receives their entry parameters.
+    template<typename WideNode, typename VectorType, typename Scalar, size_t Width>
+    inline unsigned ray_box_intersect_wide(
+        const WideNode 					&node,
+        const VectorType 				&origin,
+        const VectorType 				&inv_dir,
+        const Scalar 					 t0,
+        const Scalar 					 t1,
+        std::array<Scalar, Width> 		&tnear)
+    {
+        const auto &near_x = inv_dir.x() < 0 ? node.max[0] : node.min[0];
+        const auto &far_x  = inv_dir.x() < 0 ? node.min[0] : node.max[0];
+        const auto &near_y = inv_dir.y() < 0 ? node.max[1] : node.min[1];
+        const auto &far_y  = inv_dir.y() < 0 ? node.min[1] : node.max[1];
+        const auto &near_z = inv_dir.z() < 0 ? node.max[2] : node.min[2];
+        const auto &far_z  = inv_dir.z() < 0 ? node.min[2] : node.max[2];
+        // Branchless loop over the children to be vectorized.
+        std::array<unsigned char, Width> hit;
+        for (size_t i = 0; i < Width; ++ i) {
+            Scalar tmin = (Scalar(near_x[i]) - origin.x()) * inv_dir.x();
+            Scalar tmax = (Scalar(far_x[i])  - origin.x()) * inv_dir.x();
+            tmin = std::max(tmin, (Scalar(near_y[i]) - origin.y()) * inv_dir.y());
+            tmax = std::min(tmax, (Scalar(far_y[i])  - origin.y()) * inv_dir.y());
+            tmin = std::max(tmin, (Scalar(near_z[i]) - origin.z()) * inv_dir.z());
+            tmax = std::min(tmax, (Scalar(far_z[i])  - origin.z()) * inv_dir.z());
+            tnear[i] = tmin;
+            hit[i]   = tmin <= tmax && tmin < t1 && tmax > t0;
+        }
+        unsigned mask = 0;
+        for (size_t i = 0; i < Width; ++ i)
+            mask |= unsigned(hit[i]) << i;
+        return mask & node.valid_mask;
+    }
+
+    // Triangles of the leaf children of a WideTree node, which passed the box test, as a structure of arrays
+    // of their first vertex and edges for a vectorized ray-triangle intersection.
+    template<size_t Width>
+    struct TrianglePacket {
+        std::array<std::array<double, Width>, 3> v0;
+        std::array<std::array<double, Width>, 3> edge1;
+        std::array<std::array<double, Width>, 3> edge2;
+        std::array<size_t, Width>                idx;
+        size_t                                   size = 0;
+
+        template<typename WideNode, typename VertexType, typename IndexedFaceType>
+        void fill(const WideNode &node, unsigned leaf_mask, const std::vector<VertexType> &vertices, const std::vector<IndexedFaceType> &faces)
+        {
+            size = 0;
+            for (size_t i = 0; i < Width; ++ i)
+                if ((leaf_mask >> i) & 1) {
+                    const auto  &face = faces[node.child[i]];
+                    const Vec3d  p0   = vertices[face(0)].template cast<double>();
+                    const Vec3d  p1   = vertices[face(1)].template cast<double>();
+                    const Vec3d  p2   = vertices[face(2)].template cast<double>();
+                    for (int d = 0; d < 3; ++ d) {
+                        v0[d][size]    = p0(d);
+                        edge1[d][size] = p1(d) - p0(d);
+                        edge2[d][size] = p2(d) - p0(d);
+                    }
+                    idx[size ++] = node.child[i];
+                }
+            // Degenerate unused lanes, they will fail the determinant test.
+            for (size_t i = size; i < Width; ++ i)
+                for (int d = 0; d < 3; ++ d)
+                    v0[d][i] = edge1[d][i] = edge2[d][i] = 0.;
+        }
+    };
+
+    // Vectorized variant of intersect_triangle() over a packet of triangles.
+    // Returns mask of the triangles intersected in front of the ray origin (t > 0).
+    template<size_t Width>
+    inline unsigned intersect_triangles(const TrianglePacket<Width> &packet, const Vec3d &orig, const Vec3d &dir, double eps,
+        std::array<double, Width> &t, std::array<double, Width> &u, std::array<double, Width> &v)
+    {
+        std::array<unsigned char, Width> hit;
+        for (size_t i = 0; i < Width; ++ i) {
+            const double e1x = packet.edge1[0][i], e1y = packet.edge1[1][i], e1z = packet.edge1[2][i];
+            const double e2x = packet.edge2[0][i], e2y = packet.edge2[1][i], e2z = packet.edge2[2][i];
+            // pvec = dir x edge2
+            const double px = dir.y() * e2z - dir.z() * e2y;
+            const double py = dir.z() * e2x - dir.x() * e2z;
+            const double pz = dir.x() * e2y - dir.y() * e2x;
+            const double det = e1x * px + e1y * py + e1z * pz;
+            // tvec = orig - v0
+            const double tx = orig.x() - packet.v0[0][i];
+            const double ty = orig.y() - packet.v0[1][i];
+            const double tz = orig.z() - packet.v0[2][i];
+            const double uu = tx * px + ty * py + tz * pz;
+            // qvec = tvec x edge1
+            const double qx = ty * e1z - tz * e1y;
+            const double qy = tz * e1x - tx * e1z;
+            const double qz = tx * e1y - ty * e1x;
+            const double vv = dir.x() * qx + dir.y() * qy + dir.z() * qz;
+            const bool   front = det > eps && uu >= 0. && uu <= det && vv >= 0. && uu + vv <= det;
+            const bool   back  = det < -eps && uu <= 0. && uu >= det && vv <= 0. && uu + vv >= det;
+            const double inv_det = 1. / (front || back ? det : 1.);
+            t[i]   = (e2x * qx + e2y * qy + e2z * qz) * inv_det;
+            u[i]   = uu * inv_det;
+            v[i]   = vv * inv_det;
+            hit[i] = (front || back) && t[i] > 0.;
+        }
+        unsigned mask = 0;
+        for (size_t i = 0; i < packet.size; ++ i)
+            mask |= unsigned(hit[i]) << i;
+        return mask;
+    }
+
+    // Maximum depth of a WideTree traversal stack: Each level of the tree pushes at most Width - 1 nodes
+    // above the stack top and the depth of a tree over size_t entities is below 64.
+    template<size_t Width>
+    constexpr size_t wide_tree_stack_size() { return 64 * (Width - 1) + 1; }
+} // namespace detail
+
+// Find a first intersection of a ray with indexed triangle set using a WideTree, see intersect_ray_first_hit() over Tree.
+template<typename VertexType, typename IndexedFaceType, typename CoordType, size_t Width, typename VectorType>
+inline bool intersect_ray_first_hit(
+	const std::vector<VertexType> 		&vertices,
+	const std::vector<IndexedFaceType> 	&faces,
+	const WideTree<3, CoordType, Width> &tree,
+	const VectorType					&origin,
+	const VectorType 					&dir,
+	igl::Hit 							&hit,
+	const double 						 eps = 0.000001)
+{
+    using Scalar = typename VectorType::Scalar;
+    if (tree.empty())
+        return false;
+    const VectorType inv_dir = dir.cwiseInverse();
+    const Vec3d      origin_d = origin.template cast<double>();
+    const Vec3d      dir_d    = dir.template cast<double>();
+
+    // Nodes to visit with the ray parameter of entry into their bounding box, the closest on top.
+    std::array<std::pair<size_t, Scalar>, detail::wide_tree_stack_size<Width>()> stack;
+    size_t stack_size = 0;
+    stack[stack_size ++] = { 0, Scalar(0) };
+
+    Scalar                          min_t = std::numeric_limits<Scalar>::infinity();
+    bool                            found = false;
+    std::array<Scalar, Width>       tnear;
+    detail::TrianglePacket<Width>   packet;
+    std::array<double, Width>       t, u, v;
+    while (stack_size > 0) {
+        auto [node_idx, node_t] = stack[-- stack_size];
+        if (node_t >= min_t)
+            continue;
+        const auto &node = tree.node(node_idx);
+        unsigned mask = detail::ray_box_intersect_wide(node, origin, inv_dir, Scalar(0), min_t, tnear);
+        if (unsigned leaves = mask & node.leaf_mask; leaves) {
+            packet.fill(node, leaves, vertices, faces);
+            unsigned hits = detail::intersect_triangles(packet, origin_d, dir_d, eps, t, u, v);
+            for (size_t i = 0; i < packet.size; ++ i)
+                if (((hits >> i) & 1) && Scalar(t[i]) < min_t) {
+                    hit   = igl::Hit { int(packet.idx[i]), -1, float(u[i]), float(v[i]), float(t[i]) };
+                    min_t = Scalar(t[i]);
+                    found = true;
+                }
+        }
+        // Push the inner children, the farthest first.
+        size_t first = stack_size;
+        for (size_t i = 0; i < Width; ++ i)
+            if (((mask & ~node.leaf_mask) >> i) & 1) {
+                size_t j = stack_size ++;
+                for (; j > first && stack[j - 1].second < tnear[i]; -- j)
+                    stack[j] = stack[j - 1];
+                stack[j] = { node.child[i], tnear[i] };
+            }
+    }
+    return found;
+}
+
+// Find all intersections of a ray with indexed triangle set using a WideTree, see intersect_ray_all_hits() over Tree.
+template<typename VertexType, typename IndexedFaceType, typename CoordType, size_t Width, typename VectorType>
+inline bool intersect_ray_all_hits(
+	const std::vector<VertexType> 		&vertices,
+	const std::vector<IndexedFaceType> 	&faces,
+	const WideTree<3, CoordType, Width> &tree,
+	const VectorType					&origin,
+	const VectorType 					&dir,
+	std::vector<igl::Hit> 				&hits,
+	const double 						 eps = 0.000001)
+{
+    using Scalar = typename VectorType::Scalar;
+    hits.clear();
+    if (tree.empty())
+        return false;
+    const VectorType inv_dir = dir.cwiseInverse();
+    const Vec3d      origin_d = origin.template cast<double>();
+    const Vec3d      dir_d    = dir.template cast<double>();
+
+    std::array<size_t, detail::wide_tree_stack_size<Width>()> stack;
+    size_t stack_size = 0;
+    stack[stack_size ++] = 0;
+
+    std::array<Scalar, Width>       tnear;
+    detail::TrianglePacket<Width>   packet;
+    std::array<double, Width>       t, u, v;
+    while (stack_size > 0) {
+        const auto &node = tree.node(stack[-- stack_size]);
+        unsigned mask = detail::ray_box_intersect_wide(node, origin, inv_dir, Scalar(0), std::numeric_limits<Scalar>::infinity(), tnear);
+        if (unsigned leaves = mask & node.leaf_mask; leaves) {
+            packet.fill(node, leaves, vertices, faces);
+            unsigned packet_hits = detail::intersect_triangles(packet, origin_d, dir_d, eps, t, u, v);
+            for (size_t i = 0; i < packet.size; ++ i)
+                if ((packet_hits >> i) & 1)
+                    hits.emplace_back(igl::Hit{ int(packet.idx[i]), -1, float(u[i]), float(v[i]), float(t[i]) });
+        }
+        for (size_t i = 0; i < Width; ++ i)
+            if (((mask & ~node.leaf_mask) >> i) & 1)
+                stack[stack_size ++] = node.child[i];
+    }
+    std::sort(hits.begin(), hits.end(), [](const auto &l, const auto &r) { return l.t < r.t; });
+    return ! hits.empty();
+}
+
+// Decides if exists some triangle in defined radius using a WideTree, see is_any_triangle_in_radius() over Tree.
+template<typename VertexType, typename IndexedFaceType, typename CoordType, size_t Width, typename VectorType>
+inline bool is_any_triangle_in_radius(
+        const std::vector<VertexType> 		&vertices,
+        const std::vector<IndexedFaceType> 	&faces,
+        const WideTree<3, CoordType, Width> &tree,
+        const VectorType					&point,
+        typename VectorType::Scalar 		&max_distance_squared)
+{
+    using Scalar = typename VectorType::Scalar;
+    if (tree.empty())
+        return false;
+
+    std::array<size_t, detail::wide_tree_stack_size<Width>()> stack;
+    size_t stack_size = 0;
+    stack[stack_size ++] = 0;
+
+    std::array<unsigned char, Width> close;
+    while (stack_size > 0) {
+        const auto &node = tree.node(stack[-- stack_size]);
+        // Squared distances of the point to the children bounding boxes, vectorized.
+        for (size_t i = 0; i < Width; ++ i) {
+            Scalar d2 = 0;
+            for (int d = 0; d < 3; ++ d) {
+                Scalar dist = std::max(std::max(Scalar(node.min[d][i]) - point(d), point(d) - Scalar(node.max[d][i])), Scalar(0));
+                d2 += dist * dist;
+            }
+            close[i] = d2 < max_distance_squared;
+        }
+        for (size_t i = 0; i < Width; ++ i)
+            if (close[i] && ((node.valid_mask >> i) & 1)) {
+                if (node.is_leaf(i)) {
+                    const auto &face = faces[node.child[i]];
+                    VectorType closest_point = detail::closest_point_to_triangle<VectorType>(point,
+                        vertices[face(0)].template cast<Scalar>(),
+                        vertices[face(1)].template cast<Scalar>(),
+                        vertices[face(2)].template cast<Scalar>());
+                    if ((point - closest_point).squaredNorm() < max_distance_squared)
+                        return true;
+                } else
+                    stack[stack_size ++] = node.child[i];
+            }
+    }
+    return false;
+}
+
 // Returns all triangles within the given radius limit
 template<typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
 inline std::vector<size_t> all_triangles_in_radius(
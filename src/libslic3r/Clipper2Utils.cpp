@@ -1,4 +1,5 @@
 #include "Clipper2Utils.hpp"
+#include "ClipperUtils.hpp"
 
 namespace Slic3r {
 
@@ -57,4 +58,253 @@ Slic3r::Polylines intersection_pl_2(const Slic3r::Polylines& subject, const Slic
 Slic3r::Polylines  diff_pl_2(const Slic3r::Polylines& subject, const Slic3r::Polygons& clip)
     { return _clipper2_pl_open(Clipper2Lib::ClipType::Difference, subject, clip); }
 
+namespace Clipper2Utils {
+
+static Clipper2Lib::ClipType clip_type(ClipperLib::ClipType clipType)
+{
+    switch (clipType) {
+    case ClipperLib::ctIntersection: return Clipper2Lib::ClipType::Intersection;
+    case ClipperLib::ctUnion:        return Clipper2Lib::ClipType::Union;
+    case ClipperLib::ctDifference:   return Clipper2Lib::ClipType::Difference;
+    case ClipperLib::ctXor:          return Clipper2Lib::ClipType::Xor;
+    }
+    assert(false);
+    return Clipper2Lib::ClipType::None;
+}
+
+static Clipper2Lib::FillRule fill_rule(ClipperLib::PolyFillType fillType)
+{
+    switch (fillType) {
+    case ClipperLib::pftEvenOdd:  return Clipper2Lib::FillRule::EvenOdd;
+    case ClipperLib::pftNonZero:  return Clipper2Lib::FillRule::NonZero;
+    case ClipperLib::pftPositive: return Clipper2Lib::FillRule::Positive;
+    case ClipperLib::pftNegative: return Clipper2Lib::FillRule::Negative;
+    }
+    assert(false);
+    return Clipper2Lib::FillRule::NonZero;
+}
+
+static Clipper2Lib::JoinType join_type(ClipperLib::JoinType joinType)
+{
+    switch (joinType) {
+    case ClipperLib::jtSquare: return Clipper2Lib::JoinType::Square;
+    case ClipperLib::jtRound:  return Clipper2Lib::JoinType::Round;
+    case ClipperLib::jtMiter:  return Clipper2Lib::JoinType::Miter;
+    }
+    assert(false);
+    return Clipper2Lib::JoinType::Miter;
+}
+
+static Clipper2Lib::EndType end_type(ClipperLib::EndType endType)
+{
+    switch (endType) {
+    case ClipperLib::etClosedPolygon: return Clipper2Lib::EndType::Polygon;
+    case ClipperLib::etClosedLine:    return Clipper2Lib::EndType::Joined;
+    case ClipperLib::etOpenButt:      return Clipper2Lib::EndType::Butt;
+    case ClipperLib::etOpenSquare:    return Clipper2Lib::EndType::Square;
+    case ClipperLib::etOpenRound:     return Clipper2Lib::EndType::Round;
+    }
+    assert(false);
+    return Clipper2Lib::EndType::Polygon;
+}
+
+static Points to_points(const Clipper2Lib::Path64 &path64)
+{
+    Points out;
+    out.reserve(path64.size());
+    for (const Clipper2Lib::Point64 &pt : path64)
+        out.emplace_back(coord_t(pt.x), coord_t(pt.y));
+    return out;
+}
+
+ClipperLib::Paths to_clipperlib_paths(const Clipper2Lib::Paths64 &paths)
+{
+    ClipperLib::Paths out;
+    out.reserve(paths.size());
+    for (const Clipper2Lib::Path64 &path64 : paths)
+        out.emplace_back(to_points(path64));
+    return out;
+}
+
+// Clipper2 occasionally emits tiny triangles where the offsetted contours touch, ClipperLib cleans them up.
+// Only applied to the offsets: contours with area below SCALED_EPSILON^2 are dropped, even though ClipperLib
+// would keep such a contour if it is a genuine (if sub-resolution) result of the offset rather than an artifact.
+// The boolean operations keep all contours, the same as ClipperLib does.
+static bool is_sliver(const Clipper2Lib::Path64 &path)
+{
+    return std::abs(Clipper2Lib::Area(path)) < SCALED_EPSILON * SCALED_EPSILON;
+}
+
+static void remove_slivers(Clipper2Lib::Paths64 &paths)
+{
+    paths.erase(std::remove_if(paths.begin(), paths.end(), is_sliver), paths.end());
+}
+
+ExPolygons PolyTree64ToExPolygons(const Clipper2Lib::PolyTree64 &polytree)
+{
+    struct Inner {
+        static void PolyTreeToExPolygonsRecursive(const Clipper2Lib::PolyPath64 &polynode, ExPolygons &expolygons)
+        {
+            // Index, not a reference: the recursion below appends to expolygons.
+            size_t idx = expolygons.size();
+            expolygons.emplace_back();
+            expolygons[idx].contour.points = to_points(polynode.Polygon());
+            expolygons[idx].holes.reserve(polynode.Count());
+            for (const Clipper2Lib::PolyPath64 *hole : polynode) {
+                expolygons[idx].holes.emplace_back(to_points(hole->Polygon()));
+                // Add outer polygons contained by (nested within) holes.
+                for (const Clipper2Lib::PolyPath64 *island : *hole)
+                    PolyTreeToExPolygonsRecursive(*island, expolygons);
+            }
+        }
+    };
+
+    ExPolygons retval;
+    retval.reserve(polytree.Count());
+    for (const Clipper2Lib::PolyPath64 *node : polytree)
+        Inner::PolyTreeToExPolygonsRecursive(*node, retval);
+    return retval;
+}
+
+// Drop the vertices closer than shortest_edge_length to the previous vertex kept,
+// as ClipperLib::ClipperOffset does with ClipperOffsetShortestEdgeFactor.
+static Clipper2Lib::Path64 decimate_path(const Clipper2Lib::Path64 &path, double shortest_edge_length, bool closed)
+{
+    auto close = [l2 = shortest_edge_length * shortest_edge_length](const Clipper2Lib::Point64 &p1, const Clipper2Lib::Point64 &p2) {
+        double dx = double(p2.x - p1.x);
+        double dy = double(p2.y - p1.y);
+        return dx * dx + dy * dy < l2;
+    };
+    if (path.empty())
+        return path;
+    size_t last = path.size() - 1;
+    if (closed)
+        for (; last > 0 && close(path[last], path.front()); -- last) ;
+    Clipper2Lib::Path64 out;
+    out.reserve(last + 1);
+    out.emplace_back(path.front());
+    for (size_t i = 1; i <= last; ++ i)
+        if (! close(out.back(), path[i]))
+            out.emplace_back(path[i]);
+    return out;
+}
+
+// Offset a single path the way ClipperLib::ClipperOffset does: a closed path is reoriented to CCW first,
+// thus a positive offset grows the path independently of its orientation and the output is CCW.
+static Clipper2Lib::Paths64 offset_path(Clipper2Lib::ClipperOffset &co, const Clipper2Lib::Path64 &path, double delta, Clipper2Lib::JoinType joinType, Clipper2Lib::EndType endType)
+{
+    co.Clear();
+    Clipper2Lib::Path64 decimated = decimate_path(path, std::abs(delta * ClipperOffsetShortestEdgeFactor), endType == Clipper2Lib::EndType::Polygon || endType == Clipper2Lib::EndType::Joined);
+    // Clipper2 offsets both sides of an open path by half of the delta.
+    if (endType != Clipper2Lib::EndType::Polygon)
+        delta *= 2.;
+    else
+        // Clipper2 retains the orientation of a reversed input, ClipperLib produces CCW contours.
+        co.ReverseSolution(Clipper2Lib::Area(path) < 0);
+    co.AddPath(decimated, joinType, endType);
+    Clipper2Lib::Paths64 out = co.Execute(delta);
+    remove_slivers(out);
+    return out;
+}
+
+Clipper2Lib::Paths64 raw_offset(const Clipper2Lib::Paths64 &paths, float delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::EndType endType)
+{
+    // miterLimit is the arc tolerance for round joins.
+    Clipper2Lib::ClipperOffset co(joinType == ClipperLib::jtRound ? 2. : miterLimit, joinType == ClipperLib::jtRound ? miterLimit : 0.);
+    Clipper2Lib::JoinType      jt = join_type(joinType);
+    Clipper2Lib::EndType       et = end_type(endType);
+    Clipper2Lib::Paths64       out;
+    out.reserve(paths.size());
+    for (const Clipper2Lib::Path64 &path : paths) {
+        bool ccw = et == Clipper2Lib::EndType::Polygon ? Clipper2Lib::IsPositive(path) : true;
+        Clipper2Lib::Paths64 out_this = offset_path(co, path, ccw ? delta : - delta, jt, et);
+        for (Clipper2Lib::Path64 &path_out : out_this) {
+            if (! ccw)
+                // Reverse the resulting contours.
+                std::reverse(path_out.begin(), path_out.end());
+            out.emplace_back(std::move(path_out));
+        }
+    }
+    return out;
+}
+
+static Clipper2Lib::Paths64 clipper_do_paths(Clipper2Lib::ClipType clipType, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip, Clipper2Lib::FillRule fillRule)
+{
+    Clipper2Lib::Clipper64 clipper;
+    clipper.PreserveCollinear = false;
+    clipper.AddSubject(subject);
+    clipper.AddClip(clip);
+    Clipper2Lib::Paths64 out;
+    clipper.Execute(clipType, fillRule, out);
+    return out;
+}
+
+int offset_expolygon(const ExPolygon &expoly, float delta, ClipperLib::JoinType joinType, double miterLimit, Clipper2Lib::Paths64 &out)
+{
+    Clipper2Lib::ClipperOffset co(joinType == ClipperLib::jtRound ? 2. : miterLimit, joinType == ClipperLib::jtRound ? miterLimit : 0.);
+    Clipper2Lib::JoinType      jt = join_type(joinType);
+    // 1) Offset the outer contour.
+    Clipper2Lib::Paths64 contours = offset_path(co, to_paths64(ClipperUtils::SinglePathProvider(expoly.contour.points)).front(), delta, jt, Clipper2Lib::EndType::Polygon);
+    if (contours.empty())
+        // No need to try to offset the holes.
+        return 0;
+
+    // 2) Offset the holes one by one, collect the offsetted holes. The holes are offsetted as CCW contours.
+    Clipper2Lib::Paths64 holes;
+    for (Clipper2Lib::Path64 &hole : to_paths64(ClipperUtils::PolygonsProvider(expoly.holes)))
+        append(holes, offset_path(co, hole, - delta, jt, Clipper2Lib::EndType::Polygon));
+
+    // 3) Subtract holes from the contours.
+    if (holes.empty()) {
+        // No hole remaining after an offset. Just copy the outer contour.
+        append(out, std::move(contours));
+    } else if (delta < 0) {
+        // Negative offset. There is a chance, that the offsetted hole intersects the outer contour.
+        // Subtract the offsetted holes from the offsetted contours.
+        if (Clipper2Lib::Paths64 output = clipper_do_paths(Clipper2Lib::ClipType::Difference, contours, holes, Clipper2Lib::FillRule::NonZero); ! output.empty())
+            append(out, std::move(output));
+        else
+            // The offsetted holes have eaten up the offsetted outer contour.
+            return 0;
+    } else {
+        // Positive offset, the offsetted holes will not intersect the offsetted contour. Just collect the reversed holes.
+        append(out, std::move(contours));
+        for (Clipper2Lib::Path64 &hole : holes)
+            std::reverse(hole.begin(), hole.end());
+        append(out, std::move(holes));
+    }
+    return 1;
+}
+
+template<>
+ClipperLib::Paths clipper_do(ClipperLib::ClipType clipType, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip, ClipperLib::PolyFillType fillType)
+{
+    return to_clipperlib_paths(clipper_do_paths(clip_type(clipType), subject, clip, fill_rule(fillType)));
+}
+
+template<>
+ExPolygons clipper_do(ClipperLib::ClipType clipType, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip, ClipperLib::PolyFillType fillType)
+{
+    Clipper2Lib::Clipper64 clipper;
+    clipper.PreserveCollinear = false;
+    clipper.AddSubject(subject);
+    clipper.AddClip(clip);
+    Clipper2Lib::PolyTree64 polytree;
+    clipper.Execute(clip_type(clipType), fill_rule(fillType), polytree);
+    return PolyTree64ToExPolygons(polytree);
+}
+
+Polylines clipper_do_pl_open(ClipperLib::ClipType clipType, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip)
+{
+    Clipper2Lib::Clipper64 clipper;
+    clipper.PreserveCollinear = false;
+    clipper.AddOpenSubject(subject);
+    clipper.AddClip(clip);
+    Clipper2Lib::Paths64 solution, solution_open;
+    clipper.Execute(clip_type(clipType), Clipper2Lib::FillRule::NonZero, solution, solution_open);
+    return Paths64_to_polylines(solution_open);
+}
+
+} // namespace Clipper2Utils
+
 }
\ No newline at end of file
@@ -2,7 +2,9 @@
 #define slic3r_Clipper2Utils_hpp_
 
 #include "libslic3r.h"
+#include "clipper.hpp"
 #include "clipper2/clipper.h"
+#include "ExPolygon.hpp"
 #include "Polygon.hpp"
 #include "Polyline.hpp"
 
@@ -11,7 +13,47 @@ namespace Slic3r {
 Slic3r::Polylines  intersection_pl_2(const Slic3r::Polylines& subject, const Slic3r::Polygons& clip);
 Slic3r::Polylines  diff_pl_2(const Slic3r::Polylines& subject, const Slic3r::Polygons& clip);
 
+// Clipper2 backend of ClipperUtils, see ClipperUtils::Backend.
+// The functions mirror the ClipperLib primitives of ClipperUtils.cpp: they accept and produce the same orientations
+// and the same offset conventions, thus the public ClipperUtils API does not depend on the backend selected.
+namespace Clipper2Utils {
+
+// Convert paths of ClipperUtils path providers or ClipperLib::Paths to Clipper2 paths.
+template<typename PathsProvider>
+Clipper2Lib::Paths64 to_paths64(PathsProvider &&paths)
+{
+    Clipper2Lib::Paths64 out;
+    out.reserve(paths.size());
+    for (const Points &path : paths) {
+        Clipper2Lib::Path64 &path64 = out.emplace_back();
+        path64.reserve(path.size());
+        for (const Point &pt : path)
+            path64.emplace_back(pt.x(), pt.y());
+    }
+    return out;
 }
 
-#endif
+ClipperLib::Paths  to_clipperlib_paths(const Clipper2Lib::Paths64 &paths);
+ExPolygons         PolyTree64ToExPolygons(const Clipper2Lib::PolyTree64 &polytree);
+
+// Offset CCW contours outside, CW contours (holes) inside. Don't calculate union of the output paths.
+// Closed paths are offsetted one by one, open paths are offsetted by delta to both sides.
+Clipper2Lib::Paths64 raw_offset(const Clipper2Lib::Paths64 &paths, float delta, ClipperLib::JoinType joinType, double miterLimit,
+                                ClipperLib::EndType endType = ClipperLib::etClosedPolygon);
+
+// Offset a single ExPolygon, see offset_expolygon_inner() in ClipperUtils.cpp.
+// Returns number of expolygons collected (0 or 1).
+int offset_expolygon(const ExPolygon &expoly, float delta, ClipperLib::JoinType joinType, double miterLimit, Clipper2Lib::Paths64 &out);
+
+// Boolean operation over closed paths. TResult is either ClipperLib::Paths or ExPolygons.
+template<class TResult>
+TResult clipper_do(ClipperLib::ClipType clipType, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip, ClipperLib::PolyFillType fillType);
 
+// Clip open subject paths with closed clip paths.
+Polylines clipper_do_pl_open(ClipperLib::ClipType clipType, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip);
+
+} // namespace Clipper2Utils
+
+}
+
+#endif
@@ -10,9 +10,12 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include "ClipperUtils.hpp"
+#include "Clipper2Utils.hpp"
 #include "Geometry.hpp"
 #include "ShortestPath.hpp"
 
+#include <atomic>
+
 // #define CLIPPER_UTILS_DEBUG
 
 #ifdef CLIPPER_UTILS_DEBUG
@@ -69,6 +72,15 @@ namespace ClipperUtils {
 Points EmptyPathsProvider::s_empty_points;
 Points SinglePathProvider::s_end;
 
+#ifdef SLIC3R_CLIPPER2
+static std::atomic<Backend> s_backend { Backend::Clipper2 };
+#else
+static std::atomic<Backend> s_backend { Backend::ClipperLib };
+#endif
+
+Backend backend() { return s_backend.load(std::memory_order_relaxed); }
+void set_backend(Backend backend) { s_backend.store(backend, std::memory_order_relaxed); }
+
 // Clip source polygon to be used as a clipping polygon with a bouding box around the source (to be clipped) polygon.
 // Useful as an optimization for expensive ClipperLib operations, for example when clipping source polygons one by one
 // with a set of polygons covering the whole layer below.
@@ -270,11 +282,23 @@ bool has_duplicate_points(const ClipperLib::PolyTree &polytree)
 }
 #endif
 
+static inline bool use_clipper2() { return ClipperUtils::backend() == ClipperUtils::Backend::Clipper2; }
+
+// Results of the Clipper operations below are either ClipperLib::Paths or ExPolygons.
+// With ClipperLib, ExPolygons are extracted from a ClipperLib::PolyTree.
+template<class TResult>
+using ClipperLibResult = std::conditional_t<std::is_same_v<TResult, ExPolygons>, ClipperLib::PolyTree, TResult>;
+static inline ClipperLib::Paths to_result(ClipperLib::Paths &&paths) { return std::move(paths); }
+static inline ExPolygons to_result(ClipperLib::PolyTree &&polytree) { return PolyTreeToExPolygons(std::move(polytree)); }
+
 // Offset CCW contours outside, CW contours (holes) inside.
 // Don't calculate union of the output paths.
 template<typename PathsProvider>
 static ClipperLib::Paths raw_offset(PathsProvider &&paths, float offset, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::EndType endType = ClipperLib::etClosedPolygon)
 {
+    if (use_clipper2())
+        return Clipper2Utils::to_clipperlib_paths(Clipper2Utils::raw_offset(Clipper2Utils::to_paths64(paths), offset, joinType, miterLimit, endType));
+
     ClipperLib::ClipperOffset co;
     ClipperLib::Paths out;
     out.reserve(paths.size());
@@ -316,12 +340,15 @@ TResult clipper_do(
     TClip &&                       clip,
     const ClipperLib::PolyFillType fillType)
 {
+    if (use_clipper2())
+        return Clipper2Utils::clipper_do<TResult>(clipType, Clipper2Utils::to_paths64(subject), Clipper2Utils::to_paths64(clip), fillType);
+
     ClipperLib::Clipper clipper;
     clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
-    TResult retval;
+    ClipperLibResult<TResult> retval;
     clipper.Execute(clipType, retval, fillType, fillType);
-    return retval;
+    return to_result(std::move(retval));
 }
 
 template<class TResult, class TSubj, class TClip>
@@ -345,18 +372,21 @@ TResult clipper_union(
     // fillType pftNonZero and pftPositive "should" produce the same result for "normalized with implicit union" set of polygons
     const ClipperLib::PolyFillType fillType = ClipperLib::pftNonZero)
 {
+    if (use_clipper2())
+        return Clipper2Utils::clipper_do<TResult>(ClipperLib::ctUnion, Clipper2Utils::to_paths64(subject), Clipper2Lib::Paths64(), fillType);
+
     ClipperLib::Clipper clipper;
     clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
-    TResult retval;
+    ClipperLibResult<TResult> retval;
     clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
-    return retval;
+    return to_result(std::move(retval));
 }
 
 // Perform union of input polygons using the positive rule, convert to ExPolygons.
 //FIXME is there any benefit of not doing the boolean / using pftEvenOdd?
 inline ExPolygons ClipperPaths_to_Slic3rExPolygons(const ClipperLib::Paths &input, bool do_union)
 {
-    return PolyTreeToExPolygons(clipper_union<ClipperLib::PolyTree>(input, do_union ? ClipperLib::pftNonZero : ClipperLib::pftEvenOdd));
+    return clipper_union<ExPolygons>(input, do_union ? ClipperLib::pftNonZero : ClipperLib::pftEvenOdd);
 }
 
 template<typename PathsProvider>
@@ -371,6 +401,9 @@ static TResult expand_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
 {
     // BBS
     //assert(offset > 0);
+    if (use_clipper2())
+        return Clipper2Utils::clipper_do<TResult>(ClipperLib::ctUnion,
+            Clipper2Utils::raw_offset(Clipper2Utils::to_paths64(paths), offset, joinType, miterLimit), Clipper2Lib::Paths64(), ClipperLib::pftNonZero);
     return clipper_union<TResult>(raw_offset(std::forward<PathsProvider>(paths), offset, joinType, miterLimit));
 }
 
@@ -386,7 +419,12 @@ static TResult shrink_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
 {
     // BBS
     //assert(offset > 0);
-    TResult out;
+    if (use_clipper2())
+        // The shrunk contours keep their positive winding number, while the collapsed parts of the contours turn negative.
+        return Clipper2Utils::clipper_do<TResult>(ClipperLib::ctUnion,
+            Clipper2Utils::raw_offset(Clipper2Utils::to_paths64(paths), - offset, joinType, miterLimit), Clipper2Lib::Paths64(), ClipperLib::pftPositive);
+
+    ClipperLibResult<TResult> out;
     if (auto raw = raw_offset(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit); ! raw.empty()) {
         ClipperLib::Clipper clipper;
         clipper.AddPaths(raw, ClipperLib::ptSubject, true);
@@ -396,7 +434,7 @@ static TResult shrink_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
         clipper.Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
         remove_outermost_polygon(out);
     }
-    return out;
+    return to_result(std::move(out));
 }
 
 template<class TResult, typename PathsProvider>
@@ -416,7 +454,7 @@ Slic3r::Polygons offset(const Slic3r::Polygon &polygon, const float delta, Clipp
 Slic3r::Polygons offset(const Slic3r::Polygons &polygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
     { return to_polygons(offset_paths<ClipperLib::Paths>(ClipperUtils::PolygonsProvider(polygons), delta, joinType, miterLimit)); }
 Slic3r::ExPolygons offset_ex(const Slic3r::Polygons &polygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(ClipperUtils::PolygonsProvider(polygons), delta, joinType, miterLimit)); }
+    { return offset_paths<ExPolygons>(ClipperUtils::PolygonsProvider(polygons), delta, joinType, miterLimit); }
 
 Slic3r::Polygons offset(const Slic3r::Polyline &polyline, const float delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::EndType end_type)
     { assert(delta > 0); return to_polygons(clipper_union<ClipperLib::Paths>(raw_offset_polyline(ClipperUtils::SinglePathProvider(polyline.points), delta, joinType, miterLimit, end_type))); }
@@ -433,6 +471,13 @@ Polygons contour_to_polygons(const Polygons &polygons, const float line_width, C
 // returns number of expolygons collected (0 or 1).
 static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::Paths &out)
 {
+    if (use_clipper2()) {
+        Clipper2Lib::Paths64 out64;
+        int expolygons_collected = Clipper2Utils::offset_expolygon(expoly, delta, joinType, miterLimit, out64);
+        append(out, Clipper2Utils::to_clipperlib_paths(out64));
+        return expolygons_collected;
+    }
+
     // 1) Offset the outer contour.
     ClipperLib::Paths contours;
     {
@@ -546,11 +591,11 @@ static ClipperLib::Paths expolygons_offset(const ExPolygonVector &expolygons, co
 
 // See comment on expolygons_offset_raw. In addition, the polygons are always united to conver to polytree.
 template<typename ExPolygonVector>
-static ClipperLib::PolyTree expolygons_offset_pt(const ExPolygonVector &expolygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+static ExPolygons expolygons_offset_ex(const ExPolygonVector &expolygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
 {
     auto [output, expolygons_collected] = expolygons_offset_raw(expolygons, delta, joinType, miterLimit);
     // Unite the offsetted expolygons for both the 
-    return clipper_union<ClipperLib::PolyTree>(output);
+    return clipper_union<ExPolygons>(output);
 }
 
 Slic3r::Polygons offset(const Slic3r::ExPolygon &expolygon, const float delta, ClipperLib::JoinType joinType, double miterLimit)
@@ -565,9 +610,9 @@ Slic3r::ExPolygons offset_ex(const Slic3r::ExPolygon &expolygon, const float del
     //FIXME one may spare one Clipper Union call.
     { return ClipperPaths_to_Slic3rExPolygons(expolygon_offset(expolygon, delta, joinType, miterLimit)); }
 Slic3r::ExPolygons offset_ex(const Slic3r::ExPolygons &expolygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return PolyTreeToExPolygons(expolygons_offset_pt(expolygons, delta, joinType, miterLimit)); }
+    { return expolygons_offset_ex(expolygons, delta, joinType, miterLimit); }
 Slic3r::ExPolygons offset_ex(const Slic3r::Surfaces &surfaces, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return PolyTreeToExPolygons(expolygons_offset_pt(surfaces, delta, joinType, miterLimit)); }
+    { return expolygons_offset_ex(surfaces, delta, joinType, miterLimit); }
 
 Polygons offset2(const ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
@@ -575,12 +620,12 @@ Polygons offset2(const ExPolygons &expolygons, const float delta1, const float d
 }
 ExPolygons offset2_ex(const ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
-    return PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(expolygons_offset(expolygons, delta1, joinType, miterLimit), delta2, joinType, miterLimit));
+    return offset_paths<ExPolygons>(expolygons_offset(expolygons, delta1, joinType, miterLimit), delta2, joinType, miterLimit);
 }
 ExPolygons offset2_ex(const Surfaces &surfaces, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
     //FIXME it may be more efficient to offset to_expolygons(surfaces) instead of to_polygons(surfaces).
-    return PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(expolygons_offset(surfaces, delta1, joinType, miterLimit), delta2, joinType, miterLimit));
+    return offset_paths<ExPolygons>(expolygons_offset(surfaces, delta1, joinType, miterLimit), delta2, joinType, miterLimit);
 }
 
 // Offset outside, then inside produces morphological closing. All deltas should be positive.
@@ -594,14 +639,14 @@ Slic3r::ExPolygons closing_ex(const Slic3r::Polygons &polygons, const float delt
 {
     assert(delta1 > 0);
     assert(delta2 > 0);
-    return PolyTreeToExPolygons(shrink_paths<ClipperLib::PolyTree>(expand_paths<ClipperLib::Paths>(ClipperUtils::PolygonsProvider(polygons), delta1, joinType, miterLimit), delta2, joinType, miterLimit));
+    return shrink_paths<ExPolygons>(expand_paths<ClipperLib::Paths>(ClipperUtils::PolygonsProvider(polygons), delta1, joinType, miterLimit), delta2, joinType, miterLimit);
 }
 Slic3r::ExPolygons closing_ex(const Slic3r::Surfaces &surfaces, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
     assert(delta1 > 0);
     assert(delta2 > 0);
     //FIXME it may be more efficient to offset to_expolygons(surfaces) instead of to_polygons(surfaces).
-    return PolyTreeToExPolygons(shrink_paths<ClipperLib::PolyTree>(expand_paths<ClipperLib::Paths>(ClipperUtils::SurfacesProvider(surfaces), delta1, joinType, miterLimit), delta2, joinType, miterLimit));
+    return shrink_paths<ExPolygons>(expand_paths<ClipperLib::Paths>(ClipperUtils::SurfacesProvider(surfaces), delta1, joinType, miterLimit), delta2, joinType, miterLimit);
 }
 
 // Offset inside, then outside produces morphological opening. All deltas should be positive.
@@ -632,23 +677,27 @@ Slic3r::Polygons opening(const Slic3r::Surfaces &surfaces, const float delta1, c
 // This function implemenets a following workaround:
 // 1) Peform the Clipper operation with the output to Paths. This method handles overlaps in a reasonable time.
 // 2) Run Clipper Union once again to extract the PolyTree from the result of 1).
+// Clipper2 does not suffer from this issue, it builds its PolyTree in a single pass.
 template<typename PathProvider1, typename PathProvider2>
-inline ClipperLib::PolyTree clipper_do_polytree(
+inline ExPolygons clipper_do_ex(
     const ClipperLib::ClipType       clipType,
     PathProvider1                  &&subject,
     PathProvider2                  &&clip,
     const ClipperLib::PolyFillType   fillType)
 {
+    if (use_clipper2())
+        return clipper_do<ExPolygons>(clipType, std::forward<PathProvider1>(subject), std::forward<PathProvider2>(clip), fillType);
+
     // Perform the operation with the output to input_subject.
     // This pass does not generate a PolyTree, which is a very expensive operation with the current Clipper library
     // if there are overapping edges.
     if (auto output = clipper_do<ClipperLib::Paths>(clipType, subject, clip, fillType); ! output.empty())
         // Perform an additional Union operation to generate the PolyTree ordering.
-        return clipper_union<ClipperLib::PolyTree>(output, fillType);
-    return ClipperLib::PolyTree();
+        return clipper_union<ExPolygons>(output, fillType);
+    return ExPolygons();
 }
 template<typename PathProvider1, typename PathProvider2>
-inline ClipperLib::PolyTree clipper_do_polytree(
+inline ExPolygons clipper_do_ex(
     const ClipperLib::ClipType       clipType,
     PathProvider1                  &&subject,
     PathProvider2                  &&clip,
@@ -657,8 +706,8 @@ inline ClipperLib::PolyTree clipper_do_polytree(
 {
     assert(do_safety_offset == ApplySafetyOffset::No || clipType != ClipperLib::ctUnion);
     return do_safety_offset == ApplySafetyOffset::Yes ? 
-        clipper_do_polytree(clipType, std::forward<PathProvider1>(subject), safety_offset(std::forward<PathProvider2>(clip)), fillType) :
-        clipper_do_polytree(clipType, std::forward<PathProvider1>(subject), std::forward<PathProvider2>(clip), fillType);
+        clipper_do_ex(clipType, std::forward<PathProvider1>(subject), safety_offset(std::forward<PathProvider2>(clip)), fillType) :
+        clipper_do_ex(clipType, std::forward<PathProvider1>(subject), std::forward<PathProvider2>(clip), fillType);
 }
 
 template<class TSubj, class TClip>
@@ -724,7 +773,7 @@ Slic3r::Polygons union_(const Slic3r::Polygons &subject, const Slic3r::Polygons
 
 template <typename TSubject, typename TClip>
 static ExPolygons _clipper_ex(ClipperLib::ClipType clipType, TSubject &&subject,  TClip &&clip, ApplySafetyOffset do_safety_offset, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero)
-    { return PolyTreeToExPolygons(clipper_do_polytree(clipType, std::forward<TSubject>(subject), std::forward<TClip>(clip), fill_type, do_safety_offset)); }
+    { return clipper_do_ex(clipType, std::forward<TSubject>(subject), std::forward<TClip>(clip), fill_type, do_safety_offset); }
 
 Slic3r::ExPolygons diff_ex(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
     { return _clipper_ex(ClipperLib::ctDifference, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
@@ -801,11 +850,11 @@ Slic3r::ExPolygons intersection_ex(const Slic3r::SurfacesPtr &subject, const Sli
 Slic3r::ExPolygons union_ex(const Slic3r::Polygons &subject, ClipperLib::PolyFillType fill_type)
     { return _clipper_ex(ClipperLib::ctUnion, ClipperUtils::PolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No, fill_type); }
 Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject)
-    { return PolyTreeToExPolygons(clipper_do_polytree(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftNonZero)); }
+    { return clipper_do_ex(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftNonZero); }
 Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &subject2)
-    { return PolyTreeToExPolygons(clipper_do_polytree(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::PolygonsProvider(subject2), ClipperLib::pftNonZero)); }
+    { return clipper_do_ex(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::PolygonsProvider(subject2), ClipperLib::pftNonZero); }
 Slic3r::ExPolygons union_ex(const Slic3r::Surfaces &subject)
-    { return PolyTreeToExPolygons(clipper_do_polytree(ClipperLib::ctUnion, ClipperUtils::SurfacesProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftNonZero)); }
+    { return clipper_do_ex(ClipperLib::ctUnion, ClipperUtils::SurfacesProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftNonZero); }
 // BBS
 Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons& poly1, const Slic3r::ExPolygons& poly2, bool safety_offset_)
     {
@@ -822,6 +871,9 @@ Slic3r::ExPolygons xor_ex(const Slic3r::ExPolygons &subject, const Slic3r::ExPol
 template<typename PathsProvider1, typename PathsProvider2>
 Polylines _clipper_pl_open(ClipperLib::ClipType clipType, PathsProvider1 &&subject, PathsProvider2 &&clip)
 {
+    if (use_clipper2())
+        return Clipper2Utils::clipper_do_pl_open(clipType, Clipper2Utils::to_paths64(subject), Clipper2Utils::to_paths64(clip));
+
     ClipperLib::Clipper clipper;
     clipper.AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
     clipper.AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
@@ -937,13 +989,22 @@ Lines _clipper_ln(ClipperLib::ClipType clipType, const Lines &subject, const Pol
 
 // Convert polygons / expolygons into ClipperLib::PolyTree using ClipperLib::pftEvenOdd, thus union will NOT be performed.
 // If the contours are not intersecting, their orientation shall not be modified by union_pt().
+template<typename PathsProvider>
+static ClipperLib::PolyTree clipper_union_pt(PathsProvider &&subject)
+{
+    ClipperLib::Clipper clipper;
+    clipper.AddPaths(std::forward<PathsProvider>(subject), ClipperLib::ptSubject, true);
+    ClipperLib::PolyTree retval;
+    clipper.Execute(ClipperLib::ctUnion, retval, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);
+    return retval;
+}
 ClipperLib::PolyTree union_pt(const Polygons &subject)
 {
-    return clipper_do<ClipperLib::PolyTree>(ClipperLib::ctUnion, ClipperUtils::PolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftEvenOdd);
+    return clipper_union_pt(ClipperUtils::PolygonsProvider(subject));
 }
 ClipperLib::PolyTree union_pt(const ExPolygons &subject)
 {
-    return clipper_do<ClipperLib::PolyTree>(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftEvenOdd);
+    return clipper_union_pt(ClipperUtils::ExPolygonsProvider(subject));
 }
 
 // Simple spatial ordering of Polynodes
@@ -308,7 +308,18 @@ namespace ClipperUtils {
         size_t             m_size;
     };
 
-    
+
+    // Polygon clipping library performing the offsets and boolean operations of this module.
+    // ClipperLib is the default, Clipper2 is selected with the SLIC3R_CLIPPER2 build option
+    // or at runtime. Both produce the same results up to the discretization of the offsetted contours.
+    // union_pt(), simplify_polygons(), top_level_islands() and the variable offsets always use ClipperLib.
+    enum class Backend {
+        ClipperLib,
+        Clipper2,
+    };
+    Backend backend();
+    void    set_backend(Backend backend);
+
     // For ClipperLib with Z coordinates.
     using ZPoint  = Vec3i32;
     using ZPoints = std::vector<Vec3i32>;
@@ -4,8 +4,22 @@
 
 #include "STL.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <limits>
 #include <string>
 
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/predef/other/endian.h>
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_sort.h>
+
 #ifdef _WIN32
 #define DIR_SEPARATOR '\\'
 #else
@@ -39,6 +53,264 @@ bool load_stl(const char *path, Model *model, const char *object_name_in, Import
     return true;
 }
 
+namespace {
+
+// Facet records of a memory mapped binary STL file.
+class StlBinaryFacets
+{
+public:
+    StlBinaryFacets(const char *data, uint32_t num_facets) : m_data(data + HEADER_SIZE), m_num_facets(num_facets) {}
+
+    uint32_t    num_facets() const { return m_num_facets; }
+    uint32_t    num_corners() const { return 3 * m_num_facets; }
+
+    stl_vertex  vertex(uint32_t corner_idx) const {
+        stl_vertex v;
+        memcpy(v.data(), this->record(corner_idx / 3) + 12 * (1 + corner_idx % 3), sizeof(stl_vertex));
+        return v;
+    }
+    // Coordinates of a vertex with negative zeros switched to positive zeros, thus two vertices have equal keys
+    // if and only if admesh considers them equal.
+    std::array<uint32_t, 3> vertex_key(uint32_t corner_idx) const {
+        std::array<uint32_t, 3> key;
+        memcpy(key.data(), this->record(corner_idx / 3) + 12 * (1 + corner_idx % 3), sizeof(key));
+        for (uint32_t &k : key)
+            if (k == 0x80000000u)
+                k = 0;
+        return key;
+    }
+    // Facet with the normal stored in the file, with the first two vertices swapped if reversed, see reverse_facet() of admesh.
+    stl_facet   facet(uint32_t facet_idx, bool reversed) const {
+        stl_facet facet;
+        memcpy(facet.normal.data(), this->record(facet_idx), sizeof(stl_normal));
+        for (int i = 0; i < 3; ++ i)
+            facet.vertex[i] = this->vertex(3 * facet_idx + i);
+        if (reversed)
+            std::swap(facet.vertex[0], facet.vertex[1]);
+        return facet;
+    }
+
+private:
+    const char* record(uint32_t facet_idx) const { return m_data + size_t(SIZEOF_STL_FACET) * facet_idx; }
+
+    const char *m_data;
+    uint32_t    m_num_facets;
+};
+
+// Same as check_normal_vector(stl, facet_idx, 0) of admesh: Is the normal stored with the facet pointing backwards?
+static bool stl_stored_normal_backwards(stl_facet facet)
+{
+    const float eps = 0.001f;
+    auto close = [eps](const stl_normal &a, const stl_normal &b) {
+        stl_normal diff = (a - b).cwiseAbs();
+        return diff(0) < eps && diff(1) < eps && diff(2) < eps;
+    };
+    stl_normal normal;
+    stl_calculate_normal(normal, &facet);
+    stl_normalize_vector(normal);
+    if (close(normal, facet.normal))
+        return false;
+    stl_normal test_norm = facet.normal;
+    stl_normalize_vector(test_norm);
+    if (close(normal, test_norm))
+        return false;
+    return close(normal, - test_norm);
+}
+
+} // namespace
+
+LoadStlIndexedResult load_stl_binary_indexed(const char *path, indexed_triangle_set &its, ImportstlProgressFn stlFn)
+{
+#if BOOST_ENDIAN_BIG_BYTE
+    // The facet records would have to be byte swapped.
+    return LoadStlIndexedResult::NotApplicable;
+#else
+    static constexpr const uint32_t invalid = std::numeric_limits<uint32_t>::max();
+
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(boost::filesystem::path(path));
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << "load_stl_binary_indexed: failed to memory map " << path << ": " << ex.what();
+    }
+    // The same detection of a binary STL as stl_open_count_facets() does: Any of the 128 bytes following the header is not ASCII.
+    if (! file.is_open() || file.size() < STL_MIN_FILE_SIZE || (file.size() - HEADER_SIZE) % SIZEOF_STL_FACET != 0 ||
+        std::none_of(file.data() + HEADER_SIZE, file.data() + HEADER_SIZE + 128, [](char c) { return (unsigned char)c > 127; }))
+        return LoadStlIndexedResult::NotApplicable;
+    if ((file.size() - HEADER_SIZE) / SIZEOF_STL_FACET >= std::numeric_limits<int32_t>::max() / 3)
+        return LoadStlIndexedResult::NotApplicable;
+    const StlBinaryFacets facets(file.data(), uint32_t((file.size() - HEADER_SIZE) / SIZEOF_STL_FACET));
+    const uint32_t        num_corners = facets.num_corners();
+    if (facets.num_facets() % 2 == 1)
+        // Each edge of a closed manifold is shared by two facets, thus 3 * num_facets == 2 * num_edges.
+        return LoadStlIndexedResult::NotApplicable;
+
+    // 1) Sort the corners by their vertex keys, then by their indices.
+    // The vertex key and the corner index packed into two 64bit integers, so that the records sort fast.
+    struct CornerRecord {
+        uint64_t key01;
+        uint64_t key2_corner;
+        uint32_t corner_idx() const { return uint32_t(key2_corner); }
+        bool     same_vertex(const CornerRecord &rhs) const { return key01 == rhs.key01 && (key2_corner >> 32) == (rhs.key2_corner >> 32); }
+        bool     operator<(const CornerRecord &rhs) const { return key01 < rhs.key01 || (key01 == rhs.key01 && key2_corner < rhs.key2_corner); }
+    };
+    std::vector<CornerRecord> records(num_corners);
+    std::atomic<bool>         has_nan { false };
+    {
+        const uint32_t unit = facets.num_facets() / LOAD_STL_UNIT_NUM + 1;
+        std::string    model_id;
+        for (uint32_t begin = 0; begin < facets.num_facets(); begin += unit) {
+            if (stlFn) {
+                bool cancel = false;
+                stlFn(begin, facets.num_facets(), cancel, model_id);
+                if (cancel)
+                    return LoadStlIndexedResult::Cancelled;
+            }
+            tbb::parallel_for(tbb::blocked_range<uint32_t>(3 * begin, 3 * std::min(begin + unit, facets.num_facets())),
+                [&facets, &records, &has_nan](const tbb::blocked_range<uint32_t> &range) {
+                for (uint32_t corner_idx = range.begin(); corner_idx < range.end(); ++ corner_idx) {
+                    if (facets.vertex(corner_idx).array().isNaN().any())
+                        has_nan = true;
+                    std::array<uint32_t, 3> key = facets.vertex_key(corner_idx);
+                    records[corner_idx] = { (uint64_t(key[0]) << 32) | key[1], (uint64_t(key[2]) << 32) | corner_idx };
+                }
+            });
+        }
+    }
+    if (has_nan)
+        // stl_read() skips facets with NaN vertices, leaving them to be removed as degenerate. Let admesh handle them.
+        return LoadStlIndexedResult::NotApplicable;
+    tbb::parallel_sort(records.begin(), records.end());
+
+    // 2) Weld the vertices: Each corner refers to the first corner with the same vertex coordinates.
+    std::vector<uint32_t> corner_vertex(num_corners);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, records.size()), [&records, &corner_vertex](const tbb::blocked_range<size_t> &range) {
+        size_t first = range.begin();
+        while (first > 0 && records[first - 1].same_vertex(records[range.begin()]))
+            -- first;
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            if (! records[i].same_vertex(records[first]))
+                first = i;
+            corner_vertex[records[i].corner_idx()] = records[first].corner_idx();
+        }
+    });
+    records = {};
+
+    // 3) Pair the half edges. Each half edge is identified by the corner it starts at. A closed oriented manifold has each
+    // undirected edge exactly twice, once in each direction. Otherwise admesh would remove degenerate facets,
+    // fix the edges nearby, remove unconnected facets or reverse some of the facets to fix their orientation.
+    // The half edges are sorted by their undirected edges, thus the pairs of opposite half edges become neighbors.
+    std::vector<uint32_t> opposite(num_corners);
+    {
+        // Undirected edge and the starting corner of the half edge shifted left by one, the lowest bit set if the edge is reversed.
+        std::vector<std::pair<uint64_t, uint32_t>> half_edges(num_corners);
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, num_corners), [&half_edges, &corner_vertex](const tbb::blocked_range<uint32_t> &range) {
+            for (uint32_t corner_idx = range.begin(); corner_idx < range.end(); ++ corner_idx) {
+                uint32_t a = corner_vertex[corner_idx];
+                uint32_t b = corner_vertex[corner_idx % 3 == 2 ? corner_idx - 2 : corner_idx + 1];
+                half_edges[corner_idx] = a < b ? std::make_pair((uint64_t(a) << 32) | b, corner_idx << 1) : std::make_pair((uint64_t(b) << 32) | a, (corner_idx << 1) | 1);
+            }
+        });
+        tbb::parallel_sort(half_edges.begin(), half_edges.end(), [](const auto &l, const auto &r) { return l.first < r.first; });
+        std::atomic<bool> manifold { true };
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, half_edges.size() / 2), [&half_edges, &opposite, &manifold](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = 2 * range.begin(); i < 2 * range.end() && manifold; i += 2) {
+                const auto &he1 = half_edges[i];
+                const auto &he2 = half_edges[i + 1];
+                // A degenerate facet produces a half edge starting and ending at the same vertex.
+                if (he1.first != he2.first || (i + 2 < half_edges.size() && half_edges[i + 2].first == he1.first) ||
+                    uint32_t(he1.first >> 32) == uint32_t(he1.first) || (he1.second & 1) == (he2.second & 1))
+                    manifold = false;
+                else {
+                    opposite[he1.second >> 1] = he2.second >> 1;
+                    opposite[he2.second >> 1] = he1.second >> 1;
+                }
+            }
+        });
+        if (! manifold)
+            return LoadStlIndexedResult::NotApplicable;
+    }
+
+    // 4) Each vertex has to have a single fan of facets around it, otherwise stl_generate_shared_vertices() would split it.
+    // Walk the fan starting at the first corner of each vertex, the fans of all vertices have to cover all corners.
+    size_t num_corners_in_fans = tbb::parallel_reduce(tbb::blocked_range<uint32_t>(0, num_corners), size_t(0),
+        [&corner_vertex, &opposite, num_corners](const tbb::blocked_range<uint32_t> &range, size_t num) {
+        for (uint32_t corner_idx = range.begin(); corner_idx < range.end(); ++ corner_idx)
+            if (corner_vertex[corner_idx] == corner_idx) {
+                uint32_t i = corner_idx;
+                do {
+                    // The opposite half edge ends at the vertex of this corner.
+                    uint32_t opposite_idx = opposite[i];
+                    i = opposite_idx % 3 == 2 ? opposite_idx - 2 : opposite_idx + 1;
+                    ++ num;
+                } while (i != corner_idx && num <= num_corners);
+            }
+        return num;
+    }, std::plus<size_t>());
+    if (num_corners_in_fans != num_corners)
+        return LoadStlIndexedResult::NotApplicable;
+
+    // 5) Reverse the facets as admesh would. stl_fix_normal_directions() has nothing to fix on a consistently oriented mesh,
+    // though it reverses all facets of a connected part if the normal stored with the first facet of that part points backwards.
+    // The parts are labeled by their first facets, which are the roots of the union-find below.
+    std::vector<uint32_t> facet_part(facets.num_facets());
+    for (uint32_t i = 0; i < facets.num_facets(); ++ i)
+        facet_part[i] = i;
+    auto find_part = [&facet_part](uint32_t i) {
+        while (facet_part[i] != i)
+            i = facet_part[i] = facet_part[facet_part[i]];
+        return i;
+    };
+    for (uint32_t corner_idx = 0; corner_idx < num_corners; ++ corner_idx)
+        if (uint32_t other_idx = opposite[corner_idx]; corner_idx < other_idx) {
+            uint32_t a = find_part(corner_idx / 3);
+            uint32_t b = find_part(other_idx / 3);
+            if (a != b)
+                facet_part[std::max(a, b)] = std::min(a, b);
+        }
+    std::vector<char> facet_reversed(facets.num_facets());
+    for (uint32_t i = 0; i < facets.num_facets(); ++ i) {
+        uint32_t part = find_part(i);
+        facet_reversed[i] = part == i ? stl_stored_normal_backwards(facets.facet(i, false)) : facet_reversed[part];
+    }
+    facet_part = {};
+    {
+        // stl_calculate_volume() reverses all facets if the volume is negative. The volume is summed up sequentially
+        // in the same order and with the same precision as get_volume() of admesh does, so that its sign is the same.
+        stl_vertex p0     = facets.facet(0, facet_reversed[0]).vertex[0];
+        float      volume = 0.f;
+        for (uint32_t i = 0; i < facets.num_facets(); ++ i) {
+            stl_facet facet = facets.facet(i, facet_reversed[i]);
+            stl_calculate_normal(facet.normal, &facet);
+            stl_normalize_vector(facet.normal);
+            float height = facet.normal.dot(facet.vertex[0] - p0);
+            float area   = get_area(&facet);
+            volume += (area * height) / 3.0f;
+        }
+        if (volume < 0.f)
+            for (char &reversed : facet_reversed)
+                reversed = ! reversed;
+    }
+
+    // 6) Number the vertices in the order of their first corners, as stl_generate_shared_vertices() does.
+    std::vector<uint32_t> &vertex_idx = opposite;
+    std::fill(vertex_idx.begin(), vertex_idx.end(), invalid);
+    its.clear();
+    its.indices.assign(facets.num_facets(), stl_triangle_vertex_indices());
+    for (uint32_t i = 0; i < facets.num_facets(); ++ i)
+        for (int j = 0; j < 3; ++ j) {
+            uint32_t corner_idx = 3 * i + (facet_reversed[i] && j < 2 ? 1 - j : j);
+            uint32_t &idx       = vertex_idx[corner_vertex[corner_idx]];
+            if (idx == invalid) {
+                idx = uint32_t(its.vertices.size());
+                its.vertices.emplace_back(facets.vertex(corner_idx));
+            }
+            its.indices[i](j) = int(idx);
+        }
+    return LoadStlIndexedResult::Loaded;
+#endif
+}
+
 bool store_stl(const char *path, TriangleMesh *mesh, bool binary)
 {
     if (binary)
@@ -12,6 +12,20 @@ class ModelObject;
 // Load an STL file into a provided model.
 extern bool load_stl(const char *path, Model *model, const char *object_name = nullptr, ImportstlProgressFn stlFn = nullptr);
 
+enum class LoadStlIndexedResult {
+    Loaded,
+    Cancelled,
+    // Not a binary STL or not a closed oriented manifold, it has to be loaded through stl_open() and repaired by admesh.
+    NotApplicable,
+};
+
+// Fast path of TriangleMesh::ReadSTLFile(path, true) for binary STL files of closed, consistently oriented manifold meshes:
+// The file is memory mapped, the facet records are read in place and the vertices with equal coordinates are welded in parallel,
+// without going through stl_file. The mesh is the same as the one produced by admesh, including the vertex order
+// and the facets reversed by stl_fix_normal_directions() and stl_calculate_volume().
+// its is only written to if Loaded is returned.
+extern LoadStlIndexedResult load_stl_binary_indexed(const char *path, indexed_triangle_set &its, ImportstlProgressFn stlFn = nullptr);
+
 extern bool store_stl(const char *path, TriangleMesh *mesh, bool binary);
 extern bool store_stl(const char *path, ModelObject *model_object, bool binary);
 extern bool store_stl(const char *path, Model *model, bool binary);
@@ -0,0 +1,610 @@
+#include "../libslic3r.h"
+#include "../Exception.hpp"
+#include "../ExPolygon.hpp"
+#include "../ExtrusionEntity.hpp"
+#include "../ExtrusionEntityCollection.hpp"
+#include "../Layer.hpp"
+#include "../Print.hpp"
+#include "../Surface.hpp"
+
+#include "SliceCache.hpp"
+
+#include <cstring>
+
+#include <boost/log/trivial.hpp>
+
+#include <tbb/parallel_for.h>
+
+namespace Slic3r {
+namespace SliceCache {
+
+enum class EntityType : uint8_t {
+    Path,
+    MultiPath,
+    Loop,
+    Collection,
+};
+
+void BinaryWriter::put_varint(uint64_t v)
+{
+    while (v >= 0x80) {
+        m_out.push_back(char(uint8_t(v) | 0x80));
+        v >>= 7;
+    }
+    m_out.push_back(char(uint8_t(v)));
+}
+
+void BinaryWriter::put_string(const std::string &s)
+{
+    this->put_varint(s.size());
+    m_out.append(s);
+}
+
+void BinaryWriter::put_points(const Points &pts)
+{
+    this->put_varint(pts.size());
+    Point prev(0, 0);
+    for (const Point &pt : pts) {
+        this->put_svarint(int64_t(pt.x()) - int64_t(prev.x()));
+        this->put_svarint(int64_t(pt.y()) - int64_t(prev.y()));
+        prev = pt;
+    }
+}
+
+void BinaryReader::check(size_t size) const
+{
+    if (size_t(m_end - m_ptr) < size)
+        throw Slic3r::FileIOError("Binary slicing cache is truncated or corrupted");
+}
+
+uint64_t BinaryReader::get_varint()
+{
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t b = this->get_u8();
+        v |= uint64_t(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+            return v;
+    }
+    throw Slic3r::FileIOError("Binary slicing cache contains an invalid varint");
+}
+
+std::string BinaryReader::get_string()
+{
+    size_t len = this->get_count();
+    std::string out(m_ptr, len);
+    m_ptr += len;
+    return out;
+}
+
+void BinaryReader::get_raw(void *data, size_t size)
+{
+    this->check(size);
+    memcpy(data, m_ptr, size);
+    m_ptr += size;
+}
+
+size_t BinaryReader::get_count()
+{
+    uint64_t cnt = this->get_varint();
+    this->check(size_t(cnt));
+    return size_t(cnt);
+}
+
+void BinaryReader::get_points(Points &pts)
+{
+    size_t cnt = this->get_count();
+    pts.clear();
+    pts.reserve(cnt);
+    int64_t x = 0, y = 0;
+    for (size_t i = 0; i < cnt; ++ i) {
+        x += this->get_svarint();
+        y += this->get_svarint();
+        pts.emplace_back(coord_t(x), coord_t(y));
+    }
+}
+
+static void write_bbox(BinaryWriter &out, const BoundingBox &bbox)
+{
+    out.put_bool(bbox.defined);
+    out.put_svarint(bbox.min.x());
+    out.put_svarint(bbox.min.y());
+    out.put_svarint(bbox.max.x());
+    out.put_svarint(bbox.max.y());
+}
+
+static void read_bbox(BinaryReader &in, BoundingBox &bbox)
+{
+    bbox.defined  = in.get_bool();
+    bbox.min.x()  = coord_t(in.get_svarint());
+    bbox.min.y()  = coord_t(in.get_svarint());
+    bbox.max.x()  = coord_t(in.get_svarint());
+    bbox.max.y()  = coord_t(in.get_svarint());
+}
+
+static void write_expolygon(BinaryWriter &out, const ExPolygon &expolygon)
+{
+    out.put_points(expolygon.contour.points);
+    out.put_varint(expolygon.holes.size());
+    for (const Polygon &hole : expolygon.holes)
+        out.put_points(hole.points);
+}
+
+static void read_expolygon(BinaryReader &in, ExPolygon &expolygon)
+{
+    in.get_points(expolygon.contour.points);
+    expolygon.holes.assign(in.get_count(), Polygon());
+    for (Polygon &hole : expolygon.holes)
+        in.get_points(hole.points);
+}
+
+void write_expolygons(BinaryWriter &out, const ExPolygons &expolygons)
+{
+    out.put_varint(expolygons.size());
+    for (const ExPolygon &expolygon : expolygons)
+        write_expolygon(out, expolygon);
+}
+
+void read_expolygons(BinaryReader &in, ExPolygons &expolygons)
+{
+    expolygons.assign(in.get_count(), ExPolygon());
+    for (ExPolygon &expolygon : expolygons)
+        read_expolygon(in, expolygon);
+}
+
+static void write_surfaces(BinaryWriter &out, const Surfaces &surfaces)
+{
+    out.put_varint(surfaces.size());
+    for (const Surface &surface : surfaces) {
+        write_expolygon(out, surface.expolygon);
+        out.put_varint(surface.surface_type);
+        out.put_double(surface.thickness);
+        out.put_varint(surface.thickness_layers);
+        out.put_double(surface.bridge_angle);
+        out.put_varint(surface.extra_perimeters);
+    }
+}
+
+static void read_surfaces(BinaryReader &in, Surfaces &surfaces)
+{
+    size_t cnt = in.get_count();
+    surfaces.clear();
+    surfaces.reserve(cnt);
+    for (size_t i = 0; i < cnt; ++ i) {
+        ExPolygon expolygon;
+        read_expolygon(in, expolygon);
+        Surface surface(SurfaceType(in.get_varint()), std::move(expolygon));
+        surface.thickness        = in.get_double();
+        surface.thickness_layers = (unsigned short)in.get_varint();
+        surface.bridge_angle     = in.get_double();
+        surface.extra_perimeters = (unsigned short)in.get_varint();
+        surfaces.emplace_back(std::move(surface));
+    }
+}
+
+static void write_arc(BinaryWriter &out, const ArcSegment &arc)
+{
+    out.put_double(arc.length);
+    out.put_double(arc.angle_radians);
+    out.put_double(arc.polar_start_theta);
+    out.put_double(arc.polar_end_theta);
+    out.put_svarint(arc.start_point.x());
+    out.put_svarint(arc.start_point.y());
+    out.put_svarint(arc.end_point.x());
+    out.put_svarint(arc.end_point.y());
+    out.put_u8(uint8_t(arc.direction));
+    out.put_double(arc.radius);
+    out.put_svarint(arc.center.x());
+    out.put_svarint(arc.center.y());
+}
+
+static void read_arc(BinaryReader &in, ArcSegment &arc)
+{
+    arc.is_arc              = true;
+    arc.length              = in.get_double();
+    arc.angle_radians       = in.get_double();
+    arc.polar_start_theta   = in.get_double();
+    arc.polar_end_theta     = in.get_double();
+    arc.start_point.x()     = coord_t(in.get_svarint());
+    arc.start_point.y()     = coord_t(in.get_svarint());
+    arc.end_point.x()       = coord_t(in.get_svarint());
+    arc.end_point.y()       = coord_t(in.get_svarint());
+    arc.direction           = ArcDirection(in.get_u8());
+    arc.radius              = in.get_double();
+    arc.center.x()          = coord_t(in.get_svarint());
+    arc.center.y()          = coord_t(in.get_svarint());
+}
+
+static void write_polyline(BinaryWriter &out, const Polyline &polyline)
+{
+    out.put_points(polyline.points);
+    out.put_varint(polyline.fitting_result.size());
+    for (const PathFittingData &fitting : polyline.fitting_result) {
+        out.put_varint(fitting.start_point_index);
+        out.put_varint(fitting.end_point_index);
+        out.put_u8(uint8_t(fitting.path_type));
+        // Same as the JSON format, arc data are only stored for arcs.
+        out.put_bool(fitting.arc_data.is_arc);
+        if (fitting.arc_data.is_arc)
+            write_arc(out, fitting.arc_data);
+    }
+}
+
+static void read_polyline(BinaryReader &in, Polyline &polyline)
+{
+    in.get_points(polyline.points);
+    size_t cnt = in.get_count();
+    polyline.fitting_result.clear();
+    polyline.fitting_result.reserve(cnt);
+    for (size_t i = 0; i < cnt; ++ i) {
+        PathFittingData fitting;
+        fitting.start_point_index = size_t(in.get_varint());
+        fitting.end_point_index   = size_t(in.get_varint());
+        fitting.path_type         = EMovePathType(in.get_u8());
+        if (in.get_bool())
+            read_arc(in, fitting.arc_data);
+        polyline.fitting_result.emplace_back(std::move(fitting));
+    }
+}
+
+static void write_path(BinaryWriter &out, const ExtrusionPath &path)
+{
+    write_polyline(out, path.polyline);
+    out.put_svarint(path.overhang_degree);
+    out.put_svarint(path.curve_degree);
+    out.put_double(path.mm3_per_mm);
+    out.put_float(path.width);
+    out.put_float(path.height);
+    out.put_u8(uint8_t(path.role()));
+    out.put_bool(path.is_force_no_extrusion());
+}
+
+static void read_path(BinaryReader &in, ExtrusionPath &path)
+{
+    read_polyline(in, path.polyline);
+    path.overhang_degree = int(in.get_svarint());
+    path.curve_degree    = int(in.get_svarint());
+    path.mm3_per_mm      = in.get_double();
+    path.width           = in.get_float();
+    path.height          = in.get_float();
+    path.set_extrusion_role(ExtrusionRole(in.get_u8()));
+    path.set_force_no_extrusion(in.get_bool());
+}
+
+static void write_paths(BinaryWriter &out, const ExtrusionPaths &paths)
+{
+    out.put_varint(paths.size());
+    for (const ExtrusionPath &path : paths)
+        write_path(out, path);
+}
+
+static void read_paths(BinaryReader &in, ExtrusionPaths &paths)
+{
+    paths.assign(in.get_count(), ExtrusionPath());
+    for (ExtrusionPath &path : paths)
+        read_path(in, path);
+}
+
+static void write_collection(BinaryWriter &out, const ExtrusionEntityCollection &collection);
+static void read_collection(BinaryReader &in, ExtrusionEntityCollection &collection);
+
+static void write_entity(BinaryWriter &out, const ExtrusionEntity *entity)
+{
+    // The order of the tests matches convert_extrusion_to_json(), classes derived from ExtrusionPath are stored as ExtrusionPath.
+    if (const auto *collection = dynamic_cast<const ExtrusionEntityCollection*>(entity)) {
+        out.put_u8(uint8_t(EntityType::Collection));
+        write_collection(out, *collection);
+    } else if (const auto *path = dynamic_cast<const ExtrusionPath*>(entity)) {
+        out.put_u8(uint8_t(EntityType::Path));
+        write_path(out, *path);
+    } else if (const auto *multipath = dynamic_cast<const ExtrusionMultiPath*>(entity)) {
+        out.put_u8(uint8_t(EntityType::MultiPath));
+        write_paths(out, multipath->paths);
+    } else if (const auto *loop = dynamic_cast<const ExtrusionLoop*>(entity)) {
+        out.put_u8(uint8_t(EntityType::Loop));
+        out.put_u8(uint8_t(loop->loop_role()));
+        write_paths(out, loop->paths);
+    } else
+        throw Slic3r::RuntimeError("Unknown extrusion entity type to be stored into the slicing cache");
+}
+
+static ExtrusionEntity* read_entity(BinaryReader &in)
+{
+    switch (EntityType(in.get_u8())) {
+    case EntityType::Path: {
+        auto path = std::make_unique<ExtrusionPath>();
+        read_path(in, *path);
+        return path.release();
+    }
+    case EntityType::MultiPath: {
+        auto multipath = std::make_unique<ExtrusionMultiPath>();
+        read_paths(in, multipath->paths);
+        return multipath.release();
+    }
+    case EntityType::Loop: {
+        auto loop = std::make_unique<ExtrusionLoop>();
+        loop->set_loop_role(ExtrusionLoopRole(in.get_u8()));
+        read_paths(in, loop->paths);
+        return loop.release();
+    }
+    case EntityType::Collection: {
+        auto collection = std::make_unique<ExtrusionEntityCollection>();
+        read_collection(in, *collection);
+        return collection.release();
+    }
+    default:
+        throw Slic3r::FileIOError("Binary slicing cache contains an unknown extrusion entity type");
+    }
+}
+
+static void write_collection(BinaryWriter &out, const ExtrusionEntityCollection &collection)
+{
+    out.put_bool(collection.no_sort);
+    out.put_varint(collection.entities.size());
+    for (const ExtrusionEntity *entity : collection.entities)
+        write_entity(out, entity);
+}
+
+static void read_collection(BinaryReader &in, ExtrusionEntityCollection &collection)
+{
+    collection.no_sort = in.get_bool();
+    size_t cnt = in.get_count();
+    collection.entities.reserve(cnt);
+    for (size_t i = 0; i < cnt; ++ i)
+        collection.entities.emplace_back(read_entity(in));
+}
+
+static void write_layer_region(BinaryWriter &out, const LayerRegion &layerm)
+{
+    write_surfaces(out, layerm.slices.surfaces);
+    write_expolygons(out, layerm.raw_slices);
+    write_collection(out, layerm.thin_fills);
+    write_expolygons(out, layerm.fill_expolygons);
+    write_surfaces(out, layerm.fill_surfaces.surfaces);
+    write_expolygons(out, layerm.fill_no_overlap_expolygons);
+    out.put_varint(layerm.unsupported_bridge_edges.size());
+    for (const Polyline &polyline : layerm.unsupported_bridge_edges)
+        write_polyline(out, polyline);
+    write_collection(out, layerm.perimeters);
+    write_collection(out, layerm.fills);
+}
+
+static void read_layer_region(BinaryReader &in, LayerRegion &layerm)
+{
+    read_surfaces(in, layerm.slices.surfaces);
+    read_expolygons(in, layerm.raw_slices);
+    read_collection(in, layerm.thin_fills);
+    read_expolygons(in, layerm.fill_expolygons);
+    read_surfaces(in, layerm.fill_surfaces.surfaces);
+    read_expolygons(in, layerm.fill_no_overlap_expolygons);
+    layerm.unsupported_bridge_edges.assign(in.get_count(), Polyline());
+    for (Polyline &polyline : layerm.unsupported_bridge_edges)
+        read_polyline(in, polyline);
+    read_collection(in, layerm.perimeters);
+    read_collection(in, layerm.fills);
+}
+
+static void write_layer_data(BinaryWriter &out, const Layer &layer)
+{
+    write_expolygons(out, layer.lslices);
+    out.put_varint(layer.lslices_bboxes.size());
+    for (const BoundingBox &bbox : layer.lslices_bboxes)
+        write_bbox(out, bbox);
+    write_expolygons(out, layer.loverhangs);
+    write_bbox(out, layer.loverhangs_bbox);
+    out.put_varint(layer.regions().size());
+    for (const LayerRegion *layerm : layer.regions())
+        write_layer_region(out, *layerm);
+}
+
+static void read_layer_data(BinaryReader &in, Layer &layer)
+{
+    read_expolygons(in, layer.lslices);
+    layer.lslices_bboxes.assign(in.get_count(), BoundingBox());
+    for (BoundingBox &bbox : layer.lslices_bboxes)
+        read_bbox(in, bbox);
+    read_expolygons(in, layer.loverhangs);
+    read_bbox(in, layer.loverhangs_bbox);
+    size_t num_regions = in.get_count();
+    if (num_regions != layer.regions().size())
+        throw Slic3r::FileIOError("Binary slicing cache does not match the regions of the layer");
+    for (LayerRegion *layerm : layer.regions())
+        read_layer_region(in, *layerm);
+}
+
+static void write_support_layer_data(BinaryWriter &out, const SupportLayer &layer)
+{
+    write_layer_data(out, layer);
+    out.put_varint(layer.support_type);
+    write_expolygons(out, layer.support_islands);
+    write_collection(out, layer.support_fills);
+}
+
+static void read_support_layer_data(BinaryReader &in, SupportLayer &layer)
+{
+    read_layer_data(in, layer);
+    layer.support_type = SupportInnerType(in.get_varint());
+    read_expolygons(in, layer.support_islands);
+    read_collection(in, layer.support_fills);
+}
+
+static void write_layer_entry(BinaryWriter &out, const LayerEntry &entry)
+{
+    out.put_svarint(entry.id);
+    out.put_double(entry.height);
+    out.put_double(entry.print_z);
+    out.put_double(entry.slice_z);
+    out.put_varint(entry.interface_id);
+    out.put_varint(entry.region_config_hashes.size());
+    for (size_t hash : entry.region_config_hashes)
+        out.put_u64(hash);
+    out.put_u64(entry.offset);
+    out.put_u64(entry.size);
+}
+
+static void read_layer_entry(BinaryReader &in, LayerEntry &entry)
+{
+    entry.id           = int(in.get_svarint());
+    entry.height       = in.get_double();
+    entry.print_z      = in.get_double();
+    entry.slice_z      = in.get_double();
+    entry.interface_id = size_t(in.get_varint());
+    entry.region_config_hashes.assign(in.get_count(), 0);
+    for (size_t &hash : entry.region_config_hashes)
+        hash = size_t(in.get_u64());
+    entry.offset       = in.get_u64();
+    entry.size         = in.get_u64();
+}
+
+std::string encode_object(const PrintObject &object, const std::string &name, size_t identify_id, const std::vector<groupedVolumeSlices> &first_layer_groups,
+                          bool with_support_layers)
+{
+    // Encode the layer payloads in parallel.
+    std::vector<std::string> layer_payloads(object.layer_count());
+    std::vector<std::string> support_layer_payloads(with_support_layers ? object.support_layer_count() : 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, layer_payloads.size() + support_layer_payloads.size()),
+        [&object, &layer_payloads, &support_layer_payloads](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                if (i < layer_payloads.size()) {
+                    BinaryWriter out(layer_payloads[i]);
+                    write_layer_data(out, *object.get_layer(int(i)));
+                } else {
+                    size_t       idx = i - layer_payloads.size();
+                    BinaryWriter out(support_layer_payloads[idx]);
+                    write_support_layer_data(out, *object.support_layers()[idx]);
+                }
+            }
+        });
+
+    std::vector<LayerEntry> layers(layer_payloads.size());
+    for (size_t i = 0; i < layers.size(); ++ i) {
+        const Layer &layer = *object.get_layer(int(i));
+        LayerEntry  &entry = layers[i];
+        entry.id      = int(layer.id());
+        entry.height  = layer.height;
+        entry.print_z = layer.print_z;
+        entry.slice_z = layer.slice_z;
+        for (const LayerRegion *layerm : layer.regions())
+            entry.region_config_hashes.emplace_back(layerm->region().config_hash());
+        entry.size    = layer_payloads[i].size();
+    }
+    std::vector<LayerEntry> support_layers(support_layer_payloads.size());
+    for (size_t i = 0; i < support_layers.size(); ++ i) {
+        const SupportLayer &layer = *object.support_layers()[i];
+        LayerEntry         &entry = support_layers[i];
+        entry.id           = int(layer.id());
+        entry.height       = layer.height;
+        entry.print_z      = layer.print_z;
+        entry.slice_z      = layer.slice_z;
+        entry.interface_id = layer.interface_id();
+        entry.size         = support_layer_payloads[i].size();
+    }
+
+    // The payload offsets are stored in a fixed width, thus the directory size does not depend on them.
+    auto write_directory = [&](std::string &directory) {
+        BinaryWriter out(directory);
+        out.put_string(name);
+        out.put_varint(identify_id);
+        out.put_varint(layers.size());
+        for (const LayerEntry &entry : layers)
+            write_layer_entry(out, entry);
+        out.put_varint(support_layers.size());
+        for (const LayerEntry &entry : support_layers)
+            write_layer_entry(out, entry);
+        out.put_varint(first_layer_groups.size());
+        for (const groupedVolumeSlices &group : first_layer_groups) {
+            out.put_svarint(group.groupId);
+            out.put_varint(group.volume_ids.size());
+            for (const ObjectID &volume_id : group.volume_ids)
+                out.put_varint(volume_id.id);
+            write_expolygons(out, group.slices);
+        }
+    };
+    std::string directory;
+    write_directory(directory);
+
+    const uint64_t header_size = sizeof(BinaryMagic) + sizeof(uint32_t) + sizeof(uint64_t);
+    uint64_t       offset      = header_size + directory.size();
+    for (LayerEntry &entry : layers) {
+        entry.offset = offset;
+        offset += entry.size;
+    }
+    for (LayerEntry &entry : support_layers) {
+        entry.offset = offset;
+        offset += entry.size;
+    }
+    directory.clear();
+    write_directory(directory);
+    assert(header_size + directory.size() == (layers.empty() ? (support_layers.empty() ? offset : support_layers.front().offset) : layers.front().offset));
+
+    std::string  data;
+    data.reserve(size_t(offset));
+    BinaryWriter out(data);
+    out.put_raw(BinaryMagic, sizeof(BinaryMagic));
+    out.put_u32(BinaryVersion);
+    out.put_u64(directory.size());
+    out.put_raw(directory.data(), directory.size());
+    for (const std::string &payload : layer_payloads)
+        out.put_raw(payload.data(), payload.size());
+    for (const std::string &payload : support_layer_payloads)
+        out.put_raw(payload.data(), payload.size());
+    assert(data.size() == offset);
+    return data;
+}
+
+ObjectEntry decode_object_directory(const char *data, size_t size)
+{
+    BinaryReader header(data, data + size);
+    char         magic[sizeof(BinaryMagic)];
+    header.get_raw(magic, sizeof(magic));
+    if (memcmp(magic, BinaryMagic, sizeof(BinaryMagic)) != 0)
+        throw Slic3r::FileIOError("Not a binary slicing cache");
+    uint32_t version = header.get_u32();
+    if (version != BinaryVersion)
+        throw Slic3r::FileIOError("Unsupported version " + std::to_string(version) + " of the binary slicing cache");
+    uint64_t directory_size = header.get_u64();
+    const char *directory_begin = data + sizeof(BinaryMagic) + sizeof(uint32_t) + sizeof(uint64_t);
+    if (directory_size > uint64_t(data + size - directory_begin))
+        throw Slic3r::FileIOError("Binary slicing cache is truncated or corrupted");
+
+    BinaryReader in(directory_begin, directory_begin + directory_size);
+    ObjectEntry  object;
+    object.name        = in.get_string();
+    object.identify_id = size_t(in.get_varint());
+    auto read_entries = [&in, size](std::vector<LayerEntry> &entries) {
+        entries.assign(in.get_count(), LayerEntry());
+        for (LayerEntry &entry : entries) {
+            read_layer_entry(in, entry);
+            if (entry.offset > size || entry.size > size - entry.offset)
+                throw Slic3r::FileIOError("Binary slicing cache is truncated or corrupted");
+        }
+    };
+    read_entries(object.layers);
+    read_entries(object.support_layers);
+    object.first_layer_groups.assign(in.get_count(), groupedVolumeSlices());
+    for (groupedVolumeSlices &group : object.first_layer_groups) {
+        group.groupId = int(in.get_svarint());
+        group.volume_ids.assign(in.get_count(), ObjectID());
+        for (ObjectID &volume_id : group.volume_ids)
+            volume_id.id = size_t(in.get_varint());
+        read_expolygons(in, group.slices);
+    }
+    return object;
+}
+
+void decode_layer(const char *data, size_t size, const LayerEntry &entry, Layer &layer)
+{
+    assert(entry.offset + entry.size <= size);
+    BinaryReader in(data + entry.offset, data + entry.offset + entry.size);
+    read_layer_data(in, layer);
+}
+
+void decode_support_layer(const char *data, size_t size, const LayerEntry &entry, SupportLayer &layer)
+{
+    assert(entry.offset + entry.size <= size);
+    BinaryReader in(data + entry.offset, data + entry.offset + entry.size);
+    read_support_layer_data(in, layer);
+}
+
+} // namespace SliceCache
+} // namespace Slic3r
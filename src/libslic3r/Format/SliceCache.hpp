@@ -0,0 +1,137 @@
+#ifndef slic3r_Format_SliceCache_hpp_
+#define slic3r_Format_SliceCache_hpp_
+
+// Compact binary format of the sliced data of a PrintObject (layers, support layers, first layer groups),
+// an alternative to the JSON dump of Print::export_cached_data() / Print::load_cached_data().
+//
+// File layout (all fixed width integers little endian):
+//   magic[8] | u32 version | u64 directory size | directory | layer payloads ...
+// The directory contains the identification of the object, the parameters of all layers and support layers
+// and a fixed width (offset, size) span of each layer payload, so that the payloads may be decoded
+// in parallel directly from a memory mapped file. Inside the payloads, integers are varint coded,
+// signed integers zigzag coded and points delta coded against the previous point of the same array.
+
+#include "../libslic3r.h"
+#include "../Point.hpp"
+#include "../Print.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Slic3r {
+
+class ExPolygon;
+class Layer;
+class SupportLayer;
+
+namespace SliceCache {
+
+constexpr const char     BinaryMagic[8] = { 'O', 'R', 'C', 'A', 'S', 'L', 'C', 'B' };
+// Bump on any incompatible change of the layout, older caches are then rejected and the plate is resliced.
+constexpr uint32_t       BinaryVersion  = 1;
+constexpr const char    *BinaryExtension = ".bin";
+
+// Append only encoder of a binary stream.
+class BinaryWriter
+{
+public:
+    explicit BinaryWriter(std::string &out) : m_out(out) {}
+
+    void put_u8(uint8_t v)              { m_out.push_back(char(v)); }
+    void put_bool(bool v)               { this->put_u8(v ? 1 : 0); }
+    void put_varint(uint64_t v);
+    // Zigzag coded, so that small negative numbers are short as well.
+    void put_svarint(int64_t v)         { this->put_varint((uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+    // Fixed width, to be patched later or to be read without decoding the preceding data.
+    void put_u32(uint32_t v)            { this->put_raw(&v, sizeof(v)); }
+    void put_u64(uint64_t v)            { this->put_raw(&v, sizeof(v)); }
+    void put_float(float v)             { this->put_raw(&v, sizeof(v)); }
+    void put_double(double v)           { this->put_raw(&v, sizeof(v)); }
+    void put_string(const std::string &s);
+    void put_raw(const void *data, size_t size) { m_out.append(reinterpret_cast<const char*>(data), size); }
+    // Length prefixed array of points, each point delta coded against the previous one.
+    void put_points(const Points &pts);
+
+    size_t size() const { return m_out.size(); }
+
+private:
+    std::string &m_out;
+};
+
+// Decoder of a stream written by BinaryWriter. Throws Slic3r::FileIOError on reading past the end of data.
+class BinaryReader
+{
+public:
+    BinaryReader(const char *begin, const char *end) : m_ptr(begin), m_end(end) {}
+
+    uint8_t     get_u8()                { this->check(1); return uint8_t(*m_ptr ++); }
+    bool        get_bool()              { return this->get_u8() != 0; }
+    uint64_t    get_varint();
+    int64_t     get_svarint()           { uint64_t v = this->get_varint(); return int64_t(v >> 1) ^ - int64_t(v & 1); }
+    uint32_t    get_u32()               { uint32_t v; this->get_raw(&v, sizeof(v)); return v; }
+    uint64_t    get_u64()               { uint64_t v; this->get_raw(&v, sizeof(v)); return v; }
+    float       get_float()             { float v; this->get_raw(&v, sizeof(v)); return v; }
+    double      get_double()            { double v; this->get_raw(&v, sizeof(v)); return v; }
+    std::string get_string();
+    void        get_raw(void *data, size_t size);
+    void        get_points(Points &pts);
+    // Number of items of a length prefixed array, validated against the remaining data
+    // (each item occupies at least one byte) to fail early on a corrupted file.
+    size_t      get_count();
+
+    bool        eof() const             { return m_ptr == m_end; }
+
+private:
+    void        check(size_t size) const;
+
+    const char *m_ptr;
+    const char *m_end;
+};
+
+void write_expolygons(BinaryWriter &out, const ExPolygons &expolygons);
+void read_expolygons(BinaryReader &in, ExPolygons &expolygons);
+
+// Parameters of a layer, stored in the directory, as they are needed to create the layers
+// before their payloads could be decoded in parallel.
+struct LayerEntry
+{
+    int                     id              { 0 };
+    double                  height          { 0. };
+    double                  print_z         { 0. };
+    double                  slice_z         { 0. };
+    // Support layers only.
+    size_t                  interface_id    { 0 };
+    // Object layers only: PrintRegion::config_hash() of the LayerRegions in the order of Layer::regions().
+    std::vector<size_t>     region_config_hashes;
+    // Span of the layer payload, relative to the start of the file.
+    uint64_t                offset          { 0 };
+    uint64_t                size            { 0 };
+};
+
+struct ObjectEntry
+{
+    std::string                         name;
+    size_t                              identify_id { 0 };
+    std::vector<LayerEntry>             layers;
+    std::vector<LayerEntry>             support_layers;
+    // ObjectID::id of groupedVolumeSlices::volume_ids are indices of ModelVolumes inside the ModelObject.
+    std::vector<groupedVolumeSlices>    first_layer_groups;
+};
+
+// Encode all layers and optionally support layers of a PrintObject into a single buffer, layers are encoded in parallel.
+// first_layer_groups shall already have the volume IDs converted to volume indices.
+std::string encode_object(const PrintObject &object, const std::string &name, size_t identify_id, const std::vector<groupedVolumeSlices> &first_layer_groups,
+                          bool with_support_layers = true);
+// Decode the header and directory of a buffer produced by encode_object().
+// Throws Slic3r::FileIOError if the data is not a binary slicing cache of a compatible version.
+ObjectEntry decode_object_directory(const char *data, size_t size);
+// Decode a payload of a single layer into a Layer with the LayerRegions already created.
+// May be called for multiple layers in parallel.
+void        decode_layer(const char *data, size_t size, const LayerEntry &entry, Layer &layer);
+void        decode_support_layer(const char *data, size_t size, const LayerEntry &entry, SupportLayer &layer);
+
+} // namespace SliceCache
+} // namespace Slic3r
+
+#endif /* slic3r_Format_SliceCache_hpp_ */
@@ -31,6 +31,7 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/nowide/fstream.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/spirit/include/karma.hpp>
@@ -5425,6 +5426,7 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
         bool m_skip_auxiliary { false };    // skip normal axuiliary files
         bool m_use_loaded_id { false };        // whether to use loaded id for identify_id
         bool m_share_mesh { false };        // whether to share mesh between objects
+        int  m_compression_level { MZ_DEFAULT_LEVEL }; // deflate level of the models and G-codes
         std::string m_thumbnail_middle = PRINTER_THUMBNAIL_MIDDLE_FILE;
         std::string m_thumbnail_small  = PRINTER_THUMBNAIL_SMALL_FILE;
         std::map<void const *, std::pair<ObjectData*, ModelVolume const *>> m_shared_meshes;
@@ -5521,6 +5523,7 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
         m_from_backup_save = store_params.strategy & SaveStrategy::Backup;
 
         m_use_loaded_id = store_params.strategy & SaveStrategy::UseLoadedId;
+        m_compression_level = store_params.compression_level < 0 ? int(MZ_DEFAULT_LEVEL) : std::min(store_params.compression_level, int(MZ_UBER_COMPRESSION));
 
         if (auto info = store_params.model->model_info) {
             if (auto iter = info->metadata_items.find("Thumbnail_Small"); iter != info->metadata_items.end())
@@ -5921,40 +5924,7 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
             }
         }
 
-        // add plate_N.gcode.md5 to file
-        if (!m_skip_static && m_save_gcode) {
-            for (int i = 0; i < plate_data_list.size(); i++) {
-                PlateData *plate_data = plate_data_list[i];
-                if (!plate_data->gcode_file.empty() && plate_data->is_sliced_valid && boost::filesystem::exists(plate_data->gcode_file)) {
-                    unsigned char digest[16];
-                    MD5_CTX       ctx;
-                    MD5_Init(&ctx);
-                    auto                        src_gcode_file = plate_data->gcode_file;
-                    boost::filesystem::ifstream ifs(src_gcode_file, std::ios::binary);
-                    std::string                 buf(64 * 1024, 0);
-                    const std::size_t &         size      = boost::filesystem::file_size(src_gcode_file);
-                    std::size_t                 left_size = size;
-                    while (ifs) {
-                        ifs.read(buf.data(), buf.size());
-                        int read_bytes = ifs.gcount();
-                        MD5_Update(&ctx, (unsigned char *) buf.data(), read_bytes);
-                    }
-                    MD5_Final(digest, &ctx);
-                    char md5_str[33];
-                    for (int j = 0; j < 16; j++) { sprintf(&md5_str[j * 2], "%02X", (unsigned int) digest[j]); }
-                    plate_data->gcode_file_md5 = std::string(md5_str);
-                    std::string target_file    = (boost::format("Metadata/plate_%1%.gcode.md5") % (plate_data->plate_index + 1)).str();
-                    if (!mz_zip_writer_add_mem(&archive, target_file.c_str(), (const void *) plate_data->gcode_file_md5.c_str(), plate_data->gcode_file_md5.length(),
-                                               MZ_DEFAULT_COMPRESSION)) {
-                        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ":" << __LINE__
-                                                 << boost::format(", store  gcode md5 to 3mf's %1%,  length %2%, failed\n") %target_file %plate_data->gcode_file_md5.length();
-                        return false;
-                    }
-                }
-            }
-        }
-
-        // Adds gcode files ("Metadata/plate_1.gcode, plate_2.gcode, ...)
+        // Adds gcode files ("Metadata/plate_1.gcode, plate_2.gcode, ...) and their MD5 ("Metadata/plate_1.gcode.md5, ...)
         // Before _add_model_config_file_to_archive, because we modify plate_data
         //if (!m_skip_static && !_add_gcode_file_to_archive(archive, model, plate_data_list, proFn)) {
         if (!m_skip_static && m_save_gcode && !_add_gcode_file_to_archive(archive, model, plate_data_list, proFn)) {
@@ -6299,9 +6269,9 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
                 // GH issue #6193.
                 (uint64_t(1) << 32) - 1,
 #if WRITE_ZIP_LANGUAGE_ENCODING
-            nullptr, nullptr, 0, MZ_DEFAULT_LEVEL, nullptr, 0, nullptr, 0)) {
+            nullptr, nullptr, 0, m_compression_level, nullptr, 0, nullptr, 0)) {
 #else
-            nullptr, nullptr, 0, MZ_DEFAULT_COMPRESSION, extra.c_str(), extra.length(), extra.c_str(), extra.length())) {
+            nullptr, nullptr, 0, m_compression_level, extra.c_str(), extra.length(), extra.c_str(), extra.length())) {
 #endif
             add_error("Unable to add model file to archive");
             BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ":" << __LINE__ << boost::format(", Unable to add model file to archive\n");
@@ -7643,47 +7613,64 @@ bool _BBS_3MF_Exporter::_add_gcode_file_to_archive(mz_zip_archive& archive, cons
         }
     }
 
+    // The G-codes are compressed by multiple threads each, the MD5 is calculated while the G-code is mapped in memory.
     boost::mutex mutex;
     tbb::parallel_for(tbb::blocked_range<size_t>(0, plate_data_list2.size(), 1), [this, &plate_data_list2, &root_archive = archive, &mutex, &result](const tbb::blocked_range<size_t>& range) {
-        for (int i = range.begin(); i < range.end(); ++i) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
             PlateData* plate_data = plate_data_list2[i];
             auto src_gcode_file = plate_data->gcode_file;
             std::string gcode_in_3mf = (boost::format(GCODE_FILE_FORMAT) % (plate_data->plate_index + 1)).str();
 
             plate_data->gcode_file = gcode_in_3mf;
-            mz_zip_archive archive;
-            mz_zip_writer_staged_context context;
-            mz_zip_zero_struct(&archive);
-            mz_zip_writer_init_heap(&archive, 0, 1024 * 1024);
-            {
-                mz_zip_writer_add_staged_open(&archive, &context, gcode_in_3mf.c_str(), m_zip64 ? (uint64_t(1) << 30) * 16 : (uint64_t(1) << 32) - 1, nullptr, nullptr, 0,
-                    MZ_DEFAULT_COMPRESSION, nullptr, 0, nullptr, 0);
-                boost::filesystem::path src_gcode_path(src_gcode_file);
-                if (!boost::filesystem::exists(src_gcode_path)) {
-                    BOOST_LOG_TRIVIAL(error) << "Gcode is missing, filename = " << src_gcode_file;
-                    result = false;
-                }
-                boost::filesystem::ifstream ifs(src_gcode_file, std::ios::binary);
-                std::string buf(64 * 1024, 0);
-                while (ifs) {
-                    ifs.read(buf.data(), buf.size());
-                    mz_zip_writer_add_staged_data(&context, buf.data(), ifs.gcount());
-                }
-                mz_zip_writer_add_staged_finish(&context);
+            DeflatedData deflated;
+            try {
+                boost::iostreams::mapped_file_source gcode;
+                if (boost::filesystem::file_size(src_gcode_file) > 0)
+                    gcode.open(boost::filesystem::path(src_gcode_file));
+                const char *data = gcode.is_open() ? gcode.data() : "";
+                size_t      size = gcode.is_open() ? gcode.size() : 0;
+
+                unsigned char digest[16];
+                MD5_CTX       ctx;
+                MD5_Init(&ctx);
+                MD5_Update(&ctx, data, size);
+                MD5_Final(digest, &ctx);
+                char md5_str[33];
+                for (int j = 0; j < 16; j++) { sprintf(&md5_str[j * 2], "%02X", (unsigned int) digest[j]); }
+                plate_data->gcode_file_md5 = std::string(md5_str);
+
+                if (! deflate_parallel(data, size, m_compression_level, deflated))
+                    throw Slic3r::FileIOError("Compression failed");
+            } catch (const std::exception &ex) {
+                BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ":" << __LINE__ << boost::format(", failed to store %1% to 3mf: %2%") % src_gcode_file % ex.what();
+                result = false;
+                continue;
             }
-            void *ppBuf; size_t pSize;
-            mz_zip_writer_finalize_heap_archive(&archive, &ppBuf, &pSize);
-            mz_zip_writer_end(&archive);
-            mz_zip_zero_struct(&archive);
-            mz_zip_reader_init_mem(&archive, ppBuf, pSize, 0);
             {
                 boost::unique_lock l(mutex);
-                mz_zip_writer_add_from_zip_reader(&root_archive, &archive, 0);
+                if (! add_deflated_to_zip(&root_archive, gcode_in_3mf.c_str(), deflated)) {
+                    BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ":" << __LINE__ << boost::format(", failed to store %1% to 3mf %2%\n") % src_gcode_file % gcode_in_3mf;
+                    result = false;
+                    continue;
+                }
             }
-            mz_zip_reader_end(&archive);
-            BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << ":" <<__LINE__ << boost::format(", store  %1% to 3mf %2%\n") % src_gcode_file % gcode_in_3mf;
+            BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << ":" <<__LINE__ << boost::format(", store  %1% to 3mf %2%, compressed %3% to %4% bytes\n") % src_gcode_file % gcode_in_3mf
+                % deflated.uncompressed_size % deflated.data.size();
         }
     });
+
+    // add plate_N.gcode.md5 to file
+    for (PlateData *plate_data : plate_data_list2) {
+        if (plate_data->gcode_file_md5.empty())
+            continue;
+        std::string target_file = (boost::format("Metadata/plate_%1%.gcode.md5") % (plate_data->plate_index + 1)).str();
+        if (!mz_zip_writer_add_mem(&archive, target_file.c_str(), (const void *) plate_data->gcode_file_md5.c_str(), plate_data->gcode_file_md5.length(),
+                                   MZ_DEFAULT_COMPRESSION)) {
+            BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ":" << __LINE__
+                                     << boost::format(", store  gcode md5 to 3mf's %1%,  length %2%, failed\n") %target_file %plate_data->gcode_file_md5.length();
+            return false;
+        }
+    }
     return result;
 }
 
@@ -220,6 +220,8 @@ struct StoreParams
     std::vector<PlateBBoxData*> id_bboxes;
     BBLProject* project = nullptr;
     BBLProfile* profile = nullptr;
+    // Deflate level of the models and G-codes, 0 (stored) to 10, -1 for the default level.
+    int compression_level = -1;
 
     StoreParams() {}
 };
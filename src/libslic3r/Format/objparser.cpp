@@ -1,22 +1,72 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 
+#include <fast_float/fast_float.h>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include "objparser.hpp"
 
 #include "libslic3r/LocalesUtils.hpp"
 
 namespace ObjParser {
 
-static bool obj_parseline(const char *line, ObjData &data)
+// Drop-in replacement of strtod() for the null terminated line ending at line_end: fast_float parses the common
+// decimal notation, the rest (leading plus sign, hexadecimal floats) is left to strtod().
+static inline double parse_double(const char *str, const char *line_end, char **endptr)
+{
+	double out = 0.;
+	auto [ptr, ec] = fast_float::from_chars(str, line_end, out);
+	if (ec != std::errc() || *ptr == 'x' || *ptr == 'X')
+		return strtod(str, endptr);
+	*endptr = const_cast<char*>(ptr);
+	return out;
+}
+
+// Drop-in replacement of strtol(str, endptr, 10) converted to int, see parse_double().
+static inline int parse_int(const char *str, const char *line_end, char **endptr)
+{
+	long out = 0;
+	auto [ptr, ec] = std::from_chars(str, line_end, out);
+	if (ec != std::errc())
+		return int(strtol(str, endptr, 10));
+	*endptr = const_cast<char*>(ptr);
+	return int(out);
+}
+
+// References to the vertex attributes relative to the ends of the attribute arrays (negative indices) of faces parsed
+// from a chunk of a file by objparse_chunk(). They are resolved against the attributes parsed from the same chunk,
+// thus they have to be offset by the attributes parsed from the preceding chunks.
+struct ObjRelativeRefs
+{
+	enum Mask {
+		Coord 			= 1,
+		TextureCoord 	= 2,
+		Normal 			= 4,
+	};
+	// Index into ObjData::vertices, mask of the relative references.
+	std::vector<std::pair<size_t, int>> refs;
+};
+
+static bool obj_parseline(const char *line, ObjData &data, ObjRelativeRefs *relative_refs = nullptr)
 {
 #define EATWS() while (*line == ' ' || *line == '\t') ++ line
 
 	if (*line == 0)
 		return true;
 
+	const char *line_end = line + strlen(line);
+
     assert(Slic3r::is_decimal_separator_point());
 
 	// Ignore whitespaces at the beginning of the line.
@@ -42,14 +92,14 @@ static bool obj_parseline(const char *line, ObjData &data)
 				return false;
 			EATWS();
 			char *endptr = 0;
-			double u = strtod(line, &endptr);
+			double u = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
 			double v = 0;
 			if (*line != 0) {
-				v = strtod(line, &endptr);
+				v = parse_double(line, line_end, &endptr);
 				if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 					return false;
 				line = endptr;
@@ -57,7 +107,7 @@ static bool obj_parseline(const char *line, ObjData &data)
 			}
 			double w = 0;
 			if (*line != 0) {
-				w = strtod(line, &endptr);
+				w = parse_double(line, line_end, &endptr);
 				if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 					return false;
 				line = endptr;
@@ -79,17 +129,17 @@ static bool obj_parseline(const char *line, ObjData &data)
 				return false;
 			EATWS();
 			char *endptr = 0;
-			double x = strtod(line, &endptr);
+			double x = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
-			double y = strtod(line, &endptr);
+			double y = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
-			double z = strtod(line, &endptr);
+			double z = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 				return false;
 			line = endptr;
@@ -109,19 +159,19 @@ static bool obj_parseline(const char *line, ObjData &data)
 				return false;
 			EATWS();
 			char *endptr = 0;
-			double u = strtod(line, &endptr);
+			double u = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 				return false;
 			line = endptr;
 			EATWS();
-			double v = strtod(line, &endptr);
+			double v = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 				return false;
 			line = endptr;
 			EATWS();
 			double w = 0;
 			if (*line != 0) {
-				w = strtod(line, &endptr);
+				w = parse_double(line, line_end, &endptr);
 				if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 					return false;
 				line = endptr;
@@ -141,24 +191,24 @@ static bool obj_parseline(const char *line, ObjData &data)
 				return false;
 			EATWS();
 			char *endptr = 0;
-			double x = strtod(line, &endptr);
+			double x = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
-			double y = strtod(line, &endptr);
+			double y = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
-			double z = strtod(line, &endptr);
+			double z = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 				return false;
 			line = endptr;
 			EATWS();
 			double w = 1.0;
 			if (*line != 0) {
-				w = strtod(line, &endptr);
+				w = parse_double(line, line_end, &endptr);
 				if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 					return false;
 				line = endptr;
@@ -193,7 +243,7 @@ static bool obj_parseline(const char *line, ObjData &data)
 			vertex.coordIdx			= 0;
 			vertex.normalIdx		= 0;
 			vertex.textureCoordIdx	= 0;
-			vertex.coordIdx = strtol(line, &endptr, 10);
+			vertex.coordIdx = parse_int(line, line_end, &endptr);
 			// Coordinate has to be defined
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != '/' && *endptr != 0))
 				return false;
@@ -203,7 +253,7 @@ static bool obj_parseline(const char *line, ObjData &data)
 				// Texture coordinate index may be missing after a 1st slash, but then the normal index has to be present.
 				if (*line != '/') {
 					// Parse the texture coordinate index.
-					vertex.textureCoordIdx = strtol(line, &endptr, 10);
+					vertex.textureCoordIdx = parse_int(line, line_end, &endptr);
 					if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != '/' && *endptr != 0))
 						return false;
 					line = endptr;
@@ -211,24 +261,30 @@ static bool obj_parseline(const char *line, ObjData &data)
 				if (*line == '/') {
 					// Parse normal index.
 					++ line;
-					vertex.normalIdx = strtol(line, &endptr, 10);
+					vertex.normalIdx = parse_int(line, line_end, &endptr);
 					if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 						return false;
 					line = endptr;
 				}
 			}
-			if (vertex.coordIdx < 0)
+			int relative = 0;
+			if (vertex.coordIdx < 0) {
                 vertex.coordIdx += (int)data.coordinates.size() / 4;
-            else
+				relative |= ObjRelativeRefs::Coord;
+            } else
 				-- vertex.coordIdx;
-			if (vertex.normalIdx < 0)
+			if (vertex.normalIdx < 0) {
                 vertex.normalIdx += (int)data.normals.size() / 3;
-            else
+				relative |= ObjRelativeRefs::Normal;
+            } else
 				-- vertex.normalIdx;
-			if (vertex.textureCoordIdx < 0)
+			if (vertex.textureCoordIdx < 0) {
                 vertex.textureCoordIdx += (int)data.textureCoordinates.size() / 3;
-            else
+				relative |= ObjRelativeRefs::TextureCoord;
+            } else
 				-- vertex.textureCoordIdx;
+			if (relative && relative_refs)
+				relative_refs->refs.emplace_back(data.vertices.size(), relative);
 			data.vertices.push_back(vertex);
 			EATWS();
 		}
@@ -303,7 +359,7 @@ static bool obj_parseline(const char *line, ObjData &data)
 			return false;
 		EATWS();
 		char *endptr = 0;
-		long g = strtol(line, &endptr, 10);
+		long g = parse_int(line, line_end, &endptr);
 		if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 			return false;
 		line = endptr;
@@ -324,10 +380,9 @@ static bool obj_parseline(const char *line, ObjData &data)
 	return true;
 }
 
-bool objparse(const char *path, ObjData &data)
+// Parse the file sequentially by stdio, used if the file could not be memory mapped.
+static bool objparse_stdio(const char *path, ObjData &data)
 {
-    Slic3r::CNumericLocalesSetter locales_setter;
-
 	FILE *pFile = boost::nowide::fopen(path, "rt");
 	if (pFile == 0)
 		return false;
@@ -369,6 +424,148 @@ bool objparse(const char *path, ObjData &data)
 	return true;
 }
 
+// Parse the lines of a chunk of a file, each terminated by '\r' or '\n'. Returns false on an excessive line length.
+static bool objparse_chunk(const char *begin, const char *end, ObjData &data, ObjRelativeRefs &relative_refs)
+{
+	std::string line;
+	for (const char *it = begin; it != end;) {
+		const char *it_eol = std::find_if(it, end, [](char c) { return c == '\r' || c == '\n'; });
+		if (it_eol == end)
+			// Same as objparse_stdio(), the last line not terminated by an end of line is ignored.
+			break;
+		if (it_eol - it > 65536) {
+	    	BOOST_LOG_TRIVIAL(error) << "ObjParser: Excessive line length";
+			return false;
+		}
+		while (it != it_eol && (*it == ' ' || *it == '\t'))
+			++ it;
+		// The mapped file is read only, make a null terminated copy of the line for obj_parseline().
+		line.assign(it, it_eol);
+		//FIXME check the return value and exit on error?
+		// Will it break parsing of some obj files?
+		obj_parseline(line.c_str(), data, &relative_refs);
+		it = it_eol + 1;
+	}
+	return true;
+}
+
+// Append the data parsed from chunks of a file to data, offsetting the indices by the items already parsed.
+static void objdata_append(ObjData &data, std::vector<ObjData> &chunks, const std::vector<ObjRelativeRefs> &relative_refs)
+{
+	struct Offsets {
+		size_t coordinates;
+		size_t textureCoordinates;
+		size_t normals;
+		size_t parameters;
+		size_t vertices;
+	};
+	std::vector<Offsets> offsets(chunks.size() + 1);
+	offsets.front() = { data.coordinates.size(), data.textureCoordinates.size(), data.normals.size(), data.parameters.size(), data.vertices.size() };
+	for (size_t i = 0; i < chunks.size(); ++ i) {
+		const ObjData &chunk = chunks[i];
+		const Offsets &prev  = offsets[i];
+		offsets[i + 1] = { prev.coordinates + chunk.coordinates.size(), prev.textureCoordinates + chunk.textureCoordinates.size(),
+			prev.normals + chunk.normals.size(), prev.parameters + chunk.parameters.size(), prev.vertices + chunk.vertices.size() };
+	}
+	data.coordinates.resize(offsets.back().coordinates);
+	data.textureCoordinates.resize(offsets.back().textureCoordinates);
+	data.normals.resize(offsets.back().normals);
+	data.parameters.resize(offsets.back().parameters);
+	data.vertices.resize(offsets.back().vertices);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size(), 1), [&data, &chunks, &relative_refs, &offsets](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i) {
+			const ObjData &chunk  = chunks[i];
+			const Offsets &offset = offsets[i];
+			std::copy(chunk.coordinates.begin(), chunk.coordinates.end(), data.coordinates.begin() + offset.coordinates);
+			std::copy(chunk.textureCoordinates.begin(), chunk.textureCoordinates.end(), data.textureCoordinates.begin() + offset.textureCoordinates);
+			std::copy(chunk.normals.begin(), chunk.normals.end(), data.normals.begin() + offset.normals);
+			std::copy(chunk.parameters.begin(), chunk.parameters.end(), data.parameters.begin() + offset.parameters);
+			std::copy(chunk.vertices.begin(), chunk.vertices.end(), data.vertices.begin() + offset.vertices);
+			for (const std::pair<size_t, int> &ref : relative_refs[i].refs) {
+				ObjVertex &vertex = data.vertices[offset.vertices + ref.first];
+				if (ref.second & ObjRelativeRefs::Coord)
+					vertex.coordIdx += int(offset.coordinates / 4);
+				if (ref.second & ObjRelativeRefs::TextureCoord)
+					vertex.textureCoordIdx += int(offset.textureCoordinates / 3);
+				if (ref.second & ObjRelativeRefs::Normal)
+					vertex.normalIdx += int(offset.normals / 3);
+			}
+		}
+	});
+	for (size_t i = 0; i < chunks.size(); ++ i) {
+		ObjData &chunk       = chunks[i];
+		int      vertex_base = int(offsets[i].vertices);
+		auto append = [vertex_base](auto &dst, auto &src) {
+			for (auto &item : src) {
+				item.vertexIdxFirst += vertex_base;
+				dst.emplace_back(std::move(item));
+			}
+		};
+		data.mtllibs.insert(data.mtllibs.end(), std::make_move_iterator(chunk.mtllibs.begin()), std::make_move_iterator(chunk.mtllibs.end()));
+		append(data.usemtls, chunk.usemtls);
+		append(data.objects, chunk.objects);
+		append(data.groups, chunk.groups);
+		append(data.smoothingGroups, chunk.smoothingGroups);
+		chunk = ObjData();
+	}
+}
+
+bool objparse(const char *path, ObjData &data)
+{
+    Slic3r::CNumericLocalesSetter locales_setter;
+
+	boost::system::error_code ec;
+	uintmax_t file_size = boost::filesystem::file_size(boost::filesystem::path(path), ec);
+	if (ec)
+		return false;
+	if (file_size == 0)
+		// Nothing to parse, and an empty file cannot be memory mapped.
+		return true;
+
+	boost::iostreams::mapped_file_source file;
+	try {
+		file.open(boost::filesystem::path(path));
+	} catch (const std::exception &ex) {
+		BOOST_LOG_TRIVIAL(warning) << "ObjParser: failed to memory map " << path << ", reading it sequentially: " << ex.what();
+	}
+	if (! file.is_open())
+		return objparse_stdio(path, data);
+
+	// Split the file into chunks of whole lines, each chunk is parsed by a single thread into its own ObjData.
+	const char         *begin 	   = file.data();
+	const char         *end   	   = begin + file.size();
+	const size_t        num_chunks = std::clamp<size_t>(file.size() / (1024 * 1024), 1, 4 * size_t(tbb::this_task_arena::max_concurrency()));
+	std::vector<const char*> chunk_begins { begin };
+	for (size_t i = 1; i < num_chunks; ++ i) {
+		const char *it = std::max(chunk_begins.back(), begin + file.size() * i / num_chunks);
+		it = std::find_if(it, end, [](char c) { return c == '\r' || c == '\n'; });
+		if (it == end)
+			break;
+		chunk_begins.emplace_back(it + 1);
+	}
+	chunk_begins.emplace_back(end);
+
+	std::vector<ObjData>         chunks(chunk_begins.size() - 1);
+	std::vector<ObjRelativeRefs> relative_refs(chunks.size());
+	std::atomic<bool>            ok { true };
+	try {
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size(), 1), [&chunk_begins, &chunks, &relative_refs, &ok](const tbb::blocked_range<size_t> &range) {
+			// The locale is per thread, set it on the worker threads for the strtod() / strtol() fallbacks of the parser.
+			Slic3r::CNumericLocalesSetter locales_setter;
+			for (size_t i = range.begin(); i < range.end(); ++ i)
+				if (! objparse_chunk(chunk_begins[i], chunk_begins[i + 1], chunks[i], relative_refs[i]))
+					ok = false;
+		});
+		if (! ok)
+			return false;
+		objdata_append(data, chunks, relative_refs);
+	} catch (std::bad_alloc&) {
+    	BOOST_LOG_TRIVIAL(error) << "ObjParser: Out of memory";
+    	return false;
+	}
+	return true;
+}
+
 bool objparse(std::istream &stream, ObjData &data)
 {
     Slic3r::CNumericLocalesSetter locales_setter;
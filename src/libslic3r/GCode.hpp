@@ -11,6 +11,7 @@
 #include "GCode/AvoidCrossingPerimeters.hpp"
 #include "GCode/CoolingBuffer.hpp"
 #include "GCode/FanMover.hpp"
+#include "GCode/LayerMoves.hpp"
 #include "GCode/RetractWhenCrossingPerimeters.hpp"
 #include "GCode/SpiralVase.hpp"
 #include "GCode/ToolOrdering.hpp"
@@ -152,6 +153,8 @@ struct LayerResult {
 	// Is indicating if this LayerResult should be processed, or it is just inserted artificial LayerResult.
     // It is used for the pressure equalizer because it needs to buffer one layer back.
     bool        nop_layer_result { false };
+    // Lines of gcode parsed for the CoolingBuffer and FanMover, filled in just before the CoolingBuffer.
+    LayerMoves  moves;
 
     static LayerResult make_nop_layer_result() { return {"", std::numeric_limits<coord_t>::max(), false, false, true}; }
 };
@@ -286,6 +289,8 @@ private:
         // Write a string into a file.
         void write(const std::string& what) { this->write(what.c_str()); }
         void write(const char* what);
+        // Write a string into a file, passing the lines of what tokenized by the G-code filters to the GCodeProcessor.
+        void write(const std::string& what, const LayerMoves& moves);
 
         // Write a string into a file.
         // Add a newline, if the string does not end with a newline already.
@@ -304,11 +309,23 @@ private:
     static std::vector<LayerToPrint>        		                   collect_layers_to_print(const PrintObject &object);
     static std::vector<std::pair<coordf_t, std::vector<LayerToPrint>>> collect_layers_to_print(const Print &print);
 
+    // Per print_z data, which does not depend on the state of the G-code generator (position, active extruder, retraction, fan),
+    // thus it is calculated by process_layers() for multiple layers in parallel ahead of the serial G-code emission.
+    struct LayerPrepared;
+    static LayerPrepared prepare_layer(
+        const Print                     &print,
+        const std::vector<LayerToPrint> &layers,
+        const LayerTools                &layer_tools,
+        // Build the layer boundaries for the overhang quality estimator.
+        const bool                       overhang_boundaries);
+
     LayerResult process_layer(
         const Print                     &print,
         // Set of object & print layers of the same PrintObject and with the same print_z.
         const std::vector<LayerToPrint> &layers,
         const LayerTools  				&layer_tools,
+        // Extrusions of the layers grouped by extruders, prepared by prepare_layer().
+        LayerPrepared                  &&prepared,
         const bool                       last_layer,
 		// Pairs of PrintObject index and its instance index.
 		const std::vector<const PrintInstance*> *ordering,
@@ -392,6 +409,16 @@ private:
         std::vector<Island>         islands;
     };
 
+    struct LayerPrepared
+    {
+        // Extrusions grouped by an extruder, then by an object, an island and a region.
+        std::map<unsigned int, std::vector<ObjectByExtruder>>   by_extruder;
+        // Distancers over the object layers for the overhang quality estimator, indexed the same as LayerToPrint.
+        // Empty if the overhang quality estimator is not active.
+        std::vector<ExtrusionQualityEstimator::LayerBoundaries> overhang_boundaries;
+    };
+    struct LayerToProcess;
+
 	struct InstanceToPrint
 	{
 		InstanceToPrint(ObjectByExtruder &object_by_extruder, size_t layer_id, const PrintObject &print_object, size_t instance_id, size_t label_object_id) :
@@ -1,11 +1,12 @@
 #include "ConflictChecker.hpp"
 
 #include <tbb/parallel_for.h>
-#include <tbb/concurrent_vector.h>
+
+#include <boost/log/trivial.hpp>
 
 #include <map>
 #include <functional>
-#include <atomic>
+#include <unordered_map>
 
 namespace Slic3r {
 
@@ -89,52 +90,6 @@ inline Grids line_rasterization(const Line &line, int64_t xdist = RasteXDistance
 }
 } // namespace RasterizationImpl
 
-void LinesBucketQueue::emplace_back_bucket(ExtrusionLayers &&els, const void *objPtr, Point offset)
-{
-    auto oldSize = line_buckets.capacity();
-    line_buckets.emplace_back(std::move(els), objPtr, offset);
-    line_bucket_ptr_queue.push(&line_buckets.back());
-    auto newSize = line_buckets.capacity();
-    if (oldSize != newSize) { // pointers change
-        decltype(line_bucket_ptr_queue) newQueue;
-        for (LinesBucket &bucket : line_buckets) { newQueue.push(&bucket); }
-        std::swap(line_bucket_ptr_queue, newQueue);
-    }
-}
-
-// remove lowest and get the current bottom z
-float LinesBucketQueue::getCurrBottomZ()
-{
-    auto lowest = line_bucket_ptr_queue.top();
-    line_bucket_ptr_queue.pop();
-    float                      layerBottomZ = lowest->curBottomZ();
-    std::vector<LinesBucket *> lowests;
-    lowests.push_back(lowest);
-
-    while (line_bucket_ptr_queue.empty() == false && std::abs(line_bucket_ptr_queue.top()->curBottomZ() - lowest->curBottomZ()) < EPSILON) {
-        lowests.push_back(line_bucket_ptr_queue.top());
-        line_bucket_ptr_queue.pop();
-    }
-
-    for (LinesBucket *bp : lowests) {
-        bp->raise();
-        if (bp->valid()) { line_bucket_ptr_queue.push(bp); }
-    }
-    return layerBottomZ;
-}
-
-LineWithIDs LinesBucketQueue::getCurLines() const
-{
-    LineWithIDs lines;
-    for (const LinesBucket &bucket : line_buckets) {
-        if (bucket.valid()) {
-            LineWithIDs tmpLines = bucket.curLines();
-            lines.insert(lines.end(), tmpLines.begin(), tmpLines.end());
-        }
-    }
-    return lines;
-}
-
 void getExtrusionPathsFromEntity(const ExtrusionEntityCollection *entity, ExtrusionPaths &paths)
 {
     std::function<void(const ExtrusionEntityCollection *, ExtrusionPaths &)> getExtrusionPathImpl = [&](const ExtrusionEntityCollection *entity, ExtrusionPaths &paths) {
@@ -179,7 +134,7 @@ ExtrusionLayer getExtrusionPathsFromSupportLayer(SupportLayer *supportLayer)
     return el;
 }
 
-ObjectExtrusions getAllLayersExtrusionPathsFromObject(PrintObject *obj)
+ObjectExtrusions getAllLayersExtrusionPathsFromObject(const PrintObject *obj)
 {
     ObjectExtrusions oe;
 
@@ -213,69 +168,253 @@ ConflictComputeOpt ConflictChecker::find_inter_of_lines(const LineWithIDs &lines
     return {};
 }
 
-ConflictResultOpt ConflictChecker::find_inter_of_lines_in_diff_objs(PrintObjectPtrs                      objs,
-                                                                    std::optional<const FakeWipeTower *> wtdptr) // find the first intersection point of lines in different objects
+namespace {
+
+// Extrusion layers of a stream converted to lines, layers with the same bottom_z (the regions of a layer) merged.
+ConflictStreamLines stream_lines(const ExtrusionLayers &layers)
 {
-    if (objs.size() <= 1 && !wtdptr) { return {}; }
-    LinesBucketQueue conflictQueue;
-    if (wtdptr.has_value()) { // wipe tower at 0 by default
-        auto            wtpaths = wtdptr.value()->getFakeExtrusionPathsFromWipeTower();
-        ExtrusionLayers wtels;
-        wtels.type = ExtrusionLayersType::WIPE_TOWER;
-        for (int i = 0; i < wtpaths.size(); ++i) { // assume that wipe tower always has same height
-            ExtrusionLayer el;
-            el.paths    = wtpaths[i];
-            el.bottom_z = wtpaths[i].front().height * (float) i;
-            el.layer    = nullptr;
-            wtels.push_back(el);
+    ConflictStreamLines out;
+    for (const ExtrusionLayer &layer : layers) {
+        if (out.layers.empty() || out.layers.back().bottom_z != layer.bottom_z) {
+            out.layers.emplace_back();
+            out.layers.back().bottom_z = layer.bottom_z;
         }
-        conflictQueue.emplace_back_bucket(std::move(wtels), wtdptr.value(), {wtdptr.value()->plate_origin.x(), wtdptr.value()->plate_origin.y()});
+        ConflictLayerLines &dst = out.layers.back();
+        for (const ExtrusionPath &path : layer.paths)
+            if (path.is_force_no_extrusion() == false && path.polyline.size() >= 2) {
+                const Points &pts = path.polyline.points;
+                for (size_t i = 1; i < pts.size(); ++ i) {
+                    dst.lines.emplace_back(pts[i - 1], pts[i]);
+                    dst.roles.emplace_back(path.role());
+                }
+                dst.bbox.merge(get_extents(path.polyline));
+            }
     }
-    for (PrintObject *obj : objs) {
-        auto layers = getAllLayersExtrusionPathsFromObject(obj);
-        conflictQueue.emplace_back_bucket(std::move(layers.perimeters), obj, obj->instances().front().shift);
-        conflictQueue.emplace_back_bucket(std::move(layers.support), obj, obj->instances().front().shift);
+    for (const ConflictLayerLines &layer : out.layers)
+        if (layer.bbox.defined)
+            out.bbox.merge(layer.bbox);
+    return out;
+}
+
+bool overlap(const BoundingBox &bbox1, const Point &offset1, const BoundingBox &bbox2, const Point &offset2)
+{
+    return bbox1.defined && bbox2.defined &&
+           bbox1.min.x() + offset1.x() <= bbox2.max.x() + offset2.x() && bbox2.min.x() + offset2.x() <= bbox1.max.x() + offset1.x() &&
+           bbox1.min.y() + offset1.y() <= bbox2.max.y() + offset2.y() && bbox2.min.y() + offset2.y() <= bbox1.max.y() + offset1.y();
+}
+
+struct IndexPairHash
+{
+    size_t operator()(const RasterizationImpl::IndexPair &idx) const { return std::hash<int64_t>()(idx.first * 73856093 ^ idx.second * 19349663); }
+};
+
+// Whether the extrusions of the two layers cross. Only the lines inside the overlap of the bounding boxes of the layers
+// are rasterized, the lines of the first layer into a grid, the lines of the second layer are tested against the grid cells they pass.
+bool layers_intersect(const ConflictLayerLines &layer1, const Point &offset1, const ConflictLayerLines &layer2, const Point &offset2)
+{
+    using namespace RasterizationImpl;
+    if (! overlap(layer1.bbox, offset1, layer2.bbox, offset2))
+        return false;
+    BoundingBox clip(Point(std::max(layer1.bbox.min.x() + offset1.x(), layer2.bbox.min.x() + offset2.x()),
+                           std::max(layer1.bbox.min.y() + offset1.y(), layer2.bbox.min.y() + offset2.y())),
+                     Point(std::min(layer1.bbox.max.x() + offset1.x(), layer2.bbox.max.x() + offset2.x()),
+                           std::min(layer1.bbox.max.y() + offset1.y(), layer2.bbox.max.y() + offset2.y())));
+    clip.offset(SCALED_EPSILON);
+    auto clipped_line = [&clip](const Line &line, const Point &offset, Line &out) {
+        out = Line(line.a + offset, line.b + offset);
+        return std::max(out.a.x(), out.b.x()) >= clip.min.x() && std::min(out.a.x(), out.b.x()) <= clip.max.x() &&
+               std::max(out.a.y(), out.b.y()) >= clip.min.y() && std::min(out.a.y(), out.b.y()) <= clip.max.y();
+    };
+
+    LineWithIDs lines1;
+    std::unordered_map<IndexPair, std::vector<int>, IndexPairHash> grid;
+    Line line;
+    for (size_t i = 0; i < layer1.lines.size(); ++ i)
+        if (clipped_line(layer1.lines[i], offset1, line)) {
+            for (const IndexPair &index : line_rasterization(line))
+                grid[index].push_back(int(lines1.size()));
+            lines1.emplace_back(line, &layer1, layer1.roles[i]);
+        }
+    if (lines1.empty())
+        return false;
+
+    for (size_t i = 0; i < layer2.lines.size(); ++ i)
+        if (clipped_line(layer2.lines[i], offset2, line)) {
+            LineWithID line2(line, &layer2, layer2.roles[i]);
+            for (const IndexPair &index : line_rasterization(line))
+                if (auto it = grid.find(index); it != grid.end())
+                    for (int idx : it->second)
+                        if (ConflictChecker::line_intersect(lines1[idx], line2))
+                            return true;
+        }
+    return false;
+}
+
+// Timestamps of the steps, which produce the extrusions collected by getAllLayersExtrusionPathsFromObject().
+std::vector<size_t> object_timestamps(const PrintObject &obj)
+{
+    std::vector<size_t> out;
+    for (PrintObjectStep step : { posSlice, posPerimeters, posInfill, posIroning, posSupportMaterial, posSimplifyPath, posSimplifyInfill, posSimplifySupportPath }) {
+        PrintStateBase::StateWithTimeStamp state = obj.step_state_with_timestamp(step);
+        out.emplace_back(state.state == PrintStateBase::DONE ? state.timestamp : 0);
     }
+    return out;
+}
 
-    std::vector<LineWithIDs> layersLines;
-    std::vector<float>       bottomZs;
-    while (conflictQueue.valid()) {
-        LineWithIDs lines = conflictQueue.getCurLines();
-        float curBottomZ = conflictQueue.getCurrBottomZ();
-        bottomZs.push_back(curBottomZ);
-        layersLines.push_back(std::move(lines));
+} // namespace
+
+ConflictObjectLinesPtr ConflictChecker::object_lines(const PrintObject &obj)
+{
+    ObjectExtrusions extrusions = getAllLayersExtrusionPathsFromObject(&obj);
+    auto out = std::make_shared<ConflictObjectLines>();
+    out->streams.emplace_back(stream_lines(extrusions.perimeters));
+    out->streams.emplace_back(stream_lines(extrusions.support));
+    return out;
+}
+
+ConflictObjectLinesPtr ConflictChecker::wipe_tower_lines(const FakeWipeTower &wipe_tower)
+{
+    std::vector<ExtrusionPaths> wtpaths = wipe_tower.getFakeExtrusionPathsFromWipeTower();
+    ExtrusionLayers wtels;
+    wtels.type = ExtrusionLayersType::WIPE_TOWER;
+    for (int i = 0; i < wtpaths.size(); ++i) { // assume that wipe tower always has same height
+        ExtrusionLayer el;
+        el.paths    = wtpaths[i];
+        el.bottom_z = wtpaths[i].front().height * (float) i;
+        el.layer    = nullptr;
+        wtels.push_back(el);
     }
+    auto out = std::make_shared<ConflictObjectLines>();
+    out->streams.emplace_back(stream_lines(wtels));
+    return out;
+}
 
-    bool                                                          find = false;
-    tbb::concurrent_vector<std::pair<ConflictComputeResult, float>> conflict;
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, layersLines.size()), [&](tbb::blocked_range<size_t> range) {
-        for (size_t i = range.begin(); i < range.end(); i++) {
-            auto interRes = find_inter_of_lines(layersLines[i]);
-            if (interRes.has_value()) {
-                find = true;
-                conflict.emplace_back(interRes.value(), bottomZs[i]);
-                break;
+std::optional<float> ConflictChecker::find_inter_of_objects(const ConflictObjectLines &lines1, const Point &offset1,
+                                                            const ConflictObjectLines &lines2, const Point &offset2)
+{
+    std::optional<float> out;
+    for (const ConflictStreamLines &stream1 : lines1.streams)
+        for (const ConflictStreamLines &stream2 : lines2.streams) {
+            if (! overlap(stream1.bbox, offset1, stream2.bbox, offset2))
+                continue;
+            // Sweep both streams bottom up. The current layer of each stream is its lowest layer, which was not passed yet,
+            // the same pairs of layers are compared as if all the objects were swept at once.
+            for (size_t i = 0, j = 0; i < stream1.layers.size() && j < stream2.layers.size();) {
+                const ConflictLayerLines &layer1 = stream1.layers[i];
+                const ConflictLayerLines &layer2 = stream2.layers[j];
+                float z = std::min(layer1.bottom_z, layer2.bottom_z);
+                if (out && z >= *out)
+                    break;
+                if (layers_intersect(layer1, offset1, layer2, offset2)) {
+                    out = z;
+                    break;
+                }
+                if (std::abs(layer1.bottom_z - z) < EPSILON)
+                    ++ i;
+                if (std::abs(layer2.bottom_z - z) < EPSILON)
+                    ++ j;
             }
         }
+    return out;
+}
+
+ConflictResultOpt ConflictChecker::find_conflict(const PrintObjectPtrs &objs, std::optional<const FakeWipeTower *> wtdptr)
+{
+    if (objs.size() <= 1 && !wtdptr) {
+        this->clear();
+        return {};
+    }
+
+    // Collect the lines of the objects, which changed since the last check.
+    std::map<const PrintObject*, ObjectEntry> objects;
+    std::vector<std::pair<const PrintObject*, ObjectEntry*>> to_update;
+    for (const PrintObject *obj : objs) {
+        ObjectEntry &entry = objects[obj];
+        entry.timestamps = object_timestamps(*obj);
+        if (auto it = m_objects.find(obj); it != m_objects.end() && it->second.timestamps == entry.timestamps)
+            entry.lines = it->second.lines;
+        else
+            to_update.emplace_back(obj, &entry);
+    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, to_update.size(), 1), [&to_update](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            to_update[i].second->lines = object_lines(*to_update[i].first);
     });
+    m_objects = std::move(objects);
 
-    if (find) {
-        const void *ptr1           = conflict[0].first._obj1;
-        const void *ptr2           = conflict[0].first._obj2;
-        float       conflictPrintZ = conflict[0].second;
-        if (wtdptr.has_value()) {
-            const FakeWipeTower *wtdp = wtdptr.value();
-            if (ptr1 == wtdp || ptr2 == wtdp) {
-                if (ptr2 == wtdp) { std::swap(ptr1, ptr2); }
-                const PrintObject *obj2 = reinterpret_cast<const PrintObject *>(ptr2);
-                return std::make_optional<ConflictResult>("WipeTower", obj2->model_object()->name, conflictPrintZ, nullptr, ptr2);
-            }
-        }
-        const PrintObject *obj1 = reinterpret_cast<const PrintObject *>(ptr1);
-        const PrintObject *obj2 = reinterpret_cast<const PrintObject *>(ptr2);
-        return std::make_optional<ConflictResult>(obj1->model_object()->name, obj2->model_object()->name, conflictPrintZ, ptr1, ptr2);
+    struct Item
+    {
+        const void            *id;
+        ConflictObjectLinesPtr lines;
+        Point                  offset;
+    };
+    std::vector<Item> items;
+    if (wtdptr.has_value()) { // wipe tower at 0 by default
+        ConflictObjectLinesPtr lines = wipe_tower_lines(*wtdptr.value());
+        auto same_lines = [](const ConflictObjectLines &l, const ConflictObjectLines &r) {
+            return std::equal(l.streams.begin(), l.streams.end(), r.streams.begin(), r.streams.end(), [](const ConflictStreamLines &l, const ConflictStreamLines &r) {
+                return std::equal(l.layers.begin(), l.layers.end(), r.layers.begin(), r.layers.end(), [](const ConflictLayerLines &l, const ConflictLayerLines &r) {
+                    return l.bottom_z == r.bottom_z && l.lines == r.lines && l.roles == r.roles;
+                });
+            });
+        };
+        // Keep the lines of an unchanged wipe tower, so that its pairs are not checked again.
+        if (m_wipe_tower && same_lines(*m_wipe_tower, *lines))
+            lines = m_wipe_tower;
+        m_wipe_tower = lines;
+        items.push_back({ wtdptr.value(), std::move(lines), { wtdptr.value()->plate_origin.x(), wtdptr.value()->plate_origin.y() } });
     } else
+        m_wipe_tower.reset();
+    for (const PrintObject *obj : objs)
+        items.push_back({ obj, m_objects[obj].lines, obj->instances().front().shift });
+
+    // Check the pairs, which changed since the last check.
+    std::map<std::pair<const void*, const void*>, PairEntry> pairs;
+    std::vector<PairEntry*> to_check;
+    for (size_t i = 0; i < items.size(); ++ i)
+        for (size_t j = i + 1; j < items.size(); ++ j) {
+            PairEntry &entry = pairs[{ items[i].id, items[j].id }];
+            entry = { items[i].lines, items[j].lines, items[i].offset, items[j].offset, {} };
+            if (auto it = m_pairs.find({ items[i].id, items[j].id }); it != m_pairs.end() &&
+                it->second.lines1 == entry.lines1 && it->second.lines2 == entry.lines2 &&
+                it->second.offset1 == entry.offset1 && it->second.offset2 == entry.offset2)
+                entry.conflict_z = it->second.conflict_z;
+            else
+                to_check.emplace_back(&entry);
+        }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, to_check.size(), 1), [&to_check](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            PairEntry &entry = *to_check[i];
+            entry.conflict_z = find_inter_of_objects(*entry.lines1, entry.offset1, *entry.lines2, entry.offset2);
+        }
+    });
+    m_num_checked_pairs = to_check.size();
+    BOOST_LOG_TRIVIAL(debug) << "conflict check: " << to_update.size() << " of " << objs.size() << " objects collected, "
+                             << to_check.size() << " of " << pairs.size() << " pairs checked";
+    m_pairs = std::move(pairs);
+
+    // Report the lowest conflict.
+    const std::pair<const std::pair<const void*, const void*>, PairEntry> *lowest = nullptr;
+    for (const auto &pair : m_pairs)
+        if (pair.second.conflict_z && (lowest == nullptr || *pair.second.conflict_z < *lowest->second.conflict_z))
+            lowest = &pair;
+    if (lowest == nullptr)
         return {};
+
+    const void *ptr1           = lowest->first.first;
+    const void *ptr2           = lowest->first.second;
+    float       conflictPrintZ = *lowest->second.conflict_z;
+    if (wtdptr.has_value()) {
+        const FakeWipeTower *wtdp = wtdptr.value();
+        if (ptr1 == wtdp || ptr2 == wtdp) {
+            if (ptr2 == wtdp) { std::swap(ptr1, ptr2); }
+            const PrintObject *obj2 = reinterpret_cast<const PrintObject *>(ptr2);
+            return std::make_optional<ConflictResult>("WipeTower", obj2->model_object()->name, conflictPrintZ, nullptr, ptr2);
+        }
+    }
+    const PrintObject *obj1 = reinterpret_cast<const PrintObject *>(ptr1);
+    const PrintObject *obj2 = reinterpret_cast<const PrintObject *>(ptr2);
+    return std::make_optional<ConflictResult>(obj1->model_object()->name, obj2->model_object()->name, conflictPrintZ, ptr1, ptr2);
 }
 
 ConflictComputeOpt ConflictChecker::line_intersect(const LineWithID &l1, const LineWithID &l2)
@@ -6,7 +6,8 @@
 #include "../Print.hpp"
 #include "../Layer.hpp"
 
-#include <queue>
+#include <map>
+#include <memory>
 #include <vector>
 #include <optional>
 
@@ -50,82 +51,13 @@ struct ObjectExtrusions
     }
 };
 
-class LinesBucket
-{
-public:
-    float    _curBottomZ = 0.0;
-    unsigned _curPileIdx = 0;
-
-    ExtrusionLayers _piles;
-    const void*     _id;
-    Point           _offset;
-
-public:
-    LinesBucket(ExtrusionLayers &&paths, const void* id, Point offset) : _piles(paths), _id(id), _offset(offset) {}
-    LinesBucket(LinesBucket &&) = default;
-
-    std::pair<int, int> curRange() const
-    {
-        auto begin = std::lower_bound(_piles.begin(), _piles.end(), _piles[_curPileIdx], [](const ExtrusionLayer &l, const ExtrusionLayer &r) { return l.bottom_z < r.bottom_z; });
-        auto end = std::upper_bound(_piles.begin(), _piles.end(), _piles[_curPileIdx], [](const ExtrusionLayer &l, const ExtrusionLayer &r) { return l.bottom_z < r.bottom_z; });
-        return std::make_pair<int, int>(std::distance(_piles.begin(), begin), std::distance(_piles.begin(), end));
-    }
-    bool valid() const { return _curPileIdx < _piles.size(); }
-    void raise()
-    {
-        if (!valid()) { return; }
-        auto [b, e] = curRange();
-        _curPileIdx += (e - b);
-        _curBottomZ = _curPileIdx == _piles.size() ? _piles.back().bottom_z : _piles[_curPileIdx].bottom_z;
-    }
-    float curBottomZ() const { return _curBottomZ; }
-    LineWithIDs curLines() const
-    {
-        auto [b, e] = curRange();
-        LineWithIDs lines;
-        for (int i = b; i < e; ++i) {
-            for (const ExtrusionPath &path : _piles[i].paths) {
-                if (path.is_force_no_extrusion() == false) {
-                    Polyline check_polyline = path.polyline;
-                    check_polyline.translate(_offset);
-                    Lines tmpLines = check_polyline.lines();
-                    for (const Line &line : tmpLines) { lines.emplace_back(line, _id, path.role()); }
-                }
-            }
-        }
-        return lines;
-    }
-
-    friend bool operator>(const LinesBucket &left, const LinesBucket &right) { return left._curBottomZ > right._curBottomZ; }
-    friend bool operator<(const LinesBucket &left, const LinesBucket &right) { return left._curBottomZ < right._curBottomZ; }
-    friend bool operator==(const LinesBucket &left, const LinesBucket &right) { return left._curBottomZ == right._curBottomZ; }
-};
-
-struct LinesBucketPtrComp
-{
-    bool operator()(const LinesBucket *left, const LinesBucket *right) { return *left > *right; }
-};
-
-class LinesBucketQueue
-{
-public:
-    std::vector<LinesBucket>                                                           line_buckets;
-    std::priority_queue<LinesBucket *, std::vector<LinesBucket *>, LinesBucketPtrComp> line_bucket_ptr_queue;
-
-public:
-    void        emplace_back_bucket(ExtrusionLayers &&els, const void *objPtr, Point offset);
-    bool        valid() const { return line_bucket_ptr_queue.empty() == false; }
-    float       getCurrBottomZ();
-    LineWithIDs getCurLines() const;
-};
-
 void getExtrusionPathsFromEntity(const ExtrusionEntityCollection *entity, ExtrusionPaths &paths);
 
 ExtrusionLayers getExtrusionPathsFromLayer(const LayerRegionPtrs layerRegionPtrs);
 
 ExtrusionLayer getExtrusionPathsFromSupportLayer(SupportLayer *supportLayer);
 
-ObjectExtrusions getAllLayersExtrusionPathsFromObject(PrintObject *obj);
+ObjectExtrusions getAllLayersExtrusionPathsFromObject(const PrintObject *obj);
 
 struct ConflictComputeResult
 {
@@ -140,11 +72,77 @@ using ConflictComputeOpt = std::optional<ConflictComputeResult>;
 
 using ConflictObjName = std::optional<std::pair<std::string, std::string>>;
 
-struct ConflictChecker
+// Extrusion lines of a single layer of an object, in the coordinates of the object.
+struct ConflictLayerLines
+{
+    float                      bottom_z;
+    Lines                      lines;
+    std::vector<ExtrusionRole> roles;
+    BoundingBox                bbox;
+};
+
+// Layers of the walls and infill, of the support or of the wipe tower, sorted by bottom_z.
+struct ConflictStreamLines
+{
+    std::vector<ConflictLayerLines> layers;
+    BoundingBox                     bbox;
+};
+
+// Extrusion lines of an object or of the wipe tower, in the coordinates of the object. Immutable once built, thus shared
+// between consecutive checks until the extrusions of the object change. Only the first instance of an object is checked,
+// at the offset of that instance.
+struct ConflictObjectLines
 {
-    static ConflictResultOpt  find_inter_of_lines_in_diff_objs(PrintObjectPtrs objs, std::optional<const FakeWipeTower *> wtdptr);
+    std::vector<ConflictStreamLines> streams;
+};
+
+using ConflictObjectLinesPtr = std::shared_ptr<const ConflictObjectLines>;
+
+// Finds extrusions of different objects (or of an object and the wipe tower) crossing each other at the same height.
+// The objects are checked pair by pair: a pair of objects is only tested at the layers, where their bounding boxes
+// overlap, and only the lines inside the overlap are rasterized into a grid to find the crossing candidates.
+// An instance of the checker remembers the lines of the objects and the results of the pairs, thus when a single object
+// is moved or resliced, only the pairs with that object are checked again.
+class ConflictChecker
+{
+public:
+    // Conflict at the lowest height, if any.
+    ConflictResultOpt find_conflict(const PrintObjectPtrs &objs, std::optional<const FakeWipeTower *> wtdptr);
+    void              clear() { m_objects.clear(); m_pairs.clear(); m_wipe_tower.reset(); m_num_checked_pairs = 0; }
+    // Number of pairs, which were checked by the last find_conflict(), the results of the other pairs were reused.
+    size_t            num_checked_pairs() const { return m_num_checked_pairs; }
+
+    static ConflictResultOpt  find_inter_of_lines_in_diff_objs(PrintObjectPtrs objs, std::optional<const FakeWipeTower *> wtdptr)
+        { return ConflictChecker().find_conflict(objs, wtdptr); }
     static ConflictComputeOpt find_inter_of_lines(const LineWithIDs &lines);
     static ConflictComputeOpt line_intersect(const LineWithID &l1, const LineWithID &l2);
+
+    static ConflictObjectLinesPtr object_lines(const PrintObject &obj);
+    static ConflictObjectLinesPtr wipe_tower_lines(const FakeWipeTower &wipe_tower);
+    // Height of the lowest crossing of the extrusions of the two objects, placed at the given offsets.
+    static std::optional<float>   find_inter_of_objects(const ConflictObjectLines &lines1, const Point &offset1,
+                                                        const ConflictObjectLines &lines2, const Point &offset2);
+
+private:
+    struct ObjectEntry
+    {
+        // Timestamps of the steps producing the extrusions, see object_timestamps().
+        std::vector<size_t>    timestamps;
+        ConflictObjectLinesPtr lines;
+    };
+    struct PairEntry
+    {
+        ConflictObjectLinesPtr lines1;
+        ConflictObjectLinesPtr lines2;
+        Point                  offset1;
+        Point                  offset2;
+        std::optional<float>   conflict_z;
+    };
+
+    std::map<const PrintObject*, ObjectEntry>                 m_objects;
+    std::map<std::pair<const void*, const void*>, PairEntry> m_pairs;
+    ConflictObjectLinesPtr                                    m_wipe_tower;
+    size_t                                                    m_num_checked_pairs { 0 };
 };
 
 } // namespace Slic3r
@@ -1,8 +1,8 @@
 #include "../GCode.hpp"
 #include "CoolingBuffer.hpp"
-#include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/log/trivial.hpp>
+#include <array>
 #include <iostream>
 #include <float.h>
 #include <system_error>
@@ -299,27 +299,38 @@ finished:
 
 std::string CoolingBuffer::process_layer(std::string &&gcode, size_t layer_id, bool flush)
 {
-    // Cache the input G-code.
-    if (m_gcode.empty())
-        m_gcode = std::move(gcode);
-    else
-        m_gcode += gcode;
-
-    std::string out;
-    if (flush) {
+    LayerResult input { std::move(gcode), layer_id, false, flush };
+    input.moves = LayerMoves::parse(input.gcode, m_toolchange_prefix);
+    return this->process_layer(std::move(input)).gcode;
+}
+
+LayerResult CoolingBuffer::process_layer(LayerResult &&input)
+{
+    // Cache the input G-code together with its parsed lines.
+    if (m_gcode.empty()) {
+        m_gcode = std::move(input.gcode);
+        m_moves = std::move(input.moves);
+    } else {
+        m_moves.append(input.moves, m_gcode.size());
+        m_gcode += input.gcode;
+    }
+
+    LayerResult out { std::string(), input.layer_id, input.spiral_vase_enable, input.cooling_buffer_flush };
+    if (input.cooling_buffer_flush) {
         // This is either an object layer or the very last print layer. Calculate cool down over the collected support layers
         // and one object layer.
-        std::vector<PerExtruderAdjustments> per_extruder_adjustments = this->parse_layer_gcode(m_gcode, m_current_pos);
+        std::vector<PerExtruderAdjustments> per_extruder_adjustments = this->parse_layer_gcode(m_gcode, m_moves, m_current_pos);
         float layer_time_stretched = this->calculate_layer_slowdown(per_extruder_adjustments);
-        out = this->apply_layer_cooldown(m_gcode, layer_id, layer_time_stretched, per_extruder_adjustments);
+        out.gcode = this->apply_layer_cooldown(m_gcode, m_moves, input.layer_id, layer_time_stretched, per_extruder_adjustments, out.moves);
         m_gcode.clear();
+        m_moves.clear();
     }
     return out;
 }
 
 // Parse the layer G-code for the moves, which could be adjusted.
 // Return the list of parsed lines, bucketed by an extruder.
-std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::string &gcode, std::vector<float> &current_pos) const
+std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::string &gcode, const LayerMoves &moves, std::vector<float> &current_pos) const
 {
     std::vector<PerExtruderAdjustments> per_extruder_adjustments(m_extruder_ids.size());
     std::vector<size_t>                 map_extruder_to_per_extruder_adjustment(m_num_extruders, 0);
@@ -335,71 +346,48 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
 
     unsigned int      current_extruder  = m_current_extruder;
     PerExtruderAdjustments *adjustment  = &per_extruder_adjustments[map_extruder_to_per_extruder_adjustment[current_extruder]];
-    const char       *line_start = gcode.c_str();
-    const char       *line_end   = line_start;
     // Index of an existing CoolingLine of the current adjustment, which holds the feedrate setting command
     // for a sequence of extrusion moves.
     size_t            active_speed_modifier = size_t(-1);
 
-    for (; *line_start != 0; line_start = line_end) 
-    {
-        while (*line_end != '\n' && *line_end != 0)
-            ++ line_end;
-        // sline will not contain the trailing '\n'.
-        std::string sline(line_start, line_end);
-        // CoolingLine will contain the trailing '\n'.
-        if (*line_end == '\n')
-            ++ line_end;
-        CoolingLine line(0, line_start - gcode.c_str(), line_end - gcode.c_str());
-        if (boost::starts_with(sline, "G0 "))
+    for (const LayerMove &move : moves.moves) {
+        CoolingLine line(0, move.line_start, move.line_end);
+        if (move.type & LayerMove::TYPE_G0)
             line.type = CoolingLine::TYPE_G0;
-        else if (boost::starts_with(sline, "G1 "))
+        else if (move.type & LayerMove::TYPE_G1)
             line.type = CoolingLine::TYPE_G1;
-        else if (boost::starts_with(sline, "G92 "))
+        else if (move.type & LayerMove::TYPE_G92)
             line.type = CoolingLine::TYPE_G92;
-        else if (boost::starts_with(sline, "G2 "))
+        else if (move.type & LayerMove::TYPE_G2)
             line.type = CoolingLine::TYPE_G2;
-        else if (boost::starts_with(sline, "G3 "))
+        else if (move.type & LayerMove::TYPE_G3)
             line.type = CoolingLine::TYPE_G3;
         if (line.type) {
             // G0, G1 or G92
-            // Parse the G-code line.
-            std::vector<float> new_pos(current_pos);
-            const char *c = sline.data() + 3;
-            for (;;) {
-                // Skip whitespaces.
-                for (; *c == ' ' || *c == '\t'; ++ c);
-                if (*c == 0 || *c == ';')
-                    break;
-
-                assert(is_decimal_separator_point()); // for atof
-                //BBS: Parse the axis.
-                size_t axis = (*c >= 'X' && *c <= 'Z') ? (*c - 'X') :
-                              (*c == 'E') ? 3 : (*c == 'F') ? 4 :
-                              (*c == 'I') ? 5 : (*c == 'J') ? 6 : size_t(-1);
-                if (axis != size_t(-1)) {
-                    new_pos[axis] = float(atof(++c));
-                    if (axis == 4) {
-                        // Convert mm/min to mm/sec.
-                        new_pos[4] /= 60.f;
-                        if ((line.type & CoolingLine::TYPE_G92) == 0)
-                            // This is G0 or G1 line and it sets the feedrate. This mark is used for reducing the duplicate F calls.
-                            line.type |= CoolingLine::TYPE_HAS_F;
-                    } else if (axis == 5 || axis == 6) {
-                        // BBS: get position of arc center
-                        new_pos[axis] += current_pos[axis - 5];
-                    }
-                }
-                // Skip this word.
-                for (; *c != ' ' && *c != '\t' && *c != 0; ++ c);
+            //BBS: X, Y, Z, E, F, I, J of the parsed G-code line.
+            std::array<float, 7> new_pos;
+            std::copy(current_pos.begin(), current_pos.end(), new_pos.begin());
+            for (size_t axis = LayerMove::X; axis <= LayerMove::J; ++ axis)
+                if (move.has(LayerMove::Axis(axis)))
+                    new_pos[axis] = move.value(LayerMove::Axis(axis));
+            if (move.has(LayerMove::F)) {
+                // Convert mm/min to mm/sec.
+                new_pos[4] /= 60.f;
+                if ((line.type & CoolingLine::TYPE_G92) == 0)
+                    // This is G0 or G1 line and it sets the feedrate. This mark is used for reducing the duplicate F calls.
+                    line.type |= CoolingLine::TYPE_HAS_F;
             }
-            bool external_perimeter = boost::contains(sline, ";_EXTERNAL_PERIMETER");
-            bool wipe               = boost::contains(sline, ";_WIPE");
-            if (external_perimeter)
+            // BBS: get position of arc center
+            if (move.has(LayerMove::I))
+                new_pos[5] += current_pos[0];
+            if (move.has(LayerMove::J))
+                new_pos[6] += current_pos[1];
+            bool wipe = (move.type & LayerMove::TYPE_WIPE) != 0;
+            if (move.type & LayerMove::TYPE_EXTERNAL_PERIMETER)
                 line.type |= CoolingLine::TYPE_EXTERNAL_PERIMETER;
             if (wipe)
                 line.type |= CoolingLine::TYPE_WIPE;
-            if (boost::contains(sline, ";_EXTRUDE_SET_SPEED") && ! wipe) {
+            if ((move.type & LayerMove::TYPE_EXTRUDE_SET_SPEED) && ! wipe) {
                 line.type |= CoolingLine::TYPE_ADJUSTABLE;
                 active_speed_modifier = adjustment->lines.size();
             }
@@ -458,14 +446,13 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                     line.type = 0;
                 }
             }
-            current_pos = std::move(new_pos);
-        } else if (boost::starts_with(sline, ";_EXTRUDE_END")) {
+            current_pos.assign(new_pos.begin(), new_pos.end());
+        } else if (move.type & LayerMove::TYPE_EXTRUDE_END) {
             line.type = CoolingLine::TYPE_EXTRUDE_END;
             active_speed_modifier = size_t(-1);
-        } else if (boost::starts_with(sline, m_toolchange_prefix)) {
-            unsigned int new_extruder = 0;
-            auto ret = std::from_chars(sline.data() + m_toolchange_prefix.size(), sline.data() + sline.size(), new_extruder);
-            if (std::errc::invalid_argument != ret.ec) {
+        } else if (move.type & LayerMove::TYPE_SET_TOOL) {
+            if (move.tool >= 0) {
+                unsigned int new_extruder = unsigned(move.tool);
                 // Only change extruder in case the number is meaningful. User could provide an out-of-range index through custom gcodes -
                 // those shall be ignored.
                 if (new_extruder < map_extruder_to_per_extruder_adjustment.size()) {
@@ -478,27 +465,22 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                 } else {
                     // Only log the error in case of MM printer. Single extruder printers likely ignore any T anyway.
                     if (map_extruder_to_per_extruder_adjustment.size() > 1)
-                        BOOST_LOG_TRIVIAL(error) << "CoolingBuffer encountered an invalid toolchange, maybe from a custom gcode: " << sline;
+                        BOOST_LOG_TRIVIAL(error) << "CoolingBuffer encountered an invalid toolchange, maybe from a custom gcode: " << move.raw(gcode);
                 }
             }
-        } else if (boost::starts_with(sline, ";_OVERHANG_FAN_START")) {
+        } else if (move.type & LayerMove::TYPE_OVERHANG_FAN_START) {
             line.type = CoolingLine::TYPE_OVERHANG_FAN_START;
-        } else if (boost::starts_with(sline, ";_OVERHANG_FAN_END")) {
+        } else if (move.type & LayerMove::TYPE_OVERHANG_FAN_END) {
             line.type = CoolingLine::TYPE_OVERHANG_FAN_END;
-        } else if (boost::starts_with(sline, ";_SUPP_INTERFACE_FAN_START")) {
+        } else if (move.type & LayerMove::TYPE_SUPPORT_INTERFACE_FAN_START) {
             line.type = CoolingLine::TYPE_SUPPORT_INTERFACE_FAN_START;
-        } else if (boost::starts_with(sline, ";_SUPP_INTERFACE_FAN_END")) {
+        } else if (move.type & LayerMove::TYPE_SUPPORT_INTERFACE_FAN_END) {
             line.type = CoolingLine::TYPE_SUPPORT_INTERFACE_FAN_END;
-        } else if (boost::starts_with(sline, "G4 ")) {
-            // Parse the wait time.
+        } else if (move.type & LayerMove::TYPE_G4) {
+            // The wait time, S in seconds or P in milliseconds.
             line.type = CoolingLine::TYPE_G4;
-            size_t pos_S = sline.find('S', 3);
-            size_t pos_P = sline.find('P', 3);
-            assert(is_decimal_separator_point()); // for atof
-            line.time = line.time_max = float(
-                (pos_S > 0) ? atof(sline.c_str() + pos_S + 1) :
-                (pos_P > 0) ? atof(sline.c_str() + pos_P + 1) * 0.001 : 0.);
-        } else if (boost::starts_with(sline, ";_FORCE_RESUME_FAN_SPEED")) {
+            line.time = line.time_max = move.has(LayerMove::S) ? move.value(LayerMove::S) : move.has(LayerMove::P) ? move.value(LayerMove::P) * 0.001f : 0.f;
+        } else if (move.type & LayerMove::TYPE_FORCE_RESUME_FAN) {
             line.type = CoolingLine::TYPE_FORCE_RESUME_FAN;
         }
         if (line.type != 0)
@@ -708,12 +690,16 @@ float CoolingBuffer::calculate_layer_slowdown(std::vector<PerExtruderAdjustments
 std::string CoolingBuffer::apply_layer_cooldown(
     // Source G-code for the current layer.
     const std::string                      &gcode,
+    // Lines of the source G-code.
+    const LayerMoves                       &moves,
     // ID of the current layer, used to disable fan for the first n layers.
     size_t                                  layer_id, 
     // Total time of this layer after slow down, used to control the fan.
     float                                   layer_time,
     // Per extruder list of G-code lines and their cool down attributes.
-    std::vector<PerExtruderAdjustments>    &per_extruder_adjustments)
+    std::vector<PerExtruderAdjustments>    &per_extruder_adjustments,
+    // Lines of the adjusted G-code.
+    LayerMoves                             &moves_out)
 {
     // First sort the adjustment lines by of multiple extruders by their position in the source G-code.
     std::vector<const CoolingLine*> lines;
@@ -800,6 +786,28 @@ std::string CoolingBuffer::apply_layer_cooldown(
         }
     };
 
+    // Lines copied verbatim from the source G-code keep their parsed moves, only the lines emitted or modified here are parsed again.
+    moves_out.clear();
+    moves_out.reserve(moves.size() + moves.size() / 8);
+    size_t indexed_end = 0;
+    auto index_new_gcode = [this, &new_gcode, &moves_out, &indexed_end]() {
+        if (indexed_end < new_gcode.size()) {
+            moves_out.append_parsed(new_gcode, indexed_end, m_toolchange_prefix);
+            indexed_end = new_gcode.size();
+        }
+    };
+    auto copy_lines = [&gcode, &moves, &new_gcode, &moves_out, &indexed_end, &index_new_gcode](size_t begin, size_t end) {
+        assert(end > begin);
+        if ((new_gcode.empty() || new_gcode.back() == '\n') && gcode[end - 1] == '\n') {
+            index_new_gcode();
+            moves_out.append(moves, begin, end, ptrdiff_t(new_gcode.size()) - ptrdiff_t(begin));
+            new_gcode.append(gcode, begin, end - begin);
+            indexed_end = new_gcode.size();
+        } else
+            // Not aligned to the lines of the adjusted G-code, the block will be parsed.
+            new_gcode.append(gcode, begin, end - begin);
+    };
+
     const char         *pos               = gcode.c_str();
     int                 current_feedrate  = 0;
     change_extruder_set_fan(true);
@@ -815,7 +823,7 @@ std::string CoolingBuffer::apply_layer_cooldown(
         const char *line_start  = gcode.c_str() + line->line_start;
         const char *line_end    = gcode.c_str() + line->line_end;
         if (line_start > pos)
-            new_gcode.append(pos, line_start - pos);
+            copy_lines(pos - gcode.c_str(), line->line_start);
         if (line->type & CoolingLine::TYPE_SET_TOOL) {
             unsigned int new_extruder = 0;
             auto ret = std::from_chars(line_start + m_toolchange_prefix.size(), line_end, new_extruder);
@@ -825,7 +833,7 @@ std::string CoolingBuffer::apply_layer_cooldown(
                     change_extruder_set_fan(true);
                 }
             }
-            new_gcode.append(line_start, line_end - line_start);
+            copy_lines(line->line_start, line->line_end);
         } else if (line->type & CoolingLine::TYPE_OVERHANG_FAN_START) {
             if (overhang_fan_control && !fan_speed_change_requests[CoolingLine::TYPE_OVERHANG_FAN_START]) {
                 need_set_fan = true;
@@ -937,7 +945,7 @@ std::string CoolingBuffer::apply_layer_cooldown(
                 }
             }
         } else {
-            new_gcode.append(line_start, line_end - line_start);
+            copy_lines(line->line_start, line->line_end);
         }
 
         if (need_set_fan) {
@@ -961,7 +969,8 @@ std::string CoolingBuffer::apply_layer_cooldown(
     }
     const char *gcode_end = gcode.c_str() + gcode.size();
     if (pos < gcode_end)
-        new_gcode.append(pos, gcode_end - pos);
+        copy_lines(pos - gcode.c_str(), gcode.size());
+    index_new_gcode();
 
     return new_gcode;
 }
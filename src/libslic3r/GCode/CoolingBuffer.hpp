@@ -2,6 +2,7 @@
 #define slic3r_CoolingBuffer_hpp_
 
 #include "../libslic3r.h"
+#include "LayerMoves.hpp"
 #include <map>
 #include <string>
 
@@ -9,6 +10,7 @@ namespace Slic3r {
 
 class GCode;
 class Layer;
+struct LayerResult;
 struct PerExtruderAdjustments;
 
 // A standalone G-code filter, to control cooling of the print.
@@ -26,17 +28,23 @@ public:
     void        reset(const Vec3d &position);
     void        set_current_extruder(unsigned int extruder_id) { m_current_extruder = extruder_id; }
     std::string process_layer(std::string &&gcode, size_t layer_id, bool flush);
+    // Process the G-code of a layer using the LayerMoves parsed from it. The returned LayerResult contains
+    // the adjusted G-code together with its LayerMoves for the G-code filters following the CoolingBuffer.
+    LayerResult process_layer(LayerResult &&input);
 
 private:
 	CoolingBuffer& operator=(const CoolingBuffer&) = delete;
-    std::vector<PerExtruderAdjustments> parse_layer_gcode(const std::string &gcode, std::vector<float> &current_pos) const;
+    std::vector<PerExtruderAdjustments> parse_layer_gcode(const std::string &gcode, const LayerMoves &moves, std::vector<float> &current_pos) const;
     float       calculate_layer_slowdown(std::vector<PerExtruderAdjustments> &per_extruder_adjustments);
     // Apply slow down over G-code lines stored in per_extruder_adjustments, enable fan if needed.
-    // Returns the adjusted G-code.
-    std::string apply_layer_cooldown(const std::string &gcode, size_t layer_id, float layer_time, std::vector<PerExtruderAdjustments> &per_extruder_adjustments);
+    // Returns the adjusted G-code, fills in moves_out with the lines of the adjusted G-code.
+    std::string apply_layer_cooldown(const std::string &gcode, const LayerMoves &moves, size_t layer_id, float layer_time,
+                                     std::vector<PerExtruderAdjustments> &per_extruder_adjustments, LayerMoves &moves_out);
 
     // G-code snippet cached for the support layers preceding an object layer.
     std::string                 m_gcode;
+    // Lines of m_gcode.
+    LayerMoves                  m_moves;
     // Internal data.
     // BBS: X,Y,Z,E,F,I,J
     std::vector<char>           m_axis;
@@ -1,7 +1,5 @@
 #include "FanMover.hpp"
 
-#include "GCodeReader.hpp"
-
 #include <iomanip>
 /*
 #include <memory.h>
@@ -20,6 +18,11 @@
 namespace Slic3r {
 
 const std::string& FanMover::process_gcode(const std::string& gcode, bool flush)
+{
+    return this->process_gcode(gcode, LayerMoves::parse(gcode, {}), flush);
+}
+
+const std::string& FanMover::process_gcode(const std::string& gcode, const LayerMoves& moves, bool flush)
 {
     m_process_output = "";
 
@@ -27,9 +30,8 @@ const std::string& FanMover::process_gcode(const std::string& gcode, bool flush)
     m_buffer_time_size = 0;
     for (auto& data : m_buffer) m_buffer_time_size += data.time;
 
-    if(!gcode.empty())
-        m_parser.parse_buffer(gcode,
-            [this](GCodeReader& reader, const GCodeReader::GCodeLine& line) { /*m_process_output += line.raw() + "\n";*/ this->_process_gcode_line(reader, line); });
+    for (const LayerMove& line : moves.moves)
+        this->_process_gcode_line(gcode, line);
 
     if (flush) {
         while (!m_buffer.empty()) {
@@ -256,16 +258,21 @@ void FanMover::_process_T(const std::string_view command)
     }
 }
 
-void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCodeLine& line)
+void FanMover::_process_gcode_line(const std::string& gcode, const LayerMove& line)
 {
     // processes 'normal' gcode lines
     bool need_flush = false;
-    std::string cmd(line.cmd());
+    std::string cmd(line.cmd(gcode));
+    const std::string_view raw = line.raw(gcode);
+    if (line.has(LayerMove::E) && relative_e)
+        // With relative E distances, E is a distance, not a position.
+        m_position[LayerMove::E] = 0.f;
+    auto dist = [this, &line](LayerMove::Axis axis) { return line.has(axis) ? line.value(axis) - m_position[axis] : 0.f; };
     double time = 0;
     int16_t fan_speed = -1;
     if (cmd.length() > 1) {
-        if (line.has_f())
-            m_current_speed = line.f() / 60.0f;
+        if (line.has(LayerMove::F))
+            m_current_speed = line.value(LayerMove::F) / 60.0f;
         switch (::toupper(cmd[0])) {
         case 'T':
         case 't':
@@ -274,9 +281,9 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
         case 'G':
         {
             if (::atoi(&cmd[1]) == 1 || ::atoi(&cmd[1]) == 0) {
-                double distx = line.dist_X(reader);
-                double disty = line.dist_Y(reader);
-                double distz = line.dist_Z(reader);
+                double distx = dist(LayerMove::X);
+                double disty = dist(LayerMove::Y);
+                double distz = dist(LayerMove::Z);
                 double dist = distx * distx + disty * disty + distz * distz;
                 if (dist > 0) {
                     dist = std::sqrt(dist);
@@ -287,7 +294,7 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
         }
         case 'M':
         {
-            fan_speed = get_fan_speed(line.raw(), m_writer.config.gcode_flavor);
+            fan_speed = get_fan_speed(std::string(raw), m_writer.config.gcode_flavor);
             if (fan_speed >= 0) {
                 const auto fan_baseline = 255.0;
                 fan_speed = 100 * fan_speed / fan_baseline;
@@ -327,7 +334,7 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
                                     time_count -= it->time;
                                     if (time_count< 0) {
                                         //found something that is lower than us
-                                        _put_in_middle_G1(it, it->time + time_count, BufferData(std::string(line.raw()), 0, fan_speed, true));
+                                        _put_in_middle_G1(it, it->time + time_count, BufferData(std::string(raw), 0, fan_speed, true));
                                         //found, stop
                                         break;
                                     }
@@ -337,7 +344,7 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
                                     //can't place it in the buffer, use m_current_kickstart
                                     m_current_kickstart.fan_speed = fan_speed;
                                     m_current_kickstart.time = time_count;
-                                    m_current_kickstart.raw = line.raw();
+                                    m_current_kickstart.raw = raw;
                                 }
                                 m_front_buffer_fan_speed = fan_speed;
                             } else {
@@ -345,10 +352,11 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
                                 _remove_slow_fan(fan_speed, m_buffer_time_size + 1);
                                 // then write the fan command
                                 if (!m_buffer.empty() && (m_buffer_time_size - m_buffer.front().time * 0.1) > nb_seconds_delay) {
-                                    _print_in_middle_G1(m_buffer.front(), m_buffer_time_size - nb_seconds_delay, line.raw());
+                                    _print_in_middle_G1(m_buffer.front(), m_buffer_time_size - nb_seconds_delay, std::string(raw));
                                     remove_from_buffer(m_buffer.begin());
                                 } else {
-                                    m_process_output += line.raw() + "\n";
+                                    m_process_output += raw;
+                                    m_process_output += "\n";
                                 }
                                 m_front_buffer_fan_speed = fan_speed;
                             }
@@ -367,7 +375,7 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
                                     float kickstart_duration = kickstart * float(fan_speed - m_back_buffer_fan_speed) / 100.f;
                                     m_current_kickstart.fan_speed = fan_speed;
                                     m_current_kickstart.time += kickstart_duration;
-                                    m_current_kickstart.raw = line.raw();
+                                    m_current_kickstart.raw = raw;
                                     //i'm printed by the m_current_kickstart
                                     time = -1;
                                 }
@@ -385,7 +393,7 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
                                 //add the normal speed line for the future
                                 m_current_kickstart.fan_speed = fan_speed;
                                 m_current_kickstart.time = kickstart_duration;
-                                m_current_kickstart.raw = line.raw();
+                                m_current_kickstart.raw = raw;
                             }
                         }
                     }
@@ -400,16 +408,15 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
         }
         }
     } else {
-        if(!line.raw().empty() && line.raw().front() == ';')
+        if(!raw.empty() && raw.front() == ';')
         {
-            if (line.raw().size() > 10 && line.raw().rfind(";TYPE:", 0) == 0) {
+            if (raw.size() > 10 && raw.rfind(";TYPE:", 0) == 0) {
                 // get the type of the next extrusions
-                std::string extrusion_string = line.raw().substr(6, line.raw().size() - 6);
-                current_role = ExtrusionEntity::string_to_role(extrusion_string);
+                current_role = ExtrusionEntity::string_to_role(raw.substr(6));
             }
-            if (line.raw().size() > 16) {
-                if (line.raw().rfind("; custom gcode", 0) != std::string::npos)
-                    if (line.raw().rfind("; custom gcode end", 0) != std::string::npos)
+            if (raw.size() > 16) {
+                if (raw.rfind("; custom gcode", 0) != std::string_view::npos)
+                    if (raw.rfind("; custom gcode end", 0) != std::string_view::npos)
                         m_is_custom_gcode = false;
                     else
                         m_is_custom_gcode = true;
@@ -418,25 +425,25 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
     }
 
     if (time >= 0) {
-        BufferData& new_data = put_in_buffer(BufferData(line.raw(), time, fan_speed));
-        if (line.has(Axis::X)) {
-            new_data.x = reader.x();
-            new_data.dx = line.dist_X(reader);
+        BufferData& new_data = put_in_buffer(BufferData(std::string(raw), time, fan_speed));
+        if (line.has(LayerMove::X)) {
+            new_data.x = m_position[LayerMove::X];
+            new_data.dx = dist(LayerMove::X);
         }
-        if (line.has(Axis::Y)) {
-            new_data.y = reader.y();
-            new_data.dy = line.dist_Y(reader);
+        if (line.has(LayerMove::Y)) {
+            new_data.y = m_position[LayerMove::Y];
+            new_data.dy = dist(LayerMove::Y);
         }
-        if (line.has(Axis::Z)) {
-            new_data.z = reader.z();
-            new_data.dz = line.dist_Z(reader);
+        if (line.has(LayerMove::Z)) {
+            new_data.z = m_position[LayerMove::Z];
+            new_data.dz = dist(LayerMove::Z);
         }
-        if (line.has(Axis::E)) {
-            new_data.e = reader.e();
+        if (line.has(LayerMove::E)) {
+            new_data.e = m_position[LayerMove::E];
             if (relative_e)
-                new_data.de = line.e();
+                new_data.de = line.value(LayerMove::E);
             else
-                new_data.de = line.dist_E(reader);
+                new_data.de = dist(LayerMove::E);
         }
 
         if (m_current_kickstart.time > 0 && time > 0) {
@@ -494,6 +501,14 @@ void FanMover::_process_gcode_line(GCodeReader& reader, const GCodeReader::GCode
     double sum = 0;
     for (auto& data : m_buffer) sum += data.time;
     assert( std::abs(m_buffer_time_size - sum) < 0.01);
+
+    // update the position for G0 - G3 and G92
+    if (cmd.size() >= 2 && cmd[0] == 'G' &&
+        ((cmd.size() == 2 && cmd[1] >= '0' && cmd[1] <= '3') || (cmd.size() == 3 && cmd[1] == '9' && cmd[2] == '2'))) {
+        for (size_t axis = LayerMove::X; axis <= LayerMove::E; ++ axis)
+            if (line.has(LayerMove::Axis(axis)))
+                m_position[axis] = line.value(LayerMove::Axis(axis));
+    }
 }
 
 } // namespace Slic3r
@@ -7,8 +7,8 @@
 #include "../ExtrusionEntity.hpp"
 
 #include "../Point.hpp"
-#include "../GCodeReader.hpp"
 #include "../GCodeWriter.hpp"
+#include "LayerMoves.hpp"
 #include <regex>
 
 namespace Slic3r {
@@ -37,8 +37,9 @@ private:
     const bool only_overhangs;
     const float kickstart;
 
-    GCodeReader m_parser{};
     const GCodeWriter& m_writer;
+    // X, Y, Z, E position at the end of the last processed line.
+    float m_position[4] { 0.f, 0.f, 0.f, 0.f };
 
     //current value (at the back of the buffer), when parsing a new line
     ExtrusionRole current_role = ExtrusionRole::erCustom;
@@ -69,6 +70,8 @@ public:
 
     // Adds the gcode contained in the given string to the analysis and returns it after removing the workcodes
     const std::string& process_gcode(const std::string& gcode, bool flush);
+    // Same as above, reusing the lines of gcode parsed by the previous G-code filters.
+    const std::string& process_gcode(const std::string& gcode, const LayerMoves& moves, bool flush);
 
 private:
     BufferData& put_in_buffer(BufferData&& data) {
@@ -81,7 +84,7 @@ private:
         return m_buffer.erase(data);
     }
     // Processes the given gcode line
-    void _process_gcode_line(GCodeReader& reader, const GCodeReader::GCodeLine& line);
+    void _process_gcode_line(const std::string& gcode, const LayerMove& line);
     void _process_T(const std::string_view command);
     void _put_in_middle_G1(std::list<BufferData>::iterator item_to_split, float nb_sec, BufferData&& line_to_write);
     void _print_in_middle_G1(BufferData& line_to_split, float nb_sec, const std::string& line_to_write);
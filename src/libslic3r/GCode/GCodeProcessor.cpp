@@ -6,6 +6,7 @@
 #include "libslic3r/LocalesUtils.hpp"
 #include "libslic3r/format.hpp"
 #include "GCodeProcessor.hpp"
+#include "LayerMoves.hpp"
 
 #include <boost/log/trivial.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -389,7 +390,7 @@ void GCodeProcessor::TimeProcessor::reset()
     machine_limits = MachineEnvelopeConfig();
     filament_load_times = 0.0f;
     filament_unload_times = 0.0f;
-
+    post_process_lines = {};
 
     for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
         machines[i].reset();
@@ -397,7 +398,7 @@ void GCodeProcessor::TimeProcessor::reset()
     machines[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)].enabled = true;
 }
 
-void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, std::vector<GCodeProcessorResult::MoveVertex>& moves, std::vector<size_t>& lines_ends, size_t total_layer_num)
+void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, GCodeProcessorResult::MoveVertices& moves, std::vector<size_t>& lines_ends, size_t total_layer_num)
 {
     FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
     if (in.f == nullptr)
@@ -473,74 +474,65 @@ void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, st
     std::string export_line;
 
     // replace placeholder lines with the proper final value
-    // gcode_line is in/out parameter, to reduce expensive memory allocation
-    auto process_placeholders = [&](std::string& gcode_line) {
+    // tag is the placeholder recorded for the line, the replacement is returned in ret
+    // to reduce expensive memory allocation
+    std::string ret;
+    auto process_placeholders = [&](const ETags tag) {
         int extra_lines_count = 0;
 
-        // remove trailing '\n'
-        auto line = std::string_view(gcode_line).substr(0, gcode_line.length() - 1);
-
-        std::string ret;
-        if (line.length() > 1) {
-            line = line.substr(1);
-            if (line == reserved_tag(ETags::First_Line_M73_Placeholder) || line == reserved_tag(ETags::Last_Line_M73_Placeholder)) {
-                if (disable_m73) {
-                    // Remove current line
-                    gcode_line = "";
-                    return std::tuple(true, -1);
-                }
+        ret.clear();
+        if (tag == ETags::First_Line_M73_Placeholder || tag == ETags::Last_Line_M73_Placeholder) {
+            if (disable_m73)
+                // Remove current line
+                return std::tuple(true, -1);
+
+            for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
+                const TimeMachine& machine = machines[i];
+                if (machine.enabled) {
+                    // export pair <percent, remaining time>
+                    ret += format_line_M73_main(machine.line_m73_main_mask.c_str(),
+                        (tag == ETags::First_Line_M73_Placeholder) ? 0 : 100,
+                        (tag == ETags::First_Line_M73_Placeholder) ? time_in_minutes(machine.time) : 0);
+                    ++extra_lines_count;
 
-                for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
-                    const TimeMachine& machine = machines[i];
-                    if (machine.enabled) {
-                        // export pair <percent, remaining time>
-                        ret += format_line_M73_main(machine.line_m73_main_mask.c_str(),
-                            (line == reserved_tag(ETags::First_Line_M73_Placeholder)) ? 0 : 100,
-                            (line == reserved_tag(ETags::First_Line_M73_Placeholder)) ? time_in_minutes(machine.time) : 0);
+                    // export remaining time to next printer stop
+                    if (tag == ETags::First_Line_M73_Placeholder && !machine.stop_times.empty()) {
+                        int to_export_stop = time_in_minutes(machine.stop_times.front().elapsed_time);
+                        ret += format_line_M73_stop_int(machine.line_m73_stop_mask.c_str(), to_export_stop);
+                        last_exported_stop[i] = to_export_stop;
                         ++extra_lines_count;
-
-                        // export remaining time to next printer stop
-                        if (line == reserved_tag(ETags::First_Line_M73_Placeholder) && !machine.stop_times.empty()) {
-                            int to_export_stop = time_in_minutes(machine.stop_times.front().elapsed_time);
-                            ret += format_line_M73_stop_int(machine.line_m73_stop_mask.c_str(), to_export_stop);
-                            last_exported_stop[i] = to_export_stop;
-                            ++extra_lines_count;
-                        }
                     }
                 }
             }
-            else if (line == reserved_tag(ETags::Estimated_Printing_Time_Placeholder)) {
-                for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
-                    const TimeMachine& machine = machines[i];
-                    PrintEstimatedStatistics::ETimeMode mode = static_cast<PrintEstimatedStatistics::ETimeMode>(i);
-                    if (mode == PrintEstimatedStatistics::ETimeMode::Normal || machine.enabled) {
-                        char buf[128];
+        }
+        else if (tag == ETags::Estimated_Printing_Time_Placeholder) {
+            for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
+                const TimeMachine& machine = machines[i];
+                PrintEstimatedStatistics::ETimeMode mode = static_cast<PrintEstimatedStatistics::ETimeMode>(i);
+                if (mode == PrintEstimatedStatistics::ETimeMode::Normal || machine.enabled) {
+                    char buf[128];
 						if(!s_IsBBLPrinter)
-                            // SoftFever: compatibility with klipper_estimator
-                            sprintf(buf, "; estimated printing time (normal mode) = %s\n", get_time_dhms(machine.time).c_str());
+                        // SoftFever: compatibility with klipper_estimator
+                        sprintf(buf, "; estimated printing time (normal mode) = %s\n", get_time_dhms(machine.time).c_str());
 						else {
-                        //sprintf(buf, "; estimated printing time (%s mode) = %s\n",
-                        //    (mode == PrintEstimatedStatistics::ETimeMode::Normal) ? "normal" : "silent",
-                        //    get_time_dhms(machine.time).c_str());
-                        sprintf(buf, "; model printing time: %s; total estimated time: %s\n",
-                                get_time_dhms(machine.time - machine.prepare_time).c_str(),
-                                get_time_dhms(machine.time).c_str());
-                        }
-                        ret += buf;
+                    //sprintf(buf, "; estimated printing time (%s mode) = %s\n",
+                    //    (mode == PrintEstimatedStatistics::ETimeMode::Normal) ? "normal" : "silent",
+                    //    get_time_dhms(machine.time).c_str());
+                    sprintf(buf, "; model printing time: %s; total estimated time: %s\n",
+                            get_time_dhms(machine.time - machine.prepare_time).c_str(),
+                            get_time_dhms(machine.time).c_str());
                     }
+                    ret += buf;
                 }
             }
-            //BBS: write total layer number
-            else if (line == reserved_tag(ETags::Total_Layer_Number_Placeholder)) {
-                char buf[128];
-                sprintf(buf, "; total layer number: %zd\n", total_layer_num);
-                ret += buf;
-            }
+        }
+        //BBS: write total layer number
+        else if (tag == ETags::Total_Layer_Number_Placeholder) {
+            char buf[128];
+            sprintf(buf, "; total layer number: %zd\n", total_layer_num);
+            ret += buf;
         }
 
-        if (! ret.empty())
-            // Not moving the move operator on purpose, so that the gcode_line allocation will grow and it will not be reallocated after handful of lines are processed.
-            gcode_line = ret;
         return std::tuple(!ret.empty(), (extra_lines_count == 0) ? extra_lines_count : extra_lines_count - 1);
     };
 
@@ -648,9 +640,9 @@ void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, st
             boost::nowide::remove(out_path.c_str());
             throw Slic3r::RuntimeError(std::string("Time estimator post process export failed.\nIs the disk full?\n"));
         }
-        for (size_t i = 0; i < export_line.size(); ++ i)
-            if (export_line[i] == '\n')
-                lines_ends.emplace_back(out_file_pos + i + 1);
+        for (const char *begin = export_line.data(), *end = begin + export_line.size(), *it = begin;
+             (it = static_cast<const char*>(memchr(it, '\n', end - it))) != nullptr; ++ it)
+            lines_ends.emplace_back(out_file_pos + (it - begin) + 1);
         out_file_pos += export_line.size();
         export_line.clear();
     };
@@ -659,67 +651,99 @@ void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, st
     std::vector<std::pair<unsigned int, unsigned int>> offsets;
 
     {
-        // Read the input stream 64kB at a time, extract lines and process them.
+        // Process a single line including its end of line characters. The line is processed in place inside the read buffer,
+        // it is only copied into gcode_line if it crosses the boundary of the read buffer.
+        // The lines to be replaced or to be preceded by M73 lines were recorded by process_buffer(),
+        // the lines are not parsed again, they are only matched by their line ids.
+        auto it_move        = post_process_lines.moves.begin();
+        auto it_m73         = post_process_lines.m73.begin();
+        auto it_placeholder = post_process_lines.placeholders.begin();
+        auto process_line = [&](const std::string_view line) {
+            ++line_id;
+
+            // replace placeholder lines
+            bool processed = false;
+            if (it_placeholder != post_process_lines.placeholders.end() && it_placeholder->first == line_id) {
+                int lines_added_count;
+                std::tie(processed, lines_added_count) = process_placeholders((it_placeholder ++)->second);
+                if (processed && lines_added_count != 0)
+                    offsets.push_back({ line_id, lines_added_count });
+            }
+
+            if (!disable_m73 && !processed && !is_temporary_decoration(line) &&
+                it_move != post_process_lines.moves.end() && *it_move == line_id) {
+                ++ it_move;
+                // remove temporary lines, add lines M73 where needed
+                unsigned int extra_lines_count = process_line_move(g1_lines_counter ++);
+                if (extra_lines_count > 0)
+                    offsets.push_back({ line_id, extra_lines_count });
+            }
+
+            if (disable_m73 && !processed && it_m73 != post_process_lines.m73.end() && *it_m73 == line_id) {
+                ++ it_m73;
+                // Remove any existing M73 command
+                offsets.push_back({line_id, -1});
+                return;
+            }
+
+            if (processed)
+                export_line += ret;
+            else
+                export_line += line;
+            if (export_line.length() > 65535)
+                write_string(export_line);
+        };
+
+        // Read the input stream 640kB at a time, extract lines and process them.
         std::vector<char> buffer(65536 * 10, 0);
-        // Line buffer.
+        // Line buffer for the lines crossing the boundary of the read buffer.
         assert(gcode_line.empty());
         for (;;) {
             size_t cnt_read = ::fread(buffer.data(), 1, buffer.size(), in.f);
             if (::ferror(in.f))
                 throw Slic3r::RuntimeError(std::string("Time estimator post process export failed.\nError while reading from file.\n"));
             bool eof       = cnt_read == 0;
-            auto it        = buffer.begin();
-            auto it_bufend = buffer.begin() + cnt_read;
-            while (it != it_bufend || (eof && ! gcode_line.empty())) {
+            const char *it        = buffer.data();
+            const char *it_bufend = buffer.data() + cnt_read;
+            if (! eof && ! gcode_line.empty() && gcode_line.back() == '\r') {
+                // Finish the line, which "\r\n" end of line was split between the blocks.
+                if (*it == '\n')
+                    gcode_line += *it ++;
+                process_line(gcode_line);
+                gcode_line.clear();
+            }
+            while (it != it_bufend) {
                 // Find end of line.
-                bool eol    = false;
-                auto it_end = it;
-                for (; it_end != it_bufend && ! (eol = *it_end == '\r' || *it_end == '\n'); ++ it_end) ;
-                // End of line is indicated also if end of file was reached.
-                eol |= eof && it_end == it_bufend;
-                gcode_line.insert(gcode_line.end(), it, it_end);
-                if (eol) {
-                    ++line_id;
-
-                    // determine the end of line character and pass to output
-                    gcode_line += *it_end;
-                    if(*it_end == '\r' && *(++ it_end) == '\n')
-                        gcode_line += '\n';
-                    // replace placeholder lines
-                    auto [processed, lines_added_count] = process_placeholders(gcode_line);
-                    if (processed && lines_added_count != 0)
-                        offsets.push_back({ line_id, lines_added_count });
-
-                    if (!disable_m73 && !processed &&!is_temporary_decoration(gcode_line) &&
-                        (GCodeReader::GCodeLine::cmd_is(gcode_line, "G1") || 
-                            GCodeReader::GCodeLine::cmd_is(gcode_line, "G2") ||
-                            GCodeReader::GCodeLine::cmd_is(gcode_line, "G3"))) {
-                        // remove temporary lines, add lines M73 where needed
-                        unsigned int extra_lines_count = process_line_move(g1_lines_counter ++);
-                        if (extra_lines_count > 0)
-                            offsets.push_back({ line_id, extra_lines_count });
-                    }
-
-                    if (disable_m73 && !processed && GCodeReader::GCodeLine::cmd_is(gcode_line, "M73")) {
-                        // Remove any existing M73 command
-                        gcode_line = "";
-                        offsets.push_back({line_id, -1});
-                    }
-
-                    export_line += gcode_line;
-                    if (export_line.length() > 65535)
-                        write_string(export_line);
+                const char *it_end = it;
+                for (; it_end != it_bufend && *it_end != '\r' && *it_end != '\n'; ++ it_end) ;
+                if (it_end == it_bufend || (*it_end == '\r' && it_end + 1 == it_bufend)) {
+                    // The line continues in the next block, or its "\r\n" end of line is split between the blocks.
+                    gcode_line.append(it, it_bufend);
+                    it = it_bufend;
+                    break;
+                }
+                // Include the end of line characters.
+                if (*it_end == '\r' && it_end[1] == '\n')
+                    ++ it_end;
+                ++ it_end;
+                if (gcode_line.empty())
+                    process_line(std::string_view(it, it_end - it));
+                else {
+                    gcode_line.append(it, it_end);
+                    process_line(gcode_line);
                     gcode_line.clear();
                 }
-                // Skip EOL.
-                it = it_end; 
-                if (it != it_bufend && *it == '\r')
-                    ++ it;
-                if (it != it_bufend && *it == '\n')
-                    ++ it;
+                it = it_end;
             }
-            if (eof)
+            if (eof) {
+                if (! gcode_line.empty()) {
+                    // Last line without the end of line.
+                    gcode_line += '\n';
+                    process_line(gcode_line);
+                    gcode_line.clear();
+                }
                 break;
+            }
         }
     }
 
@@ -733,12 +757,12 @@ void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, st
     // updates moves' gcode ids which have been modified by the insertion of the M73 lines
     unsigned int curr_offset_id = 0;
     unsigned int total_offset = 0;
-    for (GCodeProcessorResult::MoveVertex& move : moves) {
-        while (curr_offset_id < static_cast<unsigned int>(offsets.size()) && offsets[curr_offset_id].first <= move.gcode_id) {
+    for (size_t i = 0; i < moves.size(); ++i) {
+        while (curr_offset_id < static_cast<unsigned int>(offsets.size()) && offsets[curr_offset_id].first <= moves.gcode_id(i)) {
             total_offset += offsets[curr_offset_id].second;
             ++curr_offset_id;
         }
-        move.gcode_id += total_offset;
+        moves.set_gcode_id(i, moves.gcode_id(i) + total_offset);
     }
 
     if (rename_file(out_path, filename)) {
@@ -845,12 +869,172 @@ void GCodeProcessor::UsedFilaments::process_caches(GCodeProcessor* processor)
     process_wipe_tower_cache(processor);
 }
 
+void GCodeProcessorResult::MoveVertices::clear()
+{
+    m_gcode_id.clear();
+    m_type.clear();
+    m_extrusion_role.clear();
+    m_extruder_id.clear();
+    m_cp_color_id.clear();
+    m_move_path_type.clear();
+    m_position.clear();
+    m_delta_extruder.clear();
+    m_feedrate.clear();
+    m_width.clear();
+    m_height.clear();
+    m_mm3_per_mm.clear();
+    m_fan_speed.clear();
+    m_temperature.clear();
+    m_time.clear();
+    m_layer_duration.clear();
+    m_arc_move_ids.clear();
+    m_arc_centers.clear();
+    m_arc_points_begin.assign(1, 0);
+    m_arc_points.clear();
+}
+
+void GCodeProcessorResult::MoveVertices::push_back(const MoveVertex& move)
+{
+    if (move.is_arc_move()) {
+        m_arc_move_ids.push_back(static_cast<unsigned int>(this->size()));
+        m_arc_centers.push_back(move.arc_center_position);
+        const Vec3f* points = move.interpolation_points.begin();
+        const size_t points_count = move.interpolation_points.size();
+        if (points_count > 0 && std::less_equal<const Vec3f*>()(m_arc_points.data(), points) &&
+            std::less<const Vec3f*>()(points, m_arc_points.data() + m_arc_points.size())) {
+            // The points of a move decoded from this container, inserting them may reallocate m_arc_points.
+            const size_t offset = points - m_arc_points.data();
+            m_arc_points.reserve(m_arc_points.size() + points_count);
+            for (size_t i = 0; i < points_count; ++i)
+                m_arc_points.push_back(m_arc_points[offset + i]);
+        }
+        else
+            m_arc_points.insert(m_arc_points.end(), points, points + points_count);
+        m_arc_points_begin.push_back(static_cast<unsigned int>(m_arc_points.size()));
+    }
+
+    m_gcode_id.push_back(move.gcode_id);
+    m_type.push_back(move.type);
+    m_extrusion_role.push_back(move.extrusion_role);
+    m_extruder_id.push_back(move.extruder_id);
+    m_cp_color_id.push_back(move.cp_color_id);
+    m_move_path_type.push_back(move.move_path_type);
+    m_position.push_back(move.position);
+    m_delta_extruder.push_back(move.delta_extruder);
+    m_feedrate.push_back(move.feedrate);
+    m_width.push_back(Eigen::half(move.width));
+    m_height.push_back(Eigen::half(move.height));
+    m_mm3_per_mm.push_back(move.mm3_per_mm);
+    m_fan_speed.push_back(move.fan_speed);
+    m_temperature.push_back(move.temperature);
+    m_time.push_back(move.time);
+    m_layer_duration.push_back(move.layer_duration);
+}
+
+void GCodeProcessorResult::MoveVertices::erase(size_t id)
+{
+    if (const int arc = this->arc_id(id); arc >= 0) {
+        const unsigned int points_begin = m_arc_points_begin[arc];
+        const unsigned int points_count = m_arc_points_begin[arc + 1] - points_begin;
+        m_arc_points.erase(m_arc_points.begin() + points_begin, m_arc_points.begin() + points_begin + points_count);
+        m_arc_move_ids.erase(m_arc_move_ids.begin() + arc);
+        m_arc_centers.erase(m_arc_centers.begin() + arc);
+        m_arc_points_begin.erase(m_arc_points_begin.begin() + arc + 1);
+        for (size_t i = arc + 1; i < m_arc_points_begin.size(); ++i)
+            m_arc_points_begin[i] -= points_count;
+    }
+    for (unsigned int& arc_move_id : m_arc_move_ids)
+        if (arc_move_id > id)
+            --arc_move_id;
+
+    auto erase_at = [id](auto& column) { column.erase(column.begin() + id); };
+    erase_at(m_gcode_id);
+    erase_at(m_type);
+    erase_at(m_extrusion_role);
+    erase_at(m_extruder_id);
+    erase_at(m_cp_color_id);
+    erase_at(m_move_path_type);
+    erase_at(m_position);
+    erase_at(m_delta_extruder);
+    erase_at(m_feedrate);
+    erase_at(m_width);
+    erase_at(m_height);
+    erase_at(m_mm3_per_mm);
+    erase_at(m_fan_speed);
+    erase_at(m_temperature);
+    erase_at(m_time);
+    erase_at(m_layer_duration);
+}
+
+GCodeProcessorResult::MoveVertex GCodeProcessorResult::MoveVertices::operator[](size_t id) const
+{
+    MoveVertex move;
+    move.gcode_id = m_gcode_id[id];
+    move.type = m_type[id];
+    move.extrusion_role = m_extrusion_role[id];
+    move.extruder_id = m_extruder_id[id];
+    move.cp_color_id = m_cp_color_id[id];
+    move.position = m_position[id];
+    move.delta_extruder = m_delta_extruder[id];
+    move.feedrate = m_feedrate[id];
+    move.width = this->width(id);
+    move.height = this->height(id);
+    move.mm3_per_mm = m_mm3_per_mm[id];
+    move.fan_speed = m_fan_speed[id];
+    move.temperature = m_temperature[id];
+    move.time = m_time[id];
+    move.layer_duration = m_layer_duration[id];
+    move.move_path_type = m_move_path_type[id];
+    if (const int arc = this->arc_id(id); arc >= 0) {
+        move.arc_center_position = m_arc_centers[arc];
+        move.interpolation_points = InterpolationPoints(m_arc_points.data() + m_arc_points_begin[arc], m_arc_points.data() + m_arc_points_begin[arc + 1]);
+    }
+    return move;
+}
+
+size_t GCodeProcessorResult::MoveVertices::memsize() const
+{
+    return SLIC3R_STDVEC_MEMSIZE(m_gcode_id, unsigned int) + SLIC3R_STDVEC_MEMSIZE(m_type, EMoveType) +
+        SLIC3R_STDVEC_MEMSIZE(m_extrusion_role, ExtrusionRole) + SLIC3R_STDVEC_MEMSIZE(m_extruder_id, unsigned char) +
+        SLIC3R_STDVEC_MEMSIZE(m_cp_color_id, unsigned char) + SLIC3R_STDVEC_MEMSIZE(m_move_path_type, EMovePathType) +
+        SLIC3R_STDVEC_MEMSIZE(m_position, Vec3f) + SLIC3R_STDVEC_MEMSIZE(m_delta_extruder, float) +
+        SLIC3R_STDVEC_MEMSIZE(m_feedrate, float) + SLIC3R_STDVEC_MEMSIZE(m_width, Eigen::half) +
+        SLIC3R_STDVEC_MEMSIZE(m_height, Eigen::half) + SLIC3R_STDVEC_MEMSIZE(m_mm3_per_mm, float) +
+        SLIC3R_STDVEC_MEMSIZE(m_fan_speed, float) + SLIC3R_STDVEC_MEMSIZE(m_temperature, float) +
+        SLIC3R_STDVEC_MEMSIZE(m_time, float) + SLIC3R_STDVEC_MEMSIZE(m_layer_duration, float) +
+        SLIC3R_STDVEC_MEMSIZE(m_arc_move_ids, unsigned int) + SLIC3R_STDVEC_MEMSIZE(m_arc_centers, Vec3f) +
+        SLIC3R_STDVEC_MEMSIZE(m_arc_points_begin, unsigned int) + SLIC3R_STDVEC_MEMSIZE(m_arc_points, Vec3f);
+}
+
+Vec3f GCodeProcessorResult::MoveVertices::arc_center_position(size_t id) const
+{
+    const int arc = this->arc_id(id);
+    return arc >= 0 ? m_arc_centers[arc] : Vec3f::Zero();
+}
+
+GCodeProcessorResult::InterpolationPoints GCodeProcessorResult::MoveVertices::interpolation_points(size_t id) const
+{
+    const int arc = this->arc_id(id);
+    return arc >= 0 ?
+        InterpolationPoints(m_arc_points.data() + m_arc_points_begin[arc], m_arc_points.data() + m_arc_points_begin[arc + 1]) :
+        InterpolationPoints();
+}
+
+int GCodeProcessorResult::MoveVertices::arc_id(size_t id) const
+{
+    if (!this->is_arc_move(id))
+        return -1;
+    auto it = std::lower_bound(m_arc_move_ids.begin(), m_arc_move_ids.end(), static_cast<unsigned int>(id));
+    assert(it != m_arc_move_ids.end() && *it == id);
+    return static_cast<int>(it - m_arc_move_ids.begin());
+}
+
 #if ENABLE_GCODE_VIEWER_STATISTICS
 void GCodeProcessorResult::reset() {
     //BBS: add mutex for protection of gcode result
     lock();
 
-    moves = std::vector<GCodeProcessorResult::MoveVertex>();
+    moves = MoveVertices();
     printable_area = Pointfs();
     //BBS: add bed exclude area
     bed_exclude_area = Pointfs();
@@ -1514,7 +1698,7 @@ void GCodeProcessor::process_file(const std::string& filename, std::function<voi
     m_result.filename = filename;
     m_result.id = ++s_result_id;
     // 1st move must be a dummy move
-    m_result.moves.emplace_back(GCodeProcessorResult::MoveVertex());
+    m_result.moves.push_back(GCodeProcessorResult::MoveVertex());
     size_t parse_line_callback_cntr = 10000;
     m_parser.parse_file(filename, [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
         if (-- parse_line_callback_cntr == 0) {
@@ -1542,24 +1726,75 @@ void GCodeProcessor::initialize(const std::string& filename)
     m_result.filename = filename;
     m_result.id = ++s_result_id;
     // 1st move must be a dummy move
-    m_result.moves.emplace_back(GCodeProcessorResult::MoveVertex());
+    m_result.moves.push_back(GCodeProcessorResult::MoveVertex());
 }
 
 void GCodeProcessor::process_buffer(const std::string &buffer)
 {
-    //FIXME maybe cache GCodeLine gline to be over multiple parse_buffer() invocations.
-    m_parser.parse_buffer(buffer, [this](GCodeReader&, const GCodeReader::GCodeLine& line) { 
+    this->process_buffer(buffer.c_str(), buffer.size());
+}
+
+void GCodeProcessor::process_buffer(const char *buffer, size_t length)
+{
+    m_parser.parse_buffer(buffer, buffer + length, m_buffer_line, [this](GCodeReader&, const GCodeReader::GCodeLine& line) {
         this->process_gcode_line(line, false);
+        this->record_post_process_line(line);
     });
 }
 
+static_assert(int(LayerMove::X) == X && int(LayerMove::Y) == Y && int(LayerMove::Z) == Z && int(LayerMove::E) == E &&
+              int(LayerMove::F) == F && int(LayerMove::I) == I && int(LayerMove::J) == J && int(LayerMove::P) == P,
+              "LayerMove axes must be ordered as Slic3r::Axis");
+
+void GCodeProcessor::process_buffer(const std::string &buffer, const LayerMoves &moves)
+{
+    assert(moves.empty() || moves.moves.back().line_end == buffer.size());
+    // GCodeReader ends a line at a lone '\r' as well, LayerMoves does not. Parse such G-code again,
+    // so that the line ids stay in sync with post_process().
+    if (moves.empty() || memchr(buffer.data(), '\r', buffer.size()) != nullptr) {
+        this->process_buffer(buffer.c_str(), buffer.size());
+        return;
+    }
+    auto callback = [this](GCodeReader&, const GCodeReader::GCodeLine& line) {
+        this->process_gcode_line(line, false);
+        this->record_post_process_line(line);
+    };
+    for (const LayerMove &move : moves.moves) {
+        // S and the other unknown axes are all UNKNOWN_AXIS for the GCodeReader.
+        uint32_t axis_mask = move.axis_mask & ((1 << NUM_AXES) - 1);
+        if (move.axis_mask & ((1 << LayerMove::S) | (1 << LayerMove::UnknownAxis)))
+            axis_mask |= 1 << UNKNOWN_AXIS;
+        m_parser.process_parsed_line(move.raw(buffer), move.cmd(buffer), move.axis_values, axis_mask, m_buffer_line, callback);
+    }
+}
+
+void GCodeProcessor::record_post_process_line(const GCodeReader::GCodeLine& line)
+{
+    TimeProcessor::PostProcessLines &lines = m_time_processor.post_process_lines;
+    const std::string_view cmd = line.cmd();
+    if (cmd.empty()) {
+        const std::string &raw = line.raw();
+        if (raw.size() > 1 && raw.front() == ';')
+            for (ETags tag : { ETags::First_Line_M73_Placeholder, ETags::Last_Line_M73_Placeholder,
+                               ETags::Estimated_Printing_Time_Placeholder, ETags::Total_Layer_Number_Placeholder })
+                if (std::string_view(raw).substr(1) == reserved_tag(tag)) {
+                    lines.placeholders.emplace_back(m_line_id, tag);
+                    break;
+                }
+    } else if (m_time_processor.disable_m73) {
+        if (cmd == "M73")
+            lines.m73.emplace_back(m_line_id);
+    } else if (cmd == "G1" || cmd == "G2" || cmd == "G3")
+        lines.moves.emplace_back(m_line_id);
+}
+
 void GCodeProcessor::finalize(bool post_process)
 {
     // update width/height of wipe moves
-    for (GCodeProcessorResult::MoveVertex& move : m_result.moves) {
-        if (move.type == EMoveType::Wipe) {
-            move.width = Wipe_Width;
-            move.height = Wipe_Height;
+    for (size_t i = 0; i < m_result.moves.size(); ++i) {
+        if (m_result.moves.type(i) == EMoveType::Wipe) {
+            m_result.moves.set_width(i, Wipe_Width);
+            m_result.moves.set_height(i, Wipe_Height);
         }
     }
 
@@ -1583,12 +1818,12 @@ void GCodeProcessor::finalize(bool post_process)
     //update times for results
     for (size_t i = 0; i < m_result.moves.size(); i++) {
         //field layer_duration contains the layer id for the move in which the layer_duration has to be set.
-        size_t layer_id = size_t(m_result.moves[i].layer_duration);
+        size_t layer_id = size_t(m_result.moves.layer_duration(i));
         std::vector<float>& layer_times = m_result.print_statistics.modes[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)].layers_times;
         if (layer_times.size() > layer_id - 1 && layer_id > 0)
-            m_result.moves[i].layer_duration = layer_id == 1 ? std::max(0.f,layer_times[layer_id - 1] - prepare_time) : layer_times[layer_id - 1];
+            m_result.moves.set_layer_duration(i, layer_id == 1 ? std::max(0.f,layer_times[layer_id - 1] - prepare_time) : layer_times[layer_id - 1]);
         else
-            m_result.moves[i].layer_duration = 0;
+            m_result.moves.set_layer_duration(i, 0);
     }
     
 #if ENABLE_GCODE_VIEWER_DATA_CHECKING
@@ -4197,8 +4432,8 @@ void GCodeProcessor::store_move_vertex(EMoveType type, EMovePathType path_type)
         ((type == EMoveType::Seam) ? m_last_line_id : m_line_id);
 
     //BBS: apply plate's and extruder's offset to arc interpolation points
-    if (path_type == EMovePathType::Arc_move_cw ||
-        path_type == EMovePathType::Arc_move_ccw) {
+    const bool is_arc_move = path_type == EMovePathType::Arc_move_cw || path_type == EMovePathType::Arc_move_ccw;
+    if (is_arc_move) {
         for (size_t i = 0; i < m_interpolation_points.size(); i++)
             m_interpolation_points[i] =
                 Vec3f(m_interpolation_points[i].x() + m_x_offset,
@@ -4227,7 +4462,9 @@ void GCodeProcessor::store_move_vertex(EMoveType type, EMovePathType path_type)
         //BBS: add arc move related data
         path_type,
         Vec3f(m_arc_center(0, 0) + m_x_offset, m_arc_center(1, 0) + m_y_offset, m_arc_center(2, 0)) + m_extruder_offsets[m_extruder_id],
-        m_interpolation_points,
+        // The interpolation points are recalculated for each arc move and copied by the moves into the arc move vertex only,
+        // the other moves would only store a stale copy of the points of the last arc.
+        is_arc_move ? GCodeProcessorResult::InterpolationPoints(m_interpolation_points) : GCodeProcessorResult::InterpolationPoints(),
     });
 
     // stores stop time placeholders for later use
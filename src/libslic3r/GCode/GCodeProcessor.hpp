@@ -9,6 +9,7 @@
 
 #include <cstdint>
 #include <array>
+#include <iterator>
 #include <vector>
 #include <mutex>
 #include <string>
@@ -17,6 +18,8 @@
 
 namespace Slic3r {
 
+class LayerMoves;
+
 // slice warnings enum strings
 #define NOZZLE_HRC_CHECKER                                          "the_actual_nozzle_hrc_smaller_than_the_required_nozzle_hrc"
 #define BED_TEMP_TOO_HIGH_THAN_FILAMENT                             "bed_temperature_too_high_than_filament"
@@ -142,6 +145,26 @@ namespace Slic3r {
             }
         };
 
+        // Interpolation points of an arc move, pointing into the storage of MoveVertices
+        // or into the points of the GCodeProcessor for the move being stored.
+        class InterpolationPoints
+        {
+        public:
+            InterpolationPoints() = default;
+            InterpolationPoints(const Vec3f* begin, const Vec3f* end) : m_begin(begin), m_end(end) {}
+            InterpolationPoints(const std::vector<Vec3f>& points) : m_begin(points.data()), m_end(points.data() + points.size()) {}
+
+            const Vec3f* begin() const { return m_begin; }
+            const Vec3f* end() const { return m_end; }
+            size_t size() const { return m_end - m_begin; }
+            bool empty() const { return m_begin == m_end; }
+            const Vec3f& operator[](size_t i) const { return m_begin[i]; }
+
+        private:
+            const Vec3f* m_begin{ nullptr };
+            const Vec3f* m_end{ nullptr };
+        };
+
         struct MoveVertex
         {
             unsigned int gcode_id{ 0 };
@@ -164,7 +187,7 @@ namespace Slic3r {
             //BBS: arc move related data
             EMovePathType move_path_type{ EMovePathType::Noop_move };
             Vec3f arc_center_position{ Vec3f::Zero() };      // mm
-            std::vector<Vec3f> interpolation_points;     // interpolation points of arc for drawing
+            InterpolationPoints interpolation_points;     // interpolation points of arc for drawing
 
             float volumetric_rate() const { return feedrate * mm3_per_mm; }
             //BBS: new function to support arc move
@@ -176,6 +199,104 @@ namespace Slic3r {
             }
         };
 
+        // The moves stored by columns, so that a loop over millions of moves reads only the columns it needs.
+        // The width and the height are stored as half floats, the type, role, extruder and color as 8 bit indices,
+        // the arc center and the interpolation points only for the arc moves.
+        class MoveVertices
+        {
+        public:
+            // Iterates over the moves decoded by operator[].
+            class const_iterator
+            {
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type        = MoveVertex;
+                using difference_type   = std::ptrdiff_t;
+                using pointer           = void;
+                using reference         = MoveVertex;
+
+                const_iterator(const MoveVertices& moves, size_t id) : m_moves(&moves), m_id(id) {}
+
+                MoveVertex      operator*() const { return (*m_moves)[m_id]; }
+                const_iterator& operator++() { ++m_id; return *this; }
+                const_iterator  operator++(int) { const_iterator it = *this; ++m_id; return it; }
+                bool            operator==(const const_iterator& rhs) const { return m_id == rhs.m_id; }
+                bool            operator!=(const const_iterator& rhs) const { return m_id != rhs.m_id; }
+
+            private:
+                const MoveVertices* m_moves;
+                size_t              m_id;
+            };
+
+            size_t size() const { return m_gcode_id.size(); }
+            bool empty() const { return m_gcode_id.empty(); }
+            void clear();
+            void push_back(const MoveVertex& move);
+            void erase(size_t id);
+            // Decodes all the columns of a move. Its interpolation points are valid until the moves are modified.
+            MoveVertex operator[](size_t id) const;
+            MoveVertex back() const { return (*this)[this->size() - 1]; }
+            const_iterator begin() const { return const_iterator(*this, 0); }
+            const_iterator end() const { return const_iterator(*this, this->size()); }
+            size_t memsize() const;
+
+            unsigned int gcode_id(size_t id) const { return m_gcode_id[id]; }
+            EMoveType type(size_t id) const { return m_type[id]; }
+            ExtrusionRole extrusion_role(size_t id) const { return m_extrusion_role[id]; }
+            unsigned char extruder_id(size_t id) const { return m_extruder_id[id]; }
+            unsigned char cp_color_id(size_t id) const { return m_cp_color_id[id]; }
+            const Vec3f& position(size_t id) const { return m_position[id]; }
+            float delta_extruder(size_t id) const { return m_delta_extruder[id]; }
+            float feedrate(size_t id) const { return m_feedrate[id]; }
+            float width(size_t id) const { return static_cast<float>(m_width[id]); }
+            float height(size_t id) const { return static_cast<float>(m_height[id]); }
+            float mm3_per_mm(size_t id) const { return m_mm3_per_mm[id]; }
+            float fan_speed(size_t id) const { return m_fan_speed[id]; }
+            float temperature(size_t id) const { return m_temperature[id]; }
+            float time(size_t id) const { return m_time[id]; }
+            float layer_duration(size_t id) const { return m_layer_duration[id]; }
+            float volumetric_rate(size_t id) const { return m_feedrate[id] * m_mm3_per_mm[id]; }
+            EMovePathType move_path_type(size_t id) const { return m_move_path_type[id]; }
+            bool is_arc_move(size_t id) const {
+                return m_move_path_type[id] == EMovePathType::Arc_move_ccw || m_move_path_type[id] == EMovePathType::Arc_move_cw;
+            }
+            Vec3f arc_center_position(size_t id) const;
+            InterpolationPoints interpolation_points(size_t id) const;
+            bool is_arc_move_with_interpolation_points(size_t id) const { return !this->interpolation_points(id).empty(); }
+
+            void set_gcode_id(size_t id, unsigned int gcode_id) { m_gcode_id[id] = gcode_id; }
+            void set_width(size_t id, float width) { m_width[id] = Eigen::half(width); }
+            void set_height(size_t id, float height) { m_height[id] = Eigen::half(height); }
+            void set_layer_duration(size_t id, float layer_duration) { m_layer_duration[id] = layer_duration; }
+
+        private:
+            // Index of an arc move into the arc columns, -1 for the other moves.
+            int arc_id(size_t id) const;
+
+            std::vector<unsigned int>  m_gcode_id;
+            std::vector<EMoveType>     m_type;
+            std::vector<ExtrusionRole> m_extrusion_role;
+            std::vector<unsigned char> m_extruder_id;
+            std::vector<unsigned char> m_cp_color_id;
+            std::vector<EMovePathType> m_move_path_type;
+            std::vector<Vec3f>         m_position;
+            std::vector<float>         m_delta_extruder;
+            std::vector<float>         m_feedrate;
+            std::vector<Eigen::half>   m_width;
+            std::vector<Eigen::half>   m_height;
+            std::vector<float>         m_mm3_per_mm;
+            std::vector<float>         m_fan_speed;
+            std::vector<float>         m_temperature;
+            std::vector<float>         m_time;
+            std::vector<float>         m_layer_duration;
+            // Arc moves sorted by move id. The interpolation points of the i-th arc are
+            // m_arc_points[m_arc_points_begin[i]] to m_arc_points[m_arc_points_begin[i + 1]].
+            std::vector<unsigned int>  m_arc_move_ids;
+            std::vector<Vec3f>         m_arc_centers;
+            std::vector<unsigned int>  m_arc_points_begin{ 0 };
+            std::vector<Vec3f>         m_arc_points;
+        };
+
         struct SliceWarning {
             int         level;                  // 0: normal tips, 1: warning; 2: error
             std::string msg;                    // enum string
@@ -185,7 +306,7 @@ namespace Slic3r {
 
         std::string filename;
         unsigned int id;
-        std::vector<MoveVertex> moves;
+        MoveVertices moves;
         // Positions of ends of lines of the final G-code this->filename after TimeProcessor::post_process() finalizes the G-code.
         std::vector<size_t> lines_ends;
         Pointfs printable_area;
@@ -480,13 +601,26 @@ namespace Slic3r {
             float filament_unload_times;
             bool  disable_m73;
 
+            // Lines of the G-code, which post_process() replaces or adds the M73 lines to. Recorded while the G-code
+            // is streamed through process_buffer(), so that post_process() does not parse the G-code again.
+            struct PostProcessLines
+            {
+                // Line ids of the G1, G2 and G3 lines, if M73 lines are to be added.
+                std::vector<unsigned int> moves;
+                // Line ids of the M73 lines, if they are to be removed.
+                std::vector<unsigned int> m73;
+                // Line ids of the placeholder lines and their tags.
+                std::vector<std::pair<unsigned int, ETags>> placeholders;
+            };
+            PostProcessLines post_process_lines;
+
             std::array<TimeMachine, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> machines;
 
             void reset();
 
             // post process the file with the given filename to add remaining time lines M73
             // and updates moves' gcode ids accordingly
-            void post_process(const std::string& filename, std::vector<GCodeProcessorResult::MoveVertex>& moves, std::vector<size_t>& lines_ends, size_t total_layer_num);
+            void post_process(const std::string& filename, GCodeProcessorResult::MoveVertices& moves, std::vector<size_t>& lines_ends, size_t total_layer_num);
         };
 
         struct UsedFilaments  // filaments per ColorChange
@@ -566,10 +700,11 @@ namespace Slic3r {
 
                 const Vec3f position = m_result.moves.back().position;
 
-                GCodeProcessorResult::MoveVertex& move = m_result.moves.emplace_back(m_result.moves[*m_move_id]);
+                GCodeProcessorResult::MoveVertex move = m_result.moves[*m_move_id];
                 move.position = position;
                 move.height = height;
-                m_result.moves.erase(m_result.moves.begin() + *m_move_id);
+                m_result.moves.push_back(move);
+                m_result.moves.erase(*m_move_id);
                 m_result.custom_gcode_per_print_z[*m_custom_gcode_per_print_z_id].print_z = position.z();
                 reset();
             }
@@ -650,6 +785,8 @@ namespace Slic3r {
 
     private:
         GCodeReader m_parser;
+        // Line reused by process_buffer() over all the buffers of the streaming interface.
+        GCodeReader::GCodeLine m_buffer_line;
         EUnits m_units;
         EPositioningType m_global_positioning_type;
         EPositioningType m_e_local_positioning_type;
@@ -756,6 +893,10 @@ namespace Slic3r {
         // Streaming interface, for processing G-codes just generated by PrusaSlicer in a pipelined fashion.
         void initialize(const std::string& filename);
         void process_buffer(const std::string& buffer);
+        // buffer shall be zero terminated at buffer[length].
+        void process_buffer(const char* buffer, size_t length);
+        // Same as above, taking the lines of buffer as tokenized by the G-code filters instead of parsing them again.
+        void process_buffer(const std::string& buffer, const LayerMoves& moves);
         void finalize(bool post_process);
 
         float get_time(PrintEstimatedStatistics::ETimeMode mode) const;
@@ -775,6 +916,8 @@ namespace Slic3r {
         void apply_config_simplify3d(const std::string& filename);
         void apply_config_superslicer(const std::string& filename);
         void process_gcode_line(const GCodeReader::GCodeLine& line, bool producers_enabled);
+        // Record the line just processed into m_time_processor.post_process_lines.
+        void record_post_process_line(const GCodeReader::GCodeLine& line);
 
         // Process tags embedded into comments
         void process_tags(const std::string_view comment, bool producers_enabled);
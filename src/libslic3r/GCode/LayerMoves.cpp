@@ -0,0 +1,173 @@
+#include "LayerMoves.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+#include <fast_float/fast_float.h>
+
+namespace Slic3r {
+
+static inline bool is_whitespace(char c)         { return c == ' ' || c == '\t'; }
+static inline bool is_end_of_gcode_line(char c)  { return c == ';' || c == '\n' || c == '\r' || c == 0; }
+static inline bool is_end_of_word(char c)        { return is_whitespace(c) || is_end_of_gcode_line(c); }
+
+static inline int axis_index(char c)
+{
+    switch (c) {
+    case 'X': return LayerMove::X;
+    case 'Y': return LayerMove::Y;
+    case 'Z': return LayerMove::Z;
+    case 'E': return LayerMove::E;
+    case 'F': return LayerMove::F;
+    case 'I': return LayerMove::I;
+    case 'J': return LayerMove::J;
+    case 'P': return LayerMove::P;
+    case 'S': return LayerMove::S;
+    default:  return -1;
+    }
+}
+
+static inline bool starts_with(std::string_view line, std::string_view prefix)
+{
+    return line.size() >= prefix.size() && memcmp(line.data(), prefix.data(), prefix.size()) == 0;
+}
+
+// Parse a single line of G-code ending at eol (pointing to '\n' or to the terminating zero of the G-code).
+static void parse_line(const char *line, const char *eol, std::string_view toolchange_prefix, LayerMove &move)
+{
+    // Command and axis words, the same way GCodeReader parses them.
+    const char *c = line;
+    while (is_whitespace(*c))
+        ++ c;
+    const char *cmd = c;
+    while (! is_end_of_word(*c))
+        ++ c;
+    move.cmd_offset = uint16_t(std::min<ptrdiff_t>(cmd - line, 0xFFFF));
+    move.cmd_length = uint16_t(std::min<ptrdiff_t>(c - cmd, 0xFFFF));
+    if (c != cmd) {
+        while (! is_end_of_gcode_line(*c)) {
+            while (is_whitespace(*c))
+                ++ c;
+            if (is_end_of_gcode_line(*c))
+                break;
+            if (int axis = axis_index(*c); axis >= 0 || (*c >= 'A' && *c <= 'Z')) {
+                double v;
+                auto [pend, ec] = fast_float::from_chars(c + 1, eol, v);
+                if (pend != c + 1 && ec == std::errc() && is_end_of_word(*pend)) {
+                    if (axis >= 0)
+                        move.axis_values[axis] = float(v);
+                    move.axis_mask |= 1 << (axis >= 0 ? axis : int(LayerMove::UnknownAxis));
+                    c = pend;
+                    continue;
+                }
+            }
+            while (! is_end_of_word(*c))
+                ++ c;
+        }
+    }
+
+    // Command types and markers, matching the tests CoolingBuffer used to do on the G-code text.
+    std::string_view sline(line, eol - line);
+    if (starts_with(sline, "G0 "))
+        move.type = LayerMove::TYPE_G0;
+    else if (starts_with(sline, "G1 "))
+        move.type = LayerMove::TYPE_G1;
+    else if (starts_with(sline, "G92 "))
+        move.type = LayerMove::TYPE_G92;
+    else if (starts_with(sline, "G2 "))
+        move.type = LayerMove::TYPE_G2;
+    else if (starts_with(sline, "G3 "))
+        move.type = LayerMove::TYPE_G3;
+    if (move.type) {
+        if (sline.find(";_EXTRUDE_SET_SPEED") != std::string_view::npos)
+            move.type |= LayerMove::TYPE_EXTRUDE_SET_SPEED;
+        if (sline.find(";_EXTERNAL_PERIMETER") != std::string_view::npos)
+            move.type |= LayerMove::TYPE_EXTERNAL_PERIMETER;
+        if (sline.find(";_WIPE") != std::string_view::npos)
+            move.type |= LayerMove::TYPE_WIPE;
+    } else if (starts_with(sline, ";_EXTRUDE_END"))
+        move.type = LayerMove::TYPE_EXTRUDE_END;
+    else if (! toolchange_prefix.empty() && starts_with(sline, toolchange_prefix)) {
+        move.type = LayerMove::TYPE_SET_TOOL;
+        unsigned int tool;
+        auto res = std::from_chars(sline.data() + toolchange_prefix.size(), sline.data() + sline.size(), tool);
+        if (res.ec == std::errc())
+            move.tool = int(std::min<unsigned int>(tool, std::numeric_limits<int>::max()));
+        else if (res.ec == std::errc::result_out_of_range)
+            move.tool = std::numeric_limits<int>::max();
+    } else if (starts_with(sline, ";_OVERHANG_FAN_START"))
+        move.type = LayerMove::TYPE_OVERHANG_FAN_START;
+    else if (starts_with(sline, ";_OVERHANG_FAN_END"))
+        move.type = LayerMove::TYPE_OVERHANG_FAN_END;
+    else if (starts_with(sline, ";_SUPP_INTERFACE_FAN_START"))
+        move.type = LayerMove::TYPE_SUPPORT_INTERFACE_FAN_START;
+    else if (starts_with(sline, ";_SUPP_INTERFACE_FAN_END"))
+        move.type = LayerMove::TYPE_SUPPORT_INTERFACE_FAN_END;
+    else if (starts_with(sline, "G4 "))
+        move.type = LayerMove::TYPE_G4;
+    else if (starts_with(sline, ";_FORCE_RESUME_FAN_SPEED"))
+        move.type = LayerMove::TYPE_FORCE_RESUME_FAN;
+}
+
+std::string_view LayerMove::raw(const std::string &gcode) const
+{
+    size_t end = this->line_end;
+    if (end > this->line_start && gcode[end - 1] == '\n')
+        -- end;
+    if (end > this->line_start && gcode[end - 1] == '\r')
+        -- end;
+    return { gcode.data() + this->line_start, end - this->line_start };
+}
+
+LayerMoves LayerMoves::parse(const std::string &gcode, std::string_view toolchange_prefix)
+{
+    LayerMoves out;
+    // A rough estimate of the average length of a G-code line, to avoid most of the reallocations.
+    out.reserve(gcode.size() / 24);
+    out.append_parsed(gcode, 0, toolchange_prefix);
+    return out;
+}
+
+void LayerMoves::append_parsed(const std::string &gcode, size_t begin, std::string_view toolchange_prefix)
+{
+    assert(begin == 0 || begin >= gcode.size() || gcode[begin - 1] == '\n');
+    const char *gcode_begin = gcode.c_str();
+    const char *gcode_end   = gcode_begin + gcode.size();
+    for (const char *line = gcode_begin + begin; line < gcode_end && *line != 0;) {
+        auto *eol = static_cast<const char*>(memchr(line, '\n', gcode_end - line));
+        if (eol == nullptr)
+            eol = gcode_end;
+        LayerMove &move = this->moves.emplace_back();
+        move.line_start = line - gcode_begin;
+        move.line_end   = (eol == gcode_end ? eol : eol + 1) - gcode_begin;
+        parse_line(line, eol, toolchange_prefix, move);
+        line = gcode_begin + move.line_end;
+    }
+}
+
+void LayerMoves::append(const LayerMoves &other, size_t begin, size_t end, ptrdiff_t shift)
+{
+    auto it = std::lower_bound(other.moves.begin(), other.moves.end(), begin,
+        [](const LayerMove &move, size_t pos) { return move.line_start < pos; });
+    for (; it != other.moves.end() && it->line_start < end; ++ it) {
+        assert(it->line_end <= end);
+        LayerMove &move = this->moves.emplace_back(*it);
+        move.line_start += shift;
+        move.line_end   += shift;
+    }
+}
+
+void LayerMoves::append(const LayerMoves &other, size_t shift)
+{
+    this->moves.reserve(this->moves.size() + other.moves.size());
+    for (const LayerMove &src : other.moves) {
+        LayerMove &move = this->moves.emplace_back(src);
+        move.line_start += shift;
+        move.line_end   += shift;
+    }
+}
+
+} // namespace Slic3r
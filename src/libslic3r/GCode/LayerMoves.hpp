@@ -0,0 +1,97 @@
+#ifndef slic3r_GCode_LayerMoves_hpp_
+#define slic3r_GCode_LayerMoves_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Slic3r {
+
+// A single line of the G-code of a layer: its position in the G-code text, the command word,
+// the axis words and the markers left in the G-code by GCode::process_layer() for the G-code filters.
+struct LayerMove
+{
+    // X to P are ordered as Slic3r::Axis, so that the GCodeProcessor may take the axes of a LayerMove as they are.
+    enum Axis : uint8_t {
+        X, Y, Z, E, F, I, J, P, S,
+        NumAxes,
+        // Set in axis_mask for any other axis word with a valid value, as GCodeReader does with UNKNOWN_AXIS.
+        UnknownAxis = NumAxes
+    };
+
+    enum Type : uint32_t {
+        // The line starts with "G0 ", "G1 ", "G2 ", "G3 ", "G4 " or "G92 ".
+        TYPE_G0                         = 1 << 0,
+        TYPE_G1                         = 1 << 1,
+        TYPE_G2                         = 1 << 2,
+        TYPE_G3                         = 1 << 3,
+        TYPE_G4                         = 1 << 4,
+        TYPE_G92                        = 1 << 5,
+        // The line starts with the tool change prefix of the GCodeWriter.
+        TYPE_SET_TOOL                   = 1 << 6,
+        // Markers for the CoolingBuffer.
+        TYPE_EXTRUDE_SET_SPEED          = 1 << 7,
+        TYPE_EXTRUDE_END                = 1 << 8,
+        TYPE_EXTERNAL_PERIMETER         = 1 << 9,
+        TYPE_WIPE                       = 1 << 10,
+        TYPE_OVERHANG_FAN_START         = 1 << 11,
+        TYPE_OVERHANG_FAN_END           = 1 << 12,
+        TYPE_SUPPORT_INTERFACE_FAN_START = 1 << 13,
+        TYPE_SUPPORT_INTERFACE_FAN_END  = 1 << 14,
+        TYPE_FORCE_RESUME_FAN           = 1 << 15,
+    };
+
+    bool             has(Axis axis) const { return (this->axis_mask & (1 << axis)) != 0; }
+    float            value(Axis axis) const { return this->axis_values[axis]; }
+    // The command word, for example "G1", "M106" or "T1". Empty for comments and empty lines.
+    std::string_view cmd(const std::string &gcode) const { return { gcode.data() + this->line_start + this->cmd_offset, this->cmd_length }; }
+    // The line without the trailing end of line characters.
+    std::string_view raw(const std::string &gcode) const;
+
+    uint32_t    type        { 0 };
+    // Start of this line in the G-code.
+    size_t      line_start  { 0 };
+    // End of this line in the G-code including the trailing '\n'.
+    size_t      line_end    { 0 };
+    // Position of the command word relative to line_start.
+    uint16_t    cmd_offset  { 0 };
+    uint16_t    cmd_length  { 0 };
+    // Extruder ID of a TYPE_SET_TOOL line, -1 if the tool change command does not contain a number,
+    // INT_MAX if the number does not fit.
+    int         tool        { -1 };
+    // Which of the axis_values were parsed from the line.
+    uint16_t    axis_mask   { 0 };
+    float       axis_values[NumAxes];
+};
+
+// Lines of the G-code of a layer, parsed once before the G-code enters the CoolingBuffer, so that the CoolingBuffer
+// and the FanMover do not have to parse the G-code text again. A filter modifying the G-code produces
+// the LayerMoves of its output by copying the moves of the untouched lines and by parsing only the lines it emitted.
+class LayerMoves
+{
+public:
+    LayerMoves() = default;
+    // Parse all lines of gcode. Lines starting with toolchange_prefix are tool changes, no tool changes are detected
+    // if toolchange_prefix is empty.
+    static LayerMoves parse(const std::string &gcode, std::string_view toolchange_prefix);
+
+    // Parse the lines of gcode starting at offset begin, which must be a start of a line, and append them.
+    void append_parsed(const std::string &gcode, size_t begin, std::string_view toolchange_prefix);
+    // Append moves of other starting at [begin, end) of its G-code, shifted by shift bytes.
+    void append(const LayerMoves &other, size_t begin, size_t end, ptrdiff_t shift);
+    // Append all moves of other, shifted by shift bytes. Used to concatenate G-code of multiple layers.
+    void append(const LayerMoves &other, size_t shift);
+
+    bool empty() const { return this->moves.empty(); }
+    size_t size() const { return this->moves.size(); }
+    void clear() { this->moves.clear(); }
+    void reserve(size_t n) { this->moves.reserve(n); }
+
+    std::vector<LayerMove> moves;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_GCode_LayerMoves_hpp_
@@ -1,4 +1,5 @@
 #include "SeamPlacer.hpp"
+#include "SeamVisibilityCache.hpp"
 
 #include "Polygon.hpp"
 #include "PrintConfig.hpp"
@@ -125,7 +126,7 @@ Vec3f sample_power_cosine_hemisphere(const Vec2f &samples, float power) {
   return Vec3f(cos(term1) * term3, sin(term1) * term3, term2);
 }
 
-std::vector<float> raycast_visibility(const AABBTreeIndirect::Tree<3, float> &raycasting_tree,
+std::vector<float> raycast_visibility(const AABBTreeIndirect::WideTree3f &raycasting_tree,
                                       const indexed_triangle_set &triangles,
                                       const TriangleSetSamples &samples,
                                       size_t negative_volumes_start_index) {
@@ -270,27 +271,10 @@ std::vector<float> calculate_polygon_angles_at_vertices(const Polygon &polygon,
   return result;
 }
 
-struct CoordinateFunctor {
-  const std::vector<Vec3f> *coordinates;
-  CoordinateFunctor(const std::vector<Vec3f> *coords) :
-                                                        coordinates(coords) {
-  }
-  CoordinateFunctor() :
-                        coordinates(nullptr) {
-  }
-
-  const float& operator()(size_t idx, size_t dim) const {
-    return coordinates->operator [](idx)[dim];
-  }
-};
-
 // structure to store global information about the model - occlusion hits, enforcers, blockers
 struct GlobalModelInfo {
-  TriangleSetSamples mesh_samples;
-  std::vector<float> mesh_samples_visibility;
-  CoordinateFunctor mesh_samples_coordinate_functor;
-  KDTreeIndirect<3, float, CoordinateFunctor> mesh_samples_tree { CoordinateFunctor { } };
-  float mesh_samples_radius;
+  // Shared through the SeamVisibilityCache, null if the visibility is not needed.
+  SeamVisibilityCache::SamplesPtr mesh_samples;
 
   indexed_triangle_set enforcers;
   indexed_triangle_set blockers;
@@ -316,7 +300,11 @@ struct GlobalModelInfo {
   }
 
   float calculate_point_visibility(const Vec3f &position) const {
-    std::vector<size_t> points = find_nearby_points(mesh_samples_tree, position, mesh_samples_radius);
+    if (! mesh_samples) {
+      return 1.0f;
+    }
+    const float mesh_samples_radius = mesh_samples->radius;
+    std::vector<size_t> points = find_nearby_points(mesh_samples->tree, position, mesh_samples_radius);
     if (points.empty()) {
       return 1.0f;
     }
@@ -331,12 +319,12 @@ struct GlobalModelInfo {
     for (size_t i = 0; i < points.size(); ++i) {
       size_t sample_idx = points[i];
 
-      Vec3f sample_point = this->mesh_samples.positions[sample_idx];
-      Vec3f sample_normal = this->mesh_samples.normals[sample_idx];
+      Vec3f sample_point = this->mesh_samples->positions[sample_idx];
+      Vec3f sample_normal = this->mesh_samples->normals[sample_idx];
 
       float weight = mesh_samples_radius - compute_dist_to_plane(position, sample_point, sample_normal);
       weight += (mesh_samples_radius - (position - sample_point).norm());
-      total_visibility += weight * mesh_samples_visibility[sample_idx];
+      total_visibility += weight * mesh_samples->visibility[sample_idx];
       total_weight += weight;
     }
 
@@ -381,11 +369,11 @@ struct GlobalModelInfo {
         return;
       }
 
-      for (size_t i = 0; i < mesh_samples.positions.size(); ++i) {
-        float visibility = mesh_samples_visibility[i];
+      for (size_t i = 0; i < mesh_samples->positions.size(); ++i) {
+        float visibility = mesh_samples->visibility[i];
         Vec3f color = value_to_rgbf(0.0f, 1.0f, visibility);
         fprintf(fp, "v %f %f %f  %f %f %f\n",
-                mesh_samples.positions[i](0), mesh_samples.positions[i](1), mesh_samples.positions[i](2),
+                mesh_samples->positions[i](0), mesh_samples->positions[i](1), mesh_samples->positions[i](2),
                 color(0), color(1), color(2));
       }
       fclose(fp);
@@ -616,8 +604,17 @@ std::pair<size_t, size_t> find_previous_and_next_perimeter_point(const std::vect
 }
 
 // Computes all global model info - transforms object, performs raycasting
+// The result only depends on the geometry of the object, it is reused from the SeamVisibilityCache if possible.
 void compute_global_occlusion(GlobalModelInfo &result, const PrintObject *po,
                               std::function<void(void)> throw_if_canceled) {
+  const std::string cache_key = SeamVisibilityCache::key(*po);
+  if (SeamVisibilityCache::SamplesPtr samples = SeamVisibilityCache::find(cache_key); samples) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "SeamPlacer: visibility samples reused from cache";
+    result.mesh_samples = std::move(samples);
+    return;
+  }
+
   BOOST_LOG_TRIVIAL(debug)
       << "SeamPlacer: gather occlusion meshes: start";
   auto obj_transform = po->trafo_centered();
@@ -656,11 +653,8 @@ void compute_global_occlusion(GlobalModelInfo &result, const PrintObject *po,
   BOOST_LOG_TRIVIAL(debug)
       << "SeamPlacer: Compute visibility sample points: start";
 
-  result.mesh_samples = sample_its_uniform_parallel(SeamPlacer::raycasting_visibility_samples_count,
-                                                    triangle_set);
-  result.mesh_samples_coordinate_functor = CoordinateFunctor(&result.mesh_samples.positions);
-  result.mesh_samples_tree = KDTreeIndirect<3, float, CoordinateFunctor>(result.mesh_samples_coordinate_functor,
-                                                                         result.mesh_samples.positions.size());
+  TriangleSetSamples mesh_samples = sample_its_uniform_parallel(SeamPlacer::raycasting_visibility_samples_count,
+                                                                triangle_set);
 
   // The following code determines search area for random visibility samples on the mesh when calculating visibility of each perimeter point
   // number of random samples in the given radius (area) is approximately poisson distribution
@@ -668,32 +662,34 @@ void compute_global_occlusion(GlobalModelInfo &result, const PrintObject *po,
   // parameters of exponential distribution to compute area that will have with probability="probability" more than given number of samples="samples"
   float probability = 0.9f;
   float samples = 4;
-  float density = SeamPlacer::raycasting_visibility_samples_count / result.mesh_samples.total_area;
+  float density = SeamPlacer::raycasting_visibility_samples_count / mesh_samples.total_area;
   // exponential probability distrubtion function is : f(x) = P(X > x) = e^(l*x) where l is the rate parameter (computed as 1/u where u is mean value)
   // probability that sampled area A with S samples contains more than samples count:
   //  P(S > samples in A) = e^-(samples/(density*A));   express A:
   float search_area = samples / (-logf(probability) * density);
   float search_radius = sqrt(search_area / PI);
-  result.mesh_samples_radius = search_radius;
 
   BOOST_LOG_TRIVIAL(debug)
       << "SeamPlacer: Compute visiblity sample points: end";
   throw_if_canceled();
 
   BOOST_LOG_TRIVIAL(debug)
-      << "SeamPlacer: Mesh sample raidus: " << result.mesh_samples_radius;
+      << "SeamPlacer: Mesh sample raidus: " << search_radius;
 
   BOOST_LOG_TRIVIAL(debug)
       << "SeamPlacer: build AABB tree: start";
-  auto raycasting_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(triangle_set.vertices,
-                                                                                     triangle_set.indices);
+  // Millions of rays are cast against the tree, the wide tree traverses faster.
+  AABBTreeIndirect::WideTree3f raycasting_tree(AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(triangle_set.vertices,
+                                                                                                           triangle_set.indices));
 
   throw_if_canceled();
   BOOST_LOG_TRIVIAL(debug)
       << "SeamPlacer: build AABB tree: end";
-  result.mesh_samples_visibility = raycast_visibility(raycasting_tree, triangle_set, result.mesh_samples,
-                                                      negative_volumes_start_index);
+  std::vector<float> mesh_samples_visibility = raycast_visibility(raycasting_tree, triangle_set, mesh_samples,
+                                                                 negative_volumes_start_index);
   throw_if_canceled();
+  result.mesh_samples = SeamVisibilityCache::insert(cache_key, std::make_shared<const SeamVisibilitySamples>(
+      std::move(mesh_samples.positions), std::move(mesh_samples.normals), std::move(mesh_samples_visibility), search_radius));
 #ifdef DEBUG_FILES
   result.debug_export(triangle_set);
 #endif
@@ -999,10 +995,10 @@ void pick_random_seam_point(const std::vector<SeamCandidate> &perimeter_points,
 
 // Parallel process and extract each perimeter polygon of the given print object.
 // Gather SeamCandidates of each layer into vector and build KDtree over them
-// Store results in the SeamPlacer variables m_seam_per_object
-void SeamPlacer::gather_seam_candidates(const PrintObject *po, const SeamPlacerImpl::GlobalModelInfo &global_model_info) {
+// Store results into seam_data
+void SeamPlacer::gather_seam_candidates(const PrintObject *po, const SeamPlacerImpl::GlobalModelInfo &global_model_info,
+                                        PrintObjectSeamData &seam_data) {
   using namespace SeamPlacerImpl;
-  PrintObjectSeamData &seam_data = m_seam_per_object.emplace(po, PrintObjectSeamData { }).first->second;
   seam_data.layers.resize(po->layer_count());
 
   tbb::parallel_for(tbb::blocked_range<size_t>(0, po->layers().size()),
@@ -1028,11 +1024,11 @@ void SeamPlacer::gather_seam_candidates(const PrintObject *po, const SeamPlacerI
   );
 }
 
-void SeamPlacer::calculate_candidates_visibility(const PrintObject *po,
+void SeamPlacer::calculate_candidates_visibility(PrintObjectSeamData &seam_data,
                                                  const SeamPlacerImpl::GlobalModelInfo &global_model_info) {
   using namespace SeamPlacerImpl;
 
-  std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+  std::vector<PrintObjectSeamData::LayerSeams> &layers = seam_data.layers;
   tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
                     [&layers, &global_model_info](tbb::blocked_range<size_t> r) {
                       for (size_t layer_idx = r.begin(); layer_idx < r.end(); ++layer_idx) {
@@ -1044,11 +1040,11 @@ void SeamPlacer::calculate_candidates_visibility(const PrintObject *po,
                     });
 }
 
-void SeamPlacer::calculate_overhangs_and_layer_embedding(const PrintObject *po) {
+void SeamPlacer::calculate_overhangs_and_layer_embedding(const PrintObject *po, PrintObjectSeamData &seam_data) {
   using namespace SeamPlacerImpl;
   using PerimeterDistancer = AABBTreeLines::LinesDistancer<Linef>;
 
-  std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+  std::vector<PrintObjectSeamData::LayerSeams> &layers = seam_data.layers;
   tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
                     [po, &layers](tbb::blocked_range<size_t> r) {
                       std::unique_ptr<PerimeterDistancer> prev_layer_distancer;
@@ -1101,7 +1097,7 @@ std::optional<std::pair<size_t, size_t>> SeamPlacer::find_next_seam_in_layer(
     const std::vector<PrintObjectSeamData::LayerSeams> &layers,
     const Vec3f &projected_position,
     const size_t layer_idx, const float max_distance,
-    const SeamPlacerImpl::SeamComparator &comparator) const {
+    const SeamPlacerImpl::SeamComparator &comparator) {
   using namespace SeamPlacerImpl;
   std::vector<size_t> nearby_points_indices = find_nearby_points(*layers[layer_idx].points_tree, projected_position,
                                                                  max_distance);
@@ -1162,8 +1158,8 @@ std::optional<std::pair<size_t, size_t>> SeamPlacer::find_next_seam_in_layer(
 }
 
 std::vector<std::pair<size_t, size_t>> SeamPlacer::find_seam_string(const PrintObject *po,
-                                                                    std::pair<size_t, size_t> start_seam, const SeamPlacerImpl::SeamComparator &comparator) const {
-  const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object.find(po)->second.layers;
+                                                                    const std::vector<PrintObjectSeamData::LayerSeams> &layers,
+                                                                    std::pair<size_t, size_t> start_seam, const SeamPlacerImpl::SeamComparator &comparator) {
   int layer_idx = start_seam.first;
 
   //initialize searching for seam string - cluster of nearby seams on previous and next layers
@@ -1220,7 +1216,7 @@ std::vector<std::pair<size_t, size_t>> SeamPlacer::find_seam_string(const PrintO
 // Does not change the positions of the SeamCandidates themselves, instead stores
 // the new aligned position into the shared Perimeter structure of each perimeter
 // Note that this position does not necesarilly lay on the perimeter.
-void SeamPlacer::align_seam_points(const PrintObject *po, const SeamPlacerImpl::SeamComparator &comparator) {
+void SeamPlacer::align_seam_points(const PrintObject *po, PrintObjectSeamData &seam_data, const SeamPlacerImpl::SeamComparator &comparator) {
   using namespace SeamPlacerImpl;
 
   // Prepares Debug files for writing.
@@ -1243,7 +1239,7 @@ void SeamPlacer::align_seam_points(const PrintObject *po, const SeamPlacerImpl::
 #endif
 
   //gather vector of all seams on the print_object - pair of layer_index and seam__index within that layer
-  const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+  const std::vector<PrintObjectSeamData::LayerSeams> &layers = seam_data.layers;
   std::vector<std::pair<size_t, size_t>> seams;
   for (size_t layer_idx = 0; layer_idx < layers.size(); ++layer_idx) {
     const std::vector<SeamCandidate> &layer_perimeter_points = layers[layer_idx].points;
@@ -1281,14 +1277,14 @@ void SeamPlacer::align_seam_points(const PrintObject *po, const SeamPlacerImpl::
       // This perimeter is already aligned, skip seam
       continue;
     } else {
-      seam_string = this->find_seam_string(po, { layer_idx, seam_index }, comparator);
+      seam_string = find_seam_string(po, layers, { layer_idx, seam_index }, comparator);
       size_t step_size = 1 + seam_string.size() / 20;
       for (size_t alternative_start = 0; alternative_start < seam_string.size(); alternative_start += step_size) {
         size_t start_layer_idx = seam_string[alternative_start].first;
         size_t seam_idx =
             layers[start_layer_idx].points[seam_string[alternative_start].second].perimeter.seam_index;
-        alternative_seam_string = this->find_seam_string(po,
-                                                         std::pair<size_t, size_t>(start_layer_idx, seam_idx), comparator);
+        alternative_seam_string = find_seam_string(po, layers,
+                                                   std::pair<size_t, size_t>(start_layer_idx, seam_idx), comparator);
         if (alternative_seam_string.size() > seam_string.size()) {
           seam_string = std::move(alternative_seam_string);
         }
@@ -1410,76 +1406,100 @@ void SeamPlacer::align_seam_points(const PrintObject *po, const SeamPlacerImpl::
 
 }
 
-void SeamPlacer::init(const Print &print, std::function<void(void)> throw_if_canceled_func) {
+std::shared_ptr<PrintObjectSeamData> SeamPlacer::analyze_object(const PrintObject &print_object, std::function<void(void)> throw_if_canceled_func) {
   using namespace SeamPlacerImpl;
-  m_seam_per_object.clear();
+  const PrintObject *po = &print_object;
+  auto seam_data = std::make_shared<PrintObjectSeamData>();
 
-  for (const PrintObject *po : print.objects()) {
-    throw_if_canceled_func();
-    SeamPosition configured_seam_preference = po->config().seam_position.value;
-    SeamComparator comparator { configured_seam_preference };
+  throw_if_canceled_func();
+  SeamPosition configured_seam_preference = po->config().seam_position.value;
+  SeamComparator comparator { configured_seam_preference };
 
-    {
-      GlobalModelInfo global_model_info { };
-      gather_enforcers_blockers(global_model_info, po);
-      throw_if_canceled_func();
-      if (configured_seam_preference == spAligned || configured_seam_preference == spNearest) {
-        compute_global_occlusion(global_model_info, po, throw_if_canceled_func);
-      }
-      throw_if_canceled_func();
-      BOOST_LOG_TRIVIAL(debug)
-          << "SeamPlacer: gather_seam_candidates: start";
-      gather_seam_candidates(po, global_model_info);
-      BOOST_LOG_TRIVIAL(debug)
-          << "SeamPlacer: gather_seam_candidates: end";
-      throw_if_canceled_func();
-      if (configured_seam_preference == spAligned || configured_seam_preference == spNearest) {
-        BOOST_LOG_TRIVIAL(debug)
-            << "SeamPlacer: calculate_candidates_visibility : start";
-        calculate_candidates_visibility(po, global_model_info);
-        BOOST_LOG_TRIVIAL(debug)
-            << "SeamPlacer: calculate_candidates_visibility : end";
-      }
-    } // destruction of global_model_info (large structure, no longer needed)
+  {
+    GlobalModelInfo global_model_info { };
+    gather_enforcers_blockers(global_model_info, po);
+    throw_if_canceled_func();
+    if (configured_seam_preference == spAligned || configured_seam_preference == spNearest) {
+      compute_global_occlusion(global_model_info, po, throw_if_canceled_func);
+    }
     throw_if_canceled_func();
     BOOST_LOG_TRIVIAL(debug)
-        << "SeamPlacer: calculate_overhangs and layer embdedding : start";
-    calculate_overhangs_and_layer_embedding(po);
+        << "SeamPlacer: gather_seam_candidates: start";
+    gather_seam_candidates(po, global_model_info, *seam_data);
     BOOST_LOG_TRIVIAL(debug)
-        << "SeamPlacer: calculate_overhangs and layer embdedding: end";
-    throw_if_canceled_func();
-    if (configured_seam_preference != spNearest) { // For spNearest, the seam is picked in the place_seam method with actual nozzle position information
-      BOOST_LOG_TRIVIAL(debug)
-          << "SeamPlacer: pick_seam_point : start";
-      //pick seam point
-      std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
-      tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
-                        [&layers, configured_seam_preference, comparator](tbb::blocked_range<size_t> r) {
-                          for (size_t layer_idx = r.begin(); layer_idx < r.end(); ++layer_idx) {
-                            std::vector<SeamCandidate> &layer_perimeter_points = layers[layer_idx].points;
-                            for (size_t current = 0; current < layer_perimeter_points.size();
-                                 current = layer_perimeter_points[current].perimeter.end_index)
-                              if (configured_seam_preference == spRandom)
-                                pick_random_seam_point(layer_perimeter_points, current);
-                              else
-                                pick_seam_point(layer_perimeter_points, current, comparator);
-                          }
-                        });
-      BOOST_LOG_TRIVIAL(debug)
-          << "SeamPlacer: pick_seam_point : end";
-    }
+        << "SeamPlacer: gather_seam_candidates: end";
     throw_if_canceled_func();
-    if (configured_seam_preference == spAligned || configured_seam_preference == spRear) {
+    if (configured_seam_preference == spAligned || configured_seam_preference == spNearest) {
       BOOST_LOG_TRIVIAL(debug)
-          << "SeamPlacer: align_seam_points : start";
-      align_seam_points(po, comparator);
+          << "SeamPlacer: calculate_candidates_visibility : start";
+      calculate_candidates_visibility(*seam_data, global_model_info);
       BOOST_LOG_TRIVIAL(debug)
-          << "SeamPlacer: align_seam_points : end";
+          << "SeamPlacer: calculate_candidates_visibility : end";
     }
+  } // destruction of global_model_info (large structure, no longer needed)
+  throw_if_canceled_func();
+  BOOST_LOG_TRIVIAL(debug)
+      << "SeamPlacer: calculate_overhangs and layer embdedding : start";
+  calculate_overhangs_and_layer_embedding(po, *seam_data);
+  BOOST_LOG_TRIVIAL(debug)
+      << "SeamPlacer: calculate_overhangs and layer embdedding: end";
+  throw_if_canceled_func();
+  if (configured_seam_preference != spNearest) { // For spNearest, the seam is picked in the place_seam method with actual nozzle position information
+    BOOST_LOG_TRIVIAL(debug)
+        << "SeamPlacer: pick_seam_point : start";
+    //pick seam point
+    std::vector<PrintObjectSeamData::LayerSeams> &layers = seam_data->layers;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
+                      [&layers, configured_seam_preference, comparator](tbb::blocked_range<size_t> r) {
+                        for (size_t layer_idx = r.begin(); layer_idx < r.end(); ++layer_idx) {
+                          std::vector<SeamCandidate> &layer_perimeter_points = layers[layer_idx].points;
+                          for (size_t current = 0; current < layer_perimeter_points.size();
+                               current = layer_perimeter_points[current].perimeter.end_index)
+                            if (configured_seam_preference == spRandom)
+                              pick_random_seam_point(layer_perimeter_points, current);
+                            else
+                              pick_seam_point(layer_perimeter_points, current, comparator);
+                        }
+                      });
+    BOOST_LOG_TRIVIAL(debug)
+        << "SeamPlacer: pick_seam_point : end";
+  }
+  throw_if_canceled_func();
+  if (configured_seam_preference == spAligned || configured_seam_preference == spRear) {
+    BOOST_LOG_TRIVIAL(debug)
+        << "SeamPlacer: align_seam_points : start";
+    align_seam_points(po, *seam_data, comparator);
+    BOOST_LOG_TRIVIAL(debug)
+        << "SeamPlacer: align_seam_points : end";
+  }
 
 #ifdef DEBUG_FILES
-    debug_export_points(m_seam_per_object[po].layers, po->bounding_box(), comparator);
+  debug_export_points(seam_data->layers, po->bounding_box(), comparator);
 #endif
+  return seam_data;
+}
+
+void SeamPlacer::init(const Print &print, std::function<void(void)> throw_if_canceled_func) {
+  m_seam_per_object.clear();
+
+  // The seams are normally analyzed by the posSeamPlacement step of each PrintObject and kept across G-code exports.
+  // Analyze the objects, for which the step has not been executed, in parallel.
+  std::vector<const PrintObject*> missing;
+  for (const PrintObject *po : print.objects()) {
+    if (std::shared_ptr<const PrintObjectSeamData> seam_data = po->seam_data(); seam_data)
+      m_seam_per_object.emplace(po, std::move(seam_data));
+    else
+      missing.emplace_back(po);
+  }
+  if (! missing.empty()) {
+    std::vector<std::shared_ptr<const PrintObjectSeamData>> seam_data(missing.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, missing.size(), 1),
+                      [&missing, &seam_data, &throw_if_canceled_func](tbb::blocked_range<size_t> r) {
+                        for (size_t i = r.begin(); i < r.end(); ++i)
+                          seam_data[i] = analyze_object(*missing[i], throw_if_canceled_func);
+                      });
+    for (size_t i = 0; i < missing.size(); ++i)
+      m_seam_per_object.emplace(missing[i], std::move(seam_data[i]));
   }
 }
 
@@ -1505,7 +1525,7 @@ void SeamPlacer::place_seam(const Layer *layer, ExtrusionLoop &loop, bool extern
   };
 
   const PrintObjectSeamData::LayerSeams &layer_perimeters =
-      m_seam_per_object.find(layer->object())->second.layers[layer_index];
+      m_seam_per_object.find(layer->object())->second->layers[layer_index];
 
   // Find the closest perimeter in the SeamPlacer to this loop.
   // Repeat search until two consecutive points of the loop are found, that result in the same closest_perimeter
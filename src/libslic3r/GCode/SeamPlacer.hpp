@@ -137,26 +137,34 @@ public:
   static constexpr size_t seam_align_mm_per_segment = 4.0f;
 
   //The following data structures hold all perimeter points for all PrintObject.
-  std::unordered_map<const PrintObject*, PrintObjectSeamData> m_seam_per_object;
+  //The data is owned by the PrintObjects, see PrintObject::seam_data(), unless it was computed by init().
+  std::unordered_map<const PrintObject*, std::shared_ptr<const PrintObjectSeamData>> m_seam_per_object;
 
+  // Gather seam candidates of a single PrintObject, evaluate their visibility and pick and align the seams.
+  // Executed by PrintObject::analyze_seams() as the posSeamPlacement step, the result is kept until the step is invalidated.
+  static std::shared_ptr<PrintObjectSeamData> analyze_object(const PrintObject &po, std::function<void(void)> throw_if_canceled_func);
+
+  // Collect the seam data of all PrintObjects, analyzing the objects without posSeamPlacement done.
   void init(const Print &print, std::function<void(void)> throw_if_canceled_func);
 
   void place_seam(const Layer *layer, ExtrusionLoop &loop, bool external_first, const Point &last_pos) const;
 
 private:
-  void gather_seam_candidates(const PrintObject *po, const SeamPlacerImpl::GlobalModelInfo &global_model_info);
-  void calculate_candidates_visibility(const PrintObject *po,
-                                       const SeamPlacerImpl::GlobalModelInfo &global_model_info);
-  void calculate_overhangs_and_layer_embedding(const PrintObject *po);
-  void align_seam_points(const PrintObject *po, const SeamPlacerImpl::SeamComparator &comparator);
-  std::vector<std::pair<size_t, size_t>> find_seam_string(const PrintObject *po,
-                                                          std::pair<size_t, size_t> start_seam,
-                                                          const SeamPlacerImpl::SeamComparator &comparator) const;
-  std::optional<std::pair<size_t, size_t>> find_next_seam_in_layer(
+  static void gather_seam_candidates(const PrintObject *po, const SeamPlacerImpl::GlobalModelInfo &global_model_info,
+                                     PrintObjectSeamData &seam_data);
+  static void calculate_candidates_visibility(PrintObjectSeamData &seam_data,
+                                              const SeamPlacerImpl::GlobalModelInfo &global_model_info);
+  static void calculate_overhangs_and_layer_embedding(const PrintObject *po, PrintObjectSeamData &seam_data);
+  static void align_seam_points(const PrintObject *po, PrintObjectSeamData &seam_data, const SeamPlacerImpl::SeamComparator &comparator);
+  static std::vector<std::pair<size_t, size_t>> find_seam_string(const PrintObject *po,
+                                                                 const std::vector<PrintObjectSeamData::LayerSeams> &layers,
+                                                                 std::pair<size_t, size_t> start_seam,
+                                                                 const SeamPlacerImpl::SeamComparator &comparator);
+  static std::optional<std::pair<size_t, size_t>> find_next_seam_in_layer(
       const std::vector<PrintObjectSeamData::LayerSeams> &layers,
       const Vec3f& projected_position,
       const size_t layer_idx, const float max_distance,
-      const SeamPlacerImpl::SeamComparator &comparator) const;
+      const SeamPlacerImpl::SeamComparator &comparator);
 };
 
 } // namespace Slic3r
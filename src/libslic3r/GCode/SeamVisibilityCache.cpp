@@ -0,0 +1,232 @@
+#include "SeamVisibilityCache.hpp"
+#include "SeamPlacer.hpp"
+
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/Print.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <openssl/md5.h>
+
+namespace Slic3r {
+namespace SeamVisibilityCache {
+
+namespace {
+
+static constexpr const uint32_t FileMagic     = 0x53564953;
+// Bump if the raycasting or the file format changes.
+static constexpr const uint32_t FileVersion   = 1;
+static constexpr const char    *FileExtension = ".seamvis";
+
+// About 1.1MB per object with the default number of samples.
+static constexpr const size_t   MaxEntries = 64;
+
+struct Cache
+{
+    struct Entry {
+        SamplesPtr  samples;
+        // Entries not used for the longest time are evicted first.
+        size_t      last_used;
+    };
+
+    std::mutex                      mutex;
+    std::map<std::string, Entry>    entries;
+    size_t                          timestamp { 0 };
+    std::string                     directory;
+
+    SamplesPtr find(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end())
+            return SamplesPtr();
+        it->second.last_used = ++ timestamp;
+        return it->second.samples;
+    }
+
+    SamplesPtr insert(const std::string &key, SamplesPtr samples)
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        auto [it, inserted] = entries.insert({ key, Entry { std::move(samples), ++ timestamp } });
+        if (inserted && entries.size() > MaxEntries)
+            entries.erase(std::min_element(entries.begin(), entries.end(),
+                [](const auto &l, const auto &r) { return l.second.last_used < r.second.last_used; }));
+        return it->second.samples;
+    }
+
+    std::string file_path(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        return directory.empty() ? std::string() : (boost::filesystem::path(directory) / (key + FileExtension)).string();
+    }
+};
+
+Cache& cache()
+{
+    static Cache instance;
+    return instance;
+}
+
+template<typename T> void write_vector(std::ostream &out, const std::vector<T> &v)
+{
+    out.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+template<typename T> void read_vector(std::istream &in, std::vector<T> &v, size_t size)
+{
+    v.assign(size, T());
+    in.read(reinterpret_cast<char*>(v.data()), size * sizeof(T));
+}
+
+SamplesPtr load(const std::string &path)
+{
+    boost::nowide::ifstream in(path, std::ios::in | std::ios::binary);
+    if (! in)
+        return SamplesPtr();
+    try {
+        uint32_t magic = 0, version = 0;
+        uint64_t count = 0;
+        float    radius = 0;
+        in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+        in.read(reinterpret_cast<char*>(&radius), sizeof(radius));
+        if (! in || magic != FileMagic || version != FileVersion || count > SeamPlacer::raycasting_visibility_samples_count * 2)
+            throw Slic3r::FileIOError("Invalid header");
+        std::vector<Vec3f> positions, normals;
+        std::vector<float> visibility;
+        read_vector(in, positions, count);
+        read_vector(in, normals, count);
+        read_vector(in, visibility, count);
+        if (! in)
+            throw Slic3r::FileIOError("Truncated file");
+        return std::make_shared<const SeamVisibilitySamples>(std::move(positions), std::move(normals), std::move(visibility), radius);
+    } catch (const std::exception &err) {
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << boost::format(": can not load %1%, reason = %2%") % path % err.what();
+        return SamplesPtr();
+    }
+}
+
+void store(const std::string &path, const SeamVisibilitySamples &samples)
+{
+    boost::filesystem::path dir      = boost::filesystem::path(path).parent_path();
+    boost::filesystem::path tmp_path = dir / boost::filesystem::unique_path("%%%%-%%%%-%%%%-%%%%.tmp");
+    try {
+        {
+            boost::nowide::ofstream out(tmp_path.string(), std::ios::out | std::ios::trunc | std::ios::binary);
+            const uint32_t magic = FileMagic, version = FileVersion;
+            const uint64_t count = samples.positions.size();
+            out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+            out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            out.write(reinterpret_cast<const char*>(&samples.radius), sizeof(samples.radius));
+            write_vector(out, samples.positions);
+            write_vector(out, samples.normals);
+            write_vector(out, samples.visibility);
+            out.close();
+            if (out.fail())
+                throw Slic3r::FileIOError("Failed to write " + tmp_path.string());
+        }
+        // Atomic on the same file system, another process storing the same key at the same time writes the same content.
+        boost::filesystem::rename(tmp_path, boost::filesystem::path(path));
+    } catch (const std::exception &err) {
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << boost::format(": can not store %1%, reason = %2%") % path % err.what();
+        boost::system::error_code ec;
+        boost::filesystem::remove(tmp_path, ec);
+    }
+}
+
+} // namespace
+
+std::string key(const PrintObject &object)
+{
+    MD5_CTX ctx;
+    MD5_Init(&ctx);
+    auto add = [&ctx](const void *data, size_t size) { MD5_Update(&ctx, data, size); };
+    auto add_value = [&add](auto value) { add(&value, sizeof(value)); };
+    auto add_trafo = [&add](const Transform3d &trafo) { add(trafo.matrix().data(), sizeof(double) * 16); };
+
+    add_value(FileVersion);
+    add_value(uint64_t(SeamPlacer::raycasting_visibility_samples_count));
+    add_value(uint64_t(SeamPlacer::fast_decimation_triangle_count_target));
+    add_value(uint64_t(SeamPlacer::sqr_rays_per_sample_point));
+    add_trafo(object.trafo_centered());
+    // Only the model parts and the negative volumes are raycasted, see compute_global_occlusion().
+    for (const ModelVolume *volume : object.model_object()->volumes)
+        if (volume->type() == ModelVolumeType::MODEL_PART || volume->type() == ModelVolumeType::NEGATIVE_VOLUME) {
+            const indexed_triangle_set &its = volume->mesh().its;
+            add_value(int(volume->type()));
+            add_trafo(volume->get_matrix());
+            add_value(uint64_t(its.vertices.size()));
+            add(its.vertices.data(), its.vertices.size() * sizeof(stl_vertex));
+            add_value(uint64_t(its.indices.size()));
+            add(its.indices.data(), its.indices.size() * sizeof(stl_triangle_vertex_indices));
+        }
+
+    unsigned char digest[MD5_DIGEST_LENGTH];
+    MD5_Final(digest, &ctx);
+    std::string out;
+    out.reserve(MD5_DIGEST_LENGTH * 2);
+    static constexpr const char hex[] = "0123456789abcdef";
+    for (unsigned char c : digest) {
+        out += hex[c >> 4];
+        out += hex[c & 0xf];
+    }
+    return out;
+}
+
+SamplesPtr find(const std::string &key)
+{
+    if (SamplesPtr samples = cache().find(key); samples)
+        return samples;
+    if (std::string path = cache().file_path(key); ! path.empty())
+        if (SamplesPtr samples = load(path); samples) {
+            BOOST_LOG_TRIVIAL(debug) << __FUNCTION__ << boost::format(": seam visibility restored from %1%") % path;
+            return cache().insert(key, std::move(samples));
+        }
+    return SamplesPtr();
+}
+
+SamplesPtr insert(const std::string &key, SamplesPtr samples)
+{
+    assert(samples);
+    if (std::string path = cache().file_path(key); ! path.empty() && ! boost::filesystem::exists(path))
+        store(path, *samples);
+    return cache().insert(key, std::move(samples));
+}
+
+void set_directory(const std::string &directory)
+{
+    if (! directory.empty()) {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(boost::filesystem::path(directory), ec);
+        if (ec)
+            BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << boost::format(": can not create seam visibility cache directory %1%: %2%") % directory % ec.message();
+    }
+    std::lock_guard<std::mutex> lk(cache().mutex);
+    cache().directory = directory;
+}
+
+size_t size()
+{
+    std::lock_guard<std::mutex> lk(cache().mutex);
+    return cache().entries.size();
+}
+
+void clear()
+{
+    std::lock_guard<std::mutex> lk(cache().mutex);
+    cache().entries.clear();
+}
+
+} // namespace SeamVisibilityCache
+} // namespace Slic3r
@@ -0,0 +1,66 @@
+#ifndef slic3r_SeamVisibilityCache_hpp_
+#define slic3r_SeamVisibilityCache_hpp_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "libslic3r/Point.hpp"
+#include "libslic3r/KDTreeIndirect.hpp"
+
+namespace Slic3r {
+
+class PrintObject;
+
+// Visibility of points sampled uniformly over the surface of an object, as raycasted by the SeamPlacer,
+// together with the KD tree over the sample positions. Immutable once constructed.
+struct SeamVisibilitySamples
+{
+    struct CoordinateFunctor {
+        const std::vector<Vec3f> *positions { nullptr };
+        const float& operator()(size_t idx, size_t dim) const { return (*positions)[idx][dim]; }
+    };
+
+    SeamVisibilitySamples(std::vector<Vec3f> &&positions, std::vector<Vec3f> &&normals, std::vector<float> &&visibility, float radius) :
+        positions(std::move(positions)), normals(std::move(normals)), visibility(std::move(visibility)), radius(radius),
+        tree(CoordinateFunctor { &this->positions }, this->positions.size()) {}
+    // The tree refers to the positions.
+    SeamVisibilitySamples(const SeamVisibilitySamples &) = delete;
+    SeamVisibilitySamples& operator=(const SeamVisibilitySamples &) = delete;
+
+    std::vector<Vec3f>                              positions;
+    std::vector<Vec3f>                              normals;
+    std::vector<float>                              visibility;
+    // Search radius around a point for the samples contributing to its visibility.
+    float                                           radius;
+    KDTreeIndirect<3, float, CoordinateFunctor>     tree;
+};
+
+// Process wide cache of the seam visibility samples. The raycasting depends only on the meshes of the model parts
+// and negative volumes of an object and on the transformation of the object, thus the samples are keyed by a digest
+// of these, and re-slicing an object, changing its settings or slicing its copy on another plate reuses them.
+// Optionally the samples are stored in a directory as files <key>.seamvis, so that they are shared across processes
+// (the command line slicer stores them next to its step cache).
+namespace SeamVisibilityCache {
+
+using SamplesPtr = std::shared_ptr<const SeamVisibilitySamples>;
+
+// Hex digest of the inputs of the visibility raycasting of the object.
+std::string key(const PrintObject &object);
+
+// Cached samples, loaded from the cache directory if not in memory. Null if not cached.
+SamplesPtr  find(const std::string &key);
+// Store the samples, returns the samples stored under the key, which may have been inserted by another thread meanwhile.
+SamplesPtr  insert(const std::string &key, SamplesPtr samples);
+
+// Directory to store the samples to, empty to cache the samples in memory only.
+void        set_directory(const std::string &directory);
+
+// Number of samples cached in memory.
+size_t      size();
+void        clear();
+
+} // namespace SeamVisibilityCache
+} // namespace Slic3r
+
+#endif // slic3r_SeamVisibilityCache_hpp_
@@ -1,6 +1,10 @@
 #include "GCodeReader.hpp"
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/format.hpp>
 #include <boost/nowide/fstream.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <fstream>
@@ -122,7 +126,7 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
 }
 
 template<typename ParseLineCallback, typename LineEndCallback>
-bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+bool GCodeReader::parse_file_raw_stdio_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
     FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
 
@@ -177,6 +181,61 @@ bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLine
     return true;
 }
 
+template<typename ParseLineCallback, typename LineEndCallback>
+bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+{
+    boost::system::error_code ec;
+    uintmax_t file_size = boost::filesystem::file_size(boost::filesystem::path(filename), ec);
+    if (ec)
+        return false;
+    if (file_size == 0)
+        // Nothing to parse, and an empty file cannot be memory mapped.
+        return true;
+
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(boost::filesystem::path(filename));
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << __FUNCTION__ << boost::format(": failed to memory map %1%, reading it sequentially: %2%") % filename % ex.what();
+    }
+    if (! file.is_open())
+        return this->parse_file_raw_stdio_internal(filename, parse_line_callback, line_end_callback);
+
+    // The lines are parsed in place inside the mapping, their ends are searched for with memchr(),
+    // which is vectorized by the C runtime.
+    const char *begin = file.data();
+    const char *end   = begin + file.size();
+    m_parsing = true;
+    for (const char *it = begin; it != end;) {
+        const char *it_eol = static_cast<const char*>(memchr(it, '\n', end - it));
+        if (it_eol == nullptr)
+            it_eol = end;
+        // A lone '\r' ends a line as well.
+        const char *it_cr = static_cast<const char*>(memchr(it, '\r', it_eol - it));
+        const char *it_end = it_cr ? it_cr : it_eol;
+        if (it_end == end) {
+            // The last line without an end of line: The parser expects an end of line character after the line,
+            // which is not available past the end of the mapping.
+            std::string gcode_line(it, it_end);
+            parse_line_callback(gcode_line.c_str(), gcode_line.c_str() + gcode_line.size());
+            break;
+        }
+        parse_line_callback(it, it_end);
+        if (! m_parsing)
+            // The callback wishes to exit.
+            return true;
+        // Skip EOL.
+        it = it_end;
+        if (*it == '\r')
+            ++ it;
+        if (it != end && *it == '\n') {
+            line_end_callback(size_t(it - begin) + 1);
+            ++ it;
+        }
+    }
+    return true;
+}
+
 template<typename ParseLineCallback, typename LineEndCallback>
 bool GCodeReader::parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
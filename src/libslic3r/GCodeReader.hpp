@@ -72,10 +72,13 @@ public:
         float j() const { return m_axis[J]; }
         float p() const { return m_axis[P]; }
 
-        static bool cmd_is(const std::string &gcode_line, const char *cmd_test) {
-            const char *cmd = GCodeReader::skip_whitespaces(gcode_line.c_str());
-            size_t len = strlen(cmd_test); 
-            return strncmp(cmd, cmd_test, len) == 0 && GCodeReader::is_end_of_word(cmd[len]);
+        // gcode_line does not need to be zero terminated, thus a line may be tested in place inside a larger buffer.
+        static bool cmd_is(const std::string_view gcode_line, const char *cmd_test) {
+            size_t i = 0;
+            for (; i < gcode_line.size() && GCodeReader::is_whitespace(gcode_line[i]); ++ i) ;
+            size_t len = strlen(cmd_test);
+            return gcode_line.substr(i, len) == std::string_view(cmd_test, len) &&
+                (i + len == gcode_line.size() || GCodeReader::is_end_of_word(gcode_line[i + len]));
         }
 
     private:
@@ -96,9 +99,16 @@ public:
     template<typename Callback>
     void parse_buffer(const std::string &buffer, Callback callback)
     {
-        const char *ptr = buffer.c_str();
-        const char *end = ptr + buffer.size();
         GCodeLine gline;
+        this->parse_buffer(buffer.c_str(), buffer.c_str() + buffer.size(), gline, callback);
+    }
+
+    // Parse a zero terminated buffer [ptr, end). gline is reused for all the lines, so that a caller parsing
+    // many short buffers may keep a single GCodeLine to not reallocate its raw string for each buffer.
+    template<typename Callback>
+    void parse_buffer(const char *ptr, const char *end, GCodeLine &gline, Callback callback)
+    {
+        assert(*end == 0);
         m_parsing = true;
         while (m_parsing && *ptr != 0) {
             gline.reset();
@@ -123,6 +133,26 @@ public:
     void parse_line(const std::string &line, Callback callback)
         { GCodeLine gline; this->parse_line(line.c_str(), line.c_str() + line.size(), gline, callback); }
 
+    // Process a line tokenized already by the caller, as parse_line() would: raw is the line without its end of line,
+    // cmd its command word inside raw, axis_values and axis_mask the parsed axes indexed by Axis.
+    template<typename Callback>
+    void process_parsed_line(std::string_view raw, std::string_view cmd, const float *axis_values, uint32_t axis_mask, GCodeLine &gline, Callback &callback)
+    {
+        gline.reset();
+        gline.m_raw.assign(raw.data(), raw.size());
+        for (size_t i = 0; i < NUM_AXES; ++ i)
+            if (axis_mask & (1 << i))
+                gline.m_axis[i] = axis_values[i];
+        gline.m_mask = axis_mask;
+        if (gline.has(E) && m_config.use_relative_e_distances)
+            m_position[E] = 0;
+        callback(*this, gline);
+        if (! cmd.empty()) {
+            std::pair<const char*, const char*> command(cmd.data(), cmd.data() + cmd.size());
+            update_coordinates(gline, command);
+        }
+    }
+
     // Returns false if reading the file failed.
     bool parse_file(const std::string &file, callback_t callback);
     // Collect positions of line ends in the binary G-code to be used by the G-code viewer when memory mapping and displaying section of G-code
@@ -151,9 +181,12 @@ public:
     float  j() const { return m_position[J]; }
 
 private:
+    // Parse the file memory mapped, falls back to parse_file_raw_stdio_internal() if the file could not be mapped.
     template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
     template<typename ParseLineCallback, typename LineEndCallback>
+    bool        parse_file_raw_stdio_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
+    template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
 
     const char* parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command);
@@ -1,7 +1,6 @@
 #include "GCodeWriter.hpp"
 #include "CustomGCode.hpp"
 #include <algorithm>
-#include <iomanip>
 #include <iostream>
 #include <map>
 #include <assert.h>
@@ -57,11 +56,11 @@ void GCodeWriter::set_extruders(std::vector<unsigned int> extruder_ids)
 
 std::string GCodeWriter::preamble()
 {
-    std::ostringstream gcode;
+    std::string gcode;
     
     if (FLAVOR_IS_NOT(gcfMakerWare)) {
-        gcode << "G90\n";
-        gcode << "G21\n";
+        gcode += "G90\n";
+        gcode += "G21\n";
     }
     if (FLAVOR_IS(gcfRepRapSprinter) ||
         FLAVOR_IS(gcfRepRapFirmware) ||
@@ -73,22 +72,22 @@ std::string GCodeWriter::preamble()
         FLAVOR_IS(gcfKlipper))
     {
         if (this->config.use_relative_e_distances) {
-            gcode << "M83 ; use relative distances for extrusion\n";
+            gcode += "M83 ; use relative distances for extrusion\n";
         } else {
-            gcode << "M82 ; use absolute distances for extrusion\n";
+            gcode += "M82 ; use absolute distances for extrusion\n";
         }
-        gcode << this->reset_e(true);
+        gcode += this->reset_e(true);
     }
     
-    return gcode.str();
+    return gcode;
 }
 
 std::string GCodeWriter::postamble() const
 {
-    std::ostringstream gcode;
+    std::string gcode;
     if (FLAVOR_IS(gcfMachinekit))
-          gcode << "M2 ; end of program\n";
-    return gcode.str();
+          gcode += "M2 ; end of program\n";
+    return gcode;
 }
 
 std::string GCodeWriter::set_temperature(unsigned int temperature, bool wait, int tool) const
@@ -109,28 +108,34 @@ std::string GCodeWriter::set_temperature(unsigned int temperature, bool wait, in
         comment = "set nozzle temperature";
     }
     
-    std::ostringstream gcode;
-    gcode << code << " ";
-    if (FLAVOR_IS(gcfMach3) || FLAVOR_IS(gcfMachinekit)) {
-        gcode << "P";
-    } else {
-        gcode << "S";
-    }
-    gcode << temperature;
-    bool multiple_tools = this->multiple_extruders && ! m_single_extruder_multi_material;
-    if (tool != -1 && (multiple_tools || FLAVOR_IS(gcfMakerWare) || FLAVOR_IS(gcfSailfish)) ) {
-        if (FLAVOR_IS(gcfRepRapFirmware)) {
-            gcode << " P" << tool;
+    std::string gcode;
+    {
+        GCodeFormatter w(gcode);
+        w.emit_string(code);
+        w.emit_char(' ');
+        if (FLAVOR_IS(gcfMach3) || FLAVOR_IS(gcfMachinekit)) {
+            w.emit_char('P');
         } else {
-            gcode << " T" << tool;
+            w.emit_char('S');
         }
+        w.emit_int(temperature);
+        bool multiple_tools = this->multiple_extruders && ! m_single_extruder_multi_material;
+        if (tool != -1 && (multiple_tools || FLAVOR_IS(gcfMakerWare) || FLAVOR_IS(gcfSailfish)) ) {
+            if (FLAVOR_IS(gcfRepRapFirmware)) {
+                w.emit_string(" P");
+            } else {
+                w.emit_string(" T");
+            }
+            w.emit_int(tool);
+        }
+        w.emit_comment(true, comment);
+        w.end_line();
     }
-    gcode << " ; " << comment << "\n";
     
     if ((FLAVOR_IS(gcfTeacup) || FLAVOR_IS(gcfRepRapFirmware)) && wait)
-        gcode << "M116 ; wait for temperature to be reached\n";
+        gcode += "M116 ; wait for temperature to be reached\n";
     
-    return gcode.str();
+    return gcode;
 }
 
 // BBS
@@ -143,7 +148,7 @@ std::string GCodeWriter::set_bed_temperature(int temperature, bool wait)
     m_last_bed_temperature_reached = wait;
 
     std::string code, comment;
-    std::ostringstream gcode;
+    GCodeFormatter w;
 
     if (wait) {
         code = "M190";
@@ -154,31 +159,43 @@ std::string GCodeWriter::set_bed_temperature(int temperature, bool wait)
         comment = "set bed temperature";
     }
 
-    gcode << code << " S" << temperature << " ; " << comment << "\n";
-    return gcode.str();
+    w.emit_string(code);
+    w.emit_string(" S");
+    w.emit_int(temperature);
+    w.emit_comment(true, comment);
+    return w.string();
 }
 
 std::string GCodeWriter::set_chamber_temperature(int temperature, bool wait)
 {
     std::string code, comment;
-    std::ostringstream gcode;
+    std::string gcode;
 
     if (wait)
     {
         // Orca: should we let the M191 command to turn on the auxiliary fan?
         if (config.auxiliary_fan)
-            gcode << "M106 P2 S255 \n";
-        gcode << "M191 S" << std::to_string(temperature) << " ;"
-              << "set chamber_temperature and wait for it to be reached\n";
+            gcode += "M106 P2 S255 \n";
+        GCodeFormatter w(gcode);
+        w.emit_string("M191 S");
+        w.emit_int(temperature);
+        w.emit_string(" ;set chamber_temperature and wait for it to be reached");
+        w.end_line();
         if (config.auxiliary_fan)
-            gcode << "M106 P2 S0 \n";
+            gcode += "M106 P2 S0 \n";
     }
     else {
         code = "M141";
         comment = "set chamber_temperature";
-        gcode << code << " S" << temperature << ";" << comment << "\n";
+        GCodeFormatter w(gcode);
+        w.emit_string(code);
+        w.emit_string(" S");
+        w.emit_int(temperature);
+        w.emit_char(';');
+        w.emit_string(comment);
+        w.end_line();
     }
-    return gcode.str();
+    return gcode;
 }
 
 // copied from PrusaSlicer
@@ -199,26 +216,30 @@ std::string GCodeWriter::set_acceleration_internal(Acceleration type, unsigned i
     
     last_value = acceleration;
     
-    std::ostringstream gcode;
-    if (FLAVOR_IS(gcfRepetier))
-        gcode << (separate_travel ? "M202 X" : "M201 X") << acceleration << " Y" << acceleration;
-    else if (FLAVOR_IS(gcfRepRapFirmware) || FLAVOR_IS(gcfMarlinFirmware))
-        gcode << (separate_travel ? "M204 T" : "M204 P") << acceleration;
-    else if (FLAVOR_IS(gcfKlipper)) {
-        gcode << "SET_VELOCITY_LIMIT ACCEL=" << acceleration;
+    GCodeFormatter w;
+    if (FLAVOR_IS(gcfRepetier)) {
+        w.emit_string(separate_travel ? "M202 X" : "M201 X");
+        w.emit_int(acceleration);
+        w.emit_string(" Y");
+        w.emit_int(acceleration);
+    } else if (FLAVOR_IS(gcfRepRapFirmware) || FLAVOR_IS(gcfMarlinFirmware)) {
+        w.emit_string(separate_travel ? "M204 T" : "M204 P");
+        w.emit_int(acceleration);
+    } else if (FLAVOR_IS(gcfKlipper)) {
+        w.emit_string("SET_VELOCITY_LIMIT ACCEL=");
+        w.emit_int(acceleration);
         if (this->config.accel_to_decel_enable) {
-            gcode << " ACCEL_TO_DECEL=" << acceleration * this->config.accel_to_decel_factor / 100;
-            if (GCodeWriter::full_gcode_comment)
-                gcode << " ; adjust ACCEL_TO_DECEL";
+            w.emit_string(" ACCEL_TO_DECEL=");
+            w.emit_double(acceleration * this->config.accel_to_decel_factor / 100);
+            w.emit_comment(GCodeWriter::full_gcode_comment, "adjust ACCEL_TO_DECEL");
         }
+    } else {
+        w.emit_string("M204 S");
+        w.emit_int(acceleration);
     }
-    else
-        gcode << "M204 S" << acceleration;
 
-    if (GCodeWriter::full_gcode_comment) gcode << " ; adjust acceleration";
-    gcode << "\n";
-    
-    return gcode.str();
+    w.emit_comment(GCodeWriter::full_gcode_comment, "adjust acceleration");
+    return w.string();
 }
 
 std::string GCodeWriter::set_jerk_xy(double jerk)
@@ -232,19 +253,26 @@ std::string GCodeWriter::set_jerk_xy(double jerk)
     
     m_last_jerk = jerk;
     
-    std::ostringstream gcode;
-    if(FLAVOR_IS(gcfKlipper))
-        gcode << "SET_VELOCITY_LIMIT SQUARE_CORNER_VELOCITY=" << jerk;
-    else
-        gcode << "M205 X" << jerk << " Y" << jerk;
+    GCodeFormatter w;
+    if(FLAVOR_IS(gcfKlipper)) {
+        w.emit_string("SET_VELOCITY_LIMIT SQUARE_CORNER_VELOCITY=");
+        w.emit_double(jerk);
+    } else {
+        w.emit_string("M205 X");
+        w.emit_double(jerk);
+        w.emit_string(" Y");
+        w.emit_double(jerk);
+    }
       
-    if (m_is_bbl_printers)
-        gcode << std::setprecision(2) << " Z" << m_max_jerk_z << " E" << m_max_jerk_e;
-
-    if (GCodeWriter::full_gcode_comment) gcode << " ; adjust jerk";
-    gcode << "\n";
+    if (m_is_bbl_printers) {
+        w.emit_string(" Z");
+        w.emit_double(m_max_jerk_z, 2);
+        w.emit_string(" E");
+        w.emit_double(m_max_jerk_e, 2);
+    }
 
-    return gcode.str();
+    w.emit_comment(GCodeWriter::full_gcode_comment, "adjust jerk");
+    return w.string();
 
 }
 
@@ -259,12 +287,14 @@ std::string GCodeWriter::set_accel_and_jerk(unsigned int acceleration, double je
         acceleration = m_max_acceleration;
     
     bool is_empty = true;
-    std::ostringstream gcode;
-    gcode << "SET_VELOCITY_LIMIT";
+    GCodeFormatter w;
+    w.emit_string("SET_VELOCITY_LIMIT");
     if (acceleration != 0 && acceleration != m_last_acceleration) {
-        gcode << " ACCEL=" << acceleration;
+        w.emit_string(" ACCEL=");
+        w.emit_int(acceleration);
         if (this->config.accel_to_decel_enable) {
-            gcode << " ACCEL_TO_DECEL=" << acceleration * this->config.accel_to_decel_factor / 100;
+            w.emit_string(" ACCEL_TO_DECEL=");
+            w.emit_double(acceleration * this->config.accel_to_decel_factor / 100);
         }
         m_last_acceleration = acceleration;
         is_empty = false;
@@ -274,7 +304,8 @@ std::string GCodeWriter::set_accel_and_jerk(unsigned int acceleration, double je
         jerk = m_max_jerk;
 
     if (jerk > 0.01 && !is_approx(jerk, m_last_jerk)) {
-        gcode << " SQUARE_CORNER_VELOCITY=" << jerk;
+        w.emit_string(" SQUARE_CORNER_VELOCITY=");
+        w.emit_double(jerk);
         m_last_jerk = jerk;
         is_empty = false;
     }
@@ -282,32 +313,33 @@ std::string GCodeWriter::set_accel_and_jerk(unsigned int acceleration, double je
     if(is_empty)
         return std::string();
 
-    if (GCodeWriter::full_gcode_comment)
-        gcode << " ; adjust VELOCITY_LIMIT(accel/jerk)";
-    gcode << "\n";
-
-    return gcode.str();
+    w.emit_comment(GCodeWriter::full_gcode_comment, "adjust VELOCITY_LIMIT(accel/jerk)");
+    return w.string();
 
 }
 
 std::string GCodeWriter::set_pressure_advance(double pa) const
 {
-    std::ostringstream gcode;
     if (pa < 0)
-        return gcode.str();
+        return std::string();
+    GCodeFormatter w;
     if(m_is_bbl_printers){
         //SoftFever: set L1000 to use linear model
-        gcode << "M900 K" <<std::setprecision(4)<< pa << " L1000 M10 ; Override pressure advance value\n";
+        w.emit_string("M900 K");
+        w.emit_double(pa, 4);
+        w.emit_string(" L1000 M10 ; Override pressure advance value");
     }
     else{
         if (FLAVOR_IS(gcfKlipper))
-            gcode << "SET_PRESSURE_ADVANCE ADVANCE=" << std::setprecision(4) << pa << "; Override pressure advance value\n";
+            w.emit_string("SET_PRESSURE_ADVANCE ADVANCE=");
         else if(FLAVOR_IS(gcfRepRapFirmware))
-            gcode << ("M572 D0 S") << std::setprecision(4) << pa << "; Override pressure advance value\n";
+            w.emit_string("M572 D0 S");
         else
-            gcode << "M900 K" <<std::setprecision(4)<< pa << "; Override pressure advance value\n";
+            w.emit_string("M900 K");
+        w.emit_double(pa, 4);
+        w.emit_string("; Override pressure advance value");
     }
-    return gcode.str();
+    return w.string();
 }
 
 
@@ -326,12 +358,8 @@ std::string GCodeWriter::reset_e(bool force)
     }
 
     if (! this->config.use_relative_e_distances) {
-        std::ostringstream gcode;
-        gcode << "G92 E0";
         //BBS
-        if (GCodeWriter::full_gcode_comment) gcode << " ; reset extrusion distance";
-        gcode << "\n";
-        return gcode.str();
+        return GCodeWriter::full_gcode_comment ? "G92 E0 ; reset extrusion distance\n" : "G92 E0\n";
     } else {
         return "";
     }
@@ -349,12 +377,12 @@ std::string GCodeWriter::update_progress(unsigned int num, unsigned int tot, boo
     unsigned int percent = (unsigned int)floor(100.0 * num / tot + 0.5);
     if (!allow_100) percent = std::min(percent, (unsigned int)99);
     
-    std::ostringstream gcode;
-    gcode << "M73 P" << percent;
+    GCodeFormatter w;
+    w.emit_string("M73 P");
+    w.emit_int(percent);
     //BBS
-    if (GCodeWriter::full_gcode_comment) gcode << " ; update progress";
-    gcode << "\n";
-    return gcode.str();
+    w.emit_comment(GCodeWriter::full_gcode_comment, "update progress");
+    return w.string();
 }
 
 std::string GCodeWriter::toolchange_prefix() const
@@ -373,33 +401,50 @@ std::string GCodeWriter::toolchange(unsigned int extruder_id)
 
     // return the toolchange command
     // if we are running a single-extruder setup, just set the extruder and return nothing
-    std::ostringstream gcode;
+    std::string gcode;
     if (this->multiple_extruders || (this->config.filament_diameter.values.size() > 1 && !is_bbl_printers())) {
-        gcode << this->toolchange_prefix() << extruder_id;
-        //BBS
-        if (GCodeWriter::full_gcode_comment)
-            gcode << " ; change extruder";
-        gcode << "\n";
-        gcode << this->reset_e(true);
+        {
+            GCodeFormatter w(gcode);
+            w.emit_string(this->toolchange_prefix());
+            w.emit_int(extruder_id);
+            //BBS
+            w.emit_comment(GCodeWriter::full_gcode_comment, "change extruder");
+            w.end_line();
+        }
+        gcode += this->reset_e(true);
     }
-    return gcode.str();
+    return gcode;
 }
 
 std::string GCodeWriter::set_speed(double F, const std::string &comment, const std::string &cooling_marker)
+{
+    std::string gcode;
+    this->set_speed(gcode, F, comment, cooling_marker);
+    return gcode;
+}
+
+void GCodeWriter::set_speed(std::string &gcode, double F, const std::string &comment, const std::string &cooling_marker)
 {
     assert(F > 0.);
     assert(F < 100000.);
     
     m_current_speed = F;
-    GCodeG1Formatter w;
+    GCodeG1Formatter w(gcode);
     w.emit_f(F);
     //BBS
     w.emit_comment(GCodeWriter::full_gcode_comment, comment);
     w.emit_string(cooling_marker);
-    return w.string();
+    w.end_line();
 }
 
 std::string GCodeWriter::travel_to_xy(const Vec2d &point, const std::string &comment)
+{
+    std::string gcode;
+    this->travel_to_xy(gcode, point, comment);
+    return gcode;
+}
+
+void GCodeWriter::travel_to_xy(std::string &gcode, const Vec2d &point, const std::string &comment)
 {
     m_pos(0) = point(0);
     m_pos(1) = point(1);
@@ -408,14 +453,14 @@ std::string GCodeWriter::travel_to_xy(const Vec2d &point, const std::string &com
     //BBS: take plate offset into consider
     Vec2d point_on_plate = { point(0) - m_x_offset, point(1) - m_y_offset };
     
-    GCodeG1Formatter w;
+    GCodeG1Formatter w(gcode);
     w.emit_xy(point_on_plate);
     auto speed = m_is_first_layer
         ? this->config.get_abs_value("initial_layer_travel_speed") : this->config.travel_speed.value;
     w.emit_f(speed * 60.0);
     //BBS
     w.emit_comment(GCodeWriter::full_gcode_comment, comment);
-    return w.string();
+    w.end_line();
 }
 
 std::string GCodeWriter::travel_to_xyz(const Vec3d &point, const std::string &comment)
@@ -593,13 +638,14 @@ std::string GCodeWriter::_spiral_travel_to_z(double z, const Vec2d &ij_offset, c
     }
     
     std::string output = "G17\n";
-    GCodeG2G3Formatter w(true);
+    GCodeG2G3Formatter w(output, true);
     w.emit_z(z);
     w.emit_ij(ij_offset);
     w.emit_string(" P1 ");
     w.emit_f(speed * 60.0);
     w.emit_comment(GCodeWriter::full_gcode_comment, comment);
-    return output + w.string();
+    w.end_line();
+    return output;
 }
 
 bool GCodeWriter::will_move_z(double z) const
@@ -620,6 +666,13 @@ bool GCodeWriter::will_move_z(double z) const
 }
 
 std::string GCodeWriter::extrude_to_xy(const Vec2d &point, double dE, const std::string &comment, bool force_no_extrusion)
+{
+    std::string gcode;
+    this->extrude_to_xy(gcode, point, dE, comment, force_no_extrusion);
+    return gcode;
+}
+
+void GCodeWriter::extrude_to_xy(std::string &gcode, const Vec2d &point, double dE, const std::string &comment, bool force_no_extrusion)
 {
     m_pos(0) = point(0);
     m_pos(1) = point(1);
@@ -632,19 +685,26 @@ std::string GCodeWriter::extrude_to_xy(const Vec2d &point, double dE, const std:
     //BBS: take plate offset into consider
     Vec2d point_on_plate = { point(0) - m_x_offset, point(1) - m_y_offset };
 
-    GCodeG1Formatter w;
+    GCodeG1Formatter w(gcode);
     w.emit_xy(point_on_plate);
     if (!force_no_extrusion)
         w.emit_e(m_extruder->E());
     //BBS
     w.emit_comment(GCodeWriter::full_gcode_comment, comment);
-    return w.string();
+    w.end_line();
 }
 
 //BBS: generate G2 or G3 extrude which moves by arc
 //point is end point which means X and Y axis
 //center_offset is I and J axis
 std::string GCodeWriter::extrude_arc_to_xy(const Vec2d& point, const Vec2d& center_offset, double dE, const bool is_ccw, const std::string& comment, bool force_no_extrusion)
+{
+    std::string gcode;
+    this->extrude_arc_to_xy(gcode, point, center_offset, dE, is_ccw, comment, force_no_extrusion);
+    return gcode;
+}
+
+void GCodeWriter::extrude_arc_to_xy(std::string &gcode, const Vec2d& point, const Vec2d& center_offset, double dE, const bool is_ccw, const std::string& comment, bool force_no_extrusion)
 {
     m_pos(0) = point(0);
     m_pos(1) = point(1);
@@ -653,14 +713,14 @@ std::string GCodeWriter::extrude_arc_to_xy(const Vec2d& point, const Vec2d& cent
 
     Vec2d point_on_plate = { point(0) - m_x_offset, point(1) - m_y_offset };
 
-    GCodeG2G3Formatter w(is_ccw);
+    GCodeG2G3Formatter w(gcode, is_ccw);
     w.emit_xy(point_on_plate);
     w.emit_ij(center_offset);
     if (!force_no_extrusion)
         w.emit_e(m_extruder->E());
     //BBS
     w.emit_comment(GCodeWriter::full_gcode_comment, comment);
-    return w.string();
+    w.end_line();
 }
 
 std::string GCodeWriter::extrude_to_xyz(const Vec3d &point, double dE, const std::string &comment, bool force_no_extrusion)
@@ -801,36 +861,32 @@ std::string GCodeWriter::unlift()
 
 std::string GCodeWriter::set_fan(const GCodeFlavor gcode_flavor, unsigned int speed)
 {
-    std::ostringstream gcode;
+    GCodeFormatter w;
     if (speed == 0) {
         switch (gcode_flavor) {
         case gcfTeacup:
-            gcode << "M106 S0"; break;
+            w.emit_string("M106 S0"); break;
         case gcfMakerWare:
         case gcfSailfish:
-            gcode << "M127";    break;
+            w.emit_string("M127");    break;
         default:
-            gcode << "M106 S0";    break;
+            w.emit_string("M106 S0");    break;
         }
-        if (GCodeWriter::full_gcode_comment)
-            gcode << " ; disable fan";
-        gcode << "\n";
+        w.emit_comment(GCodeWriter::full_gcode_comment, "disable fan");
     } else {
         switch (gcode_flavor) {
         case gcfMakerWare:
         case gcfSailfish:
-            gcode << "M126";    break;
+            w.emit_string("M126");    break;
         case gcfMach3:
         case gcfMachinekit:
-            gcode << "M106 P" << static_cast<unsigned int>(255.5 * speed / 100.0); break;
+            w.emit_string("M106 P"); w.emit_int(static_cast<unsigned int>(255.5 * speed / 100.0)); break;
         default:
-            gcode << "M106 S" << static_cast<unsigned int>(255.5 * speed / 100.0); break;
+            w.emit_string("M106 S"); w.emit_int(static_cast<unsigned int>(255.5 * speed / 100.0)); break;
         }
-        if (GCodeWriter::full_gcode_comment) 
-            gcode << " ; enable fan";
-        gcode << "\n";
+        w.emit_comment(GCodeWriter::full_gcode_comment, "enable fan");
     }
-    return gcode.str();
+    return w.string();
 }
 
 std::string GCodeWriter::set_fan(unsigned int speed) const
@@ -842,27 +898,24 @@ std::string GCodeWriter::set_fan(unsigned int speed) const
 //BBS: set additional fan speed for BBS machine only
 std::string GCodeWriter::set_additional_fan(unsigned int speed)
 {
-    std::ostringstream gcode;
+    GCodeFormatter w;
 
-    gcode << "M106 " << "P2 " << "S" << (int)(255.0 * speed / 100.0);
-    if (GCodeWriter::full_gcode_comment) {
-        if (speed == 0)
-            gcode << " ; disable additional fan ";
-        else
-            gcode << " ; enable additional fan ";
-    }
-    gcode << "\n";
-    return gcode.str();
+    w.emit_string("M106 P2 S");
+    w.emit_int((int)(255.0 * speed / 100.0));
+    w.emit_comment(GCodeWriter::full_gcode_comment, speed == 0 ? "disable additional fan " : "enable additional fan ");
+    return w.string();
 }
 
 std::string GCodeWriter::set_exhaust_fan( int speed,bool add_eol)
 {
-    std::ostringstream gcode;
-    gcode << "M106" << " P3" << " S" << (int)(speed / 100.0 * 255);
-
-    if(add_eol)
-        gcode << "\n";
-    return gcode.str();
+    std::string gcode;
+    {
+        GCodeFormatter w(gcode);
+        w.emit_string("M106 P3 S");
+        w.emit_int((int)(speed / 100.0 * 255));
+        w.end_line(add_eol);
+    }
+    return gcode;
 }
 
 void GCodeWriter::add_object_start_labels(std::string& gcode)
@@ -892,53 +945,86 @@ void GCodeWriter::add_object_change_labels(std::string& gcode)
     add_object_start_labels(gcode);
 }
 
+void GCodeFormatter::emit_int(int64_t v)
+{
+    // Sign and 19 digits of int64_t.
+    char *ptr = this->reserve(20);
+#ifdef __APPLE__
+    char *end = ptr;
+    boost::spirit::karma::generate(end, boost::spirit::karma::int_generator<int64_t>(), v);
+#else
+    char *end = std::to_chars(ptr, ptr + 20, v).ptr;
+#endif
+    m_pos += end - ptr;
+}
+
+void GCodeFormatter::emit_double(double v, int precision)
+{
+    assert(precision >= 0 && precision <= 17);
+    // Sign, 17 significant digits, decimal point and exponent up to "e-308".
+    static constexpr const size_t max_len = 32;
+    char *ptr = this->reserve(max_len + 1);
+#ifdef __APPLE__
+    // Older stdlib on macOS doesn't support floating point std::to_chars. G-code is always exported with the "C" locale active.
+    m_pos += snprintf(ptr, max_len + 1, "%.*g", precision, v);
+#else
+    // Same output as printf("%.*g"), which is what std::ostream produces with the default floatfield.
+    m_pos += std::to_chars(ptr, ptr + max_len, v, std::chars_format::general, precision).ptr - ptr;
+#endif
+}
+
 void GCodeFormatter::emit_axis(const char axis, const double v, size_t digits) {
     assert(digits <= 9);
     static constexpr const std::array<int, 10> pow_10{1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
-    *ptr_err.ptr++ = ' '; *ptr_err.ptr++ = axis;
+    // Space, axis, sign, 19 digits of int64_t, decimal point and a leading zero.
+    static constexpr const size_t max_len = 24;
+    char *ptr = this->reserve(max_len);
+    *ptr++ = ' '; *ptr++ = axis;
 
-    char *base_ptr = this->ptr_err.ptr;
+    char *base_ptr = ptr;
+    char *buf_end  = base_ptr + max_len - 2;
     auto  v_int    = int64_t(std::round(v * pow_10[digits]));
     // Older stdlib on macOS doesn't support std::from_chars at all, so it is used boost::spirit::karma::generate instead of it.
     // That is a little bit slower than std::to_chars but not much.
 #ifdef __APPLE__
-    boost::spirit::karma::generate(this->ptr_err.ptr, boost::spirit::karma::int_generator<int64_t>(), v_int);
+    boost::spirit::karma::generate(ptr, boost::spirit::karma::int_generator<int64_t>(), v_int);
 #else
-    // this->buf_end minus 1 because we need space for adding the extra decimal point.
-    this->ptr_err = std::to_chars(this->ptr_err.ptr, this->buf_end - 1, v_int);
+    // buf_end minus 1 because we need space for adding the extra decimal point.
+    ptr = std::to_chars(ptr, buf_end - 1, v_int).ptr;
 #endif
-    size_t writen_digits = (this->ptr_err.ptr - base_ptr) - (v_int < 0 ? 1 : 0);
+    size_t writen_digits = (ptr - base_ptr) - (v_int < 0 ? 1 : 0);
     if (writen_digits < digits) {
         // Number is smaller than 10^digits, so that we will pad it with zeros.
         size_t remaining_digits = digits - writen_digits;
         // Move all newly inserted chars by remaining_digits to allocate space for padding with zeros.
-        for (char *from_ptr = this->ptr_err.ptr - 1, *to_ptr = from_ptr + remaining_digits; from_ptr >= this->ptr_err.ptr - writen_digits; --to_ptr, --from_ptr)
+        for (char *from_ptr = ptr - 1, *to_ptr = from_ptr + remaining_digits; from_ptr >= ptr - writen_digits; --to_ptr, --from_ptr)
             *to_ptr = *from_ptr;
 
-        memset(this->ptr_err.ptr - writen_digits, '0', remaining_digits);
-        this->ptr_err.ptr += remaining_digits;
+        memset(ptr - writen_digits, '0', remaining_digits);
+        ptr += remaining_digits;
     }
 
     // Move all newly inserted chars by one to allocate space for a decimal point.
-    for (char *to_ptr = this->ptr_err.ptr, *from_ptr = to_ptr - 1; from_ptr >= this->ptr_err.ptr - digits; --to_ptr, --from_ptr)
+    for (char *to_ptr = ptr, *from_ptr = to_ptr - 1; from_ptr >= ptr - digits; --to_ptr, --from_ptr)
         *to_ptr = *from_ptr;
 
-    *(this->ptr_err.ptr - digits) = '.';
+    *(ptr - digits) = '.';
     for (size_t i = 0; i < digits; ++i) {
-        if (*this->ptr_err.ptr != '0')
+        if (*ptr != '0')
             break;
-        this->ptr_err.ptr--;
+        ptr--;
     }
-    if (*this->ptr_err.ptr == '.')
-        this->ptr_err.ptr--;
-    if ((this->ptr_err.ptr + 1) == base_ptr || *this->ptr_err.ptr == '-')
-        *(++this->ptr_err.ptr) = '0';
-    this->ptr_err.ptr++;
+    if (*ptr == '.')
+        ptr--;
+    if ((ptr + 1) == base_ptr || *ptr == '-')
+        *(++ptr) = '0';
+    ptr++;
+    m_pos = ptr - m_out->data();
 
 #if 0 // #ifndef NDEBUG
     {
         // Verify that the optimized formatter produces the same result as the standard sprintf().
-        double v1 = atof(std::string(base_ptr, this->ptr_err.ptr).c_str());
+        double v1 = atof(std::string(base_ptr, ptr).c_str());
         char buf[2048];
         sprintf(buf, "%.*lf", int(digits), v);
         double v2 = atof(buf);
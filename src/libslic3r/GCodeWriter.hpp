@@ -3,7 +3,9 @@
 
 #include "libslic3r.h"
 #include <string>
+#include <string_view>
 #include <charconv>
+#include <cstring>
 #include "Extruder.hpp"
 #include "Point.hpp"
 #include "PrintConfig.hpp"
@@ -64,15 +66,20 @@ public:
     std::string toolchange_prefix() const;
     std::string toolchange(unsigned int extruder_id);
     std::string set_speed(double F, const std::string &comment = std::string(), const std::string &cooling_marker = std::string());
+    // The overloads taking the output G-code append the command to it in place, without allocating a temporary string.
+    void        set_speed(std::string &gcode, double F, const std::string &comment = std::string(), const std::string &cooling_marker = std::string());
     // SoftFever NOTE: the returned speed is mm/minute
     double      get_current_speed() const { return m_current_speed;}
     std::string travel_to_xy(const Vec2d &point, const std::string &comment = std::string());
+    void        travel_to_xy(std::string &gcode, const Vec2d &point, const std::string &comment = std::string());
     std::string travel_to_xyz(const Vec3d &point, const std::string &comment = std::string());
     std::string travel_to_z(double z, const std::string &comment = std::string());
     bool        will_move_z(double z) const;
     std::string extrude_to_xy(const Vec2d &point, double dE, const std::string &comment = std::string(), bool force_no_extrusion = false);
+    void        extrude_to_xy(std::string &gcode, const Vec2d &point, double dE, const std::string &comment = std::string(), bool force_no_extrusion = false);
     //BBS: generate G2 or G3 extrude which moves by arc
     std::string extrude_arc_to_xy(const Vec2d &point, const Vec2d &center_offset, double dE, const bool is_ccw, const std::string &comment = std::string(), bool force_no_extrusion = false);
+    void        extrude_arc_to_xy(std::string &gcode, const Vec2d &point, const Vec2d &center_offset, double dE, const bool is_ccw, const std::string &comment = std::string(), bool force_no_extrusion = false);
     std::string extrude_to_xyz(const Vec3d &point, double dE, const std::string &comment = std::string(), bool force_no_extrusion = false);
     std::string retract(bool before_wipe = false, double retract_length = 0);
     std::string retract_for_toolchange(bool before_wipe = false, double retract_length = 0);
@@ -177,12 +184,17 @@ public:
 
 };
 
+// Formats G-code lines with std::to_chars, bypassing the locale and the allocations of std::ostringstream.
+// The formatter either writes into its own buffer returned by string(), or it appends the line directly
+// into an output buffer passed to its constructor, for example into the G-code of a layer being generated,
+// which is finalized by end_line().
 class GCodeFormatter {
 public:
-    GCodeFormatter() {
-        this->buf_end = buf + buflen;
-        this->ptr_err.ptr = this->buf;
-    }
+    GCodeFormatter() : m_out(&m_buf) {}
+    explicit GCodeFormatter(std::string &out) : m_out(&out), m_pos(out.size()), m_begin(out.size()) {}
+    // Rolls the output buffer back to its initial size if neither string() nor end_line() was called,
+    // so that an unfinished line does not end up in the G-code.
+    ~GCodeFormatter() { if (m_out != nullptr) m_out->resize(m_begin); }
 
     GCodeFormatter(const GCodeFormatter&) = delete;
     GCodeFormatter& operator=(const GCodeFormatter&) = delete;
@@ -241,38 +253,69 @@ public:
         this->emit_axis('J', point.y(), XYZF_EXPORT_DIGITS);
     }
 
-    void emit_string(const std::string &s) {
-        strncpy(ptr_err.ptr, s.c_str(), s.size());
-        ptr_err.ptr += s.size();
+    void emit_char(char c) {
+        *this->reserve(1) = c;
+        ++ m_pos;
+    }
+
+    void emit_string(std::string_view s) {
+        if (! s.empty()) {
+            memcpy(this->reserve(s.size()), s.data(), s.size());
+            m_pos += s.size();
+        }
     }
 
-    void emit_comment(bool allow_comments, const std::string &comment) {
+    // Integer formatted the same way as by std::ostream.
+    void emit_int(int64_t v);
+    // Double formatted the same way as by std::ostream with the given std::setprecision(), that is like printf("%.*g").
+    // The default precision 6 matches a std::ostream with default settings.
+    void emit_double(double v, int precision = 6);
+
+    void emit_comment(bool allow_comments, std::string_view comment) {
         if (allow_comments && ! comment.empty()) {
-            *ptr_err.ptr ++ = ' '; *ptr_err.ptr ++ = ';'; *ptr_err.ptr ++ = ' ';
+            this->emit_string(" ; ");
             this->emit_string(comment);
         }
     }
 
+    // Terminate the line and return it. Only valid for a formatter writing into its own buffer.
     std::string string() {
-        *ptr_err.ptr ++ = '\n';
-        return std::string(this->buf, ptr_err.ptr - buf);
+        assert(m_out == &m_buf);
+        this->end_line();
+        return std::move(m_buf);
+    }
+
+    // Terminate the line (without the line feed if eol is false), leaving the output buffer with just the formatted text.
+    // The formatter is done after that, the output buffer may be modified by the caller.
+    void end_line(bool eol = true) {
+        if (eol)
+            this->emit_char('\n');
+        m_out->resize(m_pos);
+        m_out = nullptr;
     }
 
 protected:
-    static constexpr const size_t   buflen = 256;
-    char                            buf[buflen];
-    char* buf_end;
-    std::to_chars_result            ptr_err;
+    // Make room for at least n characters at m_pos, return pointer to m_pos.
+    // The output buffer grows in small steps, std::string takes care of the geometric growth of its capacity.
+    char* reserve(size_t n) {
+        assert(m_out != nullptr);
+        if (m_out->size() < m_pos + n)
+            m_out->resize(m_pos + std::max<size_t>(n, 64));
+        return m_out->data() + m_pos;
+    }
+
+    std::string                     m_buf;
+    std::string                    *m_out;
+    // End of the formatted text inside *m_out. Characters past m_pos are scratch space.
+    size_t                          m_pos { 0 };
+    // Size of *m_out when the formatter was constructed.
+    size_t                          m_begin { 0 };
 };
 
 class GCodeG1Formatter : public GCodeFormatter {
 public:
-    GCodeG1Formatter() {
-        this->buf[0] = 'G';
-        this->buf[1] = '1';
-        this->buf_end = buf + buflen;
-        this->ptr_err.ptr = this->buf + 2;
-    }
+    GCodeG1Formatter() { this->emit_string("G1"); }
+    explicit GCodeG1Formatter(std::string &out) : GCodeFormatter(out) { this->emit_string("G1"); }
 
     GCodeG1Formatter(const GCodeG1Formatter&) = delete;
     GCodeG1Formatter& operator=(const GCodeG1Formatter&) = delete;
@@ -280,12 +323,8 @@ public:
 
 class GCodeG2G3Formatter : public GCodeFormatter {
 public:
-    GCodeG2G3Formatter(bool is_ccw) {
-        this->buf[0] = 'G';
-        this->buf[1] = is_ccw ? '3' : '2';
-        this->buf_end = buf + buflen;
-        this->ptr_err.ptr = this->buf + 2;
-    }
+    GCodeG2G3Formatter(bool is_ccw) { this->emit_string(is_ccw ? "G3" : "G2"); }
+    GCodeG2G3Formatter(std::string &out, bool is_ccw) : GCodeFormatter(out) { this->emit_string(is_ccw ? "G3" : "G2"); }
 
     GCodeG2G3Formatter(const GCodeG2G3Formatter&) = delete;
     GCodeG2G3Formatter& operator=(const GCodeG2G3Formatter&) = delete;
@@ -2375,8 +2375,12 @@ void ModelVolume::center_geometry_after_creation(bool update_source_offset)
     if (!shift.isApprox(Vec3d::Zero()))
     {
         if (m_mesh) {
-            const_cast<TriangleMesh*>(m_mesh.get())->translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
-            const_cast<TriangleMesh*>(m_mesh.get())->set_init_shift(shift);
+            // Replace the mesh instead of modifying it in place, the caches keyed by the mesh pointer
+            // (AABBTreeCache, slicing_index()) expect it to be immutable.
+            TriangleMesh mesh = *m_mesh;
+            mesh.translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
+            mesh.set_init_shift(shift);
+            this->set_mesh(std::move(mesh));
         }
         if (m_convex_hull)
 			const_cast<TriangleMesh*>(m_convex_hull.get())->translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
@@ -2426,6 +2430,49 @@ void  ModelVolume::calculate_convex_hull_2d(const Geometry::Transformation &tran
     //m_convex_hull_2d.scale(transformation.get_scaling_factor(X), transformation.get_scaling_factor(Y));
 }
 
+std::shared_ptr<const MeshSlicingIndex> ModelVolume::slicing_index(const Transform3d &trafo, bool flip_triangles) const
+{
+    // A few transformations per volume, for example of the PrintObjects of differently rotated instances.
+    static constexpr const size_t MaxEntries = 4;
+    SlicingIndexCache            &cache = *m_slicing_indices;
+    std::shared_ptr<const TriangleMesh> mesh = m_mesh;
+    auto find = [&cache, &mesh, &trafo, flip_triangles]() -> std::shared_ptr<const MeshSlicingIndex> {
+        for (SlicingIndexCache::Entry &entry : cache.entries)
+            if (entry.flipped == flip_triangles && entry.index->matches(trafo) && entry.mesh.lock() == mesh) {
+                entry.last_used = ++ cache.timestamp;
+                return entry.index;
+            }
+        return {};
+    };
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        // Drop the indices of released meshes.
+        cache.entries.erase(std::remove_if(cache.entries.begin(), cache.entries.end(),
+            [](const SlicingIndexCache::Entry &entry) { return entry.mesh.expired(); }), cache.entries.end());
+        if (std::shared_ptr<const MeshSlicingIndex> index = find(); index)
+            return index;
+    }
+    // Built outside of the lock, so that volumes sliced with different transformations do not wait for each other.
+    // Share the triangles of the mesh unless they need to be flipped.
+    std::shared_ptr<const indexed_triangle_set> its(mesh, &mesh->its);
+    if (flip_triangles) {
+        indexed_triangle_set flipped = mesh->its;
+        its_flip_triangles(flipped);
+        its = std::make_shared<const indexed_triangle_set>(std::move(flipped));
+    }
+    auto index = std::make_shared<const MeshSlicingIndex>(std::move(its), trafo);
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    // Another thread may have built the same index meanwhile, share a single one.
+    if (std::shared_ptr<const MeshSlicingIndex> other = find(); other)
+        return other;
+    // Evict the index of a transformation, which was not used for the longest time, thus likely changed.
+    if (cache.entries.size() >= MaxEntries)
+        cache.entries.erase(std::min_element(cache.entries.begin(), cache.entries.end(),
+            [](const SlicingIndexCache::Entry &l, const SlicingIndexCache::Entry &r) { return l.last_used < r.last_used; }));
+    cache.entries.push_back({ index, mesh, flip_triangles, ++ cache.timestamp });
+    return index;
+}
+
 const Polygon& ModelVolume::get_convex_hull_2d(const Transform3d &trafo_instance) const
 {
     Transform3d  new_matrix;
@@ -2656,7 +2703,10 @@ void ModelVolume::mirror(Axis axis)
 // This method could only be called before the meshes of this ModelVolumes are not shared!
 void ModelVolume::scale_geometry_after_creation(const Vec3f& versor)
 {
-	const_cast<TriangleMesh*>(m_mesh.get())->scale(versor);
+    // Replaced instead of modified in place, see center_geometry_after_creation().
+    TriangleMesh mesh = *m_mesh;
+    mesh.scale(versor);
+    this->set_mesh(std::move(mesh));
     if (m_convex_hull->empty())
         //BBS: recompute the convex hull if it is null for previous too small
         this->calculate_convex_hull();
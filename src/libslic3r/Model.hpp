@@ -38,6 +38,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -64,6 +65,7 @@ class ModelMaterial;
 class ModelObject;
 class ModelVolume;
 class ModelWipeTower;
+class MeshSlicingIndex;
 class Print;
 class SLAPrint;
 class TriangleSelector;
@@ -942,6 +944,12 @@ public:
         m_convex_hull_2d.clear();
     }
 
+    // Acceleration structure for slicing the mesh transformed by trafo, with the triangles flipped if flip_triangles is set.
+    // Cached by the mesh and the transformation, thus reused by the following slicing passes and reslices until the mesh
+    // or the transformation changes. The PrintObjects of this volume's ModelObject sliced concurrently with different
+    // transformations get their own index. Thread safe.
+    std::shared_ptr<const MeshSlicingIndex> slicing_index(const Transform3d &trafo, bool flip_triangles) const;
+
     // Get count of errors in the mesh
     int                 get_repaired_errors_count() const;
 
@@ -1024,6 +1032,21 @@ private:
     mutable Polygon                     m_convex_hull_2d; //BBS, used for convex_hell_2d acceleration
     mutable Transform3d                 m_cached_trans_matrix; //BBS, used for convex_hell_2d acceleration
     mutable Polygon                     m_cached_2d_polygon;   //BBS, used for convex_hell_2d acceleration
+    // Cached by slicing_index(), an entry is valid while its mesh is alive. Shared with the copies of the volume
+    // (the Print keeps its own copy of the Model), which share the mesh as well.
+    struct SlicingIndexCache {
+        struct Entry {
+            std::shared_ptr<const MeshSlicingIndex> index;
+            std::weak_ptr<const TriangleMesh>       mesh;
+            bool                                    flipped;
+            // Entries not used for the longest time are evicted first.
+            size_t                                  last_used;
+        };
+        std::vector<Entry>  entries;
+        size_t              timestamp { 0 };
+        std::mutex          mutex;
+    };
+    std::shared_ptr<SlicingIndexCache>  m_slicing_indices { std::make_shared<SlicingIndexCache>() };
     Geometry::Transformation        	m_transformation;
 
     //BBS: add convex_hell_2d related logic
@@ -1078,7 +1101,7 @@ private:
     ModelVolume(ModelObject *object, const ModelVolume &other) :
         ObjectBase(other),
         name(other.name), source(other.source), m_mesh(other.m_mesh), m_convex_hull(other.m_convex_hull),
-        config(other.config), m_type(other.m_type), object(object), m_transformation(other.m_transformation),
+        config(other.config), m_type(other.m_type), object(object), m_slicing_indices(other.m_slicing_indices), m_transformation(other.m_transformation),
         supported_facets(other.supported_facets), seam_facets(other.seam_facets), mmu_segmentation_facets(other.mmu_segmentation_facets),
         cut_info(other.cut_info), text_configuration(other.text_configuration), emboss_shape(other.emboss_shape)
     {
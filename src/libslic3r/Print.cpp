@@ -34,6 +34,7 @@
 #include "Support/SupportMaterial.hpp"
 #include "Thread.hpp"
 #include "Time.hpp"
+#include "Timer.hpp"
 #include "GCode.hpp"
 #include "GCode/WipeTower.hpp"
 #include "GCode/WipeTower2.hpp"
@@ -46,6 +47,7 @@
 #include <limits>
 #include <unordered_set>
 #include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/regex.hpp>
@@ -54,6 +56,7 @@
 #include "nlohmann/json.hpp"
 
 #include "GCode/ConflictChecker.hpp"
+#include "Format/SliceCache.hpp"
 
 #include <codecvt>
 
@@ -83,6 +86,7 @@ void Print::clear()
 	m_objects.clear();
     m_print_regions.clear();
     m_model.clear_objects();
+    m_conflict_checker.reset();
 }
 
 // Called by Print::apply().
@@ -92,6 +96,31 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
     if (opt_keys.empty())
         return false;
 
+    std::vector<PrintStep> steps;
+    std::vector<PrintObjectStep> osteps;
+    bool invalidated = false;
+
+    for (const t_config_option_key &opt_key : opt_keys)
+        if (! steps_invalidated_by_config_option(opt_key, steps, osteps)) {
+            // for legacy, if we can't handle this option let's invalidate all steps
+            //FIXME invalidate all steps of all objects as well?
+            invalidated |= this->invalidate_all_steps();
+            // Continue with the other opt_keys to possibly invalidate any object specific steps.
+        }
+
+    sort_remove_duplicates(steps);
+    for (PrintStep step : steps)
+        invalidated |= this->invalidate_step(step);
+    sort_remove_duplicates(osteps);
+    for (PrintObjectStep ostep : osteps)
+        for (PrintObject *object : m_objects)
+            invalidated |= object->invalidate_step(ostep);
+
+    return invalidated;
+}
+
+bool Print::steps_invalidated_by_config_option(const t_config_option_key &opt_key, std::vector<PrintStep> &steps, std::vector<PrintObjectStep> &osteps)
+{
     // Cache the plenty of parameters, which influence the G-code generator only,
     // or they are only notes not influencing the generated G-code.
     static std::unordered_set<std::string> steps_gcode = {
@@ -212,11 +241,7 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
 
     static std::unordered_set<std::string> steps_ignore;
 
-    std::vector<PrintStep> steps;
-    std::vector<PrintObjectStep> osteps;
-    bool invalidated = false;
-
-    for (const t_config_option_key &opt_key : opt_keys) {
+    {
         if (steps_gcode.find(opt_key) != steps_gcode.end()) {
             // These options only affect G-code export or they are just notes without influence on the generated G-code,
             // so there is nothing to invalidate.
@@ -327,22 +352,10 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
         else if (opt_key == "z_hop_types") {
             osteps.emplace_back(posDetectOverhangsForLift);
         } else {
-            // for legacy, if we can't handle this option let's invalidate all steps
-            //FIXME invalidate all steps of all objects as well?
-            invalidated |= this->invalidate_all_steps();
-            // Continue with the other opt_keys to possibly invalidate any object specific steps.
+            return false;
         }
     }
-
-    sort_remove_duplicates(steps);
-    for (PrintStep step : steps)
-        invalidated |= this->invalidate_step(step);
-    sort_remove_duplicates(osteps);
-    for (PrintObjectStep ostep : osteps)
-        for (PrintObject *object : m_objects)
-            invalidated |= object->invalidate_step(ostep);
-
-    return invalidated;
+    return true;
 }
 
 void Print::set_calib_params(const Calib_Params& params) {
@@ -1754,71 +1767,35 @@ void Print::process(long long *time_cost_with_cache, bool use_cache)
     BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": total object counts %1% in current print, need to slice %2%")%m_objects.size()%need_slicing_objects.size();
     BOOST_LOG_TRIVIAL(info) << "Starting the slicing process." << log_memory_info();
     if (!use_cache) {
-        for (PrintObject *obj : m_objects) {
-            if (need_slicing_objects.count(obj) != 0) {
-                obj->make_perimeters();
-            }
-            else {
-                if (obj->set_started(posSlice))
-                    obj->set_done(posSlice);
-                if (obj->set_started(posPerimeters))
-                    obj->set_done(posPerimeters);
-            }
-        }
-        for (PrintObject *obj : m_objects) {
-            if (need_slicing_objects.count(obj) != 0) {
-                obj->estimate_curled_extrusions();
-            }
-            else {
-                if (obj->set_started(posEstimateCurledExtrusions))
-                    obj->set_done(posEstimateCurledExtrusions);
-            }
-        }
-        for (PrintObject *obj : m_objects) {
-            if (need_slicing_objects.count(obj) != 0) {
-                obj->infill();
-            }
-            else {
-                if (obj->set_started(posPrepareInfill))
-                    obj->set_done(posPrepareInfill);
-                if (obj->set_started(posInfill))
-                    obj->set_done(posInfill);
-            }
-        }
-        for (PrintObject *obj : m_objects) {
-            if (need_slicing_objects.count(obj) != 0) {
-                obj->ironing();
-            }
-            else {
-                if (obj->set_started(posIroning))
-                    obj->set_done(posIroning);
-            }
-        }
-
-        tbb::parallel_for(tbb::blocked_range<int>(0, int(m_objects.size())),
-            [this, need_slicing_objects](const tbb::blocked_range<int>& range) {
+        // The objects run their chains of steps concurrently instead of all the objects waiting for each other at the end of each step:
+        // Once the layers of a small object are done with a step, the worker threads continue with the next step of that object
+        // or they are stolen by the parallel loops over the layers of the other objects. The steps of an object only depend
+        // on the preceding steps of the same object, and the status updates and the step state are thread safe,
+        // as they are with the support generation, which has always been running for all objects in parallel.
+        Timing::Timer timer;
+        timer.start();
+        tbb::parallel_for(tbb::blocked_range<int>(0, int(m_objects.size()), 1),
+            [this, &need_slicing_objects](const tbb::blocked_range<int>& range) {
                 for (int i = range.begin(); i < range.end(); i++) {
                     PrintObject* obj = m_objects[i];
                     if (need_slicing_objects.count(obj) != 0) {
+                        obj->make_perimeters();
+                        obj->estimate_curled_extrusions();
+                        obj->infill();
+                        obj->ironing();
                         obj->generate_support_material();
+                        obj->detect_overhangs_for_lift();
                     }
                     else {
-                        if (obj->set_started(posSupportMaterial))
-                            obj->set_done(posSupportMaterial);
+                        for (PrintObjectStep step : { posSlice, posPerimeters, posEstimateCurledExtrusions, posPrepareInfill, posInfill, posIroning,
+                                                      posSupportMaterial, posDetectOverhangsForLift })
+                            if (obj->set_started(step))
+                                obj->set_done(step);
                     }
                 }
             }
         );
-
-        for (PrintObject* obj : m_objects) {
-            if (need_slicing_objects.count(obj) != 0) {
-                obj->detect_overhangs_for_lift();
-            }
-            else {
-                if (obj->set_started(posDetectOverhangsForLift))
-                    obj->set_done(posDetectOverhangsForLift);
-            }
-        }
+        BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": object steps of %1% objects took %2% ms")%need_slicing_objects.size()%timer.elapsed_milliseconds();
     }
     else {
         for (PrintObject *obj : m_objects) {
@@ -1982,6 +1959,20 @@ void Print::process(long long *time_cost_with_cache, bool use_cache)
         }
     }
 
+    // The seam analysis of the objects is independent, run it for all objects at once. Objects, for which the step
+    // is still valid, keep their seam data from the previous run.
+    {
+        Timing::Timer timer;
+        timer.start();
+        tbb::parallel_for(tbb::blocked_range<int>(0, int(m_objects.size()), 1),
+            [this](const tbb::blocked_range<int>& range) {
+                for (int i = range.begin(); i < range.end(); i++)
+                    m_objects[i]->analyze_seams();
+            }
+        );
+        BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": seam analysis of %1% objects took %2% ms")%m_objects.size()%timer.elapsed_milliseconds();
+    }
+
     // BBS
     bool has_adaptive_layer_height = false;
     for (PrintObject* obj : m_objects) {
@@ -2000,7 +1991,9 @@ void Print::process(long long *time_cost_with_cache, bool use_cache)
             m_fake_wipe_tower.set_pos({m_config.wipe_tower_x.get_at(m_plate_index), m_config.wipe_tower_y.get_at(m_plate_index)});
             wipe_tower_opt = std::make_optional<const FakeWipeTower *>(&m_fake_wipe_tower);
         }
-        auto            conflictRes = ConflictChecker::find_inter_of_lines_in_diff_objs(m_objects, wipe_tower_opt);
+        if (! m_conflict_checker)
+            m_conflict_checker = std::make_shared<ConflictChecker>();
+        auto            conflictRes = m_conflict_checker->find_conflict(m_objects, wipe_tower_opt);
         auto            endTime     = Clock::now();
         volatile double seconds     = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() / (double) 1000;
         BOOST_LOG_TRIVIAL(info) << "gcode path conflicts check takes " << seconds << " secs.";
@@ -3504,7 +3497,7 @@ static void from_json(const json& j, groupedVolumeSlices& firstlayer_group)
     }
 }
 
-int Print::export_cached_data(const std::string& directory, bool with_space)
+int Print::export_cached_data(const std::string& directory, bool with_space, bool binary)
 {
     int ret = 0;
     boost::filesystem::path directory_path(directory);
@@ -3553,6 +3546,32 @@ int Print::export_cached_data(const std::string& directory, bool with_space)
         return;
     };
 
+    // Copy of the first layer groups of an object with the volume IDs replaced by the indices of the volumes inside the ModelObject.
+    auto convert_first_layer_groups = [](const PrintObject* obj) {
+        std::vector<groupedVolumeSlices> groups = obj->firstLayerObjGroups();
+        for (groupedVolumeSlices &group : groups) {
+            //convert the id
+            for (ObjectID& obj_id : group.volume_ids)
+            {
+                const ModelVolume* currentModelVolumePtr = nullptr;
+                //BBS: support shared object logic
+                const PrintObject* shared_object = obj->get_shared_object();
+                if (!shared_object)
+                    shared_object = obj;
+                const ModelVolumePtrs& volumes_ptr = shared_object->model_object()->volumes;
+                size_t volume_count = volumes_ptr.size();
+                for (size_t index = 0; index < volume_count; index ++) {
+                    currentModelVolumePtr = volumes_ptr[index];
+                    if (currentModelVolumePtr->id() == obj_id) {
+                        obj_id.id = index;
+                        break;
+                    }
+                }
+            }
+        }
+        return groups;
+    };
+
     //firstly clear this directory
     if (fs::exists(directory_path)) {
         fs::remove_all(directory_path);
@@ -3572,6 +3591,7 @@ int Print::export_cached_data(const std::string& directory, bool with_space)
     int count = 0;
     std::vector<std::string> filename_vector;
     std::vector<json> json_vector;
+    std::vector<std::string> binary_vector;
     for (PrintObject *obj : m_objects) {
         const ModelObject* model_obj = obj->model_object();
         if (obj->get_shared_object()) {
@@ -3582,11 +3602,19 @@ int Print::export_cached_data(const std::string& directory, bool with_space)
         const PrintInstance &print_instance = obj->instances()[0];
         const ModelInstance *model_instance = print_instance.model_instance;
         size_t identify_id = (model_instance->loaded_id > 0)?model_instance->loaded_id: model_instance->id().id;
-        std::string file_name = directory +"/obj_"+std::to_string(identify_id)+".json";
+        std::string file_name = directory +"/obj_"+std::to_string(identify_id)+(binary ? SliceCache::BinaryExtension : ".json");
 
         BOOST_LOG_TRIVIAL(info) << boost::format("begin to dump object %1%, identify_id %2% to %3%")%model_obj->name %identify_id %file_name;
 
         try {
+            if (binary) {
+                binary_vector.push_back(SliceCache::encode_object(*obj, model_obj->name, identify_id, convert_first_layer_groups(obj)));
+                filename_vector.push_back(file_name);
+                count ++;
+                BOOST_LOG_TRIVIAL(info) << boost::format("will dump object %1%'s binary cache to %2%.")%model_obj->name%file_name;
+                continue;
+            }
+
             json root_json, layers_json = json::array(), support_layers_json = json::array(), first_layer_groups = json::array();
 
             root_json[JSON_OBJECT_NAME] = model_obj->name;
@@ -3696,29 +3724,7 @@ int Print::export_cached_data(const std::string& directory, bool with_space)
             } // for each layer*/
             root_json[JSON_SUPPORT_LAYERS] = std::move(support_layers_json);
 
-            const std::vector<groupedVolumeSlices> &first_layer_obj_groups =  obj->firstLayerObjGroups();
-            for (size_t s_group_index = 0; s_group_index < first_layer_obj_groups.size(); ++ s_group_index) {
-                groupedVolumeSlices group = first_layer_obj_groups[s_group_index];
-
-                //convert the id
-                for (ObjectID& obj_id : group.volume_ids)
-                {
-                    const ModelVolume* currentModelVolumePtr = nullptr;
-                    //BBS: support shared object logic
-                    const PrintObject* shared_object = obj->get_shared_object();
-                    if (!shared_object)
-                        shared_object = obj;
-                    const ModelVolumePtrs& volumes_ptr = shared_object->model_object()->volumes;
-                    size_t volume_count = volumes_ptr.size();
-                    for (size_t index = 0; index < volume_count; index ++) {
-                        currentModelVolumePtr = volumes_ptr[index];
-                        if (currentModelVolumePtr->id() == obj_id) {
-                            obj_id.id = index;
-                            break;
-                        }
-                    }
-                }
-
+            for (const groupedVolumeSlices &group : convert_first_layer_groups(obj)) {
                 json first_layer_group_json;
 
                 first_layer_group_json = group;
@@ -3747,10 +3753,18 @@ int Print::export_cached_data(const std::string& directory, bool with_space)
     boost::mutex mutex;
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, filename_vector.size()),
-        [filename_vector, &json_vector, with_space, &ret, &mutex](const tbb::blocked_range<size_t>& output_range) {
+        [&filename_vector, &json_vector, &binary_vector, binary, with_space, &ret, &mutex](const tbb::blocked_range<size_t>& output_range) {
             for (size_t object_index = output_range.begin(); object_index < output_range.end(); ++ object_index) {
                 try {
                     boost::nowide::ofstream c;
+                    if (binary) {
+                        c.open(filename_vector[object_index], std::ios::out | std::ios::trunc | std::ios::binary);
+                        c.write(binary_vector[object_index].data(), binary_vector[object_index].size());
+                        c.close();
+                        if (c.fail())
+                            throw Slic3r::FileIOError("write failed");
+                        continue;
+                    }
                     c.open(filename_vector[object_index], std::ios::out | std::ios::trunc);
                     if (with_space)
                         c << std::setw(4) << json_vector[object_index] << std::endl;
@@ -3795,7 +3809,7 @@ int Print::load_cached_data(const std::string& directory)
     };
 
     int count = 0;
-    std::vector<std::pair<std::string, PrintObject*>> object_filenames;
+    std::vector<std::pair<std::string, PrintObject*>> object_filenames, binary_object_filenames;
     for (PrintObject *obj : m_objects) {
         const ModelObject* model_obj = obj->model_object();
         const PrintInstance &print_instance = obj->instances()[0];
@@ -3811,6 +3825,12 @@ int Print::load_cached_data(const std::string& directory)
             BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format(": object %1%'s loaded_id is 0, need to use the instance_id %2%")%model_obj->name %identify_id;
             //continue;
         }
+        // prefer the binary cache if both formats are present
+        std::string binary_file_name = directory +"/obj_"+std::to_string(identify_id)+SliceCache::BinaryExtension;
+        if (fs::exists(binary_file_name)) {
+            binary_object_filenames.push_back({binary_file_name, obj});
+            continue;
+        }
         std::string file_name = directory +"/obj_"+std::to_string(identify_id)+".json";
 
         if (!fs::exists(file_name)) {
@@ -3820,6 +3840,104 @@ int Print::load_cached_data(const std::string& directory)
         object_filenames.push_back({file_name, obj});
     }
 
+    // Binary caches: the file is memory mapped, the layers are created serially from the directory
+    // and then their payloads are decoded in parallel straight from the mapping.
+    auto load_binary_object = [&find_region](const std::string &file_name, PrintObject *obj) -> int {
+        boost::iostreams::mapped_file_source file;
+        file.open(boost::filesystem::path(file_name));
+        if (!file.is_open())
+            throw Slic3r::FileIOError("Failed to map " + file_name);
+        const char *data = file.data();
+        size_t      size = file.size();
+
+        SliceCache::ObjectEntry object_entry = SliceCache::decode_object_directory(data, size);
+        BOOST_LOG_TRIVIAL(info) << __FUNCTION__<<boost::format(":will load %1%, identify_id %2%, layer_count %3%, support_layer_count %4%, firstlayer_group_count %5%")
+            %object_entry.name %object_entry.identify_id %object_entry.layers.size() %object_entry.support_layers.size() %object_entry.first_layer_groups.size();
+
+        Layer* previous_layer = NULL;
+        for (const SliceCache::LayerEntry &entry : object_entry.layers) {
+            Layer* new_layer = obj->add_layer(entry.id, entry.height, entry.print_z, entry.slice_z);
+            if (!new_layer) {
+                BOOST_LOG_TRIVIAL(error) <<__FUNCTION__<< boost::format(":create_layer failed, out of memory");
+                return CLI_OUT_OF_MEMORY;
+            }
+            if (previous_layer) {
+                previous_layer->upper_layer = new_layer;
+                new_layer->lower_layer = previous_layer;
+            }
+            previous_layer = new_layer;
+
+            for (size_t region_index = 0; region_index < entry.region_config_hashes.size(); ++ region_index) {
+                const PrintRegion *print_region = find_region(obj, entry.region_config_hashes[region_index]);
+                if (!print_region) {
+                    BOOST_LOG_TRIVIAL(error) <<__FUNCTION__<< boost::format(":can not find print region of object %1%, layer %2%, print_z %3%, layer_region %4%")
+                        %object_entry.name %entry.id %new_layer->print_z %region_index;
+                    return CLI_IMPORT_CACHE_DATA_CAN_NOT_USE;
+                }
+                new_layer->add_region(print_region);
+            }
+        }
+
+        Layer* previous_support_layer = NULL;
+        for (const SliceCache::LayerEntry &entry : object_entry.support_layers) {
+            SupportLayer* new_support_layer = obj->add_support_layer(entry.id, entry.interface_id, entry.height, entry.print_z);
+            if (!new_support_layer) {
+                BOOST_LOG_TRIVIAL(error) <<__FUNCTION__<< boost::format(":add_support_layer failed, out of memory");
+                return CLI_OUT_OF_MEMORY;
+            }
+            if (previous_support_layer) {
+                previous_support_layer->upper_layer = new_support_layer;
+                new_support_layer->lower_layer = previous_support_layer;
+            }
+            previous_support_layer = new_support_layer;
+        }
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, obj->layer_count() + obj->support_layer_count()),
+            [data, size, &object_entry, obj](const tbb::blocked_range<size_t>& range) {
+                for (size_t index = range.begin(); index < range.end(); ++ index) {
+                    if (index < object_entry.layers.size())
+                        SliceCache::decode_layer(data, size, object_entry.layers[index], *obj->get_layer(int(index)));
+                    else {
+                        size_t support_index = index - object_entry.layers.size();
+                        SliceCache::decode_support_layer(data, size, object_entry.support_layers[support_index], *obj->get_support_layer(int(support_index)));
+                    }
+                }
+            }
+        );
+
+        //load first group volumes
+        std::vector<groupedVolumeSlices>& firstlayer_objgroups = obj->firstLayerObjGroupsMod();
+        ModelVolumePtrs& volumes_ptr = obj->model_object()->volumes;
+        for (groupedVolumeSlices &firstlayer_group : object_entry.first_layer_groups) {
+            //convert the id
+            for (ObjectID& obj_id : firstlayer_group.volume_ids) {
+                if (obj_id.id >= volumes_ptr.size()) {
+                    BOOST_LOG_TRIVIAL(error) << __FUNCTION__<< boost::format(": can not find volume_id %1% from object file %2% in firstlayer groups, volume_count %3%!")
+                        %obj_id.id %file_name %volumes_ptr.size();
+                    return CLI_IMPORT_CACHE_LOAD_FAILED;
+                }
+                obj_id = volumes_ptr[obj_id.id]->id();
+            }
+            firstlayer_objgroups.push_back(std::move(firstlayer_group));
+        }
+        return 0;
+    };
+
+    for (const std::pair<std::string, PrintObject*> &object_filename : binary_object_filenames) {
+        try {
+            int obj_ret = load_binary_object(object_filename.first, object_filename.second);
+            if (obj_ret)
+                return obj_ret;
+            count ++;
+            BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format(": load object %1% from %2% successfully.")%count%object_filename.first;
+        }
+        catch(std::exception &err) {
+            BOOST_LOG_TRIVIAL(error) << __FUNCTION__<< ": load from "<<object_filename.first<<" got a generic exception, reason = " << err.what();
+            return CLI_IMPORT_CACHE_LOAD_FAILED;
+        }
+    }
+
     boost::mutex mutex;
     std::vector<json> object_jsons(object_filenames.size());
     tbb::parallel_for(
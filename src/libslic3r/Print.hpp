@@ -33,6 +33,9 @@ class Layer;
 class ModelObject;
 class Print;
 class PrintObject;
+class PrintObjectStepCache;
+struct PrintObjectSeamData;
+class ConflictChecker;
 class SupportLayer;
 // BBS
 class TreeSupportData;
@@ -94,6 +97,8 @@ enum PrintObjectStep {
     // BBS
     posDetectOverhangsForLift,
     posSimplifyWall, posSimplifyInfill,
+    // Seam candidates of the perimeters, their visibility and the picked seams, consumed by the G-code export.
+    posSeamPlacement,
     posCount,
 };
 
@@ -426,6 +431,9 @@ public:
     // Helpers to project custom facets on slices
     void project_and_append_custom_facets(bool seam, EnforcerBlockerType type, std::vector<Polygons>& expolys) const;
 
+    // Result of the posSeamPlacement step, nullptr if the step is not done.
+    std::shared_ptr<const PrintObjectSeamData> seam_data() const { return this->is_step_done(posSeamPlacement) ? m_seam_data : nullptr; }
+
     //BBS
     BoundingBox get_first_layer_bbox(float& area, float& layer_height, std::string& name);
     void         get_certain_layers(float start, float end, std::vector<LayerPtrs> &out, std::vector<BoundingBox> &boundingbox_objects);
@@ -449,6 +457,8 @@ public:
   private:
     // to be called from Print only.
     friend class Print;
+    // Replaces the layers when restoring the results of a step.
+    friend class PrintObjectStepCache;
 
 	PrintObject(Print* print, ModelObject* model_object, const Transform3d& trafo, PrintInstances&& instances);
 	~PrintObject();
@@ -464,6 +474,12 @@ public:
     // It may be called for both the PrintObjectConfig and PrintRegionConfig.
     bool                    invalidate_state_by_config_options(
         const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys);
+    // Steps of this object and of the Print invalidated by a change of the option, shared by invalidate_state_by_config_options()
+    // and the step cache keys. Without the old and new configs, the change of the value affecting the most steps is assumed.
+    // Returns false if the option is not known, thus it invalidates all steps.
+    bool                    steps_invalidated_by_config_option(
+        const ConfigOptionResolver *old_config, const ConfigOptionResolver *new_config, const t_config_option_key &opt_key,
+        std::vector<PrintObjectStep> &steps, std::vector<PrintStep> &print_steps) const;
     // If ! m_slicing_params.valid, recalculate.
     void                    update_slicing_parameters();
 
@@ -472,6 +488,10 @@ public:
 private:
     void make_perimeters();
     void prepare_infill();
+    // Complete the started step by restoring its results or the results of a later cached step from the step cache of the Print,
+    // mark the later restored steps as done as well. Returns false if nothing usable was found.
+    bool restore_from_step_cache(PrintObjectStep step);
+    void store_to_step_cache(PrintObjectStep step) const;
     void infill();
     void ironing();
     void generate_support_material();
@@ -484,6 +504,7 @@ private:
     // BBS
     void detect_overhangs_for_lift();
     void clear_overhangs_for_lift();
+    void analyze_seams();
 
    void _transform_hole_to_polyholes();
 
@@ -523,6 +544,8 @@ private:
     SupportLayerPtrs                        m_support_layers;
     // BBS
     std::shared_ptr<TreeSupportData>        m_tree_support_preview_cache;
+    // Result of posSeamPlacement. Shared with the G-code export, which may still hold it when the step is invalidated.
+    std::shared_ptr<const PrintObjectSeamData> m_seam_data;
 
     // this is set to true when LayerRegion->slices is split in top/internal/bottom
     // so that next call to make_perimeters() performs a union() before computing loops
@@ -530,6 +553,8 @@ private:
 
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     FillLightning::GeneratorPtr m_lightning_generator;
+    // Memoized by PrintObjectStepCache::key(), cleared by Print::apply().
+    mutable std::string                     m_step_cache_geometry;
 
     std::vector < VolumeSlices >            firstLayerObjSliceByVolume;
     std::vector<groupedVolumeSlices>        firstLayerObjSliceByGroups;
@@ -816,14 +841,22 @@ public:
     std::vector<ObjectID> print_object_ids() const override;
 
     ApplyStatus         apply(const Model &model, DynamicPrintConfig config) override;
+    // Steps of the Print and of its objects invalidated by a change of a PrintConfig option, shared by
+    // invalidate_state_by_config_options() and the step cache keys.
+    // Returns false if the option is not known, thus it invalidates all steps of the Print.
+    static bool         steps_invalidated_by_config_option(
+        const t_config_option_key &opt_key, std::vector<PrintStep> &steps, std::vector<PrintObjectStep> &osteps);
 
     void                process(long long *time_cost_with_cache = nullptr, bool use_cache = false) override;
     // Exports G-code into a file name based on the path_template, returns the file path of the generated G-code file.
     // If preview_data is not null, the preview_data is filled in for the G-code visualization (not used by the command line Slic3r).
     std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
     //return 0 means successful
-    int                 export_cached_data(const std::string& dir_path, bool with_space=false);
+    int                 export_cached_data(const std::string& dir_path, bool with_space=false, bool binary=false);
     int                 load_cached_data(const std::string& directory);
+    // On-disk cache of the results of PrintObject steps, may be shared by multiple Prints. Disabled if null.
+    void                set_step_cache(std::shared_ptr<PrintObjectStepCache> step_cache) { m_step_cache = std::move(step_cache); }
+    const PrintObjectStepCache* step_cache() const { return m_step_cache.get(); }
 
     // methods for handling state
     bool                is_step_done(PrintStep step) const { return Inherited::is_step_done(step); }
@@ -1008,10 +1041,14 @@ private:
     //BBS
     ConflictResultOpt m_conflict_result;
     FakeWipeTower     m_fake_wipe_tower;
+    // Keeps the extrusion lines of the objects and the results of the pairs of objects between the checks.
+    std::shared_ptr<ConflictChecker> m_conflict_checker;
     
     //SoftFever: calibration
     Calib_Params m_calib_params;
 
+    std::shared_ptr<PrintObjectStepCache> m_step_cache;
+
     // To allow GCode to set the Print's GCodeExport step status.
     friend class GCode;
     // Allow PrintObject to access m_mutex and m_cancel_callback.
@@ -1272,7 +1272,9 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                     model_volume_list_update_supports(model_object, model_object_new);
                 }
             } else if (model_custom_seam_data_changed(model_object, model_object_new)) {
-                update_apply_status(this->invalidate_step(psGCodeExport));
+                // The painted seams are evaluated by the seam analysis of the objects.
+                for (const PrintObjectStatus &print_object_status : print_objects_range)
+                    update_apply_status(print_object_status.print_object->invalidate_step(posSeamPlacement));
             }
         }
         if (! solid_or_modifier_differ) {
@@ -1562,6 +1564,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
     for (PrintObject *object : m_objects)
     {
         object->update_slicing_parameters();
+        object->m_step_cache_geometry.clear();
         m_support_used |= object->config().enable_support;
     }
 
@@ -6088,6 +6088,11 @@ CLIActionsConfigDef::CLIActionsConfigDef()
     def->cli_params = "slicing_data_directory";
     def->set_default_value(new ConfigOptionString("cached_data"));
 
+    def = this->add("export_slicedata_binary", coBool);
+    def->label = "Export slicing data in binary";
+    def->tooltip = "Export slicing data in the compact binary format instead of JSON. load_slicedata reads either format.";
+    def->set_default_value(new ConfigOptionBool(false));
+
     def = this->add("load_slicedata", coStrings);
     def->label = "Load slicing data";
     def->tooltip = "Load cached slicing data from directory";
@@ -6423,6 +6428,44 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->cli_params = "dir";
     def->set_default_value(new ConfigOptionString());
 
+    def = this->add("step_cache_dir", coString);
+    def->label = "Step cache directory";
+    def->tooltip = "Reuse the slicing, wall and infill region results and the seam visibility of objects across runs and plates, stored in the given directory.";
+    def->cli_params = "dir";
+    def->set_default_value(new ConfigOptionString());
+
+    def = this->add("batch", coString);
+    def->label = "Batch mode";
+    def->tooltip = "Run the slicing jobs read from the given file, or from the standard input if \"-\", one after the other in a single process. "
+                   "Each line holds a JSON array with the command line arguments of a job. After each job, a line \"batch_job_result: \" "
+                   "followed by a JSON object with the return code and the result.json of the job is printed to the standard output.";
+    def->cli_params = "file";
+    def->set_default_value(new ConfigOptionString());
+
+    def = this->add("compression_level", coInt);
+    def->label = "3MF compression level";
+    def->tooltip = "Deflate level of the models and G-codes stored into the exported 3mf, from 0 (no compression, fastest) to 10 (smallest file), "
+                   "-1 means the default level 6.";
+    def->cli_params = "level";
+    def->min = -1;
+    def->max = 10;
+    def->set_default_value(new ConfigOptionInt(-1));
+
+    def = this->add("parallel_plates", coInt);
+    def->label = "Parallel plates";
+    def->tooltip = "Maximum number of plates sliced at the same time when slicing all plates, 1 slices the plates one after the other.";
+    def->cli_params = "count";
+    def->min = 1;
+    def->set_default_value(new ConfigOptionInt(1));
+
+    def = this->add("parallel_plates_memory", coInt);
+    def->label = "Memory budget of parallel plates";
+    def->tooltip = "When slicing plates in parallel, a further plate is only started while the memory used by the process is below this limit (MB). "
+                   "0 means three quarters of the physical memory.";
+    def->cli_params = "MB";
+    def->min = 0;
+    def->set_default_value(new ConfigOptionInt(0));
+
     def = this->add("debug", coInt);
     def->label = "Debug level";
     def->tooltip = "Sets debug logging level. 0:fatal, 1:error, 2:warning, 3:info, 4:debug, 5:trace\n";
@@ -17,17 +17,20 @@
 #include "Layer.hpp"
 #include "MutablePolygon.hpp"
 #include "PrintConfig.hpp"
+#include "PrintObjectStepCache.hpp"
 #include "SupportMaterial.hpp"
 #include "SupportSpotsGenerator.hpp"
 #include "Support/TreeSupport.hpp"
 #include "Surface.hpp"
 #include "Slicing.hpp"
 #include "Tesselate.hpp"
+#include "Timer.hpp"
 #include "TriangleMeshSlicer.hpp"
 #include "Utils.hpp"
 #include "Fill/FillAdaptive.hpp"
 #include "Fill/FillLightning.hpp"
 #include "Format/STL.hpp"
+#include "GCode/SeamPlacer.hpp"
 #include "TreeSupport.hpp"
 
 #include <float.h>
@@ -55,7 +58,6 @@ using namespace std::literals;
     // time limit for one ClipperLib operation (union / diff / offset), in ms
     #define PRINT_OBJECT_TIME_LIMIT_DEFAULT 50
     #include <boost/current_function.hpp>
-    #include "Timer.hpp"
     #define PRINT_OBJECT_TIME_LIMIT_SECONDS(limit) Timing::TimeLimitAlarm time_limit_alarm(uint64_t(limit) * 1000000000l, BOOST_CURRENT_FUNCTION)
     #define PRINT_OBJECT_TIME_LIMIT_MILLIS(limit) Timing::TimeLimitAlarm time_limit_alarm(uint64_t(limit) * 1000000l, BOOST_CURRENT_FUNCTION)
 #else
@@ -80,6 +82,26 @@ using namespace std::literals;
 
 namespace Slic3r {
 
+namespace {
+
+// Logs the wall clock time of a step of a PrintObject when going out of scope,
+// so that the effect of the scheduling of the steps on the slicing time is measurable.
+class StepTimeLog
+{
+public:
+    StepTimeLog(const PrintObject &object, const char *step) : m_object(object), m_step(step) { m_timer.start(); }
+    ~StepTimeLog() {
+        BOOST_LOG_TRIVIAL(info) << "Object " << m_object.model_object()->name << ": " << m_step << " took " << m_timer.elapsed_milliseconds() << " ms";
+    }
+
+private:
+    const PrintObject  &m_object;
+    const char         *m_step;
+    Timing::Timer       m_timer;
+};
+
+} // anonymous namespace
+
 // Constructor is called from the main thread, therefore all Model / ModelObject / ModelIntance data are valid.
 PrintObject::PrintObject(Print* print, ModelObject* model_object, const Transform3d& trafo, PrintInstances&& instances) :
     PrintObjectBaseWithState(print, model_object),
@@ -302,6 +324,9 @@ void PrintObject::make_perimeters()
         return;
 
     m_print->set_status(15, L("Generating walls"));
+    StepTimeLog step_time(*this, "make_perimeters");
+    if (this->restore_from_step_cache(posPerimeters))
+        return;
     BOOST_LOG_TRIVIAL(info) << "Generating walls..." << log_memory_info();
 
     // Revert the typed slices into untyped slices.
@@ -397,6 +422,7 @@ void PrintObject::make_perimeters()
     m_print->throw_if_canceled();
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
 
+    this->store_to_step_cache(posPerimeters);
     this->set_done(posPerimeters);
 }
 
@@ -405,6 +431,9 @@ void PrintObject::prepare_infill()
     if (! this->set_started(posPrepareInfill))
         return;
     m_print->set_status(25, L("Generating infill regions"));
+    StepTimeLog step_time(*this, "prepare_infill");
+    if (this->restore_from_step_cache(posPrepareInfill))
+        return;
     if (m_typed_slices) {
         // To improve robustness of detect_surfaces_type() when reslicing (working with typed slices), see GH issue #7442.
         // The preceding step (perimeter generator) only modifies extra_perimeters and the extra perimeters are only used by discover_vertical_shells()
@@ -427,11 +456,17 @@ void PrintObject::prepare_infill()
     // Here the stTop / stBottomBridge / stBottom infill is turned to just stInternal if zero top / bottom infill layers are configured.
     // Also tiny stInternal surfaces are turned to stInternalSolid.
     BOOST_LOG_TRIVIAL(info) << "Preparing fill surfaces..." << log_memory_info();
-    for (auto *layer : m_layers)
-        for (auto *region : layer->m_regions) {
-            region->prepare_fill_surfaces();
-            m_print->throw_if_canceled();
-        }
+    // LayerRegion::prepare_fill_surfaces() only touches its own LayerRegion, thus the layers are processed in parallel.
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, m_layers.size()),
+        [this](const tbb::blocked_range<size_t>& range) {
+            for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer) {
+                m_print->throw_if_canceled();
+                for (LayerRegion *region : m_layers[idx_layer]->m_regions)
+                    region->prepare_fill_surfaces();
+            }
+        });
+    m_print->throw_if_canceled();
 
 
     // Add solid fills to ensure the shell vertical thickness.
@@ -533,9 +568,34 @@ void PrintObject::prepare_infill()
     } // for each layer
 #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
 
+    this->store_to_step_cache(posPrepareInfill);
     this->set_done(posPrepareInfill);
 }
 
+bool PrintObject::restore_from_step_cache(PrintObjectStep step)
+{
+    const PrintObjectStepCache *step_cache = m_print->step_cache();
+    if (step_cache == nullptr)
+        return false;
+    // The cached steps are executed in the order of PrintObjectStep, try the furthest one first.
+    for (int last_step = posPrepareInfill; last_step >= int(step); -- last_step)
+        if (PrintObjectStepCache::is_cached_step(*this, PrintObjectStep(last_step)) && step_cache->load(*this, PrintObjectStep(last_step))) {
+            m_print->throw_if_canceled();
+            this->set_done(step);
+            for (int next_step = int(step) + 1; next_step <= last_step; ++ next_step)
+                if (PrintObjectStepCache::is_cached_step(PrintObjectStep(next_step)) && this->set_started(PrintObjectStep(next_step)))
+                    this->set_done(PrintObjectStep(next_step));
+            return true;
+        }
+    return false;
+}
+
+void PrintObject::store_to_step_cache(PrintObjectStep step) const
+{
+    if (const PrintObjectStepCache *step_cache = m_print->step_cache(); step_cache != nullptr && PrintObjectStepCache::is_cached_step(*this, step))
+        step_cache->store(*this, step);
+}
+
 void PrintObject::infill()
 {
     // prerequisites
@@ -543,6 +603,7 @@ void PrintObject::infill()
 
     if (this->set_started(posInfill)) {
         m_print->set_status(35, L("Generating infill toolpath"));
+        StepTimeLog step_time(*this, "infill");
         const auto& adaptive_fill_octree = this->m_adaptive_fill_octrees.first;
         const auto& support_fill_octree = this->m_adaptive_fill_octrees.second;
 
@@ -568,6 +629,7 @@ void PrintObject::infill()
 void PrintObject::ironing()
 {
     if (this->set_started(posIroning)) {
+        StepTimeLog step_time(*this, "ironing");
         BOOST_LOG_TRIVIAL(debug) << "Ironing in parallel - start";
         tbb::parallel_for(
             // Ironing starting with layer 0 to support ironing all surfaces.
@@ -599,6 +661,7 @@ static const float g_min_overhang_percent_for_lift = 0.3f;
 void PrintObject::detect_overhangs_for_lift()
 {
     if (this->set_started(posDetectOverhangsForLift)) {
+        StepTimeLog step_time(*this, "detect_overhangs_for_lift");
         const double nozzle_diameter = m_print->config().nozzle_diameter.get_at(0);
         const coordf_t line_width = this->config().get_abs_value("line_width", nozzle_diameter);
 
@@ -631,6 +694,7 @@ void PrintObject::detect_overhangs_for_lift()
 void PrintObject::generate_support_material()
 {
     if (this->set_started(posSupportMaterial)) {
+        StepTimeLog step_time(*this, "generate_support_material");
         this->clear_support_layers();
 
         if ((this->has_support() && m_layers.size() > 1) || (this->has_raft() && ! m_layers.empty())) {
@@ -676,6 +740,7 @@ void PrintObject::generate_support_material()
 void PrintObject::estimate_curled_extrusions()
 {
     if (this->set_started(posEstimateCurledExtrusions)) {
+        StepTimeLog step_time(*this, "estimate_curled_extrusions");
         if ( std::any_of(this->print()->m_print_regions.begin(), this->print()->m_print_regions.end(),
                         [](const PrintRegion *region) { return region->config().enable_overhang_speed.getBool(); })) {
 
@@ -749,6 +814,20 @@ void PrintObject::simplify_extrusion_path()
     }
 }
 
+// Seam analysis used to run at the start of every G-code export. As a step, its result survives changes of the options,
+// which only invalidate the G-code export (start G-code, fan settings, speeds, ...).
+void PrintObject::analyze_seams()
+{
+    if (this->set_started(posSeamPlacement)) {
+        StepTimeLog step_time(*this, "analyze_seams");
+        BOOST_LOG_TRIVIAL(debug) << "Seam placement analysis of object - start";
+        m_seam_data.reset();
+        m_seam_data = SeamPlacer::analyze_object(*this, [this]() { m_print->throw_if_canceled(); });
+        BOOST_LOG_TRIVIAL(debug) << "Seam placement analysis of object - end";
+        this->set_done(posSeamPlacement);
+    }
+}
+
 std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> PrintObject::prepare_adaptive_infill_data(
     const std::vector<std::pair<const Surface *, float>> &surfaces_w_bottom_z) const
 {
@@ -883,8 +962,30 @@ bool PrintObject::invalidate_state_by_config_options(
         return false;
 
     std::vector<PrintObjectStep> steps;
+    std::vector<PrintStep>       print_steps;
     bool invalidated = false;
-    for (const t_config_option_key &opt_key : opt_keys) {
+    for (const t_config_option_key &opt_key : opt_keys)
+        if (! this->steps_invalidated_by_config_option(&old_config, &new_config, opt_key, steps, print_steps)) {
+            // for legacy, if we can't handle this option let's invalidate all steps
+            this->invalidate_all_steps();
+            invalidated = true;
+        }
+
+    sort_remove_duplicates(print_steps);
+    for (PrintStep step : print_steps)
+        invalidated |= m_print->invalidate_step(step);
+    sort_remove_duplicates(steps);
+    for (PrintObjectStep step : steps)
+        invalidated |= this->invalidate_step(step);
+    return invalidated;
+}
+
+bool PrintObject::steps_invalidated_by_config_option(
+    const ConfigOptionResolver *old_config, const ConfigOptionResolver *new_config, const t_config_option_key &opt_key,
+    std::vector<PrintObjectStep> &steps, std::vector<PrintStep> &print_steps) const
+{
+    assert((old_config == nullptr) == (new_config == nullptr));
+    {
         if (   opt_key == "brim_width"
             || opt_key == "brim_object_gap"
             || opt_key == "brim_type"
@@ -902,11 +1003,11 @@ bool PrintObject::invalidate_state_by_config_options(
             // Brim is printed below supports, support invalidates brim and skirt.
             steps.emplace_back(posSupportMaterial);
             if (opt_key == "brim_type") {
-                const auto* old_brim_type = old_config.option<ConfigOptionEnum<BrimType>>(opt_key);
-                const auto* new_brim_type = new_config.option<ConfigOptionEnum<BrimType>>(opt_key);
                 //BBS: When switch to manual brim, the object must have brim, then re-generate perimeter
                 //to make the wall order of first layer to be outer-first
-                if (old_brim_type->value == btOuterOnly || new_brim_type->value == btOuterOnly)
+                if (old_config == nullptr ||
+                    old_config->option<ConfigOptionEnum<BrimType>>(opt_key)->value == btOuterOnly ||
+                    new_config->option<ConfigOptionEnum<BrimType>>(opt_key)->value == btOuterOnly)
                     steps.emplace_back(posPerimeters);
             }
         } else if (
@@ -928,10 +1029,12 @@ bool PrintObject::invalidate_state_by_config_options(
         } else if (opt_key == "gap_infill_speed"
             || opt_key == "filter_out_gap_fill" ) {
             // Return true if gap-fill speed has changed from zero value to non-zero or from non-zero value to zero.
-            auto is_gap_fill_changed_state_due_to_speed = [&opt_key, &old_config, &new_config]() -> bool {
+            auto is_gap_fill_changed_state_due_to_speed = [&opt_key, old_config, new_config]() -> bool {
+                if (old_config == nullptr)
+                    return true;
                 if (opt_key == "gap_infill_speed") {
-                    const auto *old_gap_fill_speed = old_config.option<ConfigOptionFloat>(opt_key);
-                    const auto *new_gap_fill_speed = new_config.option<ConfigOptionFloat>(opt_key);
+                    const auto *old_gap_fill_speed = old_config->option<ConfigOptionFloat>(opt_key);
+                    const auto *new_gap_fill_speed = new_config->option<ConfigOptionFloat>(opt_key);
                     assert(old_gap_fill_speed && new_gap_fill_speed);
                     return (old_gap_fill_speed->value > 0.f && new_gap_fill_speed->value == 0.f) ||
                            (old_gap_fill_speed->value == 0.f && new_gap_fill_speed->value > 0.f);
@@ -1037,12 +1140,14 @@ bool PrintObject::invalidate_state_by_config_options(
 
             steps.emplace_back(posPrepareInfill);
 
-            const auto *old_shell_layers = old_config.option<ConfigOptionInt>(opt_key);
-            const auto *new_shell_layers = new_config.option<ConfigOptionInt>(opt_key);
-            assert(old_shell_layers && new_shell_layers);
-
-            bool value_changed = (old_shell_layers->value == 0 && new_shell_layers->value > 0) ||
-                                 (old_shell_layers->value > 0 && new_shell_layers->value == 0);
+            bool value_changed = true;
+            if (old_config != nullptr) {
+                const auto *old_shell_layers = old_config->option<ConfigOptionInt>(opt_key);
+                const auto *new_shell_layers = new_config->option<ConfigOptionInt>(opt_key);
+                assert(old_shell_layers && new_shell_layers);
+                value_changed = (old_shell_layers->value == 0 && new_shell_layers->value > 0) ||
+                                (old_shell_layers->value > 0 && new_shell_layers->value == 0);
+            }
 
             if (value_changed && this->object_extruders().size() > 1) {
                 steps.emplace_back(posSlice);
@@ -1082,12 +1187,13 @@ bool PrintObject::invalidate_state_by_config_options(
         } else if (opt_key == "sparse_infill_density") {
             // One likely wants to reslice only when switching between zero infill to simulate boolean difference (subtracting volumes),
             // normal infill and 100% (solid) infill.
-            const auto *old_density = old_config.option<ConfigOptionPercent>(opt_key);
-            const auto *new_density = new_config.option<ConfigOptionPercent>(opt_key);
-            assert(old_density && new_density);
             //FIXME Vojtech is not quite sure about the 100% here, maybe it is not needed.
-            if (is_approx(old_density->value, 0.) || is_approx(old_density->value, 100.) ||
-                is_approx(new_density->value, 0.) || is_approx(new_density->value, 100.))
+            auto zero_or_solid = [&opt_key](const ConfigOptionResolver *config) {
+                const auto *density = config->option<ConfigOptionPercent>(opt_key);
+                assert(density);
+                return is_approx(density->value, 0.) || is_approx(density->value, 100.);
+            };
+            if (old_config == nullptr || zero_or_solid(old_config) || zero_or_solid(new_config))
                 steps.emplace_back(posPerimeters);
             steps.emplace_back(posPrepareInfill);
         } else if (opt_key == "internal_solid_infill_line_width") {
@@ -1130,8 +1236,10 @@ bool PrintObject::invalidate_state_by_config_options(
             || opt_key == "min_bead_width") {
             steps.emplace_back(posSlice);
         } else if (
-               opt_key == "seam_position"
-            || opt_key == "support_speed"
+               opt_key == "seam_position") {
+            steps.emplace_back(posSeamPlacement);
+        } else if (
+               opt_key == "support_speed"
             || opt_key == "support_interface_speed"
             || opt_key == "overhang_1_4_speed"
             || opt_key == "overhang_2_4_speed"
@@ -1146,24 +1254,17 @@ bool PrintObject::invalidate_state_by_config_options(
             || opt_key == "inner_wall_speed"
             || opt_key == "internal_solid_infill_speed"
             || opt_key == "top_surface_speed") {
-            invalidated |= m_print->invalidate_step(psGCodeExport);
+            print_steps.emplace_back(psGCodeExport);
         } else if (
                opt_key == "flush_into_infill"
             || opt_key == "flush_into_objects"
             || opt_key == "flush_into_support") {
-            invalidated |= m_print->invalidate_step(psWipeTower);
-            invalidated |= m_print->invalidate_step(psGCodeExport);
-        } else {
-            // for legacy, if we can't handle this option let's invalidate all steps
-            this->invalidate_all_steps();
-            invalidated = true;
-        }
+            print_steps.emplace_back(psWipeTower);
+            print_steps.emplace_back(psGCodeExport);
+        } else
+            return false;
     }
-
-    sort_remove_duplicates(steps);
-    for (PrintObjectStep step : steps)
-        invalidated |= this->invalidate_step(step);
-    return invalidated;
+    return true;
 }
 
 bool PrintObject::invalidate_step(PrintObjectStep step)
@@ -1172,17 +1273,20 @@ bool PrintObject::invalidate_step(PrintObjectStep step)
 
     // propagate to dependent steps
     if (step == posPerimeters) {
-		invalidated |= this->invalidate_steps({ posPrepareInfill, posInfill, posIroning, posSimplifyPath, posSimplifyInfill });
+		invalidated |= this->invalidate_steps({ posPrepareInfill, posInfill, posIroning, posSimplifyPath, posSimplifyInfill, posSeamPlacement });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
     } else if (step == posPrepareInfill) {
-        invalidated |= this->invalidate_steps({ posInfill, posIroning, posSimplifyPath, posSimplifyInfill });
+        invalidated |= this->invalidate_steps({ posInfill, posIroning, posSimplifyPath, posSimplifyInfill, posSeamPlacement });
     } else if (step == posInfill) {
         invalidated |= this->invalidate_steps({ posIroning, posSimplifyInfill });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
     } else if (step == posSlice) {
-		invalidated |= this->invalidate_steps({ posPerimeters, posPrepareInfill, posInfill, posIroning, posSupportMaterial, posSimplifyPath, posSimplifyInfill });
+		invalidated |= this->invalidate_steps({ posPerimeters, posPrepareInfill, posInfill, posIroning, posSupportMaterial, posSimplifyPath, posSimplifyInfill, posSeamPlacement });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
         m_slicing_params.valid = false;
+    } else if (step == posSimplifyPath) {
+        // The seam candidates are sampled from the simplified walls.
+        invalidated |= this->invalidate_steps({ posSeamPlacement });
     } else if (step == posSupportMaterial) {
         invalidated |= this->invalidate_steps({ posSimplifySupportPath });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
@@ -1229,6 +1333,171 @@ void PrintObject::detect_surfaces_type()
     bool interface_shells = ! spiral_mode && m_config.interface_shells.value;
     size_t num_layers     = spiral_mode ? std::min(size_t(this->printing_region(0).config().bottom_shell_layers), m_layers.size()) : m_layers.size();
 
+    // If we have soluble support material, don't bridge. The overhang will be squished against a soluble layer separating
+    // the support from the print.
+    // BBS: the above logic only applys for normal(auto) support. Complete logic:
+    // 1. has support, top z distance=0 (soluble material), auto support
+    // 2. for normal(auto), bridge_no_support is off
+    // 3. for tree(auto), interface top layers=0, max bridge length=0, support_critical_regions_only=false (only in this way the bridge is fully supported)
+    bool bottom_is_fully_supported = this->has_support() && m_config.support_top_z_distance.value == 0 && is_auto(m_config.support_type.value);
+    if (m_config.support_type.value == stNormalAuto)
+        bottom_is_fully_supported &= !m_config.bridge_no_support.value;
+    else if (m_config.support_type.value == stTreeAuto) {
+        bottom_is_fully_supported &= (m_config.support_interface_top_layers.value > 0 && m_config.max_bridge_length.value == 0 && m_config.support_critical_regions_only.value==false);
+    }
+    SurfaceType surface_type_bottom_other = bottom_is_fully_supported ? stBottom : stBottomBridge;
+
+    // Classify the slices of a single region of a single layer.
+    // If interface shells are allowed, the result is stored into surfaces_new instead of layerm->slices,
+    // as the region slices of the neighbor layers are being read by other threads.
+    auto detect_layer_region = [this, interface_shells, surface_type_bottom_other](size_t region_id, size_t idx_layer, Surfaces *surfaces_new) {
+        // BOOST_LOG_TRIVIAL(trace) << "Detecting solid surfaces for region " << region_id << " and layer " << layer->print_z;
+        Layer       *layer  = m_layers[idx_layer];
+        LayerRegion *layerm = layer->m_regions[region_id];
+        // comparison happens against the *full* slices (considering all regions)
+        // unless internal shells are requested
+        Layer       *upper_layer = (idx_layer + 1 < this->layer_count()) ? m_layers[idx_layer + 1] : nullptr;
+        Layer       *lower_layer = (idx_layer > 0) ? m_layers[idx_layer - 1] : nullptr;
+        // collapse very narrow parts (using the safety offset in the diff is not enough)
+        float        offset = layerm->flow(frExternalPerimeter).scaled_width() / 10.f;
+
+        // find top surfaces (difference between current surfaces
+        // of current layer and upper one)
+        Surfaces top;
+        if (upper_layer) {
+            ExPolygons upper_slices = interface_shells ?
+                diff_ex(layerm->slices.surfaces, upper_layer->m_regions[region_id]->slices.surfaces, ApplySafetyOffset::Yes) :
+                diff_ex(layerm->slices.surfaces, upper_layer->lslices, ApplySafetyOffset::Yes);
+            surfaces_append(top, opening_ex(upper_slices, offset), stTop);
+        } else {
+            // if no upper layer, all surfaces of this one are solid
+            // we clone surfaces because we're going to clear the slices collection
+            top = layerm->slices.surfaces;
+            for (Surface &surface : top)
+                surface.surface_type = stTop;
+        }
+
+        // Find bottom surfaces (difference between current surfaces of current layer and lower one).
+        Surfaces bottom;
+        if (lower_layer) {
+#if 0
+            //FIXME Why is this branch failing t\multi.t ?
+            Polygons lower_slices = interface_shells ?
+                to_polygons(lower_layer->get_region(region_id)->slices.surfaces) :
+                to_polygons(lower_layer->slices);
+            surfaces_append(bottom,
+                opening_ex(diff(layerm->slices.surfaces, lower_slices, true), offset),
+                surface_type_bottom_other);
+#else
+            // Any surface lying on the void is a true bottom bridge (an overhang)
+            surfaces_append(
+                bottom,
+                opening_ex(
+                    diff_ex(layerm->slices.surfaces, lower_layer->lslices, ApplySafetyOffset::Yes),
+                    offset),
+                surface_type_bottom_other);
+            // if user requested internal shells, we need to identify surfaces
+            // lying on other slices not belonging to this region
+            if (interface_shells) {
+                // non-bridging bottom surfaces: any part of this layer lying
+                // on something else, excluding those lying on our own region
+                surfaces_append(
+                    bottom,
+                    opening_ex(
+                        diff_ex(
+                            intersection(layerm->slices.surfaces, lower_layer->lslices), // supported
+                            lower_layer->m_regions[region_id]->slices.surfaces,
+                            ApplySafetyOffset::Yes),
+                        offset),
+                    stBottom);
+            }
+#endif
+        } else {
+            // if no lower layer, all surfaces of this one are solid
+            // we clone surfaces because we're going to clear the slices collection
+            bottom = layerm->slices.surfaces;
+            for (Surface &surface : bottom)
+                surface.surface_type = stBottom;
+        }
+
+        // now, if the object contained a thin membrane, we could have overlapping bottom
+        // and top surfaces; let's do an intersection to discover them and consider them
+        // as bottom surfaces (to allow for bridge detection)
+        if (! top.empty() && ! bottom.empty()) {
+//                Polygons overlapping = intersection(to_polygons(top), to_polygons(bottom));
+//                Slic3r::debugf "  layer %d contains %d membrane(s)\n", $layerm->layer->id, scalar(@$overlapping)
+//                    if $Slic3r::debug;
+            Polygons top_polygons = to_polygons(std::move(top));
+            top.clear();
+            surfaces_append(top, diff_ex(top_polygons, bottom), stTop);
+        }
+
+#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
+        {
+            static int iRun = 0;
+            std::vector<std::pair<Slic3r::ExPolygons, SVG::ExPolygonAttributes>> expolygons_with_attributes;
+            expolygons_with_attributes.emplace_back(std::make_pair(union_ex(top),                           SVG::ExPolygonAttributes("green")));
+            expolygons_with_attributes.emplace_back(std::make_pair(union_ex(bottom),                        SVG::ExPolygonAttributes("brown")));
+            expolygons_with_attributes.emplace_back(std::make_pair(to_expolygons(layerm->slices.surfaces),  SVG::ExPolygonAttributes("black")));
+            SVG::export_expolygons(debug_out_path("1_detect_surfaces_type_%d_region%d-layer_%f.svg", iRun ++, region_id, layer->print_z).c_str(), expolygons_with_attributes);
+        }
+#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
+
+        // save surfaces to layer
+        Surfaces &surfaces_out = interface_shells ? *surfaces_new : layerm->slices.surfaces;
+        Surfaces  surfaces_backup;
+        if (! interface_shells) {
+            surfaces_backup = std::move(surfaces_out);
+            surfaces_out.clear();
+        }
+        const Surfaces &surfaces_prev = interface_shells ? layerm->slices.surfaces : surfaces_backup;
+
+        // find internal surfaces (difference between top/bottom surfaces and others)
+        {
+            Polygons topbottom = to_polygons(top);
+            polygons_append(topbottom, to_polygons(bottom));
+            surfaces_append(surfaces_out, diff_ex(surfaces_prev, topbottom), stInternal);
+        }
+
+        surfaces_append(surfaces_out, std::move(top));
+        surfaces_append(surfaces_out, std::move(bottom));
+
+//            Slic3r::debugf "  layer %d has %d bottom, %d top and %d internal surfaces\n",
+//                $layerm->layer->id, scalar(@bottom), scalar(@top), scalar(@internal) if $Slic3r::debug;
+
+#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
+        layerm->export_region_slices_to_svg_debug("detect_surfaces_type-final");
+#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
+    };
+
+    if (! interface_shells && ! spiral_mode) {
+        // Without interface shells the classification of a region only reads the slices of its own LayerRegion
+        // and Layer::lslices of the neighbor layers, which are not modified here, and the clipping only reads its own LayerRegion.
+        // Therefore a single task classifies and clips all regions of a layer, without waiting for the other layers
+        // to be classified, and without a barrier between the regions and between the two passes.
+        BOOST_LOG_TRIVIAL(debug) << "Detecting solid surfaces in parallel - start";
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, m_layers.size()),
+            [this, &detect_layer_region](const tbb::blocked_range<size_t>& range) {
+                for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer) {
+                    m_print->throw_if_canceled();
+                    for (size_t region_id = 0; region_id < this->num_printing_regions(); ++ region_id) {
+                        detect_layer_region(region_id, idx_layer, nullptr);
+                        LayerRegion *layerm = m_layers[idx_layer]->m_regions[region_id];
+                        layerm->slices_to_fill_surfaces_clipped();
+#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
+                        layerm->export_region_fill_surfaces_to_svg_debug("1_detect_surfaces_type-final");
+#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
+                    }
+                }
+            });
+        m_print->throw_if_canceled();
+        BOOST_LOG_TRIVIAL(debug) << "Detecting solid surfaces in parallel - end";
+        // Mark the object to have the region slices classified (typed, which also means they are split based on whether they are supported, bridging, top layers etc.)
+        m_typed_slices = true;
+        return;
+    }
+
     for (size_t region_id = 0; region_id < this->num_printing_regions(); ++ region_id) {
         BOOST_LOG_TRIVIAL(debug) << "Detecting solid surfaces for region " << region_id << " in parallel - start";
 #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
@@ -1249,139 +1518,10 @@ void PrintObject::detect_surfaces_type()
             		((num_layers > 1) ? num_layers - 1 : num_layers) :
             		// In non-spiral vase mode, go over all layers.
             		m_layers.size()),
-            [this, region_id, interface_shells, &surfaces_new](const tbb::blocked_range<size_t>& range) {
-                // If we have soluble support material, don't bridge. The overhang will be squished against a soluble layer separating
-                // the support from the print.
-                // BBS: the above logic only applys for normal(auto) support. Complete logic:
-                // 1. has support, top z distance=0 (soluble material), auto support
-                // 2. for normal(auto), bridge_no_support is off
-                // 3. for tree(auto), interface top layers=0, max bridge length=0, support_critical_regions_only=false (only in this way the bridge is fully supported)
-                bool bottom_is_fully_supported = this->has_support() && m_config.support_top_z_distance.value == 0 && is_auto(m_config.support_type.value);
-                if (m_config.support_type.value == stNormalAuto)
-                    bottom_is_fully_supported &= !m_config.bridge_no_support.value;
-                else if (m_config.support_type.value == stTreeAuto) {
-                    bottom_is_fully_supported &= (m_config.support_interface_top_layers.value > 0 && m_config.max_bridge_length.value == 0 && m_config.support_critical_regions_only.value==false);
-                }
-                SurfaceType surface_type_bottom_other = bottom_is_fully_supported ? stBottom : stBottomBridge;
+            [this, region_id, interface_shells, &surfaces_new, &detect_layer_region](const tbb::blocked_range<size_t>& range) {
                 for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer) {
                     m_print->throw_if_canceled();
-                    // BOOST_LOG_TRIVIAL(trace) << "Detecting solid surfaces for region " << region_id << " and layer " << layer->print_z;
-                    Layer       *layer  = m_layers[idx_layer];
-                    LayerRegion *layerm = layer->m_regions[region_id];
-                    // comparison happens against the *full* slices (considering all regions)
-                    // unless internal shells are requested
-                    Layer       *upper_layer = (idx_layer + 1 < this->layer_count()) ? m_layers[idx_layer + 1] : nullptr;
-                    Layer       *lower_layer = (idx_layer > 0) ? m_layers[idx_layer - 1] : nullptr;
-                    // collapse very narrow parts (using the safety offset in the diff is not enough)
-                    float        offset = layerm->flow(frExternalPerimeter).scaled_width() / 10.f;
-
-                    // find top surfaces (difference between current surfaces
-                    // of current layer and upper one)
-                    Surfaces top;
-                    if (upper_layer) {
-                        ExPolygons upper_slices = interface_shells ?
-                            diff_ex(layerm->slices.surfaces, upper_layer->m_regions[region_id]->slices.surfaces, ApplySafetyOffset::Yes) :
-                            diff_ex(layerm->slices.surfaces, upper_layer->lslices, ApplySafetyOffset::Yes);
-                        surfaces_append(top, opening_ex(upper_slices, offset), stTop);
-                    } else {
-                        // if no upper layer, all surfaces of this one are solid
-                        // we clone surfaces because we're going to clear the slices collection
-                        top = layerm->slices.surfaces;
-                        for (Surface &surface : top)
-                            surface.surface_type = stTop;
-                    }
-
-                    // Find bottom surfaces (difference between current surfaces of current layer and lower one).
-                    Surfaces bottom;
-                    if (lower_layer) {
-#if 0
-                        //FIXME Why is this branch failing t\multi.t ?
-                        Polygons lower_slices = interface_shells ?
-                            to_polygons(lower_layer->get_region(region_id)->slices.surfaces) :
-                            to_polygons(lower_layer->slices);
-                        surfaces_append(bottom,
-                            opening_ex(diff(layerm->slices.surfaces, lower_slices, true), offset),
-                            surface_type_bottom_other);
-#else
-                        // Any surface lying on the void is a true bottom bridge (an overhang)
-                        surfaces_append(
-                            bottom,
-                            opening_ex(
-                                diff_ex(layerm->slices.surfaces, lower_layer->lslices, ApplySafetyOffset::Yes),
-                                offset),
-                            surface_type_bottom_other);
-                        // if user requested internal shells, we need to identify surfaces
-                        // lying on other slices not belonging to this region
-                        if (interface_shells) {
-                            // non-bridging bottom surfaces: any part of this layer lying
-                            // on something else, excluding those lying on our own region
-                            surfaces_append(
-                                bottom,
-                                opening_ex(
-                                    diff_ex(
-                                        intersection(layerm->slices.surfaces, lower_layer->lslices), // supported
-                                        lower_layer->m_regions[region_id]->slices.surfaces,
-                                        ApplySafetyOffset::Yes),
-                                    offset),
-                                stBottom);
-                        }
-#endif
-                    } else {
-                        // if no lower layer, all surfaces of this one are solid
-                        // we clone surfaces because we're going to clear the slices collection
-                        bottom = layerm->slices.surfaces;
-                        for (Surface &surface : bottom)
-                            surface.surface_type = stBottom;
-                    }
-
-                    // now, if the object contained a thin membrane, we could have overlapping bottom
-                    // and top surfaces; let's do an intersection to discover them and consider them
-                    // as bottom surfaces (to allow for bridge detection)
-                    if (! top.empty() && ! bottom.empty()) {
-        //                Polygons overlapping = intersection(to_polygons(top), to_polygons(bottom));
-        //                Slic3r::debugf "  layer %d contains %d membrane(s)\n", $layerm->layer->id, scalar(@$overlapping)
-        //                    if $Slic3r::debug;
-                        Polygons top_polygons = to_polygons(std::move(top));
-                        top.clear();
-                        surfaces_append(top, diff_ex(top_polygons, bottom), stTop);
-                    }
-
-        #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
-                    {
-                        static int iRun = 0;
-                        std::vector<std::pair<Slic3r::ExPolygons, SVG::ExPolygonAttributes>> expolygons_with_attributes;
-                        expolygons_with_attributes.emplace_back(std::make_pair(union_ex(top),                           SVG::ExPolygonAttributes("green")));
-                        expolygons_with_attributes.emplace_back(std::make_pair(union_ex(bottom),                        SVG::ExPolygonAttributes("brown")));
-                        expolygons_with_attributes.emplace_back(std::make_pair(to_expolygons(layerm->slices.surfaces),  SVG::ExPolygonAttributes("black")));
-                        SVG::export_expolygons(debug_out_path("1_detect_surfaces_type_%d_region%d-layer_%f.svg", iRun ++, region_id, layer->print_z).c_str(), expolygons_with_attributes);
-                    }
-        #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
-
-                    // save surfaces to layer
-                    Surfaces &surfaces_out = interface_shells ? surfaces_new[idx_layer] : layerm->slices.surfaces;
-                    Surfaces  surfaces_backup;
-                    if (! interface_shells) {
-                        surfaces_backup = std::move(surfaces_out);
-                        surfaces_out.clear();
-                    }
-                    const Surfaces &surfaces_prev = interface_shells ? layerm->slices.surfaces : surfaces_backup;
-
-                    // find internal surfaces (difference between top/bottom surfaces and others)
-                    {
-                        Polygons topbottom = to_polygons(top);
-                        polygons_append(topbottom, to_polygons(bottom));
-                        surfaces_append(surfaces_out, diff_ex(surfaces_prev, topbottom), stInternal);
-                    }
-
-                    surfaces_append(surfaces_out, std::move(top));
-                    surfaces_append(surfaces_out, std::move(bottom));
-
-        //            Slic3r::debugf "  layer %d has %d bottom, %d top and %d internal surfaces\n",
-        //                $layerm->layer->id, scalar(@bottom), scalar(@top), scalar(@internal) if $Slic3r::debug;
-
-        #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
-                    layerm->export_region_slices_to_svg_debug("detect_surfaces_type-final");
-        #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
+                    detect_layer_region(region_id, idx_layer, interface_shells ? &surfaces_new[idx_layer] : nullptr);
                 }
             }
         ); // for each layer of a region
@@ -52,16 +52,13 @@ static std::vector<ExPolygons> slice_volume(
     const std::function<void()>   &throw_on_cancel_callback)
 {
     std::vector<ExPolygons> layers;
-    if (! zs.empty()) {
-        indexed_triangle_set its = volume.mesh().its;
-        if (its.indices.size() > 0) {
-            MeshSlicingParamsEx params2 { params };
-            params2.trafo = params2.trafo * volume.get_matrix();
-            if (params2.trafo.rotation().determinant() < 0.)
-                its_flip_triangles(its);
-            layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
-            throw_on_cancel_callback();
-        }
+    if (! zs.empty() && ! volume.mesh().its.indices.empty()) {
+        MeshSlicingParamsEx params2 { params };
+        params2.trafo = params2.trafo * volume.get_matrix();
+        // The slicing index is cached by the volume, reused by the other slicing passes and by reslicing.
+        std::shared_ptr<const MeshSlicingIndex> index = volume.slicing_index(params2.trafo, params2.trafo.rotation().determinant() < 0.);
+        layers = slice_mesh_ex(*index, zs, params2, throw_on_cancel_callback);
+        throw_on_cancel_callback();
     }
     return layers;
 }
@@ -805,6 +802,8 @@ void PrintObject::slice()
         return;
     //BBS: add flag to reload scene for shell rendering
     m_print->set_status(5, L("Slicing mesh"), PrintBase::SlicingStatus::RELOAD_SCENE);
+    if (this->restore_from_step_cache(posSlice))
+        return;
     std::vector<coordf_t> layer_height_profile;
     this->update_layer_height_profile(*this->model_object(), m_slicing_params, layer_height_profile);
     m_print->throw_if_canceled();
@@ -850,6 +849,7 @@ void PrintObject::slice()
     if (m_layers.empty())
         throw Slic3r::SlicingError(L("No layers were detected. You might want to repair your STL file(s) or check their size or thickness and retry.\n"));
 
+    this->store_to_step_cache(posSlice);
     // BBS
     this->set_done(posSlice);
 }
@@ -0,0 +1,337 @@
+#include "PrintObjectStepCache.hpp"
+
+#include "Exception.hpp"
+#include "Layer.hpp"
+#include "Model.hpp"
+#include "Format/SliceCache.hpp"
+
+#include "libslic3r_version.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <openssl/md5.h>
+
+#include <tbb/parallel_for.h>
+
+namespace Slic3r {
+
+// Bump if the semantics of a key changes.
+static constexpr const int StepCacheKeyVersion = 3;
+
+namespace {
+
+// MD5 over a canonical byte stream describing the inputs of a step.
+class KeyHasher
+{
+public:
+    KeyHasher() { MD5_Init(&m_ctx); }
+
+    void add_raw(const void *data, size_t size) { MD5_Update(&m_ctx, data, size); }
+    template<typename T> void add(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "KeyHasher::add() requires a trivially copyable type");
+        this->add_raw(&value, sizeof(value));
+    }
+    // Length prefixed, so that the concatenation of strings is unambiguous.
+    void add(const std::string &s) { this->add(uint64_t(s.size())); this->add_raw(s.data(), s.size()); }
+    void add(const char *s) { this->add(std::string(s)); }
+    template<typename T> void add_vector(const std::vector<T> &v)
+    {
+        this->add(uint64_t(v.size()));
+        if (! v.empty())
+            this->add_raw(v.data(), v.size() * sizeof(T));
+    }
+    void add(const Transform3d &trafo) { this->add_raw(trafo.matrix().data(), sizeof(double) * 16); }
+    void add(const FacetsAnnotation &facets)
+    {
+        this->add_vector(facets.get_data().first);
+        const std::vector<bool> &bits = facets.get_data().second;
+        this->add(uint64_t(bits.size()));
+        for (size_t i = 0; i < bits.size(); i += 8) {
+            uint8_t byte = 0;
+            for (size_t j = i; j < std::min(i + 8, bits.size()); ++ j)
+                byte |= uint8_t(bits[j]) << (j - i);
+            this->add(byte);
+        }
+    }
+    // Options of a config, which the step depends on, in the alphabetical order of keys.
+    template<typename Filter> void add_config(const ConfigBase &config, Filter filter)
+    {
+        t_config_option_keys keys = config.keys();
+        std::sort(keys.begin(), keys.end());
+        for (const t_config_option_key &opt_key : keys)
+            if (filter(opt_key)) {
+                this->add(opt_key);
+                this->add(config.opt_serialize(opt_key));
+            }
+    }
+
+    std::string hex_digest()
+    {
+        unsigned char digest[MD5_DIGEST_LENGTH];
+        MD5_Final(digest, &m_ctx);
+        std::string out;
+        out.reserve(MD5_DIGEST_LENGTH * 2);
+        static constexpr const char hex[] = "0123456789abcdef";
+        for (unsigned char c : digest) {
+            out += hex[c >> 4];
+            out += hex[c & 0xf];
+        }
+        return out;
+    }
+
+private:
+    MD5_CTX m_ctx;
+};
+
+} // namespace
+
+PrintObjectStepCache::PrintObjectStepCache(const std::string &directory) : m_directory(directory)
+{
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(boost::filesystem::path(directory), ec);
+    if (ec)
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << boost::format(": can not create step cache directory %1%: %2%") % directory % ec.message();
+}
+
+std::string PrintObjectStepCache::file_path(const std::string &key) const
+{
+    return (boost::filesystem::path(m_directory) / (key + SliceCache::BinaryExtension)).string();
+}
+
+bool PrintObjectStepCache::is_cached_step(const PrintObject &object, PrintObjectStep step)
+{
+    if (! is_cached_step(step))
+        return false;
+    if (step == posPrepareInfill)
+        for (size_t region_id = 0; region_id < object.num_printing_regions(); ++ region_id)
+            if (InfillPattern pattern = object.printing_region(region_id).config().sparse_infill_pattern;
+                pattern == ipAdaptiveCubic || pattern == ipSupportCubic || pattern == ipLightning)
+                return false;
+    return true;
+}
+
+PrintObjectStep PrintObjectStepCache::first_step_depending_on(const PrintObject &object, const t_config_option_key &opt_key)
+{
+    // Perimeters only depend on whether the infill is empty, solid or sparse, which is hashed separately by key().
+    if (opt_key == "sparse_infill_density")
+        return posPrepareInfill;
+    // Classified the same way as by PrintObject::invalidate_state_by_config_options(), with the value dependent
+    // exceptions resolved conservatively.
+    std::vector<PrintObjectStep> steps;
+    std::vector<PrintStep>       print_steps;
+    if (! object.steps_invalidated_by_config_option(nullptr, nullptr, opt_key, steps, print_steps))
+        return posSlice;
+    PrintObjectStep first = posCount;
+    for (PrintObjectStep step : steps)
+        if (is_cached_step(step))
+            first = std::min(first, step);
+    return first;
+}
+
+const std::string& PrintObjectStepCache::geometry_digest(const PrintObject &object)
+{
+    // Memoized until the next Print::apply(), which may change the geometry.
+    if (! object.m_step_cache_geometry.empty())
+        return object.m_step_cache_geometry;
+    KeyHasher hasher;
+    // Geometry.
+    const ModelObject &model_object = *object.model_object();
+    hasher.add(object.trafo_centered());
+    hasher.add(uint64_t(model_object.volumes.size()));
+    for (const ModelVolume *volume : model_object.volumes) {
+        hasher.add(int(volume->type()));
+        hasher.add(volume->get_matrix());
+        hasher.add_vector(volume->mesh().its.vertices);
+        hasher.add_vector(volume->mesh().its.indices);
+        hasher.add(volume->supported_facets);
+        hasher.add(volume->mmu_segmentation_facets);
+        // Per volume overrides, mostly of modifiers.
+        hasher.add_config(volume->config.get(), [](const t_config_option_key &) { return true; });
+    }
+    hasher.add_vector(model_object.layer_height_profile.get());
+    hasher.add(uint64_t(model_object.layer_config_ranges.size()));
+    for (const auto &range : model_object.layer_config_ranges) {
+        hasher.add(range.first.first);
+        hasher.add(range.first.second);
+        hasher.add_config(range.second.get(), [](const t_config_option_key &) { return true; });
+    }
+    // Assignment of the volumes and of the painted areas to the printing regions, see PrintObjectRegions.
+    const PrintObjectRegions &regions = *object.shared_regions();
+    auto region_id = [](const PrintRegion *region) { return region ? region->print_object_region_id() : -1; };
+    hasher.add(uint64_t(regions.layer_ranges.size()));
+    for (const PrintObjectRegions::LayerRangeRegions &range : regions.layer_ranges) {
+        hasher.add(range.layer_height_range.first);
+        hasher.add(range.layer_height_range.second);
+        hasher.add(uint64_t(range.volume_regions.size()));
+        for (const PrintObjectRegions::VolumeRegion &volume_region : range.volume_regions) {
+            auto it = std::find(model_object.volumes.begin(), model_object.volumes.end(), volume_region.model_volume);
+            hasher.add(int(it - model_object.volumes.begin()));
+            hasher.add(volume_region.parent);
+            hasher.add(region_id(volume_region.region));
+        }
+        hasher.add(uint64_t(range.painted_regions.size()));
+        for (const PrintObjectRegions::PaintedRegion &painted_region : range.painted_regions) {
+            hasher.add(painted_region.extruder_id);
+            hasher.add(painted_region.parent);
+            hasher.add(region_id(painted_region.region));
+        }
+    }
+
+    object.m_step_cache_geometry = hasher.hex_digest();
+    return object.m_step_cache_geometry;
+}
+
+std::string PrintObjectStepCache::key(const PrintObject &object, PrintObjectStep step)
+{
+    assert(is_cached_step(step));
+    KeyHasher hasher;
+    hasher.add(StepCacheKeyVersion);
+    hasher.add(SliceCache::BinaryVersion);
+    hasher.add(SLIC3R_VERSION);
+    hasher.add(int(step));
+    hasher.add(geometry_digest(object));
+
+    // Layering, the same as long as equal_layering() holds.
+    const SlicingParameters &slicing_params = object.slicing_parameters();
+    for (coordf_t value : { slicing_params.base_raft_layer_height, slicing_params.interface_raft_layer_height, slicing_params.contact_raft_layer_height,
+                            slicing_params.layer_height, slicing_params.min_layer_height, slicing_params.max_layer_height,
+                            slicing_params.first_print_layer_height, slicing_params.first_object_layer_height,
+                            slicing_params.raft_base_top_z, slicing_params.raft_interface_top_z, slicing_params.raft_contact_top_z,
+                            slicing_params.object_print_z_min })
+        hasher.add(value);
+    hasher.add(uint64_t(slicing_params.base_raft_layers));
+    hasher.add(uint64_t(slicing_params.interface_raft_layers));
+    hasher.add(slicing_params.first_object_layer_bridging);
+
+    // Configuration.
+    auto depends_on = [&object, step](const t_config_option_key &opt_key) { return first_step_depending_on(object, opt_key) <= step; };
+    hasher.add_config(object.config(), depends_on);
+    hasher.add(uint64_t(object.num_printing_regions()));
+    for (size_t region_id = 0; region_id < object.num_printing_regions(); ++ region_id) {
+        const PrintRegionConfig &region_config = object.printing_region(region_id).config();
+        hasher.add_config(region_config, depends_on);
+        if (step == posPerimeters)
+            // Perimeters only depend on whether the infill is empty, solid or sparse, see PrintObject::invalidate_state_by_config_options().
+            hasher.add(is_approx(region_config.sparse_infill_density.value, 0.) ? 0 : is_approx(region_config.sparse_infill_density.value, 100.) ? 2 : 1);
+    }
+    // PrintConfig options invalidating the cached steps, classified the same way as by Print::invalidate_state_by_config_options().
+    // The options not known to it only invalidate the steps of the Print.
+    const PrintConfig &print_config = object.print()->config();
+    hasher.add(uint64_t(print_config.filament_diameter.size()));
+    hasher.add_config(print_config, [step](const t_config_option_key &opt_key) {
+        std::vector<PrintStep>       print_steps;
+        std::vector<PrintObjectStep> steps;
+        Print::steps_invalidated_by_config_option(opt_key, print_steps, steps);
+        return std::any_of(steps.begin(), steps.end(), [step](PrintObjectStep s) { return is_cached_step(s) && s <= step; });
+    });
+    return hasher.hex_digest();
+}
+
+bool PrintObjectStepCache::load(PrintObject &object, PrintObjectStep step) const
+{
+    const std::string path = this->file_path(key(object, step));
+    if (! boost::filesystem::exists(path))
+        return false;
+
+    try {
+        boost::iostreams::mapped_file_source file;
+        file.open(boost::filesystem::path(path));
+        if (! file.is_open())
+            throw Slic3r::FileIOError("Failed to map " + path);
+        const char *data = file.data();
+        size_t      size = file.size();
+
+        SliceCache::ObjectEntry object_entry = SliceCache::decode_object_directory(data, size);
+        const size_t num_regions = object.num_printing_regions();
+        for (const SliceCache::LayerEntry &entry : object_entry.layers)
+            if (entry.region_config_hashes.size() != num_regions)
+                throw Slic3r::FileIOError("Number of regions does not match");
+        if (object_entry.layers.empty())
+            throw Slic3r::FileIOError("No layers");
+
+        // The layers are recreated with all the printing regions in order, as PrintObject::slice_volumes() does.
+        object.clear_layers();
+        Layer *previous_layer = nullptr;
+        for (const SliceCache::LayerEntry &entry : object_entry.layers) {
+            Layer *layer = object.add_layer(entry.id, entry.height, entry.print_z, entry.slice_z);
+            for (size_t region_id = 0; region_id < num_regions; ++ region_id)
+                layer->add_region(&object.printing_region(region_id));
+            if (previous_layer) {
+                previous_layer->upper_layer = layer;
+                layer->lower_layer = previous_layer;
+            }
+            previous_layer = layer;
+        }
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, object_entry.layers.size()),
+            [data, size, &object_entry, &object](const tbb::blocked_range<size_t> &range) {
+                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                    SliceCache::decode_layer(data, size, object_entry.layers[layer_idx], *object.m_layers[layer_idx]);
+            });
+
+        const ModelVolumePtrs &volumes = object.model_object()->volumes;
+        std::vector<groupedVolumeSlices> &groups = object.firstLayerObjGroupsMod();
+        groups = std::move(object_entry.first_layer_groups);
+        for (groupedVolumeSlices &group : groups)
+            for (ObjectID &volume_id : group.volume_ids) {
+                if (volume_id.id >= volumes.size())
+                    throw Slic3r::FileIOError("Invalid volume index");
+                volume_id = volumes[volume_id.id]->id();
+            }
+        // detect_surfaces_type() leaves the slices typed.
+        object.m_typed_slices = step >= posPrepareInfill;
+    } catch (const std::exception &err) {
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << boost::format(": can not load %1%, reason = %2%") % path % err.what();
+        object.clear_layers();
+        object.firstLayerObjGroupsMod().clear();
+        return false;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": object %1%, step %2% restored from %3%") % object.model_object()->name % int(step) % path;
+    return true;
+}
+
+void PrintObjectStepCache::store(const PrintObject &object, PrintObjectStep step) const
+{
+    const std::string path = this->file_path(key(object, step));
+    if (boost::filesystem::exists(path))
+        return;
+
+    // Volume IDs are not persistent, store the indices of the volumes inside the ModelObject.
+    std::vector<groupedVolumeSlices> groups = object.firstLayerObjGroups();
+    const ModelVolumePtrs &volumes = object.model_object()->volumes;
+    for (groupedVolumeSlices &group : groups)
+        for (ObjectID &volume_id : group.volume_ids)
+            for (size_t idx = 0; idx < volumes.size(); ++ idx)
+                if (volumes[idx]->id() == volume_id) {
+                    volume_id.id = idx;
+                    break;
+                }
+
+    boost::filesystem::path tmp_path = boost::filesystem::path(m_directory) / boost::filesystem::unique_path("%%%%-%%%%-%%%%-%%%%.tmp");
+    try {
+        std::string data = SliceCache::encode_object(object, object.model_object()->name, 0, groups, false);
+        {
+            boost::nowide::ofstream out(tmp_path.string(), std::ios::out | std::ios::trunc | std::ios::binary);
+            out.write(data.data(), data.size());
+            out.close();
+            if (out.fail())
+                throw Slic3r::FileIOError("Failed to write " + tmp_path.string());
+        }
+        // Atomic on the same file system, another process storing the same key at the same time writes the same content.
+        boost::filesystem::rename(tmp_path, boost::filesystem::path(path));
+    } catch (const std::exception &err) {
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << boost::format(": can not store %1%, reason = %2%") % path % err.what();
+        boost::system::error_code ec;
+        boost::filesystem::remove(tmp_path, ec);
+    }
+}
+
+} // namespace Slic3r
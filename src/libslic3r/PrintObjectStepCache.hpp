@@ -0,0 +1,55 @@
+#ifndef slic3r_PrintObjectStepCache_hpp_
+#define slic3r_PrintObjectStepCache_hpp_
+
+#include "Print.hpp"
+
+#include <string>
+
+namespace Slic3r {
+
+// On-disk content addressed cache of the results of the PrintObject steps posSlice, posPerimeters and posPrepareInfill.
+// While Print::apply() only reuses the results of a step inside a single Print, the step cache reuses them across
+// processes and across plates sharing the same object: The key of a step is a digest of the object geometry
+// (meshes, transformations, painting, layer height profile and layer ranges) and of the values of the options
+// the step and the steps preceding it depend on, thus changing for example the infill pattern or the filament
+// only reruns the steps downstream of posPrepareInfill.
+//
+// The results are stored as files <key>.bin in the binary slice cache format, see Format/SliceCache.hpp.
+// Writes go through a temporary file renamed into place, so that the cache directory may be shared
+// by multiple processes.
+class PrintObjectStepCache
+{
+public:
+    explicit PrintObjectStepCache(const std::string &directory);
+
+    const std::string&      directory() const { return m_directory; }
+
+    // Steps, which results are stored in the cache.
+    static bool             is_cached_step(PrintObjectStep step) { return step == posSlice || step == posPerimeters || step == posPrepareInfill; }
+    // Whether the results of the step are stored for this object. posPrepareInfill is not stored for objects with
+    // the adaptive cubic, support cubic or lightning infill, because the octrees resp. the lightning generator
+    // used by PrintObject::infill() are built by PrintObject::bridge_over_infill() and they are not part of the cache.
+    static bool             is_cached_step(const PrintObject &object, PrintObjectStep step);
+    // The first cached step, which result depends on the value of a PrintObjectConfig / PrintRegionConfig option,
+    // posCount if none of the cached steps depends on it. Derived from PrintObject::steps_invalidated_by_config_option().
+    static PrintObjectStep  first_step_depending_on(const PrintObject &object, const t_config_option_key &opt_key);
+    // Hex digest of the inputs of the step.
+    static std::string      key(const PrintObject &object, PrintObjectStep step);
+
+    // Replace the layers of the object with the cached results of the step.
+    // Returns false if there is no usable cache entry.
+    bool                    load(PrintObject &object, PrintObjectStep step) const;
+    // Store the current layers of the object as the results of the step, unless already stored.
+    void                    store(const PrintObject &object, PrintObjectStep step) const;
+
+private:
+    // Hex digest of the geometry of the object, computed once after each Print::apply().
+    static const std::string& geometry_digest(const PrintObject &object);
+    std::string             file_path(const std::string &key) const;
+
+    std::string             m_directory;
+};
+
+} // namespace Slic3r
+
+#endif /* slic3r_PrintObjectStepCache_hpp_ */
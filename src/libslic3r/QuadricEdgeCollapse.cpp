@@ -1,8 +1,10 @@
 #include "QuadricEdgeCollapse.hpp"
 #include <tuple>
 #include <optional>
+#include <mutex>
 #include "MutablePriorityQueue.hpp"
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
 
 using namespace Slic3r;
 
@@ -87,6 +89,7 @@ namespace QuadricEdgeCollapse {
         bool is_deleted() const { return count == 0; }
     };
     using VertexInfos = std::vector<VertexInfo>;
+    using SymMats = std::vector<SymMat>;
     struct EdgeInfo {
         uint32_t t_index=0; // triangle index
         unsigned char edge = 0; // 0 or 1 or 2
@@ -115,8 +118,9 @@ namespace QuadricEdgeCollapse {
     // calculate error for vertex and quadrics, triangle quadrics and triangle vertex give zero, only pozitive number
     double vertex_error(const SymMat &q, const Vec3d &vertex);
     SymMat create_quadric(const Triangle &t, const Vec3d& n, const Vertices &vertices);
+    // when vertex_quadrics are set they are used instead of summing up the quadrics of the triangles
     std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-    init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
+    init(const indexed_triangle_set &its, const SymMats *vertex_quadrics, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
     std::optional<uint32_t> find_triangle_index1(uint32_t vi, const VertexInfo& v_info,
         uint32_t ti, const EdgeInfos& e_infos, const Indices& indices);
     void reorder_edges(EdgeInfos &e_infos, const VertexInfo &v_info, uint32_t ti0, uint32_t ti1);
@@ -133,7 +137,18 @@ namespace QuadricEdgeCollapse {
     void change_neighbors(EdgeInfos &e_infos, VertexInfos &v_infos, uint32_t ti0, uint32_t ti1,
                           uint32_t vi0, uint32_t vi1, uint32_t vi_top0,
                           const Triangle &t1, CopyEdgeInfos& infos, EdgeInfos &e_infos1);
-    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its);
+    // vertices with index smaller than frozen_count are kept even when they lost all triangles
+    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its,
+                 uint32_t frozen_count = 0, SymMats *vertex_quadrics = nullptr);
+
+    // Reduce its in place, return last collapsed error.
+    // Vertices with index smaller than frozen_count are never moved nor removed,
+    // edges touching them are not collapsed.
+    // vertex_quadrics - IN: quadrics accumulated by previous reduction (optional, empty means calculate),
+    //                   OUT: quadrics of the reduced vertices (optional)
+    float collapse(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                   uint32_t frozen_count, SymMats *vertex_quadrics,
+                   ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
 
 #ifdef EXPENSIVE_DEBUG_CHECKS
     void store_surround(const char *obj_filename, size_t triangle_index, int depth, const indexed_triangle_set &its,
@@ -153,6 +168,11 @@ namespace QuadricEdgeCollapse {
     const int status_set_offsets = 10;
     const int status_calc_errors = 30;
     const int status_create_refs = 10;
+
+    // parallel mode: count of triangles in one spatial cluster
+    const size_t parallel_cluster_size = 1 << 16;
+    // parts of status for reduction of cluster interiors, rest is for final pass over seams
+    const int status_clusters_size = 70; // in percents
     } // namespace QuadricEdgeCollapse
 
 using namespace QuadricEdgeCollapse;
@@ -171,6 +191,18 @@ void Slic3r::its_quadric_edge_collapse(
     if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
     if (status_fn == nullptr) status_fn = [](int) {};
 
+    float last_collapsed_error = collapse(its, triangle_count, maximal_error, 0, nullptr, throw_on_cancel, status_fn);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+float QuadricEdgeCollapse::collapse(indexed_triangle_set &its,
+                                    uint32_t              triangle_count,
+                                    float                 maximal_error,
+                                    uint32_t              frozen_count,
+                                    SymMats *             vertex_quadrics,
+                                    ThrowOnCancel &       throw_on_cancel,
+                                    StatusFn &            status_fn)
+{
     StatusFn init_status_fn = [&](int percent) {
         float n_percent = percent * status_init_size / 100.f;
         status_fn(static_cast<int>(std::round(n_percent)));
@@ -180,7 +212,9 @@ void Slic3r::its_quadric_edge_collapse(
     VertexInfos   v_infos;
     EdgeInfos     e_infos;
     Errors        errors;
-    std::tie(t_infos, v_infos, e_infos, errors) = init(its, throw_on_cancel, init_status_fn);
+    std::tie(t_infos, v_infos, e_infos, errors) = init(its, 
+        (vertex_quadrics != nullptr && !vertex_quadrics->empty()) ? vertex_quadrics : nullptr,
+        throw_on_cancel, init_status_fn);
     throw_on_cancel();
     status_fn(status_init_size);
 
@@ -247,15 +281,18 @@ void Slic3r::its_quadric_edge_collapse(
         Vec3f new_vertex0 = calculate_vertex(vi0, vi1, q, its.vertices);
         // set of triangle indices that change quadric
         uint32_t ti1 = -1; // triangle 1 index
-        auto ti1_opt = (v_info0.count < v_info1.count)?
-            find_triangle_index1(vi1, v_info0, ti0, e_infos, its.indices) :
-            find_triangle_index1(vi0, v_info1, ti0, e_infos, its.indices) ;
+        std::optional<uint32_t> ti1_opt;
+        // edge touching frozen vertex is never collapsed (vi0 is the smaller index)
+        if (vi0 >= frozen_count)
+            ti1_opt = (v_info0.count < v_info1.count)?
+                find_triangle_index1(vi1, v_info0, ti0, e_infos, its.indices) :
+                find_triangle_index1(vi0, v_info1, ti0, e_infos, its.indices) ;
         if (ti1_opt.has_value()) { 
             ti1 = *ti1_opt;
             reorder_edges(e_infos, v_info0, ti0, ti1);
             reorder_edges(e_infos, v_info1, ti0, ti1);
         }
-        if (!ti1_opt.has_value() || // edge has only one triangle
+        if (!ti1_opt.has_value() || // edge has only one triangle or it is frozen
             degenerate(vi0, ti0, ti1, v_info1, e_infos, its.indices) ||
             degenerate(vi1, ti0, ti1, v_info0, e_infos, its.indices) ||
             create_no_volume(vi0, vi1, ti0, ti1, v_info0, v_info1, e_infos, its.indices) ||
@@ -342,7 +379,175 @@ void Slic3r::its_quadric_edge_collapse(
     }
 
     // compact triangle
-    compact(v_infos, t_infos, e_infos, its);
+    compact(v_infos, t_infos, e_infos, its, frozen_count, vertex_quadrics);
+    return last_collapsed_error;
+}
+
+void Slic3r::its_quadric_edge_collapse_parallel(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count,
+    float *                   max_error,
+    std::function<void(void)> throw_on_cancel,
+    std::function<void(int)>  status_fn)
+{
+    // small mesh is not worth to split
+    if (its.indices.size() < 2 * parallel_cluster_size) {
+        its_quadric_edge_collapse(its, triangle_count, max_error, throw_on_cancel, status_fn);
+        return;
+    }
+    // check input
+    if (triangle_count >= its.indices.size()) return;
+    float maximal_error = (max_error == nullptr)? std::numeric_limits<float>::max() : *max_error;
+    if (maximal_error <= 0.f) return;
+    if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
+    if (status_fn == nullptr) status_fn = [](int) {};
+
+    // Sort triangles along Morton curve of their centroids,
+    // consecutive ranges of sorted triangles create spatial clusters.
+    Vec3f bb_min = its.vertices.front(), bb_max = its.vertices.front();
+    for (const Vec3f &v : its.vertices) {
+        bb_min = bb_min.cwiseMin(v);
+        bb_max = bb_max.cwiseMax(v);
+    }
+    const uint32_t grid_max = (1 << 10) - 1;
+    Vec3f scale = (bb_max - bb_min).cwiseMax(Vec3f::Constant(std::numeric_limits<float>::epsilon()))
+                      .cwiseInverse() * float(grid_max);
+    auto spread_bits = [](uint32_t x) {
+        x = (x | (x << 16)) & 0x030000FF;
+        x = (x | (x << 8))  & 0x0300F00F;
+        x = (x | (x << 4))  & 0x030C30C3;
+        x = (x | (x << 2))  & 0x09249249;
+        return x;
+    };
+    // pair of morton code and triangle index
+    std::vector<std::pair<uint32_t, uint32_t>> order(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const Triangle &t = its.indices[i];
+            Vec3f c = (its.vertices[t[0]] + its.vertices[t[1]] + its.vertices[t[2]]) / 3.f;
+            Vec3f g = ((c - bb_min).cwiseProduct(scale)).cwiseMax(Vec3f::Zero()).cwiseMin(Vec3f::Constant(float(grid_max)));
+            uint32_t code = spread_bits(uint32_t(g.x())) | (spread_bits(uint32_t(g.y())) << 1) | (spread_bits(uint32_t(g.z())) << 2);
+            order[i] = {code, uint32_t(i)};
+        }
+    }); // END parallel for
+    tbb::parallel_sort(order.begin(), order.end());
+    throw_on_cancel();
+
+    size_t cluster_count = its.indices.size() / parallel_cluster_size;
+    auto cluster_begin = [&](size_t ci) { return ci * its.indices.size() / cluster_count; };
+
+    // Vertex used by more clusters is frozen during reduction of cluster interiors.
+    const uint32_t not_used = std::numeric_limits<uint32_t>::max();
+    const uint32_t shared   = not_used - 1;
+    std::vector<uint32_t> vertex_cluster(its.vertices.size(), not_used);
+    for (size_t ci = 0; ci < cluster_count; ++ci)
+        for (size_t i = cluster_begin(ci); i < cluster_begin(ci + 1); ++i)
+            for (size_t j = 0; j < 3; ++j) {
+                uint32_t &vc = vertex_cluster[its.indices[order[i].second][j]];
+                if (vc == not_used) vc = uint32_t(ci);
+                else if (vc != ci) vc = shared;
+            }
+    // shared vertex -> index into reduced mesh, interior vertex -> index into cluster
+    std::vector<uint32_t> vertex_index(its.vertices.size(), not_used);
+    uint32_t shared_count = 0;
+    for (uint32_t vi = 0; vi < its.vertices.size(); ++vi)
+        if (vertex_cluster[vi] == shared) vertex_index[vi] = shared_count++;
+    throw_on_cancel();
+
+    struct Cluster
+    {
+        indexed_triangle_set its;
+        // shared vertices sorted by index, first in cluster vertices
+        std::vector<uint32_t> frozen;
+        SymMats quadrics;
+        float last_collapsed_error = 0.f;
+    };
+    std::vector<Cluster> clusters(cluster_count);
+    std::mutex status_mutex;
+    size_t reduced_triangle_count = 0;
+    StatusFn cluster_status_fn = [](int) {};
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, cluster_count, 1),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t ci = range.begin(); ci < range.end(); ++ci) {
+            Cluster &cluster = clusters[ci];
+            size_t begin = cluster_begin(ci), end = cluster_begin(ci + 1);
+            for (size_t i = begin; i < end; ++i)
+                for (size_t j = 0; j < 3; ++j) {
+                    uint32_t vi = its.indices[order[i].second][j];
+                    if (vertex_cluster[vi] == shared) cluster.frozen.push_back(vi);
+                }
+            sort_remove_duplicates(cluster.frozen);
+            for (uint32_t vi : cluster.frozen) cluster.its.vertices.push_back(its.vertices[vi]);
+
+            cluster.its.indices.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i) {
+                const Triangle &t = its.indices[order[i].second];
+                Triangle local;
+                for (size_t j = 0; j < 3; ++j) {
+                    uint32_t vi = t[j];
+                    if (vertex_cluster[vi] == shared) {
+                        local[j] = std::lower_bound(cluster.frozen.begin(), cluster.frozen.end(), vi) - cluster.frozen.begin();
+                    } else {
+                        if (vertex_index[vi] == not_used) {
+                            vertex_index[vi] = cluster.its.vertices.size();
+                            cluster.its.vertices.push_back(its.vertices[vi]);
+                        }
+                        local[j] = vertex_index[vi];
+                    }
+                }
+                cluster.its.indices.push_back(local);
+            }
+
+            // same ratio of reduction for each cluster
+            uint32_t cluster_triangle_count = uint32_t(double(end - begin) * triangle_count / its.indices.size());
+            cluster.last_collapsed_error = collapse(cluster.its, cluster_triangle_count, maximal_error,
+                uint32_t(cluster.frozen.size()), &cluster.quadrics, throw_on_cancel, cluster_status_fn);
+
+            std::lock_guard<std::mutex> lk(status_mutex);
+            reduced_triangle_count += end - begin;
+            status_fn(static_cast<int>(reduced_triangle_count * status_clusters_size / its.indices.size()));
+        }
+    }); // END parallel for
+    throw_on_cancel();
+
+    // Merge clusters, shared vertices are first and keep quadrics of all clusters.
+    indexed_triangle_set result;
+    SymMats quadrics(shared_count);
+    result.vertices.reserve(shared_count);
+    for (uint32_t vi = 0; vi < its.vertices.size(); ++vi)
+        if (vertex_cluster[vi] == shared) result.vertices.push_back(its.vertices[vi]);
+    float last_collapsed_error = 0.f;
+    for (Cluster &cluster : clusters) {
+        uint32_t frozen_count = uint32_t(cluster.frozen.size());
+        uint32_t offset = uint32_t(result.vertices.size()) - frozen_count;
+        for (uint32_t i = 0; i < frozen_count; ++i)
+            quadrics[vertex_index[cluster.frozen[i]]] += cluster.quadrics[i];
+        result.vertices.insert(result.vertices.end(), cluster.its.vertices.begin() + frozen_count, cluster.its.vertices.end());
+        quadrics.insert(quadrics.end(), cluster.quadrics.begin() + frozen_count, cluster.quadrics.end());
+        for (const Triangle &t : cluster.its.indices) {
+            Triangle merged;
+            for (size_t j = 0; j < 3; ++j)
+                merged[j] = (uint32_t(t[j]) < frozen_count) ? vertex_index[cluster.frozen[t[j]]] : offset + t[j];
+            result.indices.push_back(merged);
+        }
+        last_collapsed_error = std::max(last_collapsed_error, cluster.last_collapsed_error);
+        cluster = Cluster();
+    }
+    its = std::move(result);
+
+    // Final serial pass over the seams between clusters.
+    if (triangle_count < its.indices.size()) {
+        StatusFn final_status_fn = [&](int percent) {
+            status_fn(status_clusters_size + percent * (100 - status_clusters_size) / 100);
+        };
+        last_collapsed_error = std::max(last_collapsed_error,
+            collapse(its, triangle_count, maximal_error, 0, &quadrics, throw_on_cancel, final_status_fn));
+    } else {
+        // remove frozen vertices which lost all triangles
+        its_compactify_vertices(its);
+    }
+    status_fn(100);
     if (max_error != nullptr) *max_error = last_collapsed_error;
 }
 
@@ -438,13 +643,13 @@ SymMat QuadricEdgeCollapse::create_quadric(const Triangle &t,
 }
 
 std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
+QuadricEdgeCollapse::init(const indexed_triangle_set &its, const SymMats *vertex_quadrics, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
 {
     int status_offset = 0;
     TriangleInfos t_infos(its.indices.size());
     VertexInfos   v_infos(its.vertices.size());
     {
-        std::vector<SymMat> triangle_quadrics(its.indices.size());
+        SymMats triangle_quadrics(vertex_quadrics == nullptr ? its.indices.size() : 0);
         // calculate normals
         tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
         [&](const tbb::blocked_range<size_t> &range) {
@@ -453,7 +658,8 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
                 TriangleInfo &  t_info = t_infos[i];
                 Vec3d           normal = create_normal(t, its.vertices);
                 t_info.n = normal.cast<float>();
-                triangle_quadrics[i] = create_quadric(t, normal, its.vertices);
+                if (vertex_quadrics == nullptr)
+                    triangle_quadrics[i] = create_quadric(t, normal, its.vertices);
                 if (i % 1000000 == 0) {
                     throw_on_cancel();
                     status_fn(status_offset + (i * status_normal_size) / its.indices.size());
@@ -463,12 +669,17 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
         status_offset += status_normal_size;
 
         // sum quadrics
+        if (vertex_quadrics != nullptr) {
+            assert(vertex_quadrics->size() == v_infos.size());
+            for (size_t i = 0; i < v_infos.size(); i++)
+                v_infos[i].q = (*vertex_quadrics)[i];
+        }
         for (size_t i = 0; i < its.indices.size(); i++) {
             const Triangle &t = its.indices[i];
-            const SymMat &  q = triangle_quadrics[i];
             for (size_t e = 0; e < 3; e++) {
                 VertexInfo &v_info = v_infos[t[e]];
-                v_info.q += q;
+                if (vertex_quadrics == nullptr)
+                    v_info.q += triangle_quadrics[i];
                 ++v_info.count; // triangle count
             }
             if (i % 1000000 == 0) {
@@ -828,12 +1039,15 @@ void QuadricEdgeCollapse::change_neighbors(EdgeInfos &     e_infos,
 void QuadricEdgeCollapse::compact(const VertexInfos &   v_infos,
                                   const TriangleInfos & t_infos,
                                   const EdgeInfos &     e_infos,
-                                  indexed_triangle_set &its)
+                                  indexed_triangle_set &its,
+                                  uint32_t              frozen_count,
+                                  SymMats *             vertex_quadrics)
 {
+    if (vertex_quadrics != nullptr) vertex_quadrics->clear();
     uint32_t vi_new = 0;
     for (uint32_t vi = 0; vi < v_infos.size(); ++vi) {
         const VertexInfo &v_info = v_infos[vi];
-        if (v_info.is_deleted()) continue; // deleted
+        if (v_info.is_deleted() && vi >= frozen_count) continue; // deleted
         uint32_t e_info_end = v_info.start + v_info.count;
         for (uint32_t ei = v_info.start; ei < e_info_end; ++ei) { 
             const EdgeInfo &e_info = e_infos[ei];
@@ -842,6 +1056,7 @@ void QuadricEdgeCollapse::compact(const VertexInfos &   v_infos,
         }
         // compact vertices
         its.vertices[vi_new++] = its.vertices[vi];
+        if (vertex_quadrics != nullptr) vertex_quadrics->push_back(v_info.q);
     }
     // remove vertices tail
     its.vertices.erase(its.vertices.begin() + vi_new, its.vertices.end());
@@ -2,6 +2,7 @@
 #include "Concurrency.hpp"
 
 #include <libslic3r/AABBTreeIndirect.hpp>
+#include <libslic3r/AABBTreeCache.hpp>
 #include <libslic3r/TriangleMesh.hpp>
 
 #include <numeric>
@@ -16,7 +17,8 @@ namespace sla {
 
 class IndexedMesh::AABBImpl {
 private:
-    AABBTreeIndirect::Tree3f m_tree;
+    // Shared by the copies of IndexedMesh.
+    AABBTreeCache::TreePtr   m_tree;
     double                   m_triangle_ray_epsilon;
 
 public:
@@ -29,8 +31,8 @@ public:
             if (l > 0)
                 m_triangle_ray_epsilon = 0.000001 * l * l;
         }
-        m_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(
-            its.vertices, its.indices);
+        m_tree = std::make_shared<const AABBTreeIndirect::Tree3f>(
+            AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices));
     }
 
     void intersect_ray(const indexed_triangle_set &its,
@@ -39,7 +41,7 @@ public:
                        igl::Hit &                  hit)
     {
         AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices,
-                                                  m_tree, s, dir, hit, m_triangle_ray_epsilon);
+                                                  *m_tree, s, dir, hit, m_triangle_ray_epsilon);
     }
 
     void intersect_ray(const indexed_triangle_set &its,
@@ -48,7 +50,7 @@ public:
                        std::vector<igl::Hit> &     hits)
     {
         AABBTreeIndirect::intersect_ray_all_hits(its.vertices, its.indices,
-                                                 m_tree, s, dir, hits, m_triangle_ray_epsilon);
+                                                 *m_tree, s, dir, hits, m_triangle_ray_epsilon);
     }
 
     double squared_distance(const indexed_triangle_set & its,
@@ -60,7 +62,7 @@ public:
         Vec3d  closest_vec3d(closest);
         double dist =
             AABBTreeIndirect::squared_distance_to_indexed_triangle_set(
-                its.vertices, its.indices, m_tree, point, idx_unsigned,
+                its.vertices, its.indices, *m_tree, point, idx_unsigned,
                 closest_vec3d);
         i       = int(idx_unsigned);
         closest = closest_vec3d;
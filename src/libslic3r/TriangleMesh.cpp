@@ -226,6 +226,18 @@ bool TriangleMesh::from_stl(stl_file& stl, bool repair)
 
 bool TriangleMesh::ReadSTLFile(const char* input_file, bool repair, ImportstlProgressFn stlFn)
 { 
+    if (repair) {
+        // Binary STLs, which admesh would not need to repair, are indexed directly from the memory mapped file.
+        switch (load_stl_binary_indexed(input_file, this->its, stlFn)) {
+        case LoadStlIndexedResult::Loaded:
+            fill_initial_stats(this->its, this->m_stats);
+            return true;
+        case LoadStlIndexedResult::Cancelled:
+            return false;
+        case LoadStlIndexedResult::NotApplicable:
+            break;
+        }
+    }
     stl_file stl;
     if (! stl_open(&stl, input_file, stlFn))
         return false;
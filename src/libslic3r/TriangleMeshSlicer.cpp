@@ -14,13 +14,15 @@
 #include <algorithm>
 #include <cmath>
 #include <deque>
+#include <limits>
 #include <queue>
-#include <mutex>
 #include <utility>
 
 #include <boost/log/trivial.hpp>
 
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 
 #ifndef NDEBUG
 //    #define EXPENSIVE_DEBUG_CHECKS
@@ -35,8 +37,6 @@
 #endif
 
 #include <assert.h>
-#include <boost/thread/mutex.hpp>
-#include <boost/thread/lock_guard.hpp>
 
 // #define SLIC3R_DEBUG_SLICE_PROCESSING
 
@@ -476,7 +476,75 @@ static FacetSliceType slice_facet_for_cut_mesh(
     return FacetSliceType::NoSlice;
 }
 
-template<typename TransformVertex>
+// Collects IntersectionLines emitted by parallel workers into buckets (slices or slabs) without locking.
+// The faces are split into blocks of consecutive faces, each block appends (bucket, line) pairs into its own buffer.
+// The buffers are then scattered into the buckets in parallel: The lines are counted per block and bucket,
+// the counts are turned into offsets and the lines are copied to their final positions.
+// The lines of a bucket are thus ordered by the face index, independently of the number of threads.
+class IntersectionLineBuckets
+{
+public:
+    IntersectionLineBuckets(size_t num_faces, size_t num_buckets) : m_num_faces(num_faces), m_num_buckets(num_buckets)
+    {
+        // Enough blocks for load balancing, but not too many to keep the counts per block and bucket small.
+        size_t num_blocks = std::min((num_faces + 4095) / 4096, 8 * size_t(tbb::this_task_arena::max_concurrency()));
+        m_blocks.assign(std::max<size_t>(num_blocks, 1), {});
+    }
+
+    size_t  num_blocks() const { return m_blocks.size(); }
+    size_t  block_begin(size_t block_idx) const { return m_num_faces * block_idx / m_blocks.size(); }
+    size_t  block_end(size_t block_idx) const { return m_num_faces * (block_idx + 1) / m_blocks.size(); }
+
+    // To be called for a single block by a single thread at a time.
+    void    emit(size_t block_idx, size_t bucket, const IntersectionLine &il)
+    {
+        assert(bucket < m_num_buckets);
+        m_blocks[block_idx].emplace_back(uint32_t(bucket), il);
+    }
+
+    // Append the lines to the buckets, out_bucket(bucket) returns a reference to IntersectionLines of a bucket.
+    template<typename OutBucket>
+    void    scatter(OutBucket out_bucket)
+    {
+        // Number of lines per block and bucket, later the offsets of the block into the buckets.
+        std::vector<std::vector<uint32_t>> offsets(m_blocks.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_blocks.size(), 1), [this, &offsets](const tbb::blocked_range<size_t> &range) {
+            for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+                std::vector<uint32_t> &counts = offsets[block_idx];
+                counts.assign(m_num_buckets, 0);
+                for (const std::pair<uint32_t, IntersectionLine> &line : m_blocks[block_idx])
+                    ++ counts[line.first];
+            }
+        });
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_num_buckets), [this, &offsets, &out_bucket](const tbb::blocked_range<size_t> &range) {
+            for (size_t bucket = range.begin(); bucket < range.end(); ++ bucket) {
+                IntersectionLines &lines  = out_bucket(bucket);
+                size_t             offset = lines.size();
+                for (std::vector<uint32_t> &counts : offsets) {
+                    uint32_t cnt = counts[bucket];
+                    counts[bucket] = uint32_t(offset);
+                    offset += cnt;
+                }
+                lines.resize(offset);
+            }
+        });
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_blocks.size(), 1), [this, &offsets, &out_bucket](const tbb::blocked_range<size_t> &range) {
+            for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+                std::vector<uint32_t> &block_offsets = offsets[block_idx];
+                for (const std::pair<uint32_t, IntersectionLine> &line : m_blocks[block_idx])
+                    out_bucket(line.first)[block_offsets[line.first] ++] = line.second;
+                m_blocks[block_idx] = {};
+            }
+        });
+    }
+
+private:
+    size_t                                                          m_num_faces;
+    size_t                                                          m_num_buckets;
+    std::vector<std::vector<std::pair<uint32_t, IntersectionLine>>> m_blocks;
+};
+
+template<typename TransformVertex, typename EmitLine>
 void slice_facet_at_zs(
     // Scaled or unscaled vertices. transform_vertex_fn may scale zs.
     const std::vector<Vec3f>                         &mesh_vertices,
@@ -485,8 +553,8 @@ void slice_facet_at_zs(
     const Vec3i                                      &edge_ids,
     // Scaled or unscaled zs. If vertices have their zs scaled or transform_vertex_fn scales them, then zs have to be scaled as well.
     const std::vector<float>                         &zs,
-    std::vector<IntersectionLines>                   &lines,
-    std::array<std::mutex, 64>                       &lines_mutex)
+    // emit_line(slice_id, line)
+    const EmitLine                                   &emit_line)
 {
     stl_vertex vertices[3] { transform_vertex_fn(mesh_vertices[indices(0)]), transform_vertex_fn(mesh_vertices[indices(1)]), transform_vertex_fn(mesh_vertices[indices(2)]) };
 
@@ -504,9 +572,7 @@ void slice_facet_at_zs(
         // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
         if (min_z != max_z && slice_facet(*it, vertices, indices, edge_ids, idx_vertex_lowest, false, il) == FacetSliceType::Slicing) {
             assert(il.edge_type != IntersectionLine::FacetEdgeType::Horizontal);
-            size_t slice_id = it - zs.begin();
-            boost::lock_guard<std::mutex> l(lines_mutex[slice_id % lines_mutex.size()]);
-            lines[slice_id].emplace_back(il);
+            emit_line(size_t(it - zs.begin()), il);
         }
     }
 }
@@ -521,17 +587,22 @@ static inline std::vector<IntersectionLines> slice_make_lines(
     const ThrowOnCancel                              throw_on_cancel_fn)
 {
     std::vector<IntersectionLines>  lines(zs.size(), IntersectionLines());
-    std::array<std::mutex, 64>      lines_mutex;
+    IntersectionLineBuckets         buckets(indices.size(), zs.size());
     tbb::parallel_for(
-        tbb::blocked_range<int>(0, int(indices.size())),
-        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &zs, &lines, &lines_mutex, throw_on_cancel_fn](const tbb::blocked_range<int> &range) {
-            for (int face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
-                if ((face_idx & 0x0ffff) == 0)
-                    throw_on_cancel_fn();
-                slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], zs, lines, lines_mutex);
+        tbb::blocked_range<size_t>(0, buckets.num_blocks(), 1),
+        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &zs, &buckets, throw_on_cancel_fn](const tbb::blocked_range<size_t> &range) {
+            for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+                auto emit_line = [&buckets, block_idx](size_t slice_id, const IntersectionLine &il) { buckets.emit(block_idx, slice_id, il); };
+                for (size_t face_idx = buckets.block_begin(block_idx); face_idx < buckets.block_end(block_idx); ++ face_idx) {
+                    if ((face_idx & 0x0ffff) == 0)
+                        throw_on_cancel_fn();
+                    slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], zs, emit_line);
+                }
             }
         }
     );
+    throw_on_cancel_fn();
+    buckets.scatter([&lines](size_t slice_id) -> IntersectionLines& { return lines[slice_id]; });
     return lines;
 }
 
@@ -564,6 +635,44 @@ static inline IntersectionLines slice_make_lines(
     return lines;
 }
 
+// Slicing with MeshSlicingIndex: Each slicing plane visits just the faces crossing it, in the order of the face indices,
+// thus the intersection lines are the same as the ones produced by the variant above.
+template<typename ThrowOnCancel>
+static inline std::vector<IntersectionLines> slice_make_lines(
+    const MeshSlicingIndex                          &index,
+    const std::vector<float>                        &zs,
+    const ThrowOnCancel                              throw_on_cancel_fn)
+{
+    const std::vector<stl_vertex>                   &vertices      = index.vertices();
+    const std::vector<stl_triangle_vertex_indices>  &indices       = index.mesh().indices;
+    const std::vector<Vec3i>                        &face_edge_ids = index.face_edge_ids();
+    std::vector<IntersectionLines>                   lines(zs.size(), IntersectionLines());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, zs.size()),
+        [&index, &vertices, &indices, &face_edge_ids, &zs, &lines, throw_on_cancel_fn](const tbb::blocked_range<size_t> &range) {
+            std::vector<uint32_t> faces;
+            for (size_t slice_id = range.begin(); slice_id < range.end(); ++ slice_id) {
+                throw_on_cancel_fn();
+                const float slice_z = zs[slice_id];
+                index.faces_at(slice_z, faces);
+                IntersectionLines &slice_lines = lines[slice_id];
+                for (uint32_t face_idx : faces) {
+                    const stl_triangle_vertex_indices &face = indices[face_idx];
+                    stl_vertex  facet[3] { vertices[face(0)], vertices[face(1)], vertices[face(2)] };
+                    const float min_z = fminf(facet[0].z(), fminf(facet[1].z(), facet[2].z()));
+                    int         idx_vertex_lowest = (facet[1].z() == min_z) ? 1 : ((facet[2].z() == min_z) ? 2 : 0);
+                    IntersectionLine il;
+                    if (slice_facet(slice_z, facet, face, face_edge_ids[face_idx], idx_vertex_lowest, false, il) == FacetSliceType::Slicing) {
+                        assert(il.edge_type != IntersectionLine::FacetEdgeType::Horizontal);
+                        slice_lines.emplace_back(il);
+                    }
+                }
+            }
+        }
+    );
+    return lines;
+}
+
 // For projecting triangle sets onto slice slabs.
 struct SlabLines {
     // Intersection lines of a slice with a triangle set, CCW oriented.
@@ -587,7 +696,7 @@ enum class FaceOrientation : char {
     Degenerate
 };
 
-template<bool ProjectionFromTop>
+template<bool ProjectionFromTop, typename EmitAtSlice, typename EmitBetweenSlices>
 void slice_facet_with_slabs(
     // Scaled or unscaled vertices. transform_vertex_fn may scale zs.
     const std::vector<Vec3f>                         &mesh_vertices,
@@ -599,8 +708,9 @@ void slice_facet_with_slabs(
     // from bottom plane of the slab to the top plane of the slab and vice versa.
     const int                                         num_edges,
     const std::vector<float>                         &zs,
-    SlabLines                                        &lines,
-    std::array<std::mutex, 64>                       &lines_mutex)
+    // emit_at_slice(slice_id, line) for SlabLines::at_slice, emit_between_slices(slab_id, line) for SlabLines::between_slices
+    const EmitAtSlice                                &emit_at_slice,
+    const EmitBetweenSlices                          &emit_between_slices)
 {
     const stl_triangle_vertex_indices &indices = mesh_triangles[facet_idx];
     stl_vertex vertices[3] { mesh_vertices[indices(0)], mesh_vertices[indices(1)], mesh_vertices[indices(2)] };
@@ -616,11 +726,10 @@ void slice_facet_with_slabs(
     assert(min_layer == zs.end() ? max_layer == zs.end() : *min_layer >= min_z);
     assert(max_layer == zs.end() || *max_layer > max_z);
 
-    auto emit_slab_edge = [&lines, &lines_mutex](IntersectionLine il, size_t slab_id, bool reverse) {
+    auto emit_slab_edge = [&emit_between_slices](IntersectionLine il, size_t slab_id, bool reverse) {
         if (reverse)
             il.reverse();
-        boost::lock_guard<std::mutex> l(lines_mutex[(slab_id + lines_mutex.size() / 2) % lines_mutex.size()]);
-        lines.between_slices[slab_id].emplace_back(il);
+        emit_between_slices(slab_id, il);
     };
 
     if (min_layer == max_layer || horizontal) {
@@ -640,7 +749,7 @@ void slice_facet_with_slabs(
 #else
             // Project the coplanar bottom facing triangles to the plane above the slicing plane to match the behavior of slice_mesh() / slice_mesh_ex(),
             // where the slicing plane slices the top facing surfaces, but misses the bottom facing surfaces.
-            if (size_t line_id = ProjectionFromTop ? slice_id : slice_id + 1; ProjectionFromTop || line_id < lines.at_slice.size())
+            if (size_t line_id = ProjectionFromTop ? slice_id : slice_id + 1; ProjectionFromTop || line_id < zs.size())
 #endif
                 for (int iedge = 0; iedge < 3; ++ iedge)
                     if (facet_neighbors(iedge) == -1) {
@@ -655,8 +764,7 @@ void slice_facet_with_slabs(
                         };
                         // Don't flip the FacetEdgeType::Top edge, it will be flipped when chaining.
                         // if (! ProjectionFromTop) il.reverse();
-                        boost::lock_guard<std::mutex> l(lines_mutex[line_id % lines_mutex.size()]);
-                        lines.at_slice[line_id].emplace_back(il);
+                        emit_at_slice(line_id, il);
                     }
         } else {
             // Triangle is completely between two slicing planes, the triangle may or may not be horizontal, which 
@@ -773,9 +881,7 @@ void slice_facet_with_slabs(
                 if (type == FacetSliceType::Slicing) {
                     if (! ProjectionFromTop)
                         il.reverse();
-                    size_t line_id = it - zs.begin();
-                    boost::lock_guard<std::mutex> l(lines_mutex[line_id % lines_mutex.size()]);
-                    lines.at_slice[line_id].emplace_back(il);
+                    emit_at_slice(size_t(it - zs.begin()), il);
                 }
             }
             if (! ProjectionFromTop || it != zs.begin()) {
@@ -929,8 +1035,9 @@ inline std::pair<SlabLines, SlabLines> slice_slabs_make_lines(
     std::pair<SlabLines, SlabLines> out;
     SlabLines   &lines_top      = out.first;
     SlabLines   &lines_bottom   = out.second;
-    std::array<std::mutex, 64> lines_mutex_top;
-    std::array<std::mutex, 64> lines_mutex_bottom;
+    // Buckets [0, zs.size()) collect SlabLines::at_slice, buckets [zs.size(), 2 * zs.size()) collect SlabLines::between_slices.
+    IntersectionLineBuckets buckets_top(top ? indices.size() : 0, 2 * zs.size());
+    IntersectionLineBuckets buckets_bottom(bottom ? indices.size() : 0, 2 * zs.size());
 
     if (top) {
         lines_top.at_slice.assign(zs.size(), IntersectionLines());
@@ -941,41 +1048,60 @@ inline std::pair<SlabLines, SlabLines> slice_slabs_make_lines(
         lines_bottom.between_slices.assign(zs.size(), IntersectionLines());        
     }
 
+    // Both top and bottom use the same blocks of faces, as both are created for the same number of faces if enabled.
+    const IntersectionLineBuckets &blocks = top ? buckets_top : buckets_bottom;
     tbb::parallel_for(
-        tbb::blocked_range<int>(0, int(indices.size())),
-        [&vertices, &indices, &face_neighbors, &face_edge_ids, num_edges, &face_orientation, &zs, top, bottom, &lines_top, &lines_bottom, &lines_mutex_top, &lines_mutex_bottom, throw_on_cancel_fn]
-        (const tbb::blocked_range<int> &range) {
-            for (int face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
-                if ((face_idx & 0x0ffff) == 0)
-                    throw_on_cancel_fn();
-                FaceOrientation fo       = face_orientation[face_idx];
-                Vec3i           edge_ids = face_edge_ids[face_idx];
-                if (top && (fo == FaceOrientation::Up || fo == FaceOrientation::Degenerate)) {
-                    Vec3i neighbors = face_neighbors[face_idx];
-                    // Reset neighborship of this triangle in case the other triangle is oriented backwards from this one.
-                    for (int i = 0; i < 3; ++ i)
-                        if (neighbors(i) != -1) {
-                            FaceOrientation fo2 = face_orientation[neighbors(i)];
-                            if (fo2 != FaceOrientation::Up && fo2 != FaceOrientation::Degenerate)
-                                neighbors(i) = -1;
-                        }
-                    slice_facet_with_slabs<true>(vertices, indices, face_idx, neighbors, edge_ids, num_edges, zs, lines_top, lines_mutex_top);
-                }
-                // BBS: add vertical faces option
-                if (bottom && (fo == FaceOrientation::Down || fo == FaceOrientation::Degenerate)) {
-                    Vec3i neighbors = face_neighbors[face_idx];
-                    // Reset neighborship of this triangle in case the other triangle is oriented backwards from this one.
-                    for (int i = 0; i < 3; ++ i)
-                        if (neighbors(i) != -1) {
-                            FaceOrientation fo2 = face_orientation[neighbors(i)];
-                            if (fo2 != FaceOrientation::Down && fo2 != FaceOrientation::Degenerate)
-                                neighbors(i) = -1;
-                        }
-                    slice_facet_with_slabs<false>(vertices, indices, face_idx, neighbors, edge_ids, num_edges, zs, lines_bottom, lines_mutex_bottom);
+        tbb::blocked_range<size_t>(0, blocks.num_blocks(), 1),
+        [&vertices, &indices, &face_neighbors, &face_edge_ids, num_edges, &face_orientation, &zs, top, bottom, &blocks, &buckets_top, &buckets_bottom, throw_on_cancel_fn]
+        (const tbb::blocked_range<size_t> &range) {
+            for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+                const size_t num_slices = zs.size();
+                auto emit_top_at_slice           = [&buckets_top, block_idx](size_t slice_id, const IntersectionLine &il) { buckets_top.emit(block_idx, slice_id, il); };
+                auto emit_top_between_slices     = [&buckets_top, block_idx, num_slices](size_t slab_id, const IntersectionLine &il) { buckets_top.emit(block_idx, num_slices + slab_id, il); };
+                auto emit_bottom_at_slice        = [&buckets_bottom, block_idx](size_t slice_id, const IntersectionLine &il) { buckets_bottom.emit(block_idx, slice_id, il); };
+                auto emit_bottom_between_slices  = [&buckets_bottom, block_idx, num_slices](size_t slab_id, const IntersectionLine &il) { buckets_bottom.emit(block_idx, num_slices + slab_id, il); };
+                for (size_t face_idx = blocks.block_begin(block_idx); face_idx < blocks.block_end(block_idx); ++ face_idx) {
+                    if ((face_idx & 0x0ffff) == 0)
+                        throw_on_cancel_fn();
+                    FaceOrientation fo       = face_orientation[face_idx];
+                    Vec3i           edge_ids = face_edge_ids[face_idx];
+                    if (top && (fo == FaceOrientation::Up || fo == FaceOrientation::Degenerate)) {
+                        Vec3i neighbors = face_neighbors[face_idx];
+                        // Reset neighborship of this triangle in case the other triangle is oriented backwards from this one.
+                        for (int i = 0; i < 3; ++ i)
+                            if (neighbors(i) != -1) {
+                                FaceOrientation fo2 = face_orientation[neighbors(i)];
+                                if (fo2 != FaceOrientation::Up && fo2 != FaceOrientation::Degenerate)
+                                    neighbors(i) = -1;
+                            }
+                        slice_facet_with_slabs<true>(vertices, indices, face_idx, neighbors, edge_ids, num_edges, zs, emit_top_at_slice, emit_top_between_slices);
+                    }
+                    // BBS: add vertical faces option
+                    if (bottom && (fo == FaceOrientation::Down || fo == FaceOrientation::Degenerate)) {
+                        Vec3i neighbors = face_neighbors[face_idx];
+                        // Reset neighborship of this triangle in case the other triangle is oriented backwards from this one.
+                        for (int i = 0; i < 3; ++ i)
+                            if (neighbors(i) != -1) {
+                                FaceOrientation fo2 = face_orientation[neighbors(i)];
+                                if (fo2 != FaceOrientation::Down && fo2 != FaceOrientation::Degenerate)
+                                    neighbors(i) = -1;
+                            }
+                        slice_facet_with_slabs<false>(vertices, indices, face_idx, neighbors, edge_ids, num_edges, zs, emit_bottom_at_slice, emit_bottom_between_slices);
+                    }
                 }
             }
         }
     );
+    throw_on_cancel_fn();
+    auto slab_bucket = [&zs](SlabLines &lines) {
+        return [&zs, &lines](size_t bucket) -> IntersectionLines& {
+            return bucket < zs.size() ? lines.at_slice[bucket] : lines.between_slices[bucket - zs.size()];
+        };
+    };
+    if (top)
+        buckets_top.scatter(slab_bucket(lines_top));
+    if (bottom)
+        buckets_bottom.scatter(slab_bucket(lines_bottom));
     return out;
 }
 
@@ -1866,6 +1992,133 @@ static std::vector<stl_vertex> transform_mesh_vertices_for_slicing(const indexed
     return out;
 }
 
+struct MeshSlicingIndex::SlabData
+{
+    std::vector<FaceOrientation>    face_orientation;
+    std::vector<Vec3i>              face_neighbors;
+    // Unique IDs of all edges including the unbound ones, see its_face_edge_ids(mesh, face_neighbors, true, &num_edges).
+    std::vector<Vec3i>              face_edge_ids;
+    int                             num_edges { 0 };
+};
+
+MeshSlicingIndex::MeshSlicingIndex(const indexed_triangle_set &mesh, const Transform3d &trafo) :
+    m_mesh(&mesh), m_trafo(trafo), m_vertices(transform_mesh_vertices_for_slicing(mesh, trafo))
+{}
+
+MeshSlicingIndex::MeshSlicingIndex(std::shared_ptr<const indexed_triangle_set> mesh, const Transform3d &trafo) :
+    m_mesh(mesh.get()), m_mesh_shared(std::move(mesh)), m_trafo(trafo), m_vertices(transform_mesh_vertices_for_slicing(*m_mesh, trafo))
+{}
+
+MeshSlicingIndex::~MeshSlicingIndex() = default;
+
+const std::vector<Vec3i>& MeshSlicingIndex::face_edge_ids() const
+{
+    std::call_once(m_face_edge_ids_once, [this]() { m_face_edge_ids = its_face_edge_ids(*m_mesh); });
+    return m_face_edge_ids;
+}
+
+void MeshSlicingIndex::build_z_sorted_faces() const
+{
+    std::call_once(m_z_sorted_once, [this]() {
+        // Faces are split into classes by their Z extent rounded up to a power of two multiple of base_extent,
+        // so that the faces crossing a plane are found in a single range of each class sorted by the minimum Z.
+        static constexpr const double   base_extent = 0.001;
+        static constexpr const int      num_classes = 32;
+        static constexpr const uint8_t  horizontal  = 0xff;
+        const std::vector<stl_triangle_vertex_indices> &indices = m_mesh->indices;
+        std::vector<uint8_t> face_class(indices.size(), horizontal);
+        m_face_z_span.assign(indices.size(), Vec2f::Zero());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, indices.size()), [this, &indices, &face_class](const tbb::blocked_range<size_t> &range) {
+            for (size_t face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
+                const stl_triangle_vertex_indices &face = indices[face_idx];
+                const float z[3]  { m_vertices[face(0)].z(), m_vertices[face(1)].z(), m_vertices[face(2)].z() };
+                const float min_z = fminf(z[0], fminf(z[1], z[2]));
+                const float max_z = fmaxf(z[0], fmaxf(z[1], z[2]));
+                m_face_z_span[face_idx] = Vec2f(min_z, max_z);
+                // Horizontal faces are never sliced by slice_mesh().
+                if (min_z != max_z) {
+                    int exponent;
+                    std::frexp((double(max_z) - double(min_z)) / base_extent, &exponent);
+                    face_class[face_idx] = uint8_t(std::clamp(exponent, 0, num_classes - 1));
+                }
+            }
+        });
+
+        std::vector<std::vector<std::pair<float, uint32_t>>> classes(num_classes);
+        std::vector<double>                                  max_extents(num_classes, 0.);
+        for (size_t face_idx = 0; face_idx < indices.size(); ++ face_idx)
+            if (uint8_t cls = face_class[face_idx]; cls != horizontal) {
+                const Vec2f &span = m_face_z_span[face_idx];
+                classes[cls].emplace_back(span.x(), uint32_t(face_idx));
+                max_extents[cls] = std::max(max_extents[cls], double(span.y()) - double(span.x()));
+            }
+        for (int cls = 0; cls < num_classes; ++ cls)
+            if (! classes[cls].empty()) {
+                std::vector<std::pair<float, uint32_t>> &faces = classes[cls];
+                tbb::parallel_sort(faces.begin(), faces.end());
+                ExtentClass &out = m_extent_classes.emplace_back();
+                out.max_extent = max_extents[cls];
+                out.min_z.reserve(faces.size());
+                out.faces.reserve(faces.size());
+                for (const std::pair<float, uint32_t> &face : faces) {
+                    out.min_z.emplace_back(face.first);
+                    out.faces.emplace_back(face.second);
+                }
+                faces = {};
+            }
+    });
+}
+
+void MeshSlicingIndex::faces_at(float z, std::vector<uint32_t> &out) const
+{
+    this->build_z_sorted_faces();
+    out.clear();
+    for (const ExtentClass &cls : m_extent_classes) {
+        // All faces of this class reaching z start above z - max_extent. Step one ulp down to compensate for the rounding to float.
+        const float min_z_lower = std::nextafter(float(double(z) - cls.max_extent), - std::numeric_limits<float>::infinity());
+        auto        it_begin    = std::lower_bound(cls.min_z.begin(), cls.min_z.end(), min_z_lower);
+        auto        it_end      = std::upper_bound(it_begin, cls.min_z.end(), z);
+        for (auto it = it_begin; it != it_end; ++ it)
+            if (uint32_t face_idx = cls.faces[it - cls.min_z.begin()]; m_face_z_span[face_idx].y() >= z)
+                out.emplace_back(face_idx);
+    }
+    std::sort(out.begin(), out.end());
+}
+
+const MeshSlicingIndex::SlabData& MeshSlicingIndex::slab_data() const
+{
+    std::call_once(m_slab_data_once, [this]() {
+        auto       data          = std::make_unique<SlabData>();
+        const auto mirrored_sign = int64_t(m_trafo.matrix().block(0, 0, 3, 3).determinant() < 0 ? -1 : 1);
+        data->face_orientation.assign(m_mesh->indices.size(), FaceOrientation::Up);
+        for (const stl_triangle_vertex_indices &tri : m_mesh->indices) {
+            const Vec3f   fa = m_vertices[tri(0)];
+            const Vec3f   fb = m_vertices[tri(1)];
+            const Vec3f   fc = m_vertices[tri(2)];
+            assert(fa != fb && fa != fc && fb != fc);
+            const Point   a = to_2d(fa).cast<coord_t>();
+            const Point   b = to_2d(fb).cast<coord_t>();
+            const Point   c = to_2d(fc).cast<coord_t>();
+            const int64_t d = cross2((b - a).cast<int64_t>(), (c - b).cast<int64_t>()) * mirrored_sign;
+            FaceOrientation fo = FaceOrientation::Vertical;
+            if (d > 0)
+                fo = FaceOrientation::Up;
+            else if (d < 0)
+                fo = FaceOrientation::Down;
+            else {
+                // Is the triangle vertical or degenerate?
+                assert(d == 0);
+                fo = fa == fb || fa == fc || fb == fc ? FaceOrientation::Degenerate : FaceOrientation::Vertical;
+            }
+            data->face_orientation[&tri - m_mesh->indices.data()] = fo;
+        }
+        data->face_neighbors = its_face_neighbors_par(*m_mesh);
+        data->face_edge_ids  = its_face_edge_ids(*m_mesh, data->face_neighbors, true, &data->num_edges);
+        m_slab_data = std::move(data);
+    });
+    return *m_slab_data;
+}
+
 std::vector<Polygons> slice_mesh(
     const indexed_triangle_set       &mesh,
     // Unscaled Zs
@@ -1942,6 +2195,20 @@ std::vector<Polygons> slice_mesh(
     return layers;
 }
 
+std::vector<Polygons> slice_mesh(
+    const MeshSlicingIndex           &index,
+    // Unscaled Zs
+    const std::vector<float>         &zs,
+    const MeshSlicingParams          &params,
+    std::function<void()>             throw_on_cancel)
+{
+    BOOST_LOG_TRIVIAL(debug) << "slice_mesh to polygons with a slicing index";
+
+    std::vector<IntersectionLines> lines = slice_make_lines(index, zs, throw_on_cancel);
+    throw_on_cancel();
+    return make_loops(lines, params, throw_on_cancel);
+}
+
 // Specialized version for a single slicing plane only, running on a single thread.
 Polygons slice_mesh(
     const indexed_triangle_set       &mesh,
@@ -2005,22 +2272,22 @@ Polygons slice_mesh(
     return layers.front();
 }
 
-std::vector<ExPolygons> slice_mesh_ex(
-    const indexed_triangle_set       &mesh,
-    const std::vector<float>         &zs,
+// PositiveLargestContour is applied by slice_mesh_ex() to the expolygons, slice the polygons as Positive.
+static inline MeshSlicingParams slicing_params_for_expolygons(const MeshSlicingParamsEx &params)
+{
+    MeshSlicingParams slicing_params(params);
+    if (params.mode == MeshSlicingParams::SlicingMode::PositiveLargestContour)
+        slicing_params.mode = MeshSlicingParams::SlicingMode::Positive;
+    if (params.mode_below == MeshSlicingParams::SlicingMode::PositiveLargestContour)
+        slicing_params.mode_below = MeshSlicingParams::SlicingMode::Positive;
+    return slicing_params;
+}
+
+static std::vector<ExPolygons> make_expolygons_from_slices(
+    const std::vector<Polygons>      &layers_p,
     const MeshSlicingParamsEx        &params,
-    std::function<void()>             throw_on_cancel)
+    const std::function<void()>      &throw_on_cancel)
 {
-    std::vector<Polygons> layers_p;
-    {
-        MeshSlicingParams slicing_params(params);
-        if (params.mode == MeshSlicingParams::SlicingMode::PositiveLargestContour)
-            slicing_params.mode = MeshSlicingParams::SlicingMode::Positive;
-        if (params.mode_below == MeshSlicingParams::SlicingMode::PositiveLargestContour)
-            slicing_params.mode_below = MeshSlicingParams::SlicingMode::Positive;
-        layers_p = slice_mesh(mesh, zs, slicing_params, throw_on_cancel);
-    }
-    
 //    BOOST_LOG_TRIVIAL(debug) << "slice_mesh make_expolygons in parallel - start";
     std::vector<ExPolygons> layers(layers_p.size(), ExPolygons{});
     tbb::parallel_for(
@@ -2054,6 +2321,24 @@ std::vector<ExPolygons> slice_mesh_ex(
     return layers;
 }
 
+std::vector<ExPolygons> slice_mesh_ex(
+    const indexed_triangle_set       &mesh,
+    const std::vector<float>         &zs,
+    const MeshSlicingParamsEx        &params,
+    std::function<void()>             throw_on_cancel)
+{
+    return make_expolygons_from_slices(slice_mesh(mesh, zs, slicing_params_for_expolygons(params), throw_on_cancel), params, throw_on_cancel);
+}
+
+std::vector<ExPolygons> slice_mesh_ex(
+    const MeshSlicingIndex           &index,
+    const std::vector<float>         &zs,
+    const MeshSlicingParamsEx        &params,
+    std::function<void()>             throw_on_cancel)
+{
+    return make_expolygons_from_slices(slice_mesh(index, zs, slicing_params_for_expolygons(params), throw_on_cancel), params, throw_on_cancel);
+}
+
 // Slice a triangle set with a set of Z slabs (thick layers).
 // The effect is similar to producing the usual top / bottom layers from a sliced mesh by 
 // subtracting layer[i] from layer[i - 1] for the top surfaces resp.
@@ -2115,45 +2400,28 @@ void slice_mesh_slabs(
     }
 #endif // EXPENSIVE_DEBUG_CHECKS
 
-    std::vector<stl_vertex> vertices_transformed = transform_mesh_vertices_for_slicing(mesh, trafo);
-    const auto mirrored_sign = int64_t(trafo.matrix().block(0, 0, 3, 3).determinant() < 0 ? -1 : 1);
-
-    std::vector<FaceOrientation> face_orientation(mesh.indices.size(), FaceOrientation::Up);
-    for (const stl_triangle_vertex_indices &tri : mesh.indices) {
-        const Vec3f   fa = vertices_transformed[tri(0)];
-        const Vec3f   fb = vertices_transformed[tri(1)];
-        const Vec3f   fc = vertices_transformed[tri(2)];
-        assert(fa != fb && fa != fc && fb != fc);
-        const Point   a = to_2d(fa).cast<coord_t>();
-        const Point   b = to_2d(fb).cast<coord_t>();
-        const Point   c = to_2d(fc).cast<coord_t>();
-        const int64_t d = cross2((b - a).cast<int64_t>(), (c - b).cast<int64_t>()) * mirrored_sign;
-        FaceOrientation fo = FaceOrientation::Vertical;
-        if (d > 0)
-            fo = FaceOrientation::Up;
-        else if (d < 0)
-            fo = FaceOrientation::Down;
-        else {
-            // Is the triangle vertical or degenerate?
-            assert(d == 0);
-            fo = fa == fb || fa == fc || fb == fc ? FaceOrientation::Degenerate : FaceOrientation::Vertical;
-        }
-        face_orientation[&tri - mesh.indices.data()] = fo;
-    }
+    slice_mesh_slabs(MeshSlicingIndex(mesh, trafo), zs, out_top, out_bottom, throw_on_cancel);
+}
 
-    std::vector<Vec3i> face_neighbors = its_face_neighbors_par(mesh);
-    int                num_edges;
-    std::vector<Vec3i> face_edge_ids  = its_face_edge_ids(mesh, face_neighbors, true, &num_edges);
+void slice_mesh_slabs(
+    const MeshSlicingIndex           &index,
+    // Unscaled Zs
+    const std::vector<float>         &zs,
+    std::vector<Polygons>            *out_top,
+    std::vector<Polygons>            *out_bottom,
+    std::function<void()>             throw_on_cancel)
+{
+    const MeshSlicingIndex::SlabData &slab_data = index.slab_data();
     std::pair<SlabLines, SlabLines> lines = slice_slabs_make_lines(
-        vertices_transformed, mesh.indices, face_neighbors, face_edge_ids, num_edges, face_orientation, zs, 
+        index.vertices(), index.mesh().indices, slab_data.face_neighbors, slab_data.face_edge_ids, slab_data.num_edges, slab_data.face_orientation, zs, 
         out_top != nullptr, out_bottom != nullptr, throw_on_cancel);
 
     throw_on_cancel();
 
     if (out_top)
-        *out_top = make_slab_loops<true>(lines.first, num_edges, throw_on_cancel);
+        *out_top = make_slab_loops<true>(lines.first, slab_data.num_edges, throw_on_cancel);
     if (out_bottom)
-        *out_bottom = make_slab_loops<false>(lines.second, num_edges, throw_on_cancel);
+        *out_bottom = make_slab_loops<false>(lines.second, slab_data.num_edges, throw_on_cancel);
 }
 
 // Remove duplicates of slice_vertices, optionally triangulate the cut.
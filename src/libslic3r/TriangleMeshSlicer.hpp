@@ -6,6 +6,8 @@
 #define slic3r_TriangleMeshSlicer_hpp_
 
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include "Polygon.hpp"
 #include "ExPolygon.hpp"
@@ -50,6 +52,60 @@ struct MeshSlicingParamsEx : public MeshSlicingParams
     double        resolution { 0 };
 };
 
+// Acceleration structure for slicing a single mesh with a single transformation repeatedly, for example when reslicing
+// an object after its layer height profile changed, see ModelVolume::slicing_index().
+// Holds the transformed vertices, the edge IDs for chaining the intersection lines and the faces sorted by their minimum Z
+// in classes of a similar Z extent, so that slicing at a plane only visits the faces crossing that plane instead of all faces.
+// The data needed by slice_mesh() resp. slice_mesh_slabs() is calculated on first use. The methods are thread safe.
+class MeshSlicingIndex
+{
+public:
+    // The mesh is referenced, it has to outlive the index.
+    MeshSlicingIndex(const indexed_triangle_set &mesh, const Transform3d &trafo);
+    // The index shares the ownership of the mesh.
+    MeshSlicingIndex(std::shared_ptr<const indexed_triangle_set> mesh, const Transform3d &trafo);
+    MeshSlicingIndex(const MeshSlicingIndex &) = delete;
+    ~MeshSlicingIndex();
+    MeshSlicingIndex& operator=(const MeshSlicingIndex &) = delete;
+
+    const indexed_triangle_set&     mesh() const { return *m_mesh; }
+    const Transform3d&              trafo() const { return m_trafo; }
+    bool                            matches(const Transform3d &trafo) const { return m_trafo.matrix() == trafo.matrix(); }
+    // Vertices of the mesh transformed by trafo, scaled in XY, not scaled in Z.
+    const std::vector<stl_vertex>&  vertices() const { return m_vertices; }
+    // Edge IDs of the faces as calculated by its_face_edge_ids(mesh).
+    const std::vector<Vec3i>&       face_edge_ids() const;
+    // Indices of the non-horizontal faces crossing or touching the plane at unscaled z, sorted by the face index.
+    void                            faces_at(float z, std::vector<uint32_t> &out) const;
+
+    // Face orientation, neighbors and edge IDs for slice_mesh_slabs(), defined in TriangleMeshSlicer.cpp.
+    struct SlabData;
+    const SlabData&                 slab_data() const;
+
+private:
+    void                            build_z_sorted_faces() const;
+
+    const indexed_triangle_set                     *m_mesh;
+    std::shared_ptr<const indexed_triangle_set>     m_mesh_shared;
+    Transform3d                                     m_trafo;
+    std::vector<stl_vertex>                         m_vertices;
+
+    // Non-horizontal faces with a Z extent up to max_extent, sorted by their minimum Z.
+    struct ExtentClass {
+        double                                      max_extent { 0. };
+        std::vector<float>                          min_z;
+        std::vector<uint32_t>                       faces;
+    };
+    mutable std::once_flag                          m_z_sorted_once;
+    // Minimum and maximum Z of each face.
+    mutable std::vector<Vec2f>                      m_face_z_span;
+    mutable std::vector<ExtentClass>                m_extent_classes;
+    mutable std::once_flag                          m_face_edge_ids_once;
+    mutable std::vector<Vec3i>                      m_face_edge_ids;
+    mutable std::once_flag                          m_slab_data_once;
+    mutable std::unique_ptr<SlabData>               m_slab_data;
+};
+
 // All the following slicing functions shall produce consistent results with the same mesh, same transformation matrix and slicing parameters.
 // Namely, slice_mesh_slabs() shall produce consistent results with slice_mesh() and slice_mesh_ex() in the sense, that projections made by 
 // slice_mesh_slabs() shall fall onto slicing planes produced by slice_mesh().
@@ -67,6 +123,14 @@ std::vector<Polygons>           slice_mesh(
     const MeshSlicingParams          &params,
     std::function<void()>             throw_on_cancel = []{});
 
+// Slicing with a prebuilt index, MeshSlicingParams::trafo is ignored in favor of MeshSlicingIndex::trafo().
+// Produces the same intersection lines as slicing the mesh of the index, while visiting just the faces crossing each plane.
+std::vector<Polygons>           slice_mesh(
+    const MeshSlicingIndex           &index,
+    const std::vector<float>         &zs,
+    const MeshSlicingParams          &params,
+    std::function<void()>             throw_on_cancel = []{});
+
 // Specialized version for a single slicing plane only, running on a single thread.
 Polygons                        slice_mesh(
     const indexed_triangle_set       &mesh,
@@ -79,6 +143,12 @@ std::vector<ExPolygons>         slice_mesh_ex(
     const MeshSlicingParamsEx        &params,
     std::function<void()>             throw_on_cancel = []{});
 
+std::vector<ExPolygons>         slice_mesh_ex(
+    const MeshSlicingIndex           &index,
+    const std::vector<float>         &zs,
+    const MeshSlicingParamsEx        &params,
+    std::function<void()>             throw_on_cancel = []{});
+
 inline std::vector<ExPolygons>  slice_mesh_ex(
     const indexed_triangle_set       &mesh,
     const std::vector<float>         &zs,
@@ -113,6 +183,15 @@ void slice_mesh_slabs(
     std::vector<Polygons>            *out_bottom,
     std::function<void()>             throw_on_cancel);
 
+// Same as above with a prebuilt index, slicing the mesh of the index transformed by MeshSlicingIndex::trafo().
+void slice_mesh_slabs(
+    const MeshSlicingIndex           &index,
+    // Unscaled Zs
+    const std::vector<float>         &zs,
+    std::vector<Polygons>            *out_top,
+    std::vector<Polygons>            *out_bottom,
+    std::function<void()>             throw_on_cancel);
+
 // Project mesh upwards pointing surfaces / downwards pointing surfaces into 2D polygons.
 void project_mesh(
     const indexed_triangle_set       &mesh,
@@ -90,6 +90,8 @@ extern std::string log_memory_info(bool ignore_loglevel = false);
 extern void disable_multi_threading();
 // Returns the size of physical memory (RAM) in bytes.
 extern size_t total_physical_memory();
+// Returns the resident memory of this process in bytes, zero if not available.
+extern size_t current_process_memory();
 
 // Set a path with GUI resource files.
 void set_var_dir(const std::string &path);
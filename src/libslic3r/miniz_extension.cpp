@@ -8,6 +8,13 @@
 
 #include "I18N.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+
 //! macro used to mark string used at localization,
 //! return same string
 #define L(s) Slic3r::I18N::translate(s)
@@ -76,6 +83,122 @@ bool open_zip_writer(mz_zip_archive *zip, const std::string &fname)
 bool close_zip_reader(mz_zip_archive *zip) { return close_zip(zip, true); }
 bool close_zip_writer(mz_zip_archive *zip) { return close_zip(zip, false); }
 
+namespace {
+// CRC32 of two concatenated blocks from the CRC32 of the blocks, the second block being len2 long.
+// Multiplication by the CRC polynomial in GF(2), as crc32_combine() of zlib, which miniz is missing.
+mz_uint32 gf2_matrix_times(const mz_uint32 *mat, mz_uint32 vec)
+{
+    mz_uint32 sum = 0;
+    for (; vec; vec >>= 1, ++ mat)
+        if (vec & 1)
+            sum ^= *mat;
+    return sum;
+}
+
+void gf2_matrix_square(mz_uint32 *square, const mz_uint32 *mat)
+{
+    for (int n = 0; n < 32; ++ n)
+        square[n] = gf2_matrix_times(mat, mat[n]);
+}
+
+mz_uint32 crc32_combine(mz_uint32 crc1, mz_uint32 crc2, uint64_t len2)
+{
+    if (len2 == 0)
+        return crc1;
+    mz_uint32 even[32];
+    mz_uint32 odd[32];
+    // Operator for one zero bit.
+    odd[0] = 0xedb88320u;
+    for (mz_uint32 n = 1, row = 1; n < 32; ++ n, row <<= 1)
+        odd[n] = row;
+    // Operators for two and four zero bits.
+    gf2_matrix_square(even, odd);
+    gf2_matrix_square(odd, even);
+    // Apply len2 zero bytes to crc1.
+    do {
+        gf2_matrix_square(even, odd);
+        if (len2 & 1)
+            crc1 = gf2_matrix_times(even, crc1);
+        len2 >>= 1;
+        if (len2 == 0)
+            break;
+        gf2_matrix_square(odd, even);
+        if (len2 & 1)
+            crc1 = gf2_matrix_times(odd, crc1);
+        len2 >>= 1;
+    } while (len2 != 0);
+    return crc1 ^ crc2;
+}
+
+mz_bool deflate_put_buf(const void *buf, int len, void *user)
+{
+    static_cast<std::string*>(user)->append(static_cast<const char*>(buf), size_t(len));
+    return MZ_TRUE;
+}
+} // namespace
+
+bool deflate_parallel(const void *data, size_t size, int level, DeflatedData &out)
+{
+    // Large enough for the dictionary reset at each chunk not to matter.
+    static constexpr size_t chunk_size = 4 * 1024 * 1024;
+
+    out.data.clear();
+    out.uncompressed_size = size;
+    out.level             = std::max(0, std::min(level < 0 ? int(MZ_DEFAULT_LEVEL) : level, int(MZ_UBER_COMPRESSION)));
+    const auto *src = static_cast<const unsigned char*>(data);
+    if (out.level == 0 || size == 0) {
+        out.data.assign(reinterpret_cast<const char*>(src), size);
+        out.crc32 = (mz_uint32)mz_crc32(MZ_CRC32_INIT, src, size);
+        return true;
+    }
+
+    struct Chunk {
+        std::string data;
+        mz_uint32   crc32 { MZ_CRC32_INIT };
+        bool        ok { false };
+    };
+    std::vector<Chunk> chunks((size + chunk_size - 1) / chunk_size);
+    const mz_uint      comp_flags = tdefl_create_comp_flags_from_zip_params(out.level, -15, MZ_DEFAULT_STRATEGY);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size(), 1), [&chunks, src, size, comp_flags](const tbb::blocked_range<size_t> &range) {
+        // The compressor state is large, allocate it on heap once per range.
+        auto compressor = std::make_unique<tdefl_compressor>();
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            Chunk        &chunk = chunks[i];
+            const size_t  begin = i * chunk_size;
+            const size_t  len   = std::min(chunk_size, size - begin);
+            const bool    last  = i + 1 == chunks.size();
+            chunk.data.reserve(len / 2);
+            chunk.crc32 = (mz_uint32)mz_crc32(MZ_CRC32_INIT, src + begin, len);
+            // All but the last chunk end with an empty stored block aligning the stream to a byte boundary.
+            chunk.ok = tdefl_init(compressor.get(), deflate_put_buf, &chunk.data, int(comp_flags)) == TDEFL_STATUS_OKAY &&
+                       tdefl_compress_buffer(compressor.get(), src + begin, len, last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH) == (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY);
+        }
+    });
+
+    size_t compressed_size = 0;
+    for (const Chunk &chunk : chunks) {
+        if (! chunk.ok)
+            return false;
+        compressed_size += chunk.data.size();
+    }
+    out.data.reserve(compressed_size);
+    out.crc32 = MZ_CRC32_INIT;
+    for (size_t i = 0; i < chunks.size(); ++ i) {
+        out.data += chunks[i].data;
+        out.crc32 = crc32_combine(out.crc32, chunks[i].crc32, std::min(chunk_size, size - i * chunk_size));
+        std::string().swap(chunks[i].data);
+    }
+    return true;
+}
+
+bool add_deflated_to_zip(mz_zip_archive *zip, const char *archive_name, const DeflatedData &deflated)
+{
+    if (deflated.level == 0 || deflated.uncompressed_size == 0)
+        return mz_zip_writer_add_mem(zip, archive_name, deflated.data.data(), deflated.data.size(), MZ_NO_COMPRESSION);
+    return mz_zip_writer_add_mem_ex_v2(zip, archive_name, deflated.data.data(), deflated.data.size(), nullptr, 0,
+        mz_uint(deflated.level) | MZ_ZIP_FLAG_COMPRESSED_DATA, deflated.uncompressed_size, deflated.crc32, nullptr, nullptr, 0, nullptr, 0);
+}
+
 MZ_Archive::MZ_Archive()
 {
     mz_zip_zero_struct(&arch);
@@ -11,6 +11,23 @@ bool open_zip_writer(mz_zip_archive *zip, const std::string &fname_utf8);
 bool close_zip_reader(mz_zip_archive *zip);
 bool close_zip_writer(mz_zip_archive *zip);
 
+// Raw deflate stream produced by deflate_parallel(), to be stored into an archive by add_deflated_to_zip().
+struct DeflatedData
+{
+    std::string data;
+    size_t      uncompressed_size { 0 };
+    mz_uint32   crc32 { MZ_CRC32_INIT };
+    // Level 0 stores the data uncompressed.
+    int         level { MZ_DEFAULT_LEVEL };
+};
+
+// Compress the data by multiple threads: The data is split into chunks, which are compressed independently
+// and flushed to a byte boundary, thus their concatenation is a single valid deflate stream.
+// The compression ratio is slightly lower than when compressed at once, as the dictionary is reset at each chunk.
+bool deflate_parallel(const void *data, size_t size, int level, DeflatedData &out);
+// Add an entry compressed by deflate_parallel() into an archive open for writing.
+bool add_deflated_to_zip(mz_zip_archive *zip, const char *archive_name, const DeflatedData &deflated);
+
 class MZ_Archive {
 public:
     mz_zip_archive arch;
@@ -1935,7 +1935,7 @@ GLGizmoCut3D::PartSelection::PartSelection(const ModelObject* mo, const Transfor
     m_parts.clear();
     for (const ModelVolume* volume : volumes) {
         assert(volume != nullptr);
-        m_parts.emplace_back(Part{GLModel(), MeshRaycaster(volume->mesh()), true, !volume->is_model_part()});
+        m_parts.emplace_back(Part{GLModel(), MeshRaycaster(volume->mesh_ptr()), true, !volume->is_model_part()});
         m_parts.back().glmodel.set_color({ 0.f, 0.f, 1.f, 1.f });
         m_parts.back().glmodel.init_from(volume->mesh());
 
@@ -2004,7 +2004,7 @@ GLGizmoCut3D::PartSelection::PartSelection(const ModelObject* object, int instan
 
     for (const ModelVolume* volume : object->volumes) {
         assert(volume != nullptr);
-        m_parts.emplace_back(Part{ GLModel(), MeshRaycaster(volume->mesh()), true, !volume->is_model_part() });
+        m_parts.emplace_back(Part{ GLModel(), MeshRaycaster(volume->mesh_ptr()), true, !volume->is_model_part() });
         m_parts.back().glmodel.init_from(volume->mesh());
 
         // Now check whether this part is below or above the plane.
@@ -222,16 +222,20 @@ void Raycaster::on_update()
         return;
 
     std::vector<const TriangleMesh*> meshes;
+    std::vector<std::shared_ptr<const TriangleMesh>> mesh_ptrs;
     const std::vector<ModelVolume*>& mvs = mo->volumes;
     for (const ModelVolume* mv : mvs) {
-        if (mv->is_model_part())
+        if (mv->is_model_part()) {
             meshes.push_back(&mv->mesh());
+            mesh_ptrs.push_back(mv->mesh_ptr());
+        }
     }
 
     if (meshes != m_old_meshes) {
         m_raycasters.clear();
-        for (const TriangleMesh* mesh : meshes)
-            m_raycasters.emplace_back(new MeshRaycaster(std::make_shared<const TriangleMesh>(*mesh)));
+        // Share the meshes with the volumes, so that their AABB trees are shared through AABBTreeCache.
+        for (const std::shared_ptr<const TriangleMesh> &mesh : mesh_ptrs)
+            m_raycasters.emplace_back(new MeshRaycaster(mesh));
         m_old_meshes = meshes;
     }
 }
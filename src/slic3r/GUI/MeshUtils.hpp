@@ -164,7 +164,7 @@ class MeshRaycaster {
 public:
     explicit MeshRaycaster(std::shared_ptr<const TriangleMesh> mesh)
         : m_mesh(std::move(mesh))
-        , m_emesh(*m_mesh, true) // calculate epsilon for triangle-ray intersection from an average edge length
+        , m_emesh(m_mesh, true) // calculate epsilon for triangle-ray intersection from an average edge length
         , m_normals(its_face_normals(m_mesh->its))
     {
         assert(m_mesh);
@@ -11192,6 +11192,9 @@ int Plater::export_3mf(const boost::filesystem::path& output_path, SaveStrategy
     store_params.id_bboxes = plate_bboxes;//BBS
     store_params.project = &p->project;
     store_params.strategy = strategy | SaveStrategy::Zip64;
+    // Optional "fast save": a lower deflate level of the models and G-codes.
+    if (std::string level = wxGetApp().app_config->get("3mf_compression_level"); !level.empty())
+        store_params.compression_level = std::atoi(level.c_str());
 
 
     // get type and color for platedata
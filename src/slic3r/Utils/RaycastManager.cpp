@@ -262,7 +262,7 @@ void actualize(RaycastManager::Meshes &meshes, const ModelVolumePtrs &volumes, c
 
         // add new raycaster
         bool calculate_epsilon = true;
-        auto mesh = std::make_unique<AABBMesh>(volume->mesh(), calculate_epsilon);
+        auto mesh = std::make_unique<AABBMesh>(volume->mesh_ptr(), calculate_epsilon);
         meshes.emplace_back(std::make_pair(oid, std::move(mesh)));
         need_sort = true;        
     }
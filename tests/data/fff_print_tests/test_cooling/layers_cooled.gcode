@@ -0,0 +1,423 @@
+M106 S0 ; disable fan
+;LAYER_CHANGE
+G1 Z0.200 F600
+G1 X14.275 Y11.249
+G1 X1.871 Y23.405
+G1 X-10.682 Y21.268 F12000
+G1 X4.933 Y26.647
+G1 X3.053 Y36.203
+G1 X16.321 Y18.730
+G1 X20.305 Y29.854
+G1 X8.118 Y19.200
+G1 F1800
+G1 X13.075 Y22.602 E0.09458
+G2 X10.372 Y20.493 I1.598 J-0.598 E0.25398
+G1 X9.237 Y25.073 E0.00016
+G1 X6.334 Y29.176 E0.29411
+G1 X5.308 Y24.906 E0.23355
+G1 F3000
+G2 X1.654 Y26.976 I-0.210 J-0.079 E0.20462
+M106 S0 ; disable fan
+G1 X21.066 Y37.757
+G1 X16.860 Y57.359 F12000
+G1 X35.854 Y61.069
+G1 F2400
+G2 X36.624 Y56.490 I-0.351 J-2.943 E0.18310
+G2 X39.926 Y55.352 I-1.748 J0.820 E0.00465
+G2 X38.613 Y56.573 I0.524 J1.994 E0.04072
+G1 X37.474 Y57.846 E0.06852
+G2 X38.579 Y60.099 I0.774 J0.324 E0.20609
+G2 X37.461 Y59.925 I-2.716 J-2.346 E0.15371
+G1 X33.125 Y56.757
+G1 X33.928 Y73.927
+G1 F1200
+G1 X29.670 Y71.051 E0.22470
+G1 X25.361 Y70.165 E0.01398
+G1 X23.181 Y70.475 E0.02766
+G1 X19.565 Y69.978 E0.21987
+G1 X19.784 Y74.447 E0.27708
+; just a comment
+G92 E0
+G1 F1800
+G1 X16.150 Y70.171 E0.11033
+G1 X11.595 Y74.534 E0.03886
+G2 X16.229 Y72.950 I-0.160 J-2.534 E0.25719
+G1 F1200
+G2 X15.020 Y68.074 I-2.456 J-2.307 E0.07716
+G1 X14.183 Y66.376 E0.20825
+G1 X13.760 Y66.002 E0.15561
+G2 X13.906 Y64.104 I-2.866 J2.744 E0.03387
+G1 X13.358 Y79.961
+G1 F2400
+G1 X14.958 Y79.381 E0.09809
+G1 X16.617 Y76.366 E0.24180
+G1 X20.759 Y80.168 E0.17493
+G1 F1200
+G1 X22.871 Y84.668 E0.05074
+T0
+M106 S0 ; disable fan
+G1 X18.173 Y85.467
+G1 X31.849 Y90.458
+G1 X22.974 Y94.761
+G1 F6000
+G1 X23.474 Y94.761 E-0.1 
+G4 S1
+G1 X4.238 Y80.196
+G2 X9.079 Y76.349 I0.212 J0.839 E0.11060
+M106 S0 ; disable fan
+G1 F1200
+G1 X9.427 Y71.711 E0.23358
+G1 X9.824 Y76.179 E0.29904
+G1 X6.416 Y79.666 E0.06718
+G1 X5.521 Y83.593 E0.13515
+M106 S0 ; disable fan
+G1 X-14.210 Y85.593
+G1 X-1.432 Y79.317
+G1 X-17.474 Y93.964
+G1 X-32.534 Y83.655
+G1 F3000
+G2 X-34.915 Y85.838 I0.028 J-2.777 E0.10262
+G1 X-35.701 Y83.591 E0.06549
+G2 X-32.026 Y82.880 I0.199 J1.120 E0.27480
+G1 X-16.003 Y83.608
+G1 X-0.806 Y86.766
+G1 X-3.229 Y89.117
+G1 X-16.655 Y89.686
+T1
+M106 S0 ; disable fan
+G1 X-1.852 Y94.063
+G1 X-5.709 Y89.113 E0.16150
+G1 X-10.270 Y93.286 E0.29682
+G2 X-14.050 Y89.219 I2.585 J-0.246 E0.27623
+G1 X-11.046 Y88.260 E0.14791
+G1 X-12.649 Y92.269 E0.27601
+G1 F1200
+G2 X-10.628 Y97.042 I-2.067 J-2.929 E0.08522
+G1 X-8.392 Y94.487 E0.14990
+G1 X-3.451 Y103.194
+G1 X-22.521 Y108.515
+G1 X-20.994 Y123.068
+G1 X-19.994 Y124.068 E0.1
+;_SUPP_INTERFACE_FAN_END
+G1 X-18.994 Y125.068 E0.1
+;_SUPP_INTERFACE_FAN_END
+G1 X-15.528 Y110.527
+G1 X-21.624 Y97.772
+G1 X-33.837 Y108.905 F12000
+G1 F2400
+G1 X-37.867 Y112.227 E0.23698
+G1 X-41.607 Y111.254 E0.00533
+G1 X-44.597 Y113.078 E0.29051
+G1 X-48.443 Y113.135 E0.15084
+G1 F1800
+G1 X-47.310 Y117.186 E0.05687
+G2 X-51.160 Y113.911 I-1.301 J1.038 E0.17393
+G2 X-54.816 Y115.721 I-2.420 J-0.655 E0.12793
+G1 X-56.270 Y112.821 E0.19020
+G1 X-60.861 Y109.824 E0.10787
+G1 X-56.666 Y93.616
+G1 F9000
+G1 X-48.479 Y108.045
+G1 X-44.495 Y108.217
+;LAYER_CHANGE
+G1 Z0.400 F600
+T0
+M106 S0 ; disable fan
+G1 X-33.376 Y120.803
+G1 X-18.182 Y128.595
+G1 X-21.952 Y137.500 F12000
+; just a comment
+G1 X-41.528 Y131.725
+G1 X-52.244 Y149.512
+
+G1 X-50.921 Y145.096
+G1 X-42.871 Y155.566
+G1 F1800
+G1 X-42.823 Y158.179 E0.00323
+G1 X-45.238 Y155.936 E0.16215
+G1 X-46.081 Y156.143 E0.02989
+G1 X-46.637 Y157.589 E0.20053
+G1 X-29.093 Y153.025
+G1 X-27.415 Y156.888
+G1 X-36.038 Y152.830
+G1 X-36.708 Y143.621
+G1 X-26.798 Y124.695
+G1 X-21.478 Y121.047
+G1 F3000
+M106 S255 ; enable fan
+G1 X-17.034 Y116.782 E0.12885
+G1 X-17.258 Y121.514 E0.15701
+G1 X-12.885 Y123.741 E0.29365
+G2 X-9.718 Y124.778 I0.745 J-0.266 E0.06110
+G2 X-14.198 Y125.059 I-0.343 J1.007 E0.13667
+G1 X-16.576 Y125.881 E0.23339
+G1 X1.529 Y135.252 F12000
+G1 F3000
+G1 X-0.723 Y136.350 E0.20971
+G1 X-3.823 Y134.137 E0.28557
+G2 X-3.802 Y135.666 I1.099 J0.770 E0.00284
+G1 F1800
+G2 X-1.244 Y139.795 I-1.591 J2.889 E0.14520
+G1 F12000
+G1 X12.298 Y122.769
+G1 X17.248 Y133.519
+G1 X7.571 Y145.914
+G1 X27.138 Y138.930
+G1 X43.971 Y136.036
+G1 F3000
+G1 X44.651 Y139.189 E0.24705
+G1 X39.744 Y137.290 E0.18112
+G1 X41.695 Y137.238 E0.09838
+G1 X45.512 Y134.425 E0.09812
+G1 X49.574 Y132.650 E0.17843
+G1 X40.743 Y133.858
+G1 X29.591 Y152.569
+G1 X12.963 Y165.710 F12000
+G1 X16.355 Y177.555
+G1 X11.965 Y163.747
+G1 F1800
+G2 X15.083 Y160.959 I-2.048 J-1.225 E0.00670
+G1 X18.500 Y160.187 E0.09164
+G1 X18.955 Y158.532 E0.03162
+G1 F2400
+G1 X16.409 Y155.736 E0.15647
+G1 X19.056 Y154.680 E0.29048
+G1 X20.780 Y154.617 E0.21628
+G1 X22.862 Y158.767 E0.24787
+G1 X35.098 Y172.120
+G1 X40.709 Y173.074
+G1 X37.573 Y169.892 F12000
+G1 X57.214 Y164.913
+M106 S255 ; enable fan
+G1 X58.214 Y165.913 E0.1
+M106 S255 ; enable fan
+G1 X49.895 Y184.703
+G4 S1
+G1 F2400
+G1 X52.426 Y179.875 E0.24012
+G1 F3000
+G1 X52.145 Y179.961 E0.26836
+G1 X51.170 Y184.068 E0.18803
+G1 X55.590 Y184.572 E0.14543
+G1 X54.616 Y189.129 E0.23150
+G1 X50.540 Y192.755 E0.06523
+G1 X46.883 Y195.738 E0.23841
+G1 X29.201 Y212.708
+G1 X45.410 Y210.709 F12000
+G1 X60.403 Y207.340
+G1 F2400
+G1 X60.562 Y202.869 E0.05349
+G2 X57.605 Y207.031 I-2.230 J-0.890 E0.18446
+G1 X57.885 Y210.928 E0.02486
+G1 X58.124 Y191.689 F12000
+G1 F1800
+G2 X58.557 Y191.946 I1.992 J-1.132 E0.09322
+M106 S0 ; disable fan
+G4 S1
+G1 X67.163 Y186.334
+G1 F1200
+G1 X68.702 Y181.458 E0.21300
+G1 X67.026 Y161.877
+G1 X55.295 Y166.519 F12000
+G1 X56.886 Y158.447
+G1 X63.553 Y148.705
+G1 X56.729 Y166.507
+G1 X49.996 Y179.582
+G1 F1800
+G1 X46.794 Y178.605 E0.17782
+G2 X42.695 Y175.871 I-2.255 J-0.559 E0.02180
+;LAYER_CHANGE
+G1 Z0.600 F600
+G1 X28.258 Y164.089 F12000
+G1 X27.567 Y180.942
+G1 X32.091 Y173.650
+M106 S204 ; enable fan
+G1 X33.091 Y174.650 E0.1
+M106 S0 ; disable fan
+G1 X34.287 Y165.079
+G4 S1
+G1 X36.575 Y153.274
+G1 F3000
+G1 X37.075 Y153.274 E-0.1 
+G1 X23.409 Y163.934
+G1 X17.511 Y163.951
+G1 X36.982 Y164.593
+G1 X24.870 Y182.388
+G1 F1800
+G1 X26.841 Y180.680 E0.10836
+G1 X26.472 Y176.920 E0.04068
+G1 X30.512 Y177.355 E0.16810
+G1 X28.156 Y181.448 E0.24525
+G2 X30.739 Y180.079 I0.585 J1.868 E0.13631
+G1 X29.773 Y182.906 E0.29966
+M106 S0 ; disable fan
+G1 X43.668 Y199.164
+G1 X54.201 Y185.506
+G1 F1200
+G1 X54.398 Y183.142 E0.09963
+G1 X55.815 Y178.521 E0.04342
+G1 X60.409 Y179.522 E0.12343
+G1 X70.730 Y189.591
+G1 X84.260 Y203.792
+G1 X86.898 Y220.002
+G1 X84.187 Y236.174
+G1 X88.013 Y239.944 E0.25331
+G1 X85.437 Y243.675 E0.14271
+G1 X81.491 Y247.774 E0.19705
+G1 X101.462 Y257.006
+G1 X103.308 Y259.565 F12000
+G1 X100.171 Y244.472
+G1 X85.369 Y259.759
+G1 X77.213 Y268.886
+G1 F1200
+G1 X73.626 Y270.809 E0.09187
+G1 X73.175 Y268.947 E0.04297
+G1 X75.941 Y271.712 E0.06081
+G2 X79.531 Y273.637 I-1.105 J2.155 E0.26980
+M106 S0 ; disable fan
+G1 X87.448 Y276.030
+M106 S204 ; enable fan
+G1 X88.448 Y277.030 E0.1
+M106 S0 ; disable fan
+G1 X107.499 Y283.035
+G1 X125.953 Y273.991
+G1 X119.351 Y292.268
+G1 X106.127 Y306.730 F12000
+G1 X96.885 Y315.536
+G1 F6000
+G1 X97.385 Y315.536 E-0.1 
+G1 X103.865 Y330.913
+M106 S204 ; enable fan
+G1 X104.865 Y331.913 E0.1
+M106 S0 ; disable fan
+G4 S1
+G1 X111.546 Y322.987
+G1 X115.620 Y318.056 E0.16118
+G2 X114.855 Y318.742 I2.930 J-1.863 E0.05380
+G1 X117.197 Y314.030 E0.04523
+G1 X121.175 Y315.249 E0.17547
+G2 X116.202 Y319.165 I-2.616 J1.661 E0.27291
+G1 X97.480 Y310.823
+G1 X116.816 Y320.597
+G1 X127.666 Y305.082
+G1 X129.579 Y295.328
+G1 X119.966 Y297.095
+G1 X110.419 Y285.195
+G1 F1200
+M106 S255 ; enable fan
+G1 X111.502 Y286.281 E0.15111
+G2 X113.734 Y289.847 I-2.314 J-1.931 E0.19196
+G1 X118.663 Y272.007
+G1 X131.449 Y281.545
+G1 X131.382 Y287.548
+G1 X121.308 Y287.423
+G1 X119.489 Y280.055
+G1 X127.640 Y298.343 F12000
+G1 X131.670 Y283.725
+G1 X151.096 Y263.858
+G1 X134.753 Y266.102
+G1 X153.618 Y273.296
+G1 X158.116 Y265.124
+G1 X154.850 Y248.565
+M106 S227 ; enable fan
+;LAYER_CHANGE
+G1 Z0.800 F600
+G1 F9000
+G1 F1200
+G1 X153.282 Y250.512 E0.17720
+G1 X157.146 Y250.138 E0.25291
+G1 X155.957 Y252.951 E0.10422
+G2 X152.793 Y253.447 I-1.778 J-1.713 E0.14031
+G1 X150.878 Y252.918 E0.20376
+G1 X154.506 Y249.964 E0.02183
+G1 X145.486 Y230.706 F12000
+T1
+M106 S227 ; enable fan
+G1 X151.465 Y219.408
+G1 F3000
+G1 X146.669 Y217.629 E0.02495
+G1 F9000
+G4 S1
+G1 X146.206 Y205.138
+G1 F2400
+G1 X148.146 Y205.307 E0.09416
+G1 X147.663 Y204.077 E0.25038
+G2 X148.013 Y203.571 I0.101 J-0.866 E0.03079
+G2 X146.717 Y204.684 I2.089 J1.483 E0.14485
+G1 X141.831 Y207.300 E0.19813
+M106 S227 ; enable fan
+G1 X144.156 Y201.435 F12000
+G1 X139.123 Y212.768
+G1 X123.916 Y212.484
+G1 X115.298 Y220.618
+G1 X103.375 Y231.350
+G1 X104.193 Y241.061
+G1 X103.325 Y231.341
+G4 S1
+G1 X119.426 Y216.154
+G1 X110.306 Y211.241
+G1 F6000
+G1 X110.806 Y211.241 E-0.1 
+G1 X93.697 Y192.656
+G1 X85.590 Y205.262
+G1 X80.966 Y198.920
+G2 X81.395 Y200.048 I-2.590 J-0.216 E0.13487
+G1 X86.058 Y198.897 E0.20503
+G1 X83.787 Y198.848 E0.00633
+G1 X84.841 Y196.546 E0.06602
+G1 X85.047 Y200.810 E0.00105
+G1 X95.658 Y183.972
+G1 X103.303 Y195.836 F12000
+G1 F1800
+G2 X102.265 Y192.400 I-2.034 J-1.002 E0.20678
+G1 X105.315 Y190.336 E0.11005
+G1 X106.995 Y190.320 E0.10867
+G1 X109.057 Y194.494 E0.26324
+G1 X113.949 Y197.673 E0.09305
+G1 X117.438 Y197.796 E0.01211
+G1 X116.717 Y191.582
+G1 X124.470 Y181.700
+G1 X131.783 Y169.043
+M106 S204 ; enable fan
+G1 X132.783 Y170.043 E0.1
+M106 S227 ; enable fan
+G1 X117.958 Y189.379
+G1 F3000
+M106 S255 ; enable fan
+G1 X119.170 Y187.299 E0.29214
+G1 X118.888 Y189.237 E0.27826
+G1 X116.568 Y186.948 E0.19973
+G2 X115.435 Y188.741 I-2.056 J2.984 E0.26124
+M106 S227 ; enable fan
+; just a comment
+G1 X127.501 Y184.924
+G1 X141.723 Y171.773 F12000
+G1 X156.515 Y177.757
+G1 X152.843 Y163.437
+G1 X141.507 Y154.745
+G1 X154.860 Y156.992
+G1 X152.165 Y143.066
+T0
+M106 S255 ; enable fan
+T1
+M106 S255 ; enable fan
+T0
+M106 S255 ; enable fan
+G1 F2400
+G1 X148.681 Y138.138 E0.20108
+M106 S227 ; enable fan
+G1 F9000
+G1 X136.769 Y152.828
+G1 X149.049 Y148.665 F12000
+G1 X155.325 Y153.587
+G1 X169.909 Y173.358
+G1 X178.907 Y160.392
+G1 F1800
+G1 X181.443 Y158.492 E0.00314
+G1 X161.884 Y159.582
+G1 X171.300 Y155.553
+G1 X182.009 Y174.991 F12000
+G1 X178.099 Y183.201
+G1 X159.039 Y186.274
+G1 X153.812 Y192.552
+G1 X159.333 Y186.715
@@ -0,0 +1,1225 @@
+G92 E0
+;LAYER_CHANGE
+G1 Z0.200 F600
+G1 X2.418 Y2.952 E0.28274
+M106 S200
+G1 X-0.092 Y-1.530 E0.04706
+G1 X-4.072 Y-4.036 E0.21936
+G1 X-5.177 Y-1.417 E0.02158
+G1 X-0.454 Y-6.364 E0.23208
+G1 X-2.318 Y-9.375 E0.26284
+G1 X-5.349 Y-4.724 E0.11497 F2400
+G1 X-9.697 Y-6.710 E0.18093 F2400 ; comment
+G1 X-11.637 Y-4.746 E0.05543
+G1 X-7.247 Y-0.254 E0.10729
+G1 X-8.483 Y3.158 E0.13585
+G1 X-12.293 Y0.619 E0.24585
+G1 X-14.784 Y0.248 E0.17693
+G1 X-15.454 Y5.031 E0.06255
+G1 X-17.697 Y7.057 E0.02762
+G1 X-16.429 Y9.269 E0.09279
+
+G1 X-12.193 Y4.587 E0.22217
+G1 X-15.737 Y9.377 E0.19150
+G1 X-10.924 Y10.018 E0.03983
+G1 X-12.194 Y5.606 E0.12619
+G1 X-15.501 Y5.827 E0.28804
+G1 X-15.800 Y9.846 E0.03377
+G1 X-11.429 Y13.524 E0.05404
+G1 X-11.401 Y9.155 E0.23855
+M107
+G1 X-10.807 Y10.838 E0.25057
+G1 X-6.239 Y9.239 E0.05359
+G1 X-7.979 Y6.976 E0.08665
+G1 X-10.241 Y5.432 E0.28125
+G1 X-6.571 Y4.929 E0.10928
+G1 X-9.584 Y3.550 E0.25616 ; comment
+G1 X-10.418 Y4.718 E0.28087
+G1 X-9.886 Y8.389 E0.08121
+G1 X-8.645 Y5.196 E0.22770
+G1 X-3.848 Y1.854 E0.26754
+G1 X-3.365 Y1.009 E0.10533 ; comment
+G1 X-1.184 Y-0.251 E0.10516
+G1 X0.704 Y0.221 E0.28931
+G1 X0.831 Y4.732 E0.08796
+G1 X1.470 Y5.116 E0.14024
+G1 X-1.539 Y1.446 E0.02725
+G1 X-3.278 Y5.611 E0.16183
+G1 X-3.986 Y10.377 E0.14802
+G1 X-0.437 Y6.968 E0.17819
+G1 X-5.240 Y11.419 E0.09225
+M106 S255
+G1 X-7.785 Y6.819 E0.04093
+G1 X-10.350 Y6.562 E0.01103
+G1 X-12.493 Y6.485 E0.29774
+G1 X-8.543 Y1.646 E0.03781
+G1 X-6.230 Y-3.087 E0.10493
+G1 X-11.202 Y-2.555 E0.20572
+G1 X-11.905 Y0.520 E0.17847
+G1 X-8.318 Y3.932 E0.14272
+G1 X-8.667 Y6.514 E0.09110 F2400
+G1 X-8.943 Y4.624 E0.04963
+G1 X-8.563 Y3.879 E0.16242 F1800
+
+; custom gcode
+M106 S100
+; custom gcode end
+G1 X-10.233 Y3.173 E0.02061
+G1 X-14.009 Y4.318 E0.24730
+G1 X-11.951 Y3.698 E0.05493
+T0
+;TYPE:Overhang wall
+G1 X-9.496 Y1.497 E0.17133
+G1 X-14.396 Y-2.589 E0.20564
+G1 X-10.248 Y-6.207 E0.08842
+G1 X-5.829 Y-5.708 E0.06618 F1800
+G1 X-5.659 Y-9.370 E0.07033
+G1 X-3.526 Y-7.820 E0.02557 ; comment
+G1 X-2.586 Y-10.434 E0.26308
+G1 X-7.292 Y-8.184 E0.01610
+G1 X-10.061 Y-12.023 E0.29181
+G1 X-8.813 Y-13.480 E0.07051
+G1 X-9.955 Y-17.116 E0.24933
+G1 X-6.439 Y-16.941 E0.17779
+G1 X-10.469 Y-21.609 E0.06072 F2400
+G1 X-11.200 Y-23.604 E0.28038
+G1 X-14.284 Y-22.070 E0.02136
+G1 X-13.763 Y-25.968 E0.24553
+M107
+G1 X-15.320 Y-23.448 E0.09482 F1800
+G1 X-10.866 Y-27.269 E0.20057
+G1 X-14.234 Y-30.259 E0.00748 ; comment
+G1 X-9.498 Y-31.616 E0.09355
+G1 X-7.318 Y-34.983 E0.07216
+G1 X-8.012 Y-30.228 E0.00188 F2400
+M107
+G1 X-4.639 Y-29.576 E0.28185
+G1 X-8.720 Y-29.864 E0.20484
+G1 X-13.241 Y-26.529 E0.13376
+G1 X-16.296 Y-24.572 E0.19217
+G1 X-13.388 Y-28.704 E0.29555 ; comment
+G1 X-12.138 Y-29.292 E0.10728
+G1 X-15.811 Y-34.168 E0.22685
+G1 X-15.266 Y-37.781 E0.14497
+G1 X-18.940 Y-37.413 E0.14148
+G1 X-17.277 Y-39.655 E0.14780
+G1 X-13.450 Y-35.800 E0.02156
+G1 X-18.449 Y-37.941 E0.28210 ; comment
+G1 X-16.573 Y-35.127 E0.00561 F2400
+G1 X-17.749 Y-38.825 E0.01978
+G1 X-19.894 Y-43.190 E0.22914 ; comment
+;TYPE:Outer wall
+G1 X-20.535 Y-45.608 E0.28544 F2400
+G1 X-21.952 Y-48.975 E0.18576
+G1 X-20.893 Y-47.669 E0.04321
+G1 X-22.558 Y-48.211 E0.06849
+;TYPE:Outer wall
+G1 X-17.862 Y-47.251 E0.03107
+;TYPE:Overhang wall
+M107
+G1 X-18.042 Y-43.433 E0.11782
+G1 X-17.417 Y-44.863 E0.22532
+G1 X-12.593 Y-41.461 E0.25495
+G1 X-9.276 Y-41.560 E0.01132 ; comment
+G1 X-5.274 Y-44.567 E0.23911
+G1 X-4.043 Y-41.563 E0.11293 F1800
+M106 S0
+G1 X-3.907 Y-41.551 E0.16370
+G1 X-3.114 Y-37.204 E0.16724 F1800
+G1 X-2.178 Y-35.409 E0.15666 ; comment
+
+G1 X-1.374 Y-32.813 E0.21434
+G1 X0.787 Y-37.092 E0.22602
+G1 X2.663 Y-33.710 E0.22158
+G1 X6.625 Y-36.319 E0.29240
+M106 S200
+G1 X9.133 Y-36.036 E0.06215
+G1 X12.564 Y-32.143 E0.20650
+G1 X10.502 Y-29.169 E0.23915 F1800 ; comment
+G1 X7.357 Y-27.610 E0.17098
+G1 X6.427 Y-30.303 E0.14497
+G1 X2.271 Y-26.408 E0.09921
+G1 X2.821 Y-25.775 E0.13015
+G1 X1.123 Y-30.013 E0.28569
+G1 F1200
+G1 X2.575 Y-25.745 E0.06872
+G1 X-1.417 Y-28.810 E0.04699 F1800
+G1 X-0.668 Y-29.399 E0.09683
+G1 X-0.177 Y-28.595 E0.26077
+G1 X-3.222 Y-30.353 E0.05186
+G1 X-5.763 Y-25.939 E0.13980 F2400
+M106 S200
+G1 X-1.313 Y-30.217 E0.22794
+G1 X-1.523 Y-31.675 E0.22119
+G1 X-1.535 Y-29.707 E0.23670
+G1 X1.945 Y-29.514 E0.01512
+G1 X-2.321 Y-31.804 E0.02881
+G1 X-3.459 Y-27.465 E0.02755
+M106 S64
+G1 X-8.295 Y-29.956 E0.13747
+;TYPE:Outer wall
+G1 X-5.260 Y-34.834 E0.15576
+G1 X-5.556 Y-39.609 E0.04800
+G1 X-1.158 Y-37.999 E0.18546
+G1 X1.075 Y-34.874 E0.24709
+M106 S64
+G1 X-2.443 Y-32.065 E0.12664
+G1 X-3.229 Y-34.356 E0.14095
+G1 X-6.537 Y-34.779 E0.02217
+G1 X-9.572 Y-39.595 E0.24849
+G1 X-12.206 Y-35.393 E0.28127 F1800
+
+G1 X-10.667 Y-37.051 E0.06438
+G1 X-10.092 Y-39.215 E0.03175
+G1 X-9.616 Y-39.781 E0.26124
+M106 S0
+G1 X-13.280 Y-39.970 E0.21173 F1800
+G1 X-12.175 Y-37.041 E0.01682 ; comment
+G1 X-13.717 Y-41.827 E0.08932
+G1 X-15.013 Y-41.526 E0.21395
+G1 X-16.995 Y-44.860 E0.27957 F2400 ; comment
+G1 X-15.802 Y-48.875 E0.15402
+G1 X-16.240 Y-53.244 E0.00115
+;TYPE:Overhang wall
+G1 X-12.388 Y-54.502 E0.10223
+G1 X-16.145 Y-56.988 E0.00744
+G1 X-14.125 Y-56.068 E0.26257
+G1 X-13.468 Y-52.051 E0.10652
+G1 X-12.358 Y-50.311 E0.19488 F2400
+G1 X-11.245 Y-49.191 E0.06646
+; custom gcode
+M106 S100
+; custom gcode end
+G1 X-15.317 Y-53.522 E0.13809
+G1 X-19.623 Y-52.091 E0.25309
+G1 X-21.637 Y-57.076 E0.22746
+G1 X-25.083 Y-59.912 E0.07901
+
+G1 X-29.292 Y-60.660 E0.18648
+G1 X-29.379 Y-58.788 E0.13415
+G1 X-31.701 Y-58.851 E0.16083
+G1 X-32.505 Y-56.008 E0.25078
+G1 X-33.929 Y-52.111 E0.07938
+G1 X-37.765 Y-49.412 E0.10092
+G1 X-36.940 Y-53.914 E0.29164
+G1 X-39.333 Y-54.830 E0.09879 F1800
+G1 X-34.344 Y-55.745 E0.01985 F1800
+G1 X-30.381 Y-55.681 E0.03125
+M106 S255
+G1 X-28.865 Y-53.865 E0.09699 ; comment
+G1 X-32.163 Y-56.404 E0.18451 F2400
+G1 X-31.654 Y-51.675 E0.12836
+G1 X-32.836 Y-50.336 E0.27562
+G1 X-36.442 Y-54.801 E0.28170
+G1 X-35.702 Y-54.799 E0.08524
+G1 X-33.117 Y-53.750 E0.04026
+G1 X-37.090 Y-48.775 E0.04002 ; comment
+G1 X-35.894 Y-45.202 E0.04895
+G1 X-38.375 Y-46.639 E0.01575
+G1 X-40.011 Y-45.722 E0.19173
+G1 X-42.190 Y-47.384 E0.26308
+G1 X-37.426 Y-51.102 E0.19652
+M106 S64
+G1 X-33.895 Y-49.488 E0.12624
+G1 X-31.577 Y-49.437 E0.21347
+G1 X-31.632 Y-54.425 E0.23724
+;TYPE:Overhang wall
+G1 X-35.437 Y-57.399 E0.29231
+G1 X-33.927 Y-58.550 E0.19342
+M106 S64
+G1 X-31.493 Y-58.512 E0.13046
+G1 X-30.525 Y-55.936 E0.13336 ; comment
+G1 X-27.119 Y-59.461 E0.01705 F1800
+G1 X-27.735 Y-56.432 E0.14299 ; comment
+G1 X-25.061 Y-55.197 E0.25044
+G1 X-23.887 Y-59.995 E0.26535
+T1
+G1 X-23.546 Y-56.118 E0.05165 ; comment
+;TYPE:Outer wall
+G1 X-24.659 Y-59.458 E0.28602
+G1 X-25.632 Y-59.948 E0.12261 F2400
+G1 X-23.757 Y-56.563 E0.08001 F1800
+G1 X-24.596 Y-54.966 E0.19748
+G1 X-27.689 Y-56.691 E0.07511
+G1 X-27.354 Y-53.288 E0.10969 F2400
+G1 X-29.474 Y-58.219 E0.04466
+M106 S255
+G1 X-26.187 Y-54.236 E0.21793
+G1 X-21.305 Y-52.007 E0.11089
+G1 X-17.444 Y-53.714 E0.29078
+G1 X-12.663 Y-58.549 E0.14411
+G1 X-12.823 Y-62.717 E0.19648 ; comment
+G1 X-16.082 Y-64.213 E0.23083 F1800
+G1 X-13.436 Y-60.503 E0.20446 F2400
+G1 X-14.005 Y-63.992 E0.08347 ; comment
+G1 X-16.570 Y-66.089 E0.02725
+G1 X-20.611 Y-67.631 E0.28351 F2400
+G1 X-24.571 Y-69.381 E0.24906 ; comment
+G1 X-22.567 Y-65.073 E0.17848
+G1 X-18.672 Y-64.814 E0.15400 F2400
+G1 X-16.386 Y-60.472 E0.03720 F2400
+G1 X-17.734 Y-59.440 E0.17714
+G1 X-22.320 Y-63.352 E0.22662 ; comment
+
+G1 X-24.475 Y-61.787 E0.01027
+G1 X-22.539 Y-61.686 E0.25602
+G1 X-25.765 Y-61.941 E0.09587
+G1 X-27.061 Y-59.104 E0.28285
+G1 X-22.091 Y-62.802 E0.22424
+G1 X-25.357 Y-63.685 E0.27957
+G1 X-25.983 Y-62.550 E0.13635 ; comment
+G1 X-24.393 Y-65.113 E0.14980
+G1 X-21.607 Y-67.048 E0.10162
+G1 X-26.153 Y-67.053 E0.08201 ; comment
+G1 X-21.262 Y-64.173 E0.06631 ; comment
+G1 X-24.344 Y-59.330 E0.09354 ; comment
+G1 X-19.390 Y-56.928 E0.27610
+G1 X-22.699 Y-59.228 E0.01963
+G1 X-27.595 Y-61.181 E0.25487
+G1 X-23.477 Y-60.609 E0.11499
+M107
+G1 X-23.901 Y-64.408 E0.02418
+G1 X-24.031 Y-61.038 E0.22331
+G1 X-25.860 Y-59.695 E0.25652
+G1 X-30.770 Y-58.850 E0.06842 F2400 ; comment
+G1 X-31.942 Y-57.384 E0.06531
+G1 X-35.249 Y-56.325 E0.18452
+G1 X-35.857 Y-58.265 E0.07621
+G1 X-34.357 Y-56.502 E0.19195
+G1 X-39.213 Y-61.364 E0.04957
+G1 X-35.832 Y-57.845 E0.18169
+G1 X-34.522 Y-55.430 E0.18320
+G1 X-34.059 Y-58.445 E0.21498
+G1 X-32.661 Y-60.328 E0.03381
+G1 X-29.600 Y-61.540 E0.24242 F2400
+G1 X-27.929 Y-59.331 E0.14318
+G1 X-26.801 Y-63.888 E0.15153
+G1 X-28.123 Y-62.724 E0.18425
+G1 X-26.029 Y-60.682 E0.06918
+; custom gcode
+M106 S100
+; custom gcode end
+G1 X-28.761 Y-60.761 E0.15713
+G1 X-24.366 Y-61.331 E0.16994
+G1 X-19.802 Y-65.487 E0.23316
+G1 X-16.203 Y-69.020 E0.14596
+G1 X-13.174 Y-65.736 E0.01937
+G1 X-10.613 Y-67.400 E0.23095
+G1 X-6.961 Y-65.258 E0.29114
+G1 X-6.343 Y-69.767 E0.28778
+;LAYER_CHANGE
+G1 Z0.400 F600
+;TYPE:Outer wall
+G1 X-8.809 Y-65.047 E0.06906
+T1
+G1 X-9.041 Y-66.761 E0.07773 ; comment
+G1 X-12.553 Y-68.615 E0.23052
+G1 X-14.620 Y-67.325 E0.14361
+G1 X-18.179 Y-64.473 E0.03157
+G1 X-14.443 Y-66.300 E0.28389 F2400
+G1 X-11.099 Y-66.045 E0.11739 F1800 ; comment
+G1 X-11.442 Y-61.952 E0.27240
+G1 X-13.395 Y-66.126 E0.12801
+G1 X-8.917 Y-66.372 E0.09230
+G1 X-12.876 Y-68.992 E0.29910
+G1 X-11.155 Y-68.779 E0.11002 ; comment
+G1 X-12.102 Y-73.677 E0.20238
+G1 X-12.174 Y-76.581 E0.25571 ; comment
+
+G1 X-11.392 Y-78.668 E0.21392 F2400
+G1 X-15.887 Y-79.410 E0.25105
+G1 X-20.250 Y-79.192 E0.05441
+G1 X-20.332 Y-76.352 E0.04021
+G1 X-16.472 Y-78.379 E0.29414
+G1 X-12.126 Y-76.110 E0.02200
+G1 X-10.317 Y-80.719 E0.10429
+G1 X-10.156 Y-81.991 E0.08011
+G1 X-7.637 Y-77.665 E0.00929 ; comment
+G1 X-5.243 Y-75.135 E0.18444
+G1 X-8.299 Y-77.941 E0.03381 F2400
+G1 X-9.174 Y-80.153 E0.23439
+G1 X-4.887 Y-84.688 E0.13774
+G1 X-6.909 Y-86.664 E0.18220
+G1 X-7.176 Y-82.195 E0.13159
+G1 X-6.282 Y-79.298 E0.21357
+G1 X-11.071 Y-77.425 E0.09863 ; comment
+M106 S255
+G1 X-11.711 Y-75.667 E0.27226
+G1 X-14.874 Y-74.859 E0.19320
+G1 X-12.774 Y-78.473 E0.24968
+G1 X-14.552 Y-80.821 E0.09912
+G1 X-13.933 Y-79.264 E0.07863 F1800 ; comment
+G1 X-14.858 Y-77.798 E0.03202
+G1 X-19.491 Y-76.783 E0.09648
+G1 X-14.588 Y-73.902 E0.18880
+G1 X-14.624 Y-69.859 E0.02004
+G1 X-17.281 Y-74.344 E0.03283 ; comment
+G1 X-17.879 Y-78.588 E0.22438 F1800
+G1 X-20.594 Y-76.278 E0.13060
+G1 X-20.110 Y-75.203 E0.27287
+G1 X-18.831 Y-76.124 E0.07998
+M107
+G1 X-20.241 Y-74.258 E0.19685
+G1 X-21.730 Y-71.747 E0.20378
+M106 S255
+G1 X-19.825 Y-76.527 E0.20130
+G1 X-21.558 Y-72.562 E0.12346 F2400
+G1 X-19.721 Y-76.859 E0.25477
+G1 X-19.737 Y-74.311 E0.10369
+G1 X-22.817 Y-70.262 E0.26486
+G1 X-18.767 Y-69.333 E0.06602
+G1 X-22.273 Y-72.308 E0.18908 F1800
+G1 X-22.316 Y-72.378 E0.13564 F2400
+G1 X-26.896 Y-68.531 E0.01889 F2400
+G1 X-30.757 Y-64.874 E0.25024 F1800
+G1 X-28.745 Y-66.112 E0.03415
+G1 X-31.037 Y-67.470 E0.28080
+G1 X-26.254 Y-70.702 E0.05907
+G1 X-24.414 Y-72.970 E0.17832
+G1 X-25.137 Y-69.025 E0.04296
+G1 X-29.074 Y-70.864 E0.29423
+G1 X-27.118 Y-74.021 E0.12944
+G1 X-30.460 Y-72.223 E0.15682
+G1 X-34.316 Y-72.837 E0.02248
+G1 X-36.647 Y-69.276 E0.28360
+G1 X-36.929 Y-65.429 E0.13923
+G1 X-38.251 Y-61.591 E0.21224 ; comment
+G1 X-39.078 Y-62.888 E0.17481 F2400
+G1 X-40.844 Y-62.803 E0.25934
+G1 X-38.783 Y-63.919 E0.23086 F2400
+G1 X-35.532 Y-66.791 E0.12792
+G1 X-36.907 Y-67.506 E0.11068
+G1 X-34.157 Y-69.915 E0.29162 F1800
+G1 X-37.852 Y-66.581 E0.19505
+G1 X-40.178 Y-67.353 E0.11396
+G1 X-37.186 Y-66.046 E0.02481
+G1 X-39.855 Y-68.548 E0.11311
+G1 X-38.775 Y-70.767 E0.10323
+G1 X-43.125 Y-69.203 E0.26017
+G1 X-42.526 Y-68.647 E0.05295
+G1 X-43.098 Y-65.286 E0.19243
+G1 X-42.570 Y-67.306 E0.14134
+G1 X-43.842 Y-66.926 E0.16860
+G1 X-39.618 Y-70.472 E0.20430
+G1 X-42.227 Y-73.711 E0.28721 F1800
+G1 X-41.322 Y-78.698 E0.08843
+G1 X-40.085 Y-73.915 E0.18465 ; comment
+G1 X-42.539 Y-70.489 E0.27026
+G1 X-45.949 Y-70.084 E0.23786
+G1 X-49.023 Y-68.254 E0.10695
+G1 X-51.260 Y-72.627 E0.23695 F1800
+G1 X-51.631 Y-75.300 E0.22897
+G1 X-51.723 Y-76.345 E0.13961
+G1 X-48.707 Y-79.993 E0.20118
+G1 X-44.304 Y-84.286 E0.18755
+G1 X-40.708 Y-82.978 E0.26650
+G1 X-43.883 Y-79.947 E0.17320
+G1 X-42.143 Y-75.093 E0.09804
+G1 X-41.803 Y-70.433 E0.20920
+G1 X-43.116 Y-68.721 E0.11277
+G1 X-45.144 Y-72.003 E0.09882
+G1 X-45.982 Y-74.602 E0.26457
+G1 X-46.008 Y-78.281 E0.06324
+G1 X-44.961 Y-80.274 E0.27462
+G1 X-42.364 Y-81.887 E0.26098
+G1 X-40.338 Y-79.360 E0.10269
+G1 X-44.970 Y-81.538 E0.09284
+G1 X-48.928 Y-86.361 E0.10193
+G1 X-48.800 Y-87.757 E0.12225 F2400
+G1 X-51.771 Y-84.925 E0.15228
+G1 X-48.546 Y-87.913 E0.04148
+G1 X-49.692 Y-85.571 E0.08826
+G1 X-45.258 Y-81.698 E0.29903
+G1 X-48.548 Y-77.452 E0.17129
+G1 X-43.989 Y-81.202 E0.06768
+G1 X-39.039 Y-78.482 E0.18302
+G1 X-40.787 Y-74.235 E0.15795 F1800
+G1 X-40.865 Y-74.675 E0.18921
+G1 X-36.997 Y-71.853 E0.21762
+G1 X-39.331 Y-74.805 E0.28500
+G1 X-40.284 Y-79.560 E0.05320
+G1 X-39.289 Y-82.930 E0.19735
+G1 X-38.554 Y-87.910 E0.07992 ; comment
+G1 F6000
+G1 X-37.930 Y-86.015 E0.26066
+G1 X-33.225 Y-81.474 E0.04556
+G1 X-31.280 Y-83.728 E0.22368
+;TYPE:Inner wall
+G1 X-29.055 Y-87.564 E0.16395
+G1 X-33.347 Y-88.213 E0.07125
+G1 X-38.126 Y-83.475 E0.01659
+G1 X-38.836 Y-83.403 E0.01669 ; comment
+G1 X-36.726 Y-79.958 E0.05340
+G1 X-40.547 Y-82.490 E0.25967
+G1 X-39.331 Y-85.515 E0.14424
+G1 X-34.570 Y-83.628 E0.15256
+G1 X-32.868 Y-85.923 E0.06368
+M107
+G1 X-28.258 Y-85.824 E0.11040
+G1 X-29.208 Y-85.019 E0.08264
+G1 X-30.727 Y-83.634 E0.05886
+M106 S64
+G1 X-29.362 Y-78.758 E0.12037 F2400
+G1 X-32.975 Y-75.832 E0.05689
+G1 X-35.881 Y-78.477 E0.17831 ; comment
+G1 X-35.582 Y-77.935 E0.15466
+G1 X-37.274 Y-82.518 E0.14119 F2400 ; comment
+G1 X-35.115 Y-83.804 E0.22418
+G1 X-39.141 Y-83.364 E0.04944
+G1 X-37.747 Y-87.861 E0.28250
+G1 X-39.250 Y-84.812 E0.03331
+G1 X-40.204 Y-88.565 E0.17289
+G1 X-43.422 Y-91.195 E0.29871
+G1 X-43.834 Y-88.624 E0.06442
+T1
+G1 X-42.670 Y-93.027 E0.11457 F2400
+G1 X-45.022 Y-95.518 E0.20602
+G1 X-45.186 Y-91.674 E0.04158
+G1 X-48.665 Y-95.536 E0.00822
+G1 X-45.311 Y-100.276 E0.09197
+M106 S128
+G1 X-43.094 Y-102.681 E0.21427
+G1 X-45.255 Y-99.899 E0.13889 ; comment
+G1 X-45.544 Y-95.549 E0.05435
+G1 X-42.942 Y-95.121 E0.27036 ; comment
+G1 X-38.160 Y-99.726 E0.25989 ; comment
+G1 X-34.768 Y-104.338 E0.26202
+G1 X-34.511 Y-108.550 E0.05845
+G1 X-33.669 Y-104.152 E0.05242
+M107
+G1 X-37.557 Y-108.843 E0.11167
+G1 X-35.196 Y-109.385 E0.24495 F2400
+G1 X-32.927 Y-108.839 E0.17664
+M107
+G1 X-28.308 Y-105.252 E0.19258
+G1 X-24.555 Y-108.181 E0.20802
+G1 X-21.585 Y-109.329 E0.14011
+G1 X-24.909 Y-113.933 E0.26750
+G1 X-29.467 Y-117.119 E0.17956
+M107
+G1 X-34.297 Y-112.568 E0.26281 F2400
+G1 X-34.285 Y-116.984 E0.20473
+G1 X-32.814 Y-113.942 E0.08743
+G1 X-32.691 Y-117.179 E0.29526
+G1 X-31.429 Y-115.955 E0.26332
+G1 X-34.396 Y-113.967 E0.14311
+G1 X-33.635 Y-109.823 E0.23908
+G1 X-35.332 Y-111.143 E0.27108
+G1 X-39.811 Y-110.481 E0.23915
+G1 X-44.431 Y-106.414 E0.20423
+G1 X-41.176 Y-109.178 E0.05501
+G1 X-40.708 Y-109.102 E0.09326
+G1 X-41.586 Y-112.637 E0.28861
+M106 S128
+G1 X-40.947 Y-110.514 E0.08663 F1800
+M106 S0
+G1 X-44.175 Y-110.146 E0.10733
+G1 X-42.975 Y-106.367 E0.28350 ; comment
+G1 X-46.261 Y-104.503 E0.28194
+G1 X-48.330 Y-103.631 E0.25967
+G1 X-49.952 Y-100.194 E0.16450
+G1 X-50.138 Y-105.054 E0.18322 ; comment
+G1 X-49.204 Y-101.260 E0.23500
+G1 X-47.860 Y-98.001 E0.02293 F2400
+G1 X-51.998 Y-94.318 E0.24595
+G1 X-48.631 Y-97.425 E0.21902
+G1 X-49.692 Y-92.630 E0.29799
+G1 X-45.947 Y-92.586 E0.03960
+G1 X-45.261 Y-92.568 E0.19322
+G1 X-40.720 Y-94.342 E0.10457
+G1 X-37.762 Y-91.083 E0.09449
+M106 S0
+G1 X-41.931 Y-90.510 E0.25852 F1800
+G1 X-39.325 Y-89.093 E0.14862 F1800 ; comment
+G1 X-36.424 Y-84.716 E0.20639
+G1 X-35.641 Y-81.862 E0.16583
+G1 X-39.571 Y-85.910 E0.18884 F1800 ; comment
+G1 X-38.678 Y-89.891 E0.00857 F2400
+G1 X-41.725 Y-93.823 E0.00369
+M107
+G1 X-40.935 Y-96.748 E0.26477
+G1 X-38.948 Y-99.379 E0.04482
+G1 X-36.553 Y-104.055 E0.21765
+G1 X-38.257 Y-100.254 E0.06671 F2400
+G1 X-43.107 Y-97.294 E0.20085
+G1 X-44.596 Y-95.183 E0.02679 F2400
+G1 X-39.813 Y-95.461 E0.26043
+G1 X-39.727 Y-100.112 E0.28538 F2400
+G1 X-41.727 Y-105.021 E0.11999
+G1 X-37.248 Y-101.311 E0.07687
+G1 X-40.845 Y-102.987 E0.18423
+G1 X-38.768 Y-107.303 E0.26937
+G1 X-35.434 Y-102.471 E0.03211 F2400 ; comment
+G1 X-33.833 Y-102.721 E0.04281
+G1 X-29.831 Y-100.322 E0.04974
+G1 X-25.018 Y-96.425 E0.01633
+G1 X-29.194 Y-93.141 E0.18474
+G1 X-26.873 Y-91.862 E0.16402 ; comment
+G1 X-24.985 Y-92.713 E0.13530
+G1 X-21.945 Y-89.394 E0.07041
+G1 X-26.082 Y-92.495 E0.07367
+G1 X-25.026 Y-93.090 E0.16119
+G1 X-21.178 Y-96.878 E0.03567
+G1 X-20.146 Y-95.835 E0.27181
+G1 X-24.387 Y-97.866 E0.15447
+G1 X-27.496 Y-99.074 E0.17215
+G1 X-31.489 Y-96.254 E0.23832 F1800
+G1 X-35.363 Y-94.330 E0.10930
+M107
+G1 X-38.329 Y-96.863 E0.17498
+;TYPE:Sparse infill
+M107
+G1 X-39.731 Y-94.289 E0.12665
+G1 X-42.616 Y-89.690 E0.23392 ; comment
+G1 X-41.087 Y-88.896 E0.17019
+G1 X-36.564 Y-92.482 E0.15897
+G1 X-34.042 Y-96.275 E0.08901
+G1 X-36.280 Y-92.915 E0.17587
+G1 X-40.934 Y-93.613 E0.03628
+G1 X-43.916 Y-96.050 E0.29263
+G1 X-39.319 Y-92.790 E0.27792
+G1 X-40.997 Y-91.711 E0.09929
+G1 X-43.633 Y-93.313 E0.22276
+G1 X-39.874 Y-96.241 E0.15302
+G1 X-43.235 Y-91.881 E0.18048
+G1 X-44.446 Y-95.094 E0.10686
+G1 X-42.849 Y-90.749 E0.19502
+G1 X-40.341 Y-90.044 E0.17776 ; comment
+M107
+G1 X-41.359 Y-89.027 E0.13277
+G1 X-39.973 Y-91.884 E0.28290
+G1 X-43.498 Y-87.046 E0.05967
+G1 X-40.584 Y-83.142 E0.26760
+G1 X-35.603 Y-84.865 E0.19154 F2400
+G1 X-40.342 Y-82.762 E0.00080
+G1 X-37.468 Y-85.997 E0.10427
+G1 X-35.260 Y-89.064 E0.26341
+G1 X-38.208 Y-91.485 E0.19175
+G1 X-33.220 Y-95.688 E0.02898 ; comment
+;TYPE:Sparse infill
+G1 X-37.198 Y-90.863 E0.05181
+G1 X-35.471 Y-91.356 E0.22373
+G1 X-39.008 Y-87.898 E0.05302
+G1 X-35.123 Y-86.154 E0.14991
+G1 X-36.500 Y-86.196 E0.01195 ; comment
+G1 X-31.839 Y-82.947 E0.14066 F2400
+G1 X-32.002 Y-85.533 E0.06092 F2400
+G1 X-31.945 Y-87.221 E0.19875
+G1 X-36.556 Y-90.862 E0.09578
+G1 X-40.006 Y-87.564 E0.21279
+G1 X-39.892 Y-86.200 E0.21596
+G1 X-40.162 Y-90.002 E0.05214 ; comment
+;LAYER_CHANGE
+G1 Z0.600 F600
+G1 X-37.999 Y-94.799 E0.04413
+G1 X-35.011 Y-95.907 E0.00359
+G1 X-30.693 Y-98.029 E0.11841
+; custom gcode
+M106 S100
+; custom gcode end
+G1 X-29.072 Y-101.767 E0.03058
+G1 X-24.387 Y-100.142 E0.12892
+G1 X-24.684 Y-99.967 E0.03159
+G1 X-23.840 Y-95.881 E0.18657
+G1 X-24.261 Y-91.312 E0.28390 F1800 ; comment
+G1 X-25.016 Y-94.564 E0.27204
+G1 X-28.951 Y-91.827 E0.07353 F2400
+G1 X-32.184 Y-87.863 E0.03388
+G1 X-34.504 Y-86.348 E0.02921
+G1 X-31.728 Y-89.953 E0.25413
+G1 X-32.157 Y-94.522 E0.20955 F1800
+G1 X-32.963 Y-92.538 E0.19132
+G1 X-37.311 Y-91.701 E0.21813 ; comment
+
+G1 X-34.447 Y-90.366 E0.29545
+G1 X-37.071 Y-94.255 E0.11711 F2400
+G1 X-37.377 Y-92.262 E0.23714
+G1 X-36.636 Y-90.592 E0.05862
+G1 X-40.812 Y-92.734 E0.12418
+G1 X-36.885 Y-87.902 E0.15360 ; comment
+G1 X-33.523 Y-89.446 E0.18291 F2400
+G1 X-29.569 Y-91.279 E0.26480 ; comment
+G1 X-29.786 Y-90.516 E0.10077
+G1 X-33.078 Y-87.447 E0.23923
+G1 X-37.448 Y-85.837 E0.04343
+G1 X-37.564 Y-86.568 E0.06131
+G1 X-42.494 Y-82.700 E0.12957
+G1 X-43.112 Y-81.196 E0.12254
+M107
+G1 X-46.424 Y-84.585 E0.01278 ; comment
+G1 X-48.304 Y-83.141 E0.18716 F2400 ; comment
+G1 X-44.843 Y-86.735 E0.22100
+G1 X-40.892 Y-85.368 E0.29530
+;TYPE:Outer wall
+G1 X-44.650 Y-84.387 E0.14898
+G1 X-48.733 Y-81.629 E0.08276
+
+G1 X-44.992 Y-83.362 E0.02516
+G1 X-49.117 Y-83.577 E0.03639
+G1 X-49.570 Y-83.003 E0.27378 ; comment
+G1 X-53.309 Y-79.786 E0.26132
+G1 X-52.386 Y-76.106 E0.16272
+M106 S200
+G1 X-53.526 Y-74.512 E0.18342
+G1 X-48.747 Y-69.749 E0.09479
+G1 X-46.938 Y-66.547 E0.15981
+G1 X-49.907 Y-67.974 E0.14473
+G1 X-45.216 Y-72.847 E0.22304 ; comment
+G1 X-46.093 Y-76.153 E0.10644
+G1 X-48.338 Y-80.492 E0.23530
+G1 X-45.604 Y-84.678 E0.15540
+G1 X-49.297 Y-86.540 E0.04904
+G1 X-47.317 Y-88.534 E0.16452
+G1 X-44.257 Y-88.621 E0.13900
+G1 X-40.033 Y-90.452 E0.17925
+G1 X-39.465 Y-88.579 E0.22560
+G1 X-40.080 Y-89.234 E0.19597
+G1 F3000
+G1 X-43.652 Y-93.701 E0.15632
+G1 X-40.301 Y-89.531 E0.12799 F2400 ; comment
+G1 X-45.296 Y-93.650 E0.04673
+G1 X-41.426 Y-90.319 E0.07193
+G1 X-38.446 Y-93.405 E0.16061
+G1 X-38.304 Y-93.267 E0.08697
+G1 X-38.402 Y-93.060 E0.02308
+G1 X-41.785 Y-97.774 E0.10585
+G1 X-45.654 Y-96.590 E0.24577 ; comment
+G1 X-42.530 Y-96.942 E0.17105
+G1 X-46.027 Y-100.243 E0.16436 F2400
+G1 X-45.451 Y-98.938 E0.25926
+G1 X-41.616 Y-96.882 E0.15635 F2400
+G1 X-38.704 Y-98.139 E0.26617
+G1 X-40.466 Y-101.525 E0.23710
+G1 X-37.819 Y-104.880 E0.27942 F1800
+G1 X-40.281 Y-107.739 E0.26710
+G1 X-38.871 Y-108.864 E0.24647
+G1 X-41.974 Y-108.330 E0.16727
+G1 X-39.556 Y-103.351 E0.12427 ; comment
+G1 X-36.825 Y-107.478 E0.23997 ; comment
+G1 X-33.493 Y-111.142 E0.05418
+G1 X-37.254 Y-108.599 E0.20846
+G1 X-35.810 Y-107.248 E0.07345
+G1 X-36.196 Y-107.621 E0.22168 F1800
+G1 X-33.940 Y-111.749 E0.27001
+G1 X-36.160 Y-110.730 E0.14675
+G1 X-33.984 Y-107.937 E0.19061
+G1 X-37.924 Y-110.226 E0.04394
+G1 X-37.016 Y-113.854 E0.21090 ; comment
+G1 X-37.275 Y-109.866 E0.27512
+G1 X-34.890 Y-107.869 E0.22448
+G1 X-38.220 Y-106.257 E0.20355
+G1 X-37.155 Y-103.283 E0.18893
+G1 X-39.029 Y-101.441 E0.11314
+G1 X-34.928 Y-102.134 E0.03549 F1800 ; comment
+G1 F6000
+G1 X-32.466 Y-101.150 E0.07538
+G1 X-30.322 Y-101.947 E0.03326
+G1 X-33.421 Y-102.041 E0.24017
+G1 X-37.634 Y-102.577 E0.21361
+G1 X-39.600 Y-107.194 E0.16528
+G1 X-41.341 Y-109.819 E0.00140
+G1 X-37.446 Y-106.609 E0.00369
+G1 X-39.347 Y-108.177 E0.05998 ; comment
+G1 X-36.640 Y-109.520 E0.09724
+G1 X-33.528 Y-105.253 E0.24278
+;TYPE:Inner wall
+G1 X-34.146 Y-103.710 E0.11313
+G1 X-36.644 Y-103.261 E0.01341 ; comment
+G1 X-37.763 Y-98.942 E0.15188
+G1 X-37.204 Y-96.675 E0.12037 ; comment
+G1 X-41.478 Y-96.703 E0.14467
+M106 S255
+G1 X-36.571 Y-94.403 E0.15285
+G1 X-33.678 Y-94.907 E0.26198
+G1 X-38.266 Y-98.250 E0.20304
+M106 S0
+; custom gcode
+M106 S100
+; custom gcode end
+G1 X-38.816 Y-99.562 E0.09032
+G1 X-43.496 Y-104.067 E0.12659
+G1 X-39.642 Y-100.126 E0.16174
+G1 X-42.899 Y-99.654 E0.13686
+G1 X-41.839 Y-101.526 E0.04603
+G1 X-38.560 Y-98.681 E0.09914
+M106 S64
+G1 F6000
+G1 X-37.245 Y-93.934 E0.01560
+G1 X-42.016 Y-89.615 E0.18261 ; comment
+G1 X-41.168 Y-85.952 E0.09430 F1800
+G1 X-44.618 Y-90.033 E0.18217 ; comment
+G1 X-41.388 Y-92.584 E0.17647
+G1 X-45.502 Y-94.211 E0.20104
+G1 X-50.286 Y-98.630 E0.03440
+G1 X-51.335 Y-96.231 E0.24736
+G1 X-47.368 Y-93.769 E0.01273
+G1 X-51.957 Y-97.962 E0.00225
+G1 X-48.608 Y-98.875 E0.04163
+G1 X-51.499 Y-95.996 E0.02965
+G1 X-49.725 Y-96.714 E0.04627 F2400
+; custom gcode
+M106 S100
+; custom gcode end
+G1 X-46.390 Y-99.676 E0.28340
+G1 X-41.759 Y-99.873 E0.22130
+G1 X-42.151 Y-101.559 E0.05929
+G1 X-45.542 Y-96.622 E0.10215
+G1 X-46.288 Y-101.290 E0.15621
+G1 X-48.474 Y-97.919 E0.17492
+G1 X-51.313 Y-94.238 E0.22270
+G1 X-46.503 Y-91.968 E0.27474
+G1 X-41.524 Y-89.983 E0.04461
+M106 S128
+G1 X-43.888 Y-91.436 E0.03315
+G1 X-45.088 Y-88.085 E0.12247
+G1 X-46.168 Y-86.282 E0.13221
+G1 X-49.183 Y-88.053 E0.19623
+G1 X-49.234 Y-85.496 E0.20066
+G1 X-48.832 Y-85.126 E0.08030
+G1 X-47.862 Y-90.064 E0.16463
+M107
+G1 X-52.709 Y-87.930 E0.15607
+G1 X-53.025 Y-92.810 E0.15023
+G1 X-51.727 Y-95.417 E0.21605
+G1 X-56.153 Y-90.774 E0.14670
+G1 X-56.602 Y-88.077 E0.11742
+G1 X-57.256 Y-88.158 E0.28780
+G1 X-58.469 Y-88.997 E0.15294 F2400 ; comment
+M106 S200
+G1 X-60.352 Y-90.728 E0.17275
+G1 X-58.324 Y-93.734 E0.28660
+G1 X-56.479 Y-94.162 E0.14352
+G1 X-59.024 Y-89.323 E0.01692
+G1 X-54.215 Y-85.348 E0.29751
+G1 X-52.904 Y-84.293 E0.00903
+G1 X-51.156 Y-88.593 E0.06636
+G1 X-50.013 Y-89.447 E0.17553
+G1 X-47.927 Y-92.481 E0.24290
+G1 X-48.647 Y-89.542 E0.26492
+M106 S128
+G1 X-46.397 Y-90.073 E0.21247
+G1 X-47.146 Y-86.061 E0.20105
+G1 X-48.698 Y-85.121 E0.29412
+G1 X-47.194 Y-85.350 E0.14334
+G1 X-50.605 Y-85.559 E0.04405
+G1 X-52.452 Y-82.559 E0.07054
+G1 X-53.248 Y-80.732 E0.14920
+G1 X-53.224 Y-80.999 E0.13719
+G1 X-55.768 Y-81.642 E0.09435
+G1 X-57.610 Y-85.670 E0.19022
+;TYPE:Overhang wall
+G1 X-56.957 Y-83.981 E0.10619
+G1 X-54.516 Y-83.579 E0.15302
+M107
+G1 X-56.432 Y-80.557 E0.29015
+G1 X-51.537 Y-81.041 E0.26160 F2400
+G1 X-48.888 Y-76.913 E0.29871 ; comment
+G1 X-45.948 Y-75.034 E0.00375
+G1 X-47.916 Y-75.479 E0.27904
+G1 X-44.133 Y-71.380 E0.21541
+G1 X-42.436 Y-74.605 E0.29907 F2400
+G1 X-39.141 Y-74.592 E0.29163
+G1 X-39.970 Y-74.053 E0.06353
+G1 X-43.271 Y-77.083 E0.29640
+G1 X-47.920 Y-72.873 E0.27602 ; comment
+G1 X-43.269 Y-71.244 E0.29473
+G1 X-45.874 Y-75.929 E0.26838
+G1 X-49.504 Y-75.340 E0.09111
+G1 X-52.408 Y-78.020 E0.06407
+G1 X-53.241 Y-77.108 E0.17490 ; comment
+G1 X-52.892 Y-75.410 E0.16502
+G1 X-49.055 Y-73.544 E0.28728
+G1 X-46.843 Y-74.533 E0.29470
+G1 X-50.515 Y-76.062 E0.00867
+G1 X-55.175 Y-72.523 E0.06612
+G1 X-58.683 Y-73.577 E0.09040 F2400
+G1 X-61.664 Y-72.274 E0.20958 ; comment
+G1 X-62.513 Y-75.513 E0.22338
+G1 X-65.101 Y-71.838 E0.01744
+G1 X-63.718 Y-73.825 E0.28279 ; comment
+G1 X-62.050 Y-71.765 E0.06897
+G1 X-63.408 Y-69.740 E0.29115
+G1 X-62.584 Y-67.989 E0.27090 F1800 ; comment
+M106 S255
+G1 X-63.953 Y-66.979 E0.13199
+G1 X-61.479 Y-71.395 E0.18282
+G1 X-65.976 Y-71.013 E0.11156
+G1 X-64.901 Y-70.050 E0.17128
+G1 X-63.153 Y-65.668 E0.03167 F2400
+G1 X-61.775 Y-66.689 E0.02182
+G1 X-66.501 Y-69.836 E0.16201
+G1 X-64.989 Y-74.361 E0.09407
+G1 X-69.963 Y-76.310 E0.12862
+G1 X-67.581 Y-75.942 E0.12227
+G1 X-64.119 Y-79.422 E0.15225
+G1 X-63.533 Y-74.931 E0.17882 ; comment
+G1 X-66.331 Y-78.589 E0.02350
+G1 X-62.402 Y-81.997 E0.12451
+G1 X-66.298 Y-78.521 E0.00948
+G1 X-66.061 Y-74.524 E0.20268
+G1 X-65.338 Y-75.777 E0.23614 ; comment
+G1 X-67.764 Y-76.507 E0.22791
+G1 X-68.072 Y-79.427 E0.20281 F2400
+G1 X-63.856 Y-83.542 E0.07109
+G1 X-62.706 Y-81.399 E0.12060 F2400
+G1 X-67.121 Y-76.545 E0.01596
+G1 X-69.358 Y-77.682 E0.09882
+G1 X-72.548 Y-79.340 E0.03222 ; comment
+G1 X-68.098 Y-79.228 E0.13824
+G1 X-72.459 Y-83.570 E0.08546
+G1 X-71.954 Y-85.658 E0.10031
+G1 X-75.593 Y-86.011 E0.19688
+G1 X-75.963 Y-90.605 E0.20195 F1800
+M107
+G1 X-71.813 Y-89.581 E0.26524
+M106 S255
+G1 X-72.810 Y-93.372 E0.15328
+G1 X-70.466 Y-91.053 E0.17999
+G1 X-67.303 Y-95.984 E0.06408
+G1 X-63.139 Y-94.894 E0.00287
+G1 X-60.434 Y-97.904 E0.06197 F2400
+G1 X-60.664 Y-98.752 E0.23255
+G1 X-60.804 Y-95.278 E0.10435
+G1 X-55.833 Y-96.607 E0.04870
+G1 X-53.928 Y-92.048 E0.20494
+G1 X-53.546 Y-87.454 E0.23419
+G1 X-51.470 Y-84.793 E0.09490
+G1 X-51.154 Y-80.200 E0.03403
+G1 X-55.950 Y-84.671 E0.12749
+G1 X-55.553 Y-85.765 E0.19477
+G1 X-53.110 Y-89.636 E0.00457
+G1 X-52.236 Y-91.109 E0.17413
+G1 F6000
+G1 X-56.201 Y-92.508 E0.14219
+G1 X-54.626 Y-91.312 E0.20152
+G1 X-55.331 Y-93.292 E0.26758 F1800
+G1 X-57.028 Y-98.167 E0.14911 F1800
+G1 X-59.441 Y-98.648 E0.11533
+G1 X-62.226 Y-102.036 E0.02520
+G1 X-66.064 Y-97.344 E0.06434
+G1 X-62.344 Y-98.888 E0.28782
+G1 X-61.044 Y-96.639 E0.29810
+
+G1 X-64.798 Y-92.310 E0.28573
+G1 X-63.449 Y-89.494 E0.25844
+M106 S255
+G1 X-62.486 Y-85.801 E0.05649
+G1 X-60.068 Y-86.744 E0.17482
+G1 X-56.830 Y-88.915 E0.16587
+G1 X-57.622 Y-88.032 E0.25082
+G1 X-62.229 Y-89.899 E0.23096 ; comment
+G1 X-58.447 Y-86.380 E0.22660
+G1 X-59.274 Y-90.848 E0.05843
+T0
+G1 F1200
+G1 X-59.524 Y-92.917 E0.18385
+G1 X-56.545 Y-92.413 E0.19174
+G1 X-55.932 Y-91.278 E0.26493
+G1 X-55.058 Y-88.503 E0.17693
+G1 X-53.377 Y-85.821 E0.14030 ; comment
+;LAYER_CHANGE
+G1 Z0.800 F600
+G1 X-51.106 Y-83.867 E0.03194
+G1 X-46.611 Y-87.744 E0.06452 ; comment
+G1 X-51.112 Y-86.419 E0.18948
+G1 X-53.015 Y-86.519 E0.17641 ; comment
+; custom gcode
+M106 S100
+; custom gcode end
+G1 X-56.111 Y-82.096 E0.12779
+G1 F1200
+G1 X-57.071 Y-79.332 E0.21259
+G1 X-60.260 Y-81.060 E0.06743
+G1 X-57.938 Y-84.056 E0.03687
+G1 X-53.804 Y-79.381 E0.23973
+G1 X-54.613 Y-83.174 E0.07055
+G1 X-55.799 Y-79.018 E0.25382 F1800
+G1 X-59.248 Y-82.104 E0.14721
+
+M106 S64
+G1 X-59.682 Y-85.215 E0.20311 ; comment
+M107
+G1 X-57.567 Y-86.855 E0.03487 F2400
+G1 X-62.077 Y-87.052 E0.22413
+G1 X-64.871 Y-91.306 E0.17638
+G1 X-68.867 Y-94.542 E0.26063
+G1 X-71.448 Y-98.871 E0.29690
+G1 X-72.056 Y-94.145 E0.11449 F2400
+G1 X-70.745 Y-91.249 E0.03960
+G1 X-73.994 Y-94.442 E0.02931
+G1 X-76.114 Y-91.807 E0.09958
+G1 X-78.327 Y-89.200 E0.11319
+G1 X-81.883 Y-87.214 E0.13780 ; comment
+G1 X-84.688 Y-85.770 E0.24535
+G1 X-79.733 Y-85.102 E0.15647
+G1 X-75.373 Y-80.121 E0.10615
+G1 X-74.989 Y-77.391 E0.09670
+G1 X-76.744 Y-76.105 E0.05735
+G1 X-76.709 Y-75.733 E0.18683
+G1 X-75.461 Y-75.628 E0.26187 F1800
+G1 X-71.085 Y-76.660 E0.02504
+G1 X-70.474 Y-78.409 E0.12685
+G1 X-70.231 Y-81.016 E0.28527 ; comment
+G1 X-65.768 Y-81.314 E0.15864 F1800
+G1 X-64.624 Y-83.294 E0.28858
+G1 X-66.374 Y-84.370 E0.20049
+G1 X-62.629 Y-83.938 E0.25370
+G1 X-60.079 Y-83.355 E0.15971
+G1 X-64.228 Y-85.887 E0.28040 ; comment
+G1 X-68.784 Y-87.354 E0.20784
+G1 X-70.399 Y-91.101 E0.24754
+G1 X-71.565 Y-92.542 E0.10918
+;TYPE:Outer wall
+G1 X-67.786 Y-95.071 E0.01350
+M106 S200
+G1 X-66.978 Y-92.329 E0.27183
+G1 X-69.986 Y-93.011 E0.14609
+G1 X-74.537 Y-96.670 E0.07269
+M106 S64
+G1 X-70.867 Y-100.399 E0.14671
+G1 X-70.386 Y-102.757 E0.12536 F2400
+G1 X-68.568 Y-100.068 E0.13244
+G1 X-65.529 Y-95.745 E0.04587
+G1 X-67.818 Y-96.810 E0.08143
+G1 X-69.256 Y-99.997 E0.24220
+;TYPE:Sparse infill
+G1 X-67.370 Y-99.249 E0.21247
+G1 X-70.849 Y-94.250 E0.20581
+G1 X-71.920 Y-95.064 E0.04685
+G1 X-74.748 Y-92.606 E0.28397
+
+G1 X-79.226 Y-93.316 E0.12516
+G1 X-78.783 Y-91.824 E0.07370 ; comment
+G1 X-77.874 Y-87.641 E0.27273 ; comment
+G1 X-76.052 Y-85.238 E0.09533
+G1 X-78.287 Y-89.090 E0.21356
+G1 X-78.859 Y-91.947 E0.00734
+G1 X-79.607 Y-93.213 E0.14190
+G1 X-82.347 Y-90.867 E0.14450
+G1 X-77.604 Y-95.727 E0.21283
+G1 X-78.192 Y-96.557 E0.12268
+G1 X-82.740 Y-98.240 E0.07486
+G1 X-84.353 Y-98.611 E0.14042
+G1 X-85.138 Y-98.457 E0.19580
+G1 X-81.690 Y-102.028 E0.06580
+G1 X-78.558 Y-101.013 E0.00116
+G1 X-75.430 Y-103.971 E0.19344
+G1 X-79.155 Y-107.175 E0.17080 ; comment
+G1 X-81.924 Y-106.950 E0.15032
+G1 X-83.858 Y-102.463 E0.10615
+G1 X-81.933 Y-104.222 E0.03215
+G1 X-83.279 Y-101.072 E0.18475
+G1 X-83.152 Y-98.882 E0.29974
+G1 X-81.027 Y-102.585 E0.14262
+G1 X-85.063 Y-97.755 E0.11160
+G1 X-85.893 Y-96.253 E0.24289
+G1 X-83.867 Y-97.807 E0.14734
+G1 X-84.712 Y-94.527 E0.26053
+G1 X-86.060 Y-91.938 E0.00888
+G1 X-85.353 Y-91.576 E0.28010
+G1 X-85.413 Y-91.821 E0.24259 F1800
+G1 X-86.023 Y-90.686 E0.25084
+G1 X-90.380 Y-87.488 E0.25422
+G1 X-89.054 Y-89.068 E0.06226 F2400
+G1 X-84.502 Y-84.684 E0.03944
+G1 X-83.643 Y-79.809 E0.10202
+G1 X-86.300 Y-82.402 E0.27587
+G1 X-88.727 Y-85.203 E0.26656
+G1 X-87.565 Y-82.482 E0.19832
+G1 X-84.302 Y-86.702 E0.05663
+G1 X-85.406 Y-90.181 E0.20755
+M106 S128
+G1 X-89.682 Y-87.943 E0.16713
+G1 X-86.333 Y-88.980 E0.26825
+G1 X-85.568 Y-91.878 E0.24044
+G1 X-88.864 Y-92.287 E0.28003
+G1 X-84.437 Y-95.462 E0.12180
+G1 X-83.758 Y-94.413 E0.03818
+G1 X-82.577 Y-98.361 E0.16248
+G1 X-85.698 Y-103.041 E0.12398
+G1 X-90.233 Y-99.568 E0.05586 ; comment
+G1 X-91.047 Y-100.503 E0.15077
+G1 X-90.894 Y-99.707 E0.06169
+G1 X-90.407 Y-104.200 E0.26037
+G1 X-94.924 Y-109.192 E0.25968
+G1 X-90.224 Y-112.709 E0.26909
+G1 X-87.764 Y-114.974 E0.26771 F2400
+G1 X-87.595 Y-119.389 E0.21695
+G1 X-87.507 Y-114.415 E0.03193 ; comment
+G1 X-85.787 Y-117.877 E0.23294
+G1 X-87.703 Y-115.735 E0.10248
+G1 X-83.670 Y-112.354 E0.27926 ; comment
+G1 X-85.544 Y-111.206 E0.04144
+G1 X-89.459 Y-113.190 E0.24021
+G1 X-87.907 Y-117.106 E0.16439
+G1 X-90.135 Y-121.994 E0.07394
+G1 X-90.749 Y-117.557 E0.16934
+M106 S0
+G1 X-92.108 Y-114.715 E0.07871
+G1 X-94.480 Y-115.948 E0.05960
+G1 X-90.058 Y-118.101 E0.19523
+G1 X-91.829 Y-116.550 E0.27844
+
+G1 X-89.143 Y-113.344 E0.21133 ; comment
+G1 X-89.949 Y-111.447 E0.09464
+G1 X-88.080 Y-111.804 E0.20611
+G1 X-90.160 Y-114.815 E0.27299
+G1 X-89.919 Y-116.079 E0.13545
+G1 X-92.619 Y-114.224 E0.24546 F2400
+G1 F6000
+G1 X-92.527 Y-109.431 E0.21901
+G1 X-92.191 Y-113.858 E0.29624 F1800
+G1 X-91.230 Y-114.282 E0.11705
+G1 X-94.954 Y-116.164 E0.05403
+G1 X-93.058 Y-120.031 E0.25254
+G1 X-94.030 Y-117.485 E0.29811
+G1 X-90.421 Y-114.802 E0.01572
+G1 X-93.266 Y-114.254 E0.18881
+G1 X-96.537 Y-112.694 E0.04741 F1800
+G1 X-94.506 Y-113.988 E0.19246
+G1 X-97.762 Y-109.837 E0.19398
+;TYPE:Outer wall
+G1 X-93.443 Y-114.625 E0.14115
+G1 X-98.094 Y-110.835 E0.13004
+G1 X-102.050 Y-115.521 E0.01438
+G1 X-102.654 Y-111.423 E0.06338
+G1 X-107.397 Y-112.289 E0.13832
+G1 X-110.104 Y-108.870 E0.29360
+G1 X-113.100 Y-105.339 E0.16282
+G1 X-116.689 Y-109.091 E0.26827 ; comment
+G1 X-112.625 Y-105.735 E0.03541
+G1 X-113.560 Y-102.307 E0.13900 ; comment
+G1 X-111.356 Y-97.982 E0.04919
+G1 X-109.740 Y-96.395 E0.28676
+G1 X-108.062 Y-98.926 E0.26118
+G1 X-105.860 Y-94.008 E0.25739
+G1 X-105.234 Y-96.444 E0.26028
+G1 X-101.523 Y-95.867 E0.03698 F1800
+G1 X-104.678 Y-99.333 E0.10248 F1800
+G1 X-106.994 Y-94.573 E0.28526 F1800
+G1 X-107.878 Y-97.950 E0.24773
+G1 X-106.293 Y-101.444 E0.02071 F2400
+G1 X-109.577 Y-96.517 E0.22715
+G1 X-105.291 Y-96.992 E0.15656
+G1 X-106.009 Y-99.679 E0.28857
+G1 X-109.090 Y-104.132 E0.04639
+G1 X-111.812 Y-99.963 E0.27617
+G1 X-112.040 Y-96.724 E0.13004
+G1 X-115.035 Y-95.525 E0.01118 ; comment
+G1 X-116.104 Y-98.394 E0.10858
+G1 X-111.271 Y-101.630 E0.29338
+G1 X-115.228 Y-97.568 E0.13664 F2400
+G1 X-111.998 Y-99.622 E0.29054
+G1 X-107.530 Y-98.481 E0.02206
+G1 X-105.702 Y-102.269 E0.00608
+G1 X-107.666 Y-99.857 E0.27453
+G1 X-108.568 Y-96.254 E0.05488
+G1 X-106.230 Y-93.473 E0.10944 F2400 ; comment
+G1 X-105.560 Y-92.727 E0.13331
+G1 X-103.012 Y-89.804 E0.24921
+G1 X-100.334 Y-90.952 E0.02659 F1800
+G1 X-98.115 Y-89.223 E0.02290
+G1 X-99.332 Y-87.931 E0.25230
+G1 X-98.658 Y-86.591 E0.27649
+G1 X-94.991 Y-89.256 E0.11743
+G1 X-97.434 Y-92.753 E0.24772
+G1 X-100.222 Y-90.037 E0.19454
+G1 X-95.998 Y-89.671 E0.16322
+G1 X-96.621 Y-90.850 E0.27781
+G1 X-100.346 Y-88.898 E0.15726
+G1 X-100.507 Y-84.247 E0.28134
+G1 X-100.385 Y-81.139 E0.05432 ; comment
+G1 X-102.656 Y-78.668 E0.07935
+G1 X-102.326 Y-78.613 E0.00091
+G1 X-104.792 Y-76.659 E0.04750
+G1 X-101.532 Y-79.576 E0.07632
+G1 X-99.237 Y-74.800 E0.18457 F1800
+G1 X-99.725 Y-74.655 E0.11494
+M107
+; custom gcode
+M106 S100
+; custom gcode end
+M106 S255
+G1 X-101.803 Y-73.156 E0.27126 F1800
+G1 X-101.928 Y-75.696 E0.13222
+G1 X-105.065 Y-78.117 E0.24396
+G1 X-105.321 Y-73.720 E0.27888
+G1 X-103.302 Y-71.168 E0.19804
+G1 X-98.687 Y-73.158 E0.01029
+G1 X-94.632 Y-72.996 E0.16217
+G1 X-98.604 Y-77.573 E0.21390
+G1 X-99.850 Y-74.614 E0.03848 F2400
+G1 X-99.746 Y-77.758 E0.11149
+G1 X-104.642 Y-81.414 E0.08715
+G1 X-100.984 Y-84.811 E0.04879
+G1 X-105.416 Y-80.828 E0.11517
+G1 X-102.958 Y-81.099 E0.14609
+G1 X-107.471 Y-76.441 E0.06228
+G1 X-108.633 Y-75.767 E0.05087
+G1 X-107.618 Y-80.357 E0.03097
+G1 X-112.074 Y-82.593 E0.28132
+G1 X-116.547 Y-82.419 E0.05805 F1800 ; comment
+G1 X-118.174 Y-79.617 E0.23921
+G1 X-119.433 Y-81.607 E0.16328
+G1 F3000
+G1 X-119.330 Y-82.135 E0.06017 ; comment
+G1 X-123.390 Y-81.972 E0.21709 F2400
+G1 X-123.706 Y-83.385 E0.00822
+G1 X-128.627 Y-81.595 E0.03467 ; comment
+G1 X-126.633 Y-82.820 E0.01241
+G1 X-124.678 Y-86.044 E0.28069
+G1 X-124.960 Y-81.430 E0.10421
+G1 X-127.966 Y-79.323 E0.23944
+G1 X-126.448 Y-75.424 E0.17066
+G1 X-126.741 Y-79.956 E0.02034
+G1 X-122.383 Y-75.419 E0.09092
+G1 X-119.883 Y-75.183 E0.25275
+G1 X-118.054 Y-79.205 E0.00174
+G1 X-113.197 Y-83.907 E0.19295
+G1 X-115.621 Y-85.968 E0.05163
+G1 X-111.410 Y-84.815 E0.02421
+G1 X-112.672 Y-85.644 E0.10332
+G1 X-115.692 Y-84.631 E0.27702 F2400
+G1 X-114.694 Y-80.314 E0.19059
+G1 X-115.444 Y-83.739 E0.01201
+G1 X-118.627 Y-81.923 E0.19155
+M107
+G1 X-114.127 Y-83.587 E0.27523
+G1 X-114.266 Y-80.597 E0.22536
+G1 X-110.731 Y-82.839 E0.04054 F2400
+G1 X-110.279 Y-87.262 E0.10238
+G1 X-108.321 Y-91.766 E0.12072
+G1 X-110.716 Y-93.384 E0.11355
+G1 X-114.466 Y-94.599 E0.01638
+G1 X-112.787 Y-95.582 E0.05677
+G1 X-111.123 Y-91.294 E0.19478
+G1 X-110.854 Y-89.644 E0.09387
+G1 X-108.683 Y-94.146 E0.26054 F1800
+G1 X-113.033 Y-97.521 E0.26163
+G1 X-113.753 Y-99.519 E0.15298
+;TYPE:Outer wall
+G1 X-117.311 Y-94.836 E0.24637
+G1 X-113.135 Y-95.416 E0.23485
+G1 X-111.387 Y-96.314 E0.25806
+G1 X-110.680 Y-98.504 E0.29438
+G1 X-111.168 Y-101.140 E0.09653 ; comment
+G1 X-112.431 Y-98.167 E0.09675
+G1 X-112.377 Y-94.173 E0.17394
+G1 X-117.294 Y-91.799 E0.06105
+G1 X-113.156 Y-86.910 E0.02642
+G1 X-109.277 Y-87.568 E0.23144
+G1 X-112.855 Y-85.016 E0.18451 F2400
+G1 X-113.735 Y-80.801 E0.02269 ; comment
+G1 X-113.498 Y-77.830 E0.25601
+G1 X-113.858 Y-75.013 E0.11747
+G1 X-110.649 Y-73.807 E0.01032 F2400
+G1 X-114.929 Y-75.909 E0.07029
+G1 X-116.805 Y-75.991 E0.19315
+M106 S0
+G1 X-115.842 Y-72.855 E0.05391
+G1 X-113.858 Y-73.480 E0.08098
+G1 X-111.559 Y-73.285 E0.23947 ; comment
+G1 X-111.285 Y-71.761 E0.24496
+G1 X-112.417 Y-66.863 E0.27695 F1800
+G1 X-108.655 Y-71.412 E0.09152
+G1 X-111.283 Y-75.214 E0.10151
@@ -0,0 +1,172 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+#include "libslic3r/GCode.hpp"
+#include "libslic3r/GCode/CoolingBuffer.hpp"
+#include "libslic3r/GCode/FanMover.hpp"
+#include "libslic3r/Utils.hpp"
+
+using namespace Slic3r;
+
+static std::string process_cooling_layer(const std::string &gcode)
+{
+    PrintConfig print_config;
+    print_config.gcode_flavor.value                = gcfMarlinFirmware;
+    print_config.slow_down_for_layer_cooling.values = { 1 };
+    print_config.slow_down_layer_time.values       = { 10 };
+    print_config.slow_down_min_speed.values        = { 10 };
+    GCode gcodegen;
+    gcodegen.apply_print_config(print_config);
+    gcodegen.set_layer_count(10);
+    gcodegen.writer().set_extruders({ 0 });
+    gcodegen.writer().set_extruder(0);
+    CoolingBuffer cooling_buffer(gcodegen);
+    return cooling_buffer.process_layer(std::string(gcode), 5, true);
+}
+
+TEST_CASE("Cooling counts the dwells toward the layer time", "[CoolingBuffer]") {
+    // 100mm at 50mm/s, that is 2 seconds of printing, below the 10 seconds of slow_down_layer_time.
+    const std::string extrusion =
+        "G1 X0 Y0 F12000\n"
+        "G1 F3000;_EXTRUDE_SET_SPEED\n"
+        "G1 X100 Y0 E1\n"
+        ";_EXTRUDE_END\n";
+    SECTION("The layer without a dwell is slowed down") {
+        REQUIRE(process_cooling_layer(extrusion).find("G1 F3000\n") == std::string::npos);
+    }
+    SECTION("A dwell in seconds fills in the layer time") {
+        REQUIRE(process_cooling_layer(extrusion + "G4 S10\n").find("G1 F3000\n") != std::string::npos);
+    }
+    SECTION("A dwell in milliseconds fills in the layer time") {
+        REQUIRE(process_cooling_layer(extrusion + "G4 P10000\n").find("G1 F3000\n") != std::string::npos);
+    }
+}
+
+TEST_CASE("Fan mover splits a move at the position of the delayed fan command", "[FanMover]") {
+    GCodeWriter writer;
+    writer.config.gcode_flavor.value = gcfMarlinFirmware;
+    // Three 1 second moves followed by a fan start, moved 1.5 seconds ahead into the middle of the second move.
+    SECTION("Absolute E") {
+        FanMover fan_mover(writer, 1.5f, false, false, false, 0.f);
+        REQUIRE(fan_mover.process_gcode(
+            "G1 X0 Y0 F6000\n"
+            "G1 X100 Y0 E10\n"
+            "G1 X200 Y0 E20\n"
+            "G1 X300 Y0 E30\n"
+            "M106 S255\n", true) ==
+            "G1 X0 Y0 F6000\n"
+            "G1 X100 Y0 E10\n"
+            "G1 X150.000 Y0 E15.00000\n"
+            "M106 S255\n"
+            "G1 X200 Y0 E20\n"
+            "G1 X300 Y0 E30\n");
+    }
+    SECTION("Relative E") {
+        FanMover fan_mover(writer, 1.5f, false, true, false, 0.f);
+        REQUIRE(fan_mover.process_gcode(
+            "G1 X0 Y0 F6000\n"
+            "G1 X100 Y0 E10\n"
+            "G1 X200 Y0 E10\n"
+            "G1 X300 Y0 E10\n"
+            "M106 S255\n", true) ==
+            "G1 X0 Y0 F6000\n"
+            "G1 X100 Y0 E10\n"
+            "G1 X150.000 Y0 E5.00000\n"
+            "M106 S255\n"
+            "G1 X200 Y0 E5.00000\n"
+            "G1 X300 Y0 E10\n");
+    }
+}
+
+// The golden outputs in fff_print_tests/test_cooling were written by the CoolingBuffer and the FanMover
+// as they were before the LayerMoves, parsing the G-code text themselves.
+static std::string load_test_gcode(const char *name)
+{
+    std::string gcode;
+    load_string_file(std::string(TEST_DATA_DIR) + "/fff_print_tests/test_cooling/" + name, gcode);
+    return gcode;
+}
+
+static std::vector<std::string> split_layers(const std::string &gcode)
+{
+    std::vector<std::string> layers;
+    for (size_t begin = 0; begin < gcode.size();) {
+        size_t end = gcode.find(";LAYER_CHANGE", begin + 1);
+        if (end == std::string::npos)
+            end = gcode.size();
+        layers.emplace_back(gcode.substr(begin, end - begin));
+        begin = end;
+    }
+    return layers;
+}
+
+static bool same_moves(const std::string &gcode, const LayerMoves &moves, const LayerMoves &expected)
+{
+    if (moves.size() != expected.size())
+        return false;
+    for (size_t i = 0; i < moves.size(); ++ i) {
+        const LayerMove &a = moves.moves[i];
+        const LayerMove &b = expected.moves[i];
+        if (a.type != b.type || a.tool != b.tool || a.axis_mask != b.axis_mask || a.raw(gcode) != b.raw(gcode) || a.cmd(gcode) != b.cmd(gcode))
+            return false;
+        for (int axis = 0; axis < LayerMove::NumAxes; ++ axis)
+            if (a.has(LayerMove::Axis(axis)) && a.value(LayerMove::Axis(axis)) != b.value(LayerMove::Axis(axis)))
+                return false;
+    }
+    return true;
+}
+
+TEST_CASE("Cooling of parsed layers matches the golden output", "[CoolingBuffer]") {
+    PrintConfig print_config;
+    print_config.gcode_flavor.value                          = gcfMarlinFirmware;
+    print_config.slow_down_for_layer_cooling.values           = { 1 };
+    print_config.slow_down_layer_time.values                 = { 10 };
+    print_config.slow_down_min_speed.values                  = { 10 };
+    print_config.fan_cooling_layer_time.values               = { 30 };
+    print_config.overhang_fan_speed.values                   = { 100 };
+    print_config.support_material_interface_fan_speed.values = { 80 };
+    print_config.close_fan_the_first_x_layers.values         = { 1 };
+    GCode gcodegen;
+    gcodegen.apply_print_config(print_config);
+    gcodegen.writer().set_extruders({ 0, 1 });
+    const std::string toolchange_prefix = gcodegen.writer().toolchange_prefix();
+    CoolingBuffer cooling_text(gcodegen);
+    CoolingBuffer cooling_moves(gcodegen);
+
+    std::string out_text;
+    std::string out_moves;
+    std::vector<std::string> layers = split_layers(load_test_gcode("layers.gcode"));
+    for (size_t layer_id = 0; layer_id < layers.size(); ++ layer_id) {
+        // Cache some of the layers, as the support layers preceding an object layer are.
+        bool flush = layer_id % 3 != 1;
+        out_text += cooling_text.process_layer(std::string(layers[layer_id]), layer_id, flush);
+        LayerResult in { layers[layer_id], layer_id, false, flush };
+        in.moves = LayerMoves::parse(in.gcode, toolchange_prefix);
+        LayerResult out = cooling_moves.process_layer(std::move(in));
+        // The moves handed to the FanMover are those of the cooled G-code.
+        REQUIRE(same_moves(out.gcode, out.moves, LayerMoves::parse(out.gcode, toolchange_prefix)));
+        out_moves += out.gcode;
+    }
+    const std::string golden = load_test_gcode("layers_cooled.gcode");
+    REQUIRE(out_text == golden);
+    REQUIRE(out_moves == golden);
+}
+
+TEST_CASE("Fan mover of parsed layers matches the golden output", "[FanMover]") {
+    GCodeWriter writer;
+    writer.config.gcode_flavor.value = gcfMarlinFirmware;
+    FanMover fan_mover_text(writer, 1.5f, false, true, false, 0.6f);
+    FanMover fan_mover_moves(writer, 1.5f, false, true, false, 0.6f);
+
+    std::string out_text;
+    std::string out_moves;
+    for (const std::string &layer : split_layers(load_test_gcode("layers_relative_e.gcode"))) {
+        out_text += fan_mover_text.process_gcode(layer, true);
+        out_moves += fan_mover_moves.process_gcode(layer, LayerMoves::parse(layer, writer.toolchange_prefix()), true);
+    }
+    const std::string golden = load_test_gcode("layers_relative_e_fan_moved.gcode");
+    REQUIRE(out_text == golden);
+    REQUIRE(out_moves == golden);
+}
@@ -1,6 +1,8 @@
 #include <catch2/catch.hpp>
 
+#include <iomanip>
 #include <memory>
+#include <sstream>
 
 #include "libslic3r/GCodeWriter.hpp"
 
@@ -94,3 +96,65 @@ SCENARIO("set_speed emits values with fixed-point output.", "[GCodeWriter]") {
         }
     }
 }
+
+SCENARIO("GCodeFormatter output matches std::ostream and appends in place.", "[GCodeWriter]") {
+
+    GIVEN("Values formatted by std::ostringstream") {
+        const double values[] = { 0., -0.5, 1., 0.1, 33.3, 333.33333, 1234567., 1e-7, -2.5e12, 0.0004 };
+        WHEN("They are formatted by emit_int() and emit_double() with various precisions") {
+            THEN("The output is identical") {
+                for (double v : values)
+                    for (int precision : { 2, 4, 6 }) {
+                        std::ostringstream ss;
+                        ss << std::setprecision(precision) << v << " " << int64_t(v);
+                        GCodeFormatter w;
+                        w.emit_double(v, precision);
+                        w.emit_char(' ');
+                        w.emit_int(int64_t(v));
+                        REQUIRE_THAT(w.string(), Catch::Equals(ss.str() + "\n"));
+                    }
+            }
+        }
+    }
+    GIVEN("An output buffer with some G-code") {
+        std::string gcode = "G90\n";
+        WHEN("Lines with long comments are appended to it") {
+            const std::string comment(1000, 'c');
+            for (int i = 0; i < 10; ++ i) {
+                GCodeG1Formatter w(gcode);
+                w.emit_xy(Vec2d(i, 2.5));
+                w.emit_comment(true, comment);
+                w.end_line();
+            }
+            THEN("The buffer contains all of them") {
+                REQUIRE(gcode.size() == 4 + 10 * (std::string("G1 X0 Y2.5 ; \n").size() + comment.size()));
+                REQUIRE(gcode.compare(0, 16, "G90\nG1 X0 Y2.5 ;") == 0);
+                REQUIRE(gcode.back() == '\n');
+            }
+        }
+        WHEN("A formatter is destroyed without ending its line") {
+            {
+                GCodeG1Formatter w(gcode);
+                w.emit_f(1200.);
+            }
+            THEN("The buffer is rolled back to its content before the formatter") {
+                REQUIRE_THAT(gcode, Catch::Equals("G90\n"));
+            }
+        }
+        WHEN("A line is ended without the line feed") {
+            {
+                GCodeG1Formatter w(gcode);
+                w.emit_f(1200.);
+                w.end_line(false);
+            }
+            THEN("The buffer keeps the line without the line feed") {
+                REQUIRE_THAT(gcode, Catch::Equals("G90\nG1 F1200"));
+            }
+        }
+    }
+}
+
+SCENARIO("set_exhaust_fan() optionally omits the line feed", "[GCodeWriter]") {
+    REQUIRE_THAT(GCodeWriter::set_exhaust_fan(100, true), Catch::Equals("M106 P3 S255\n"));
+    REQUIRE_THAT(GCodeWriter::set_exhaust_fan(100, false), Catch::Equals("M106 P3 S255"));
+}
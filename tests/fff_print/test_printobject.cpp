@@ -3,6 +3,11 @@
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+#include "libslic3r/PrintObjectStepCache.hpp"
+#include "libslic3r/GCode/ConflictChecker.hpp"
+
+#include <boost/filesystem.hpp>
 
 #include "test_data.hpp"
 
@@ -87,3 +92,175 @@ SCENARIO("PrintObject: object layer heights", "[PrintObject]") {
 #endif
     }
 }
+
+SCENARIO("PrintObject: step cache", "[PrintObject]") {
+    GIVEN("20mm cube") {
+        auto keys = [](std::initializer_list<Slic3r::ConfigBase::SetDeserializeItem> config_items) {
+            Slic3r::Print print;
+            Slic3r::Model model;
+            Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config_items);
+            const PrintObject &object = *print.objects().front();
+            return std::vector<std::string>{ PrintObjectStepCache::key(object, posSlice), PrintObjectStepCache::key(object, posPerimeters), PrintObjectStepCache::key(object, posPrepareInfill) };
+        };
+        const std::vector<std::string> base = keys({ { "sparse_infill_density", "15%" } });
+        WHEN("the infill pattern changes") {
+            const std::vector<std::string> changed = keys({ { "sparse_infill_density", "15%" }, { "sparse_infill_pattern", "gyroid" } });
+            THEN("only the key of posPrepareInfill changes") {
+                REQUIRE(changed[0] == base[0]);
+                REQUIRE(changed[1] == base[1]);
+                REQUIRE(changed[2] != base[2]);
+            }
+        }
+        WHEN("the sparse infill density changes to zero") {
+            const std::vector<std::string> changed = keys({ { "sparse_infill_density", "0%" } });
+            THEN("the keys of posPerimeters and posPrepareInfill change") {
+                REQUIRE(changed[0] == base[0]);
+                REQUIRE(changed[1] != base[1]);
+                REQUIRE(changed[2] != base[2]);
+            }
+        }
+        WHEN("the layer height changes") {
+            const std::vector<std::string> changed = keys({ { "sparse_infill_density", "15%" }, { "layer_height", 0.3 } });
+            THEN("all keys change") {
+                REQUIRE(changed[0] != base[0]);
+                REQUIRE(changed[1] != base[1]);
+                REQUIRE(changed[2] != base[2]);
+            }
+        }
+        WHEN("a PrintConfig option only affecting the G-code export changes") {
+            const std::vector<std::string> changed = keys({ { "sparse_infill_density", "15%" }, { "machine_start_gcode", "G28 ; changed" } });
+            THEN("no key changes") {
+                REQUIRE(changed == base);
+            }
+        }
+        WHEN("a PrintConfig option invalidating the perimeters changes") {
+            const std::vector<std::string> changed = keys({ { "sparse_infill_density", "15%" }, { "wall_sequence", "outer wall/inner wall" } });
+            THEN("the keys of posPerimeters and posPrepareInfill change") {
+                REQUIRE(changed[0] == base[0]);
+                REQUIRE(changed[1] != base[1]);
+                REQUIRE(changed[2] != base[2]);
+            }
+        }
+        WHEN("the object is processed twice with the same step cache") {
+            boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("step_cache_%%%%-%%%%");
+            auto step_cache = std::make_shared<PrintObjectStepCache>(dir.string());
+            auto process = [&step_cache]() {
+                Slic3r::Print print;
+                Slic3r::Model model;
+                Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, { { "sparse_infill_density", "15%" } });
+                print.set_step_cache(step_cache);
+                print.process();
+                // Islands, perimeters and typed fill surfaces of all layers.
+                std::vector<ExPolygons>                         lslices;
+                std::vector<Polylines>                          perimeters;
+                std::vector<std::pair<SurfaceType, ExPolygon>> fill_surfaces;
+                for (const Layer *layer : print.objects().front()->layers()) {
+                    lslices.emplace_back(layer->lslices);
+                    perimeters.emplace_back();
+                    layer->regions().front()->perimeters.collect_polylines(perimeters.back());
+                    for (const Surface &surface : layer->regions().front()->fill_surfaces)
+                        fill_surfaces.emplace_back(surface.surface_type, surface.expolygon);
+                }
+                return std::make_tuple(lslices, perimeters, fill_surfaces);
+            };
+            const auto first  = process();
+            const auto second = process();
+            boost::filesystem::remove_all(dir);
+            THEN("the restored layers match the computed ones") {
+                REQUIRE(! std::get<0>(first).empty());
+                REQUIRE(! std::get<2>(first).empty());
+                REQUIRE(std::get<0>(first) == std::get<0>(second));
+                REQUIRE(std::get<1>(first) == std::get<1>(second));
+                REQUIRE(std::get<2>(first) == std::get<2>(second));
+            }
+        }
+        for (const char *pattern : { "lightning", "adaptivecubic", "supportcubic" })
+            WHEN(std::string("the object with the ") + pattern + " infill is processed twice with the same step cache") {
+                boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("step_cache_%%%%-%%%%");
+                auto step_cache = std::make_shared<PrintObjectStepCache>(dir.string());
+                auto process = [&step_cache, pattern]() {
+                    Slic3r::Print print;
+                    Slic3r::Model model;
+                    Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, { { "sparse_infill_density", "15%" }, { "sparse_infill_pattern", pattern } });
+                    print.set_step_cache(step_cache);
+                    print.process();
+                    // Infill of all layers, generated with the octrees resp. the lightning generator.
+                    std::vector<Polylines> fills;
+                    for (const Layer *layer : print.objects().front()->layers()) {
+                        fills.emplace_back();
+                        layer->regions().front()->fills.collect_polylines(fills.back());
+                    }
+                    return fills;
+                };
+                const std::vector<Polylines> first  = process();
+                const std::vector<Polylines> second = process();
+                boost::filesystem::remove_all(dir);
+                THEN("the infill is regenerated and matches the computed one") {
+                    REQUIRE(! first.empty());
+                    REQUIRE(first == second);
+                }
+            }
+    }
+}
+
+SCENARIO("PrintObject: slicing index is reused by reslicing", "[PrintObject]") {
+    GIVEN("20mm cube") {
+        DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        print.process();
+        auto index = [&print]() {
+            const PrintObject &object = *print.objects().front();
+            const ModelVolume &volume = *object.model_object()->volumes.front();
+            return volume.slicing_index(object.trafo_centered() * volume.get_matrix(), false);
+        };
+        std::shared_ptr<const MeshSlicingIndex> first = index();
+        WHEN("the object is resliced with a different layer height") {
+            config.set_deserialize_strict({ { "layer_height", 0.3 } });
+            print.apply(model, config);
+            print.process();
+            THEN("the slicing index of the first slicing is reused") {
+                REQUIRE(index() == first);
+            }
+        }
+        WHEN("the object is rotated") {
+            model.objects.front()->rotate(0.5 * PI, Axis::Z);
+            print.apply(model, config);
+            print.process();
+            THEN("a new slicing index is built") {
+                REQUIRE(index() != first);
+            }
+        }
+    }
+}
+
+SCENARIO("Print: Conflict checker reuses the pairs of unchanged objects", "[PrintObject]") {
+    GIVEN("Three separated 20mm cubes") {
+        DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20, TestMesh::cube_20x20x20, TestMesh::cube_20x20x20}, print, model, config);
+        print.process();
+        ConflictChecker checker;
+        REQUIRE(! checker.find_conflict(print.objects_mutable(), {}));
+        REQUIRE(checker.num_checked_pairs() == 3);
+        WHEN("nothing changes") {
+            THEN("no pair is checked again") {
+                REQUIRE(! checker.find_conflict(print.objects_mutable(), {}));
+                REQUIRE(checker.num_checked_pairs() == 0);
+            }
+        }
+        WHEN("the last object is moved onto the first one") {
+            Vec3d offset = model.objects.front()->instances.front()->get_offset();
+            model.objects.back()->instances.front()->set_offset(offset + Vec3d(5., 5., 0.));
+            print.apply(model, config);
+            print.process();
+            THEN("only the pairs with the moved object are checked, and they conflict") {
+                ConflictResultOpt conflict = checker.find_conflict(print.objects_mutable(), {});
+                REQUIRE(checker.num_checked_pairs() == 2);
+                REQUIRE(conflict);
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/3mf.hpp"
 #include "libslic3r/Format/STL.hpp"
+#include "libslic3r/miniz_extension.hpp"
 
 #include <boost/filesystem/operations.hpp>
 
@@ -131,3 +132,36 @@ SCENARIO("2D convex hull of sinking object", "[3mf]") {
     }
 }
 
+
+SCENARIO("Parallel deflate of large 3mf entries", "[3mf]") {
+    GIVEN("a G-code like buffer spanning multiple compression chunks") {
+        std::string gcode;
+        for (int i = 0; gcode.size() < 9 * 1024 * 1024; ++ i)
+            gcode += "G1 X" + std::to_string(i % 250) + "." + std::to_string(i % 7) + " Y" + std::to_string((i * 13) % 250) + " E0.0" + std::to_string(i % 97) + "\n";
+        for (int level : { 0, 1, 6 }) {
+            WHEN("compressed at level " + std::to_string(level) + " and stored into a zip archive") {
+                DeflatedData deflated;
+                REQUIRE(deflate_parallel(gcode.data(), gcode.size(), level, deflated));
+                mz_zip_archive archive;
+                mz_zip_zero_struct(&archive);
+                REQUIRE(mz_zip_writer_init_heap(&archive, 0, 1024 * 1024));
+                REQUIRE(add_deflated_to_zip(&archive, "Metadata/plate_1.gcode", deflated));
+                void *buf; size_t buf_size;
+                REQUIRE(mz_zip_writer_finalize_heap_archive(&archive, &buf, &buf_size));
+                mz_zip_writer_end(&archive);
+                THEN("the entry is read back unchanged and its CRC matches") {
+                    mz_zip_zero_struct(&archive);
+                    REQUIRE(mz_zip_reader_init_mem(&archive, buf, buf_size, 0));
+                    size_t size = 0;
+                    void  *data = mz_zip_reader_extract_file_to_heap(&archive, "Metadata/plate_1.gcode", &size, 0);
+                    REQUIRE(data != nullptr);
+                    REQUIRE(std::string(static_cast<const char*>(data), size) == gcode);
+                    REQUIRE(deflated.crc32 == mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(gcode.data()), gcode.size()));
+                    mz_free(data);
+                    mz_zip_reader_end(&archive);
+                }
+                mz_free(buf);
+            }
+        }
+    }
+}
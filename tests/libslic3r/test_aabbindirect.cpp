@@ -3,6 +3,7 @@
 
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/AABBTreeIndirect.hpp>
+#include <libslic3r/AABBTreeCache.hpp>
 
 using namespace Slic3r;
 
@@ -58,3 +59,60 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.y() == Approx(0.5));
     REQUIRE(closest_point.z() == Approx(1.));
 }
+
+TEST_CASE("AABBTreeCache shares trees of a mesh while the mesh is alive", "[AABBIndirect]")
+{
+    AABBTreeCache::clear();
+    auto mesh = std::make_shared<const TriangleMesh>(its_make_sphere(1., PI / 16.));
+    AABBTreeCache::TreePtr tree = AABBTreeCache::get(mesh);
+    REQUIRE(tree);
+    REQUIRE(tree == AABBTreeCache::get(mesh));
+    REQUIRE(AABBTreeCache::size() == 1);
+
+    auto copy = std::make_shared<const TriangleMesh>(*mesh);
+    REQUIRE(tree != AABBTreeCache::get(copy));
+    REQUIRE(AABBTreeCache::size() == 2);
+
+    copy.reset();
+    REQUIRE(AABBTreeCache::size() == 1);
+    // The tree outlives its mesh as long as it is referenced.
+    mesh.reset();
+    REQUIRE(AABBTreeCache::size() == 0);
+    REQUIRE(! tree->empty());
+    AABBTreeCache::clear();
+}
+
+TEST_CASE("Wide tree gives the same hits as the binary tree", "[AABBIndirect]")
+{
+    indexed_triangle_set its = its_make_sphere(1., PI / 32.);
+    its_merge(its, its_make_cube(0.5, 0.5, 0.5));
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    AABBTreeIndirect::WideTree3f wide_tree(tree);
+    REQUIRE(! wide_tree.empty());
+
+    for (int i = 0; i < 200; ++ i) {
+        double phi = 2. * PI * i / 200.;
+        Vec3d  origin(2. * std::cos(phi), 2. * std::sin(phi), 0.3 * std::sin(3. * phi));
+        Vec3d  dir = (Vec3d(0.1 * std::sin(7. * phi), 0.2, 0.) - origin).normalized();
+
+        igl::Hit hit, hit_wide;
+        bool intersected = AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, origin, dir, hit);
+        REQUIRE(AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, wide_tree, origin, dir, hit_wide) == intersected);
+        if (intersected) {
+            REQUIRE(hit_wide.id == hit.id);
+            REQUIRE(hit_wide.t == Approx(hit.t));
+        }
+
+        std::vector<igl::Hit> hits, hits_wide;
+        AABBTreeIndirect::intersect_ray_all_hits(its.vertices, its.indices, tree, origin, dir, hits);
+        AABBTreeIndirect::intersect_ray_all_hits(its.vertices, its.indices, wide_tree, origin, dir, hits_wide);
+        REQUIRE(hits_wide.size() == hits.size());
+        for (size_t j = 0; j < hits.size(); ++ j)
+            REQUIRE(hits_wide[j].t == Approx(hits[j].t));
+
+        Vec3d  point = origin * (0.25 + 0.5 * (i % 3));
+        double radius_sq = 0.01, radius_sq_wide = 0.01;
+        REQUIRE(AABBTreeIndirect::is_any_triangle_in_radius(its.vertices, its.indices, wide_tree, point, radius_sq_wide) ==
+                AABBTreeIndirect::is_any_triangle_in_radius(its.vertices, its.indices, tree, point, radius_sq));
+    }
+}
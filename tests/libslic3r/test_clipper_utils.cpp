@@ -7,6 +7,9 @@
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/ExPolygon.hpp"
 #include "libslic3r/SVG.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+
+#include <test_utils.hpp>
 
 using namespace Slic3r;
 
@@ -299,3 +302,109 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+// Run the same operations with ClipperLib and with Clipper2, compare the resulting areas, counts and lengths.
+TEST_CASE("Clipper2 backend produces the same results as ClipperLib", "[ClipperUtils]") {
+    struct Result {
+        std::vector<double> areas;
+        std::vector<size_t> counts;
+        std::vector<double> lengths;
+        void add(const ExPolygons &expolys, bool with_count = true) {
+            double area = 0;
+            size_t count = 0;
+            for (const ExPolygon &expoly : expolys) {
+                area  += expoly.area();
+                count += expoly.holes.size() + 1;
+            }
+            areas.emplace_back(area);
+            counts.emplace_back(with_count ? count : 0);
+        }
+        void add(const Polygons &polys) {
+            double area = 0;
+            for (const Polygon &poly : polys)
+                area += poly.area();
+            areas.emplace_back(area);
+            counts.emplace_back(polys.size());
+        }
+        void add(const Polylines &polylines) {
+            double length = 0;
+            for (const Polyline &polyline : polylines)
+                length += polyline.length();
+            lengths.emplace_back(length);
+        }
+    };
+
+    auto run = [](const ExPolygons &layer, const ExPolygons &below, const Polylines &lines) {
+        Result   r;
+        Polygons polygons = to_polygons(layer);
+        r.add(offset_ex(layer, - scaled<float>(0.2)));
+        r.add(offset_ex(layer, scaled<float>(0.5), ClipperLib::jtRound, scaled<double>(0.01)));
+        r.add(offset(layer, - scaled<float>(0.45), ClipperLib::jtSquare));
+        r.add(offset(polygons, scaled<float>(0.3)));
+        r.add(offset_ex(polygons, - scaled<float>(0.3)));
+        r.add(offset2_ex(layer, - scaled<float>(1.), scaled<float>(0.8)));
+        r.add(opening(polygons, scaled<float>(0.6), scaled<float>(0.6)));
+        r.add(closing_ex(polygons, scaled<float>(0.6), scaled<float>(0.6)));
+        r.add(union_ex(layer, to_polygons(below)));
+        r.add(diff_ex(layer, below, ApplySafetyOffset::Yes));
+        r.add(intersection_ex(layer, below));
+        r.add(diff(polygons, offset(below, scaled<float>(0.1))));
+        r.add(intersection(polygons, to_polygons(below)));
+        r.add(union_(polygons, to_polygons(below)));
+        if (! below.empty())
+            // The libraries split the regions touching at a single point differently, compare just the area.
+            r.add(xor_ex(layer, below.front()), false);
+        r.add(intersection_pl(lines, layer));
+        r.add(diff_pl(lines, layer));
+        r.add(diff_pl(to_polygons(below), polygons));
+        r.add(offset(lines, scaled<float>(0.2)));
+        return r;
+    };
+
+    // Restores the backend selected before the test, even if a REQUIRE fails.
+    struct BackendGuard {
+        ClipperUtils::Backend saved { ClipperUtils::backend() };
+        ~BackendGuard() { ClipperUtils::set_backend(saved); }
+    } backend_guard;
+    for (const char *model : { "20mm_cube.obj", "bridge.obj", "cube_with_concave_hole.obj", "extruder_idler.obj", "frog_legs.obj",
+                               "ipadstand.obj", "overhang.obj", "sloping_hole.obj", "two_hollow_squares.obj" }) {
+        TriangleMesh mesh = load_model(model);
+        REQUIRE(! mesh.empty());
+        BoundingBoxf3 bbox = mesh.bounding_box();
+        std::vector<float> zs;
+        for (double z = bbox.min.z() + 0.1; z < bbox.max.z(); z += 0.7)
+            zs.emplace_back(float(z));
+        // Slice with the legacy backend, the slicer itself calls ClipperUtils.
+        ClipperUtils::set_backend(ClipperUtils::Backend::ClipperLib);
+        std::vector<ExPolygons> layers = slice_mesh_ex(mesh.its, zs);
+        for (size_t i = 0; i < layers.size(); ++ i) {
+            const ExPolygons &layer = layers[i];
+            ExPolygons below = i == 0 ? ExPolygons() : layers[i - 1];
+            for (ExPolygon &expoly : below)
+                expoly.translate(scaled(0.3), scaled(0.2));
+            // Hatching lines crossing the layer.
+            BoundingBox lines_bbox = get_extents(layer);
+            Polylines   lines;
+            for (coord_t x = lines_bbox.min.x(); x < lines_bbox.max.x(); x += scaled<coord_t>(1.3))
+                lines.push_back({ { x, lines_bbox.min.y() - 100 }, { x + scaled<coord_t>(2.), lines_bbox.max.y() + 100 } });
+
+            ClipperUtils::set_backend(ClipperUtils::Backend::ClipperLib);
+            Result legacy = run(layer, below, lines);
+            ClipperUtils::set_backend(ClipperUtils::Backend::Clipper2);
+            Result clipper2 = run(layer, below, lines);
+
+            INFO("Model " << model << ", layer " << i);
+            REQUIRE(legacy.areas.size() == clipper2.areas.size());
+            for (size_t j = 0; j < legacy.areas.size(); ++ j) {
+                INFO("Area of operation " << j);
+                // The offset contours are discretized slightly differently.
+                REQUIRE(clipper2.areas[j] == Approx(legacy.areas[j]).epsilon(0.005).margin(scaled<double>(0.1) * scaled<double>(0.1)));
+                REQUIRE(clipper2.counts[j] == legacy.counts[j]);
+            }
+            for (size_t j = 0; j < legacy.lengths.size(); ++ j) {
+                INFO("Length of operation " << j);
+                REQUIRE(clipper2.lengths[j] == Approx(legacy.lengths[j]).epsilon(1e-4).margin(scaled<double>(0.01)));
+            }
+        }
+    }
+}
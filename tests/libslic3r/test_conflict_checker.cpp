@@ -0,0 +1,54 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/GCode/ConflictChecker.hpp"
+
+using namespace Slic3r;
+
+// Object with a single stream, one square loop per layer of 0.2mm.
+static ConflictObjectLines make_object(double size, int num_layers)
+{
+    ConflictObjectLines object;
+    object.streams.emplace_back();
+    ConflictStreamLines &stream = object.streams.back();
+    Polygon square({ { 0, 0 }, { scaled(size), 0 }, { scaled(size), scaled(size) }, { 0, scaled(size) } });
+    for (int i = 0; i < num_layers; ++ i) {
+        ConflictLayerLines layer;
+        layer.bottom_z = 0.2f * i;
+        layer.lines    = square.lines();
+        layer.roles.assign(layer.lines.size(), erExternalPerimeter);
+        layer.bbox     = get_extents(square);
+        stream.layers.emplace_back(std::move(layer));
+        stream.bbox.merge(stream.layers.back().bbox);
+    }
+    return object;
+}
+
+TEST_CASE("Conflicts are found between overlapping objects only", "[ConflictChecker]") {
+    ConflictObjectLines tall  = make_object(10., 50);
+    ConflictObjectLines short_ = make_object(10., 5);
+
+    SECTION("Separated objects do not conflict") {
+        REQUIRE(! ConflictChecker::find_inter_of_objects(tall, Point(0, 0), short_, Point(scaled(20.), 0)));
+    }
+    SECTION("Crossing walls conflict at the first layer") {
+        std::optional<float> z = ConflictChecker::find_inter_of_objects(tall, Point(0, 0), short_, Point(scaled(5.), scaled(5.)));
+        REQUIRE(z);
+        REQUIRE(*z == Approx(0.f));
+    }
+    SECTION("The offset of an instance is applied to the shared lines") {
+        REQUIRE(ConflictChecker::find_inter_of_objects(tall, Point(scaled(100.), 0), short_, Point(scaled(105.), scaled(5.))));
+        REQUIRE(! ConflictChecker::find_inter_of_objects(tall, Point(scaled(100.), 0), short_, Point(scaled(5.), scaled(5.))));
+    }
+    SECTION("Layers above the shorter object are not compared") {
+        // Grows from a 1mm square to a 10mm square at the 10th layer.
+        ConflictObjectLines growing = make_object(10., 50);
+        for (size_t i = 0; i < 10; ++ i)
+            growing.streams.front().layers[i] = make_object(1., 1).streams.front().layers.front();
+        for (size_t i = 0; i < 10; ++ i)
+            growing.streams.front().layers[i].bottom_z = 0.2f * i;
+        REQUIRE(! ConflictChecker::find_inter_of_objects(growing, Point(0, 0), short_, Point(scaled(5.), scaled(5.))));
+        std::optional<float> z = ConflictChecker::find_inter_of_objects(growing, Point(0, 0), tall, Point(scaled(5.), scaled(5.)));
+        REQUIRE(z);
+        REQUIRE(*z == Approx(2.f));
+    }
+}
@@ -0,0 +1,70 @@
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Moves of the G-code processor result are stored by columns", "[GCodeProcessor]") {
+    using MoveVertex = GCodeProcessorResult::MoveVertex;
+    GCodeProcessorResult::MoveVertices moves;
+
+    MoveVertex travel;
+    travel.gcode_id = 10;
+    travel.type     = EMoveType::Travel;
+    travel.position = Vec3f(1.f, 2.f, 0.2f);
+    travel.feedrate = 120.f;
+
+    MoveVertex extrude;
+    extrude.gcode_id       = 11;
+    extrude.type           = EMoveType::Extrude;
+    extrude.extrusion_role = erExternalPerimeter;
+    extrude.extruder_id    = 1;
+    extrude.position       = Vec3f(10.f, 2.f, 0.2f);
+    extrude.width          = 0.45f;
+    extrude.height         = 0.2f;
+
+    const std::vector<Vec3f> points = { Vec3f(11.f, 3.f, 0.2f), Vec3f(12.f, 4.f, 0.2f) };
+    MoveVertex arc = extrude;
+    arc.gcode_id             = 12;
+    arc.position             = Vec3f(13.f, 5.f, 0.2f);
+    arc.move_path_type       = EMovePathType::Arc_move_ccw;
+    arc.arc_center_position  = Vec3f(10.f, 5.f, 0.2f);
+    arc.interpolation_points = points;
+
+    moves.push_back(MoveVertex());
+    moves.push_back(travel);
+    moves.push_back(arc);
+    moves.push_back(extrude);
+    REQUIRE(moves.size() == 4);
+
+    SECTION("The moves are decoded with the width and the height as half floats") {
+        REQUIRE(moves.type(1) == EMoveType::Travel);
+        REQUIRE(moves.feedrate(1) == 120.f);
+        REQUIRE(moves[3].extrusion_role == erExternalPerimeter);
+        REQUIRE(moves[3].extruder_id == 1);
+        REQUIRE(moves[3].position == extrude.position);
+        REQUIRE(moves.width(3) == Approx(0.45f).epsilon(0.001));
+        REQUIRE(moves.height(3) == Approx(0.2f).epsilon(0.001));
+        REQUIRE(moves.interpolation_points(3).empty());
+    }
+    SECTION("Only the arc moves keep the arc center and the interpolation points") {
+        const MoveVertex decoded = moves[2];
+        REQUIRE(decoded.is_arc_move_with_interpolation_points());
+        REQUIRE(decoded.arc_center_position == arc.arc_center_position);
+        REQUIRE(std::vector<Vec3f>(decoded.interpolation_points.begin(), decoded.interpolation_points.end()) == points);
+        REQUIRE(moves.arc_center_position(1) == Vec3f::Zero());
+    }
+    SECTION("A move is moved to the end with its arc") {
+        moves.push_back(moves[2]);
+        moves.erase(2);
+        REQUIRE(moves.size() == 4);
+        REQUIRE(moves.gcode_id(2) == 11);
+        REQUIRE(moves.gcode_id(3) == 12);
+        REQUIRE(! moves.is_arc_move(2));
+        const GCodeProcessorResult::InterpolationPoints moved = moves.interpolation_points(3);
+        REQUIRE(std::vector<Vec3f>(moved.begin(), moved.end()) == points);
+        REQUIRE(moves.arc_center_position(3) == arc.arc_center_position);
+    }
+}
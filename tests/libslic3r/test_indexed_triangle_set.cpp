@@ -309,3 +309,80 @@ TEST_CASE("Simplified cube should not be empty.", "[its]")
     its_quadric_edge_collapse(its, wanted_count, &max_error);
     CHECK(!its.indices.empty());
 }
+
+TEST_CASE("Simplify mesh by Quadric edge collapse in parallel", "[its]")
+{
+    // big enough to be split into clusters
+    indexed_triangle_set sphere = its_make_sphere(10., 2 * PI / 400);
+    REQUIRE(its_num_open_edges(sphere) == 0);
+    double original_volume = its_volume(sphere);
+
+    SECTION("Reduce to triangle count") {
+        indexed_triangle_set its = sphere; // copy
+        uint32_t wanted_count = sphere.indices.size() * 0.05;
+        float max_error = std::numeric_limits<float>::max();
+        its_quadric_edge_collapse_parallel(its, wanted_count, &max_error);
+        CHECK(its.indices.size() <= wanted_count);
+        CHECK(its_num_open_edges(its) == 0);
+        CHECK(!exist_triangle_with_twice_vertices(its.indices));
+        CHECK(fabs(original_volume - its_volume(its)) < 5.);
+
+        CompareConfig cfg;
+        cfg.max_average_distance = 0.01f;
+        cfg.max_distance         = 0.05f;
+        CHECK(is_similar(sphere, its, cfg));
+        CHECK(is_similar(its, sphere, cfg));
+    }
+
+    SECTION("Reduce to maximal error") {
+        indexed_triangle_set its = sphere; // copy
+        float max_error = 1e-3f;
+        its_quadric_edge_collapse_parallel(its, 0, &max_error);
+        CHECK(its.indices.size() < sphere.indices.size());
+        CHECK(max_error < 1e-3f);
+        CHECK(its_num_open_edges(its) == 0);
+        CHECK(!exist_triangle_with_twice_vertices(its.indices));
+    }
+}
+
+#include "libslic3r/Geometry.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+TEST_CASE("Slicing with MeshSlicingIndex matches slicing the mesh", "[its][TriangleMeshSlicer]")
+{
+    TriangleMesh mesh = load_model("frog_legs.obj");
+    REQUIRE_FALSE(mesh.empty());
+    Transform3d trafo = Geometry::assemble_transform(Vec3d(1., -2., 0.5), Vec3d(0.3, 0.2, 0.1), Vec3d(1., 1.5, 0.8));
+    BoundingBoxf3 bbox = mesh.transformed_bounding_box(trafo);
+    std::vector<float> zs;
+    for (double z = bbox.min.z() + 0.05; z < bbox.max.z(); z += 0.1)
+        zs.emplace_back(float(z));
+
+    MeshSlicingIndex index(mesh.its, trafo);
+    SECTION("faces at a plane") {
+        std::vector<uint32_t> faces;
+        for (float z : { zs.front(), zs[zs.size() / 2], zs.back() }) {
+            std::vector<uint32_t> expected;
+            for (uint32_t face_idx = 0; face_idx < uint32_t(mesh.its.indices.size()); ++ face_idx) {
+                const Vec3i &face  = mesh.its.indices[face_idx];
+                float        min_z = std::min({ index.vertices()[face(0)].z(), index.vertices()[face(1)].z(), index.vertices()[face(2)].z() });
+                float        max_z = std::max({ index.vertices()[face(0)].z(), index.vertices()[face(1)].z(), index.vertices()[face(2)].z() });
+                if (min_z != max_z && min_z <= z && max_z >= z)
+                    expected.emplace_back(face_idx);
+            }
+            index.faces_at(z, faces);
+            CHECK(faces == expected);
+        }
+    }
+    SECTION("slice_mesh") {
+        MeshSlicingParams params;
+        params.trafo = trafo;
+        CHECK(slice_mesh(index, zs, params) == slice_mesh(mesh.its, zs, params));
+    }
+    SECTION("slice_mesh_slabs") {
+        std::vector<Polygons> top, bottom, top_index, bottom_index;
+        slice_mesh_slabs(mesh.its, zs, trafo, &top, &bottom, []{});
+        slice_mesh_slabs(index, zs, &top_index, &bottom_index, []{});
+        CHECK(top_index == top);
+        CHECK(bottom_index == bottom);
+    }
+}
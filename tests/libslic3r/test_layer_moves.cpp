@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "libslic3r/GCode/LayerMoves.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Layer moves are parsed once with their axes and markers", "[LayerMoves]") {
+    const std::string gcode =
+        "G1 F1800;_EXTRUDE_SET_SPEED;_EXTERNAL_PERIMETER\n"
+        "G1 X10.5 Y-2 E0.125\n"
+        ";_EXTRUDE_END\n"
+        "T1\n"
+        "  M106 S255 ; enable fan\n"
+        "G4 P500\n"
+        "\n"
+        "G2 X1 Y1 I0.5 J-0.5 E0.01";
+    LayerMoves moves = LayerMoves::parse(gcode, "T");
+    REQUIRE(moves.size() == 8);
+
+    const LayerMove &set_speed = moves.moves[0];
+    REQUIRE(set_speed.type == (LayerMove::TYPE_G1 | LayerMove::TYPE_EXTRUDE_SET_SPEED | LayerMove::TYPE_EXTERNAL_PERIMETER));
+    REQUIRE(set_speed.has(LayerMove::F));
+    REQUIRE(set_speed.value(LayerMove::F) == 1800.f);
+
+    const LayerMove &extrude = moves.moves[1];
+    REQUIRE(extrude.type == LayerMove::TYPE_G1);
+    REQUIRE(extrude.value(LayerMove::X) == 10.5f);
+    REQUIRE(extrude.value(LayerMove::Y) == -2.f);
+    REQUIRE(extrude.value(LayerMove::E) == 0.125f);
+    REQUIRE(! extrude.has(LayerMove::Z));
+    REQUIRE(extrude.raw(gcode) == "G1 X10.5 Y-2 E0.125");
+
+    REQUIRE(moves.moves[2].type == LayerMove::TYPE_EXTRUDE_END);
+    REQUIRE(moves.moves[3].type == LayerMove::TYPE_SET_TOOL);
+    REQUIRE(moves.moves[3].tool == 1);
+
+    const LayerMove &fan = moves.moves[4];
+    REQUIRE(fan.cmd(gcode) == "M106");
+    REQUIRE(fan.value(LayerMove::S) == 255.f);
+
+    REQUIRE(moves.moves[5].type == LayerMove::TYPE_G4);
+    REQUIRE(moves.moves[5].value(LayerMove::P) == 500.f);
+    REQUIRE(moves.moves[6].cmd(gcode).empty());
+
+    // The last line is not terminated.
+    const LayerMove &arc = moves.moves[7];
+    REQUIRE(arc.type == LayerMove::TYPE_G2);
+    REQUIRE(arc.value(LayerMove::J) == -0.5f);
+    REQUIRE(arc.line_end == gcode.size());
+}
+
+TEST_CASE("Copied layer moves match the moves of the concatenated G-code", "[LayerMoves]") {
+    const std::string a = "G1 X1 Y1\nT0\n";
+    const std::string b = "M107\nG1 X2 Y2 E0.5\n";
+    LayerMoves moves = LayerMoves::parse(a, "T");
+    moves.append(LayerMoves::parse(b, "T"), a.size());
+
+    const std::string ab = a + b;
+    LayerMoves expected = LayerMoves::parse(ab, "T");
+    REQUIRE(moves.size() == expected.size());
+    for (size_t i = 0; i < moves.size(); ++ i) {
+        REQUIRE(moves.moves[i].line_start == expected.moves[i].line_start);
+        REQUIRE(moves.moves[i].line_end == expected.moves[i].line_end);
+        REQUIRE(moves.moves[i].raw(ab) == expected.moves[i].raw(ab));
+    }
+
+    // Copy the lines of b only, shifted to the start of another G-code.
+    LayerMoves part;
+    part.append(expected, a.size(), ab.size(), - ptrdiff_t(a.size()));
+    REQUIRE(part.size() == 2);
+    REQUIRE(part.moves.front().line_start == 0);
+    REQUIRE(part.moves.back().raw(b) == "G1 X2 Y2 E0.5");
+}
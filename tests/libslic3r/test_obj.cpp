@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Format/objparser.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <sstream>
+
+using namespace ObjParser;
+
+static inline std::string obj_path(const char *path)
+{
+	return std::string(TEST_DATA_DIR) + "/" + path;
+}
+
+TEST_CASE("Parsing an OBJ file in chunks matches parsing it sequentially", "[obj]") {
+	// A file large enough to be split into multiple chunks, referencing the vertex attributes by relative indices
+	// across the chunk boundaries, with groups and materials.
+	std::ostringstream obj;
+	obj << "mtllib material.mtl\n";
+	for (int i = 0; i < 100000; ++ i) {
+		if (i % 1000 == 0)
+			obj << "g group" << i << "\nusemtl material" << i % 3 << "\n";
+		obj << "v " << 0.1 * i << " " << 1e-3 * i << " " << -7.5 * i << "\r\nvt 0.25 " << 1. / (i + 1) << "\nvn 0 0 1\n";
+		if (i >= 3)
+			obj << (i % 2 ? "f -1/-1/-1 -2/-2/-1 -4/-3/-1\n" : "f -1//-1 -2//-1 -3//-1 -4//-1\n");
+	}
+	obj << "f 1 2 3\n";
+	REQUIRE(obj.str().size() > 4 * 1024 * 1024);
+
+	boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.obj");
+	{
+		boost::nowide::ofstream file(path.string(), std::ios::binary);
+		file << obj.str();
+	}
+	ObjData data_chunked;
+	REQUIRE(objparse(path.string().c_str(), data_chunked));
+	boost::filesystem::remove(path);
+
+	std::istringstream stream(obj.str());
+	ObjData data_sequential;
+	REQUIRE(objparse(stream, data_sequential));
+	REQUIRE(objequal(data_chunked, data_sequential));
+	REQUIRE(data_chunked.groups.size() == 100);
+	REQUIRE(data_chunked.vertices.back().coordIdx == -1);
+	REQUIRE(data_chunked.vertices[data_chunked.vertices.size() - 2].coordIdx == 2);
+}
+
+TEST_CASE("Parsing an OBJ file with quads", "[obj]") {
+	ObjData data_chunked;
+	REQUIRE(objparse(obj_path("extruder_idler_quads.obj").c_str(), data_chunked));
+	boost::nowide::ifstream file(obj_path("extruder_idler_quads.obj"), std::ios::binary);
+	ObjData data_sequential;
+	REQUIRE(objparse(file, data_sequential));
+	REQUIRE(objequal(data_chunked, data_sequential));
+}
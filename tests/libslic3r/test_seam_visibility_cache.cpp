@@ -0,0 +1,51 @@
+#include <catch2/catch.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include "libslic3r/GCode/SeamVisibilityCache.hpp"
+
+using namespace Slic3r;
+
+static SeamVisibilityCache::SamplesPtr make_samples()
+{
+    std::vector<Vec3f> positions { Vec3f(0.f, 0.f, 0.f), Vec3f(1.f, 0.f, 0.f), Vec3f(0.f, 2.f, 1.f) };
+    std::vector<Vec3f> normals   { Vec3f(0.f, 0.f, 1.f), Vec3f(1.f, 0.f, 0.f), Vec3f(0.f, 1.f, 0.f) };
+    return std::make_shared<const SeamVisibilitySamples>(std::move(positions), std::move(normals), std::vector<float>{ 0.25f, 0.5f, 1.f }, 0.75f);
+}
+
+TEST_CASE("Seam visibility samples are shared through the cache", "[SeamVisibilityCache]") {
+    SeamVisibilityCache::set_directory({});
+    SeamVisibilityCache::clear();
+    REQUIRE(! SeamVisibilityCache::find("key"));
+
+    SeamVisibilityCache::SamplesPtr samples = SeamVisibilityCache::insert("key", make_samples());
+    REQUIRE(SeamVisibilityCache::find("key") == samples);
+    // The first samples inserted win.
+    REQUIRE(SeamVisibilityCache::insert("key", make_samples()) == samples);
+    REQUIRE(SeamVisibilityCache::size() == 1);
+
+    std::vector<size_t> nearby = find_nearby_points(samples->tree, Vec3f(0.9f, 0.f, 0.f), 0.5f);
+    REQUIRE(nearby == std::vector<size_t>{ 1 });
+    SeamVisibilityCache::clear();
+}
+
+TEST_CASE("Seam visibility samples are restored from the cache directory", "[SeamVisibilityCache]") {
+    boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("seamvis-%%%%-%%%%");
+    SeamVisibilityCache::set_directory(dir.string());
+    SeamVisibilityCache::clear();
+    SeamVisibilityCache::insert("0123abcd", make_samples());
+    SeamVisibilityCache::clear();
+
+    SeamVisibilityCache::SamplesPtr restored = SeamVisibilityCache::find("0123abcd");
+    REQUIRE(restored);
+    SeamVisibilityCache::SamplesPtr expected = make_samples();
+    REQUIRE(restored->positions == expected->positions);
+    REQUIRE(restored->normals == expected->normals);
+    REQUIRE(restored->visibility == expected->visibility);
+    REQUIRE(restored->radius == expected->radius);
+    REQUIRE(find_nearby_points(restored->tree, Vec3f(0.f, 2.f, 0.9f), 0.5f) == std::vector<size_t>{ 2 });
+
+    SeamVisibilityCache::set_directory({});
+    SeamVisibilityCache::clear();
+    boost::filesystem::remove_all(dir);
+}
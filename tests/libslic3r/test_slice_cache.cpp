@@ -0,0 +1,70 @@
+#include <catch2/catch.hpp>
+
+#include <limits>
+
+#include "libslic3r/ExPolygon.hpp"
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/Format/SliceCache.hpp"
+
+using namespace Slic3r;
+
+SCENARIO("Binary slice cache stream", "[SliceCache]") {
+    GIVEN("scalars of all kinds") {
+        std::string buffer;
+        SliceCache::BinaryWriter out(buffer);
+        out.put_varint(0);
+        out.put_varint(300);
+        out.put_varint(uint64_t(-1));
+        out.put_svarint(-1);
+        out.put_svarint(std::numeric_limits<int64_t>::min());
+        out.put_double(0.2);
+        out.put_string("layer");
+        WHEN("read back") {
+            SliceCache::BinaryReader in(buffer.data(), buffer.data() + buffer.size());
+            THEN("the values match") {
+                REQUIRE(in.get_varint() == 0);
+                REQUIRE(in.get_varint() == 300);
+                REQUIRE(in.get_varint() == uint64_t(-1));
+                REQUIRE(in.get_svarint() == -1);
+                REQUIRE(in.get_svarint() == std::numeric_limits<int64_t>::min());
+                REQUIRE(in.get_double() == 0.2);
+                REQUIRE(in.get_string() == "layer");
+                REQUIRE(in.eof());
+                REQUIRE_THROWS_AS(in.get_u8(), Slic3r::FileIOError);
+            }
+        }
+    }
+    GIVEN("an ExPolygon with a hole") {
+        ExPolygon expoly;
+        expoly.contour = Polygon{ { -scaled<coord_t>(10.), -scaled<coord_t>(10.) }, { scaled<coord_t>(10.), -scaled<coord_t>(10.) },
+                                  { scaled<coord_t>(10.), scaled<coord_t>(10.) }, { -scaled<coord_t>(10.), scaled<coord_t>(10.) } };
+        expoly.holes.push_back(Polygon{ { -100, -100 }, { -100, 100 }, { 100, 100 }, { 100, -100 } });
+        std::string buffer;
+        SliceCache::BinaryWriter out(buffer);
+        SliceCache::write_expolygons(out, { expoly, expoly });
+        WHEN("read back") {
+            SliceCache::BinaryReader in(buffer.data(), buffer.data() + buffer.size());
+            ExPolygons expolys;
+            SliceCache::read_expolygons(in, expolys);
+            THEN("the polygons are identical") {
+                REQUIRE(expolys.size() == 2);
+                REQUIRE(expolys.front() == expoly);
+                REQUIRE(expolys.back() == expoly);
+                REQUIRE(in.eof());
+            }
+        }
+        WHEN("the stream is truncated") {
+            SliceCache::BinaryReader in(buffer.data(), buffer.data() + buffer.size() / 2);
+            ExPolygons expolys;
+            THEN("reading throws") {
+                REQUIRE_THROWS_AS(SliceCache::read_expolygons(in, expolys), Slic3r::FileIOError);
+            }
+        }
+    }
+    GIVEN("data which is not a binary slice cache") {
+        std::string buffer = "{\"name\": \"not a binary cache\"}";
+        THEN("decoding the directory throws") {
+            REQUIRE_THROWS_AS(SliceCache::decode_object_directory(buffer.data(), buffer.size()), Slic3r::FileIOError);
+        }
+    }
+}
@@ -2,6 +2,14 @@
 
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/STL.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+#include <admesh/stl.h>
+
+#include <algorithm>
+#include <random>
+
+#include <boost/filesystem.hpp>
 
 using namespace Slic3r;
 
@@ -55,3 +63,81 @@ SCENARIO("Reading an STL file", "[stl]") {
 		}
 	}
 }
+
+SCENARIO("Connecting facets of an STL", "[stl]") {
+	GIVEN("facets of a closed sphere in random order") {
+		indexed_triangle_set sphere = its_make_sphere(10., 2. * PI / 64.);
+		std::vector<stl_facet> facets;
+		for (const stl_triangle_vertex_indices &face : sphere.indices) {
+			stl_facet facet;
+			facet.normal = stl_normal::Zero();
+			for (int i = 0; i < 3; ++ i)
+				facet.vertex[i] = sphere.vertices[face(i)];
+			facets.emplace_back(facet);
+		}
+		std::shuffle(facets.begin(), facets.end(), std::mt19937(0));
+		stl_file stl;
+		stl.stats.type                = inmemory;
+		stl.stats.number_of_facets    = uint32_t(facets.size());
+		stl.stats.original_num_facets = int(facets.size());
+		stl_allocate(&stl);
+		std::copy(facets.begin(), facets.end(), stl.facet_start.begin());
+		stl_get_size(&stl);
+		WHEN("edges are matched exactly") {
+			stl_check_facets_exact(&stl);
+			THEN("all facets are connected along all their edges, symmetrically") {
+				REQUIRE(stl.stats.connected_facets_3_edge == int(facets.size()));
+				REQUIRE(stl.stats.connected_edges == 3 * int(facets.size()));
+				for (int facet_idx = 0; facet_idx < int(facets.size()); ++ facet_idx)
+					for (int edge_idx = 0; edge_idx < 3; ++ edge_idx) {
+						int neighbor = stl.neighbors_start[facet_idx].neighbor[edge_idx];
+						const stl_neighbors &other = stl.neighbors_start[neighbor];
+						REQUIRE(std::count(other.neighbor, other.neighbor + 3, facet_idx) == 1);
+					}
+			}
+			THEN("shared vertices are recovered") {
+				indexed_triangle_set its;
+				stl_generate_shared_vertices(&stl, its);
+				REQUIRE(its.vertices.size() == sphere.vertices.size());
+				REQUIRE(its.indices.size() == sphere.indices.size());
+				REQUIRE(its_num_open_edges(its) == 0);
+			}
+		}
+	}
+}
+
+SCENARIO("Loading a binary STL of a closed mesh through the fast path", "[stl]") {
+	GIVEN("two spheres in a binary STL, one of them inside out, facets in random order") {
+		indexed_triangle_set its = its_make_sphere(10., 2. * PI / 64.);
+		indexed_triangle_set other = its;
+		its_translate(other, Vec3f(30.f, 0.f, 0.f));
+		its_flip_triangles(other);
+		its_merge(its, other);
+		std::shuffle(its.indices.begin(), its.indices.end(), std::mt19937(0));
+		boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.stl");
+		REQUIRE(its_write_stl_binary(path.string().c_str(), "", its));
+		WHEN("the STL is loaded") {
+			indexed_triangle_set loaded;
+			LoadStlIndexedResult result = load_stl_binary_indexed(path.string().c_str(), loaded);
+			TriangleMesh mesh;
+			stl_file stl;
+			REQUIRE(stl_open(&stl, path.string().c_str()));
+			mesh.from_stl(stl, true);
+			THEN("the mesh is the same as the one repaired by admesh") {
+				REQUIRE(result == LoadStlIndexedResult::Loaded);
+				REQUIRE(loaded.vertices == mesh.its.vertices);
+				REQUIRE(loaded.indices == mesh.its.indices);
+			}
+		}
+		WHEN("a facet is removed") {
+			its.indices.pop_back();
+			its.indices.pop_back();
+			REQUIRE(its_write_stl_binary(path.string().c_str(), "", its));
+			indexed_triangle_set loaded;
+			THEN("the fast path rejects the open mesh") {
+				REQUIRE(load_stl_binary_indexed(path.string().c_str(), loaded) == LoadStlIndexedResult::NotApplicable);
+			}
+		}
+		boost::filesystem::remove(path);
+	}
+}